@@ -0,0 +1,52 @@
+// An aggregation may be answered from an index alone when the index holds every field the
+// pipeline depends on.  Index keys hold null for a missing field, so that must not turn missing
+// fields into nulls.  Each pipeline is checked against the same pipeline on an unindexed copy of
+// the data, which can only be answered by a collection scan.
+
+load('jstests/aggregation/extras/utils.js');
+
+var t = db.covered_missing_fields;
+var unindexed = db.covered_missing_fields_unindexed;
+t.drop();
+unindexed.drop();
+
+[{_id: 0, a: 1, b: 1},
+ {_id: 1, a: 1},
+ {_id: 2, a: 2, b: null},
+ {_id: 3, b: 3},
+ {_id: 4, a: 3, b: {c: 1}},
+ {_id: 5, a: 3, b: {}},
+ {_id: 6, a: 4, b: "x"}].forEach(function(doc) {
+    t.insert(doc);
+    unindexed.insert(doc);
+});
+t.ensureIndex({a: 1, b: 1});
+t.ensureIndex({"b.c": 1, a: 1});
+
+function check(pipeline) {
+    var expected = unindexed.aggregate(pipeline).toArray();
+    var actual = t.aggregate(pipeline).toArray();
+    assert(resultsEq(expected, actual),
+           tojson({pipeline: pipeline, expected: expected, actual: actual}));
+    return actual;
+}
+
+// Nothing in the query rules out documents without b.
+var res = check([{$match: {a: {$gte: 1}}}, {$project: {_id: 0, a: 1, b: 1}}]);
+assert.eq(6, res.length);
+check([{$match: {a: 1}}, {$project: {_id: 0, b: 1}}]);
+check([{$match: {a: {$in: [1, 2]}}}, {$sort: {a: 1}}, {$project: {_id: 0, a: 1, b: 1}}]);
+check([{$match: {a: {$gte: 1}, b: {$ne: 1}}}, {$project: {_id: 0, a: 1, b: 1}}]);
+check([{$match: {a: {$gte: 1}, b: {$in: [1, null]}}}, {$project: {_id: 0, a: 1, b: 1}}]);
+check([{$match: {a: {$gte: 1}, b: {$lte: null}}}, {$project: {_id: 0, a: 1, b: 1}}]);
+check([{$match: {"b.c": {$gte: 1}}}, {$project: {_id: 0, a: 1, "b.c": 1}}]);
+
+// The query rules out documents without b, so the index may answer.
+check([{$match: {a: {$gte: 1}, b: {$exists: true}}}, {$project: {_id: 0, a: 1, b: 1}}]);
+check([{$match: {a: {$gte: 1}, b: {$gte: 1}}}, {$project: {_id: 0, a: 1, b: 1}}]);
+check([{$match: {$and: [{a: {$gte: 1}}, {b: {$in: [1, "x"]}}]}},
+       {$project: {_id: 0, a: 1, b: 1}}]);
+
+// A collection scan on the indexed collection agrees too.
+var collScan = t.find({a: {$gte: 1}}, {_id: 0, a: 1, b: 1}).hint({$natural: 1}).toArray();
+assert(resultsEq(collScan, res), tojson({collScan: collScan, aggregate: res}));
@@ -0,0 +1,62 @@
+// Test that building a text index with parallel key generation produces the same index as
+// building it on a single thread.
+
+var t = db.fts_index_build_parallel;
+t.drop();
+
+var words = ["running", "jumps", "apple", "banana", "cherry", "the", "correr", "saltar",
+             "manzana", "plátano", "and", "y"];
+Random.setRandomSeed(23);
+for (var i = 0; i < 3000; i++) {
+    var body = [];
+    var length = 1 + Random.randInt(10);
+    for (var j = 0; j < length; j++) {
+        body.push(words[Random.randInt(words.length)]);
+    }
+    var doc = {_id: i, title: words[i % words.length], body: body.join(" ")};
+    if (i % 3 == 0) {
+        doc.language = "spanish";
+    }
+    t.insert(doc);
+}
+
+var queries = ["run", "jump apple", "correr", "manzana plátano", "cherry -banana", "\"the apple\""];
+
+function indexContents() {
+    var results = {};
+    queries.forEach(function(q) {
+        results[q] = t.find({$text: {$search: q}}, {score: {$meta: "textScore"}})
+                      .sort({_id: 1}).toArray();
+    });
+    return results;
+}
+
+function buildIndex(threads) {
+    assert.commandWorked(db.adminCommand({setParameter: 1, bulkIndexBuildKeyGenThreads: threads}));
+    t.dropIndexes();
+    return t.ensureIndex({title: "text", body: "text"}, {weights: {title: 5}});
+}
+
+var old = db.adminCommand({getParameter: 1, bulkIndexBuildKeyGenThreads: 1});
+assert.commandWorked(old);
+
+try {
+    assert.commandWorked(buildIndex(1));
+    var serial = indexContents();
+    assert.commandWorked(buildIndex(4));
+    var parallel = indexContents();
+    queries.forEach(function(q) {
+        assert.lt(0, serial[q].length, q);
+        assert.eq(serial[q], parallel[q], q);
+    });
+
+    // A document whose keys can't be generated still fails the build.
+    t.insert({_id: "bad", body: "apple", language: "klingon"});
+    var res = buildIndex(4);
+    assert.commandFailed(res);
+    assert.eq(17262, res.code, tojson(res));
+}
+finally {
+    db.adminCommand({setParameter: 1,
+                     bulkIndexBuildKeyGenThreads: old.bulkIndexBuildKeyGenThreads});
+}
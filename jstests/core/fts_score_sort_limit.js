@@ -0,0 +1,69 @@
+// Test that a limited sort on text score returns the same top results as a full sort.
+
+var t = db.fts_score_sort_limit;
+t.drop();
+
+var words = ["apple", "banana", "cherry", "grape", "lemon", "mango", "olive", "peach", "plum"];
+Random.setRandomSeed(17);
+for (var i = 0; i < 500; i++) {
+    var body = [];
+    var length = 1 + Random.randInt(12);
+    for (var j = 0; j < length; j++) {
+        // Earlier words are much more common than later ones.
+        body.push(words[Math.floor(words.length * Math.pow(Random.rand(), 2))]);
+    }
+    t.insert({_id: i, body: body.join(" "), n: i % 5});
+}
+assert.commandWorked(t.ensureIndex({body: "text"}));
+
+var proj = {score: {$meta: "textScore"}};
+var sort = {score: {$meta: "textScore"}};
+
+function scores(cursor) {
+    return cursor.toArray().map(function(doc) { return doc.score; });
+}
+
+function checkTopK(query, k) {
+    var all = scores(t.find(query, proj).sort(sort));
+    var top = scores(t.find(query, proj).sort(sort).limit(k));
+    assert.eq(all.slice(0, k), top, tojson(query) + " limit " + k);
+}
+
+var queries = [
+    {$text: {$search: "apple"}},
+    {$text: {$search: "apple banana plum"}},
+    {$text: {$search: "peach plum olive"}},
+    {$text: {$search: "apple banana -cherry"}},
+    {$text: {$search: "\"apple banana\" grape"}},
+    {$text: {$search: "banana lemon"}, n: 3},
+    {$text: {$search: "kiwi"}}
+];
+queries.forEach(function(query) {
+    [1, 5, 40, 1000].forEach(function(k) {
+        checkTopK(query, k);
+    });
+});
+
+// Skip is applied after the top k + skip documents are found.
+var all = scores(t.find(queries[1], proj).sort(sort));
+var page = scores(t.find(queries[1], proj).sort(sort).skip(10).limit(10));
+assert.eq(all.slice(10, 20), page);
+
+// The text stage reports that it was asked for the top documents, and reads no more keys.
+var explain = t.find(queries[1], proj).sort(sort).limit(5).explain(true);
+var fullExplain = t.find(queries[1], proj).sort(sort).explain(true);
+function textStats(stats) {
+    if (stats.type == "TEXT") {
+        return stats;
+    }
+    for (var i = 0; i < stats.children.length; i++) {
+        var res = textStats(stats.children[i]);
+        if (res) {
+            return res;
+        }
+    }
+    return null;
+}
+assert.eq(5, textStats(explain.stats).topK);
+assert.eq(0, textStats(fullExplain.stats).topK);
+assert.lte(textStats(explain.stats).keysExamined, textStats(fullExplain.stats).keysExamined);
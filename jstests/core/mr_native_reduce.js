@@ -0,0 +1,110 @@
+// Test map/reduce with the built in reducers, and mapping on several threads.
+
+var t = db.mr_native_reduce;
+t.drop();
+
+var outName = "mr_native_reduce_out";
+var out = db[outName];
+out.drop();
+
+// Enough distinct keys that tuples get spilled before the final reduce.
+for (var i = 0; i < 20000; i++) {
+    t.insert({_id: i, k: "key" + (i % 5000), n: i % 7, tags: ["t" + (i % 3), "t" + (i % 4)]});
+}
+
+var map = function() { emit(this.k, this.n); };
+var mapTags = function() { emit(this.k, this.tags); };
+
+var jsReducers = {
+    $sum: function(k, vs) { return Array.sum(vs); },
+    $min: function(k, vs) { return Math.min.apply(null, vs); },
+    $max: function(k, vs) { return Math.max.apply(null, vs); }
+};
+
+function results(m, r, opts) {
+    var res = t.mapReduce(m, r, opts);
+    assert.commandWorked(res);
+    var docs = opts.out.inline ? res.results : out.find().toArray();
+    var byKey = {};
+    docs.forEach(function(d) { byKey[d._id] = d.value; });
+    return byKey;
+}
+
+function sortedSets(byKey) {
+    for (var k in byKey) {
+        byKey[k] = byKey[k].sort();
+    }
+    return byKey;
+}
+
+function runAll(label) {
+    [{replace: outName}, {inline: 1}].forEach(function(outOpt) {
+        for (var name in jsReducers) {
+            var expected = results(map, jsReducers[name], {out: outOpt});
+            var actual = results(map, name, {out: outOpt});
+            assert.eq(5000, Object.keySet(actual).length, label + " " + name);
+            assert.eq(expected, actual, label + " " + name + " " + tojson(outOpt));
+        }
+    });
+
+    var expectedSets = {};
+    t.find().forEach(function(d) {
+        var set = expectedSets[d.k] || [];
+        d.tags.forEach(function(tag) {
+            if (set.indexOf(tag) < 0) {
+                set.push(tag);
+            }
+        });
+        expectedSets[d.k] = set;
+    });
+    assert.eq(sortedSets(expectedSets),
+              sortedSets(results(mapTags, "$addToSet", {out: {replace: outName}})),
+              label + " $addToSet");
+}
+
+var old = db.adminCommand({getParameter: 1, mapReduceMapThreads: 1});
+assert.commandWorked(old);
+
+try {
+    assert.commandWorked(db.adminCommand({setParameter: 1, mapReduceMapThreads: 1}));
+    runAll("serial");
+    var serial = results(map, "$sum", {out: {replace: outName}, finalize: function(k, v) {
+        return v * 2;
+    }});
+
+    assert.commandWorked(db.adminCommand({setParameter: 1, mapReduceMapThreads: 4}));
+    runAll("parallel");
+    assert.eq(serial, results(map, "$sum", {out: {replace: outName}, finalize: function(k, v) {
+        return v * 2;
+    }}));
+
+    // A map function that throws still fails the whole map/reduce.
+    var res = t.runCommand("mapReduce", {map: function() { throw "oops"; },
+                                         reduce: "$sum",
+                                         out: {inline: 1}});
+    assert.commandFailed(res);
+
+    // out: reduce combines new results with the existing ones using the same reducer.
+    out.drop();
+    var once = results(map, "$sum", {out: {reduce: outName}});
+    var twice = results(map, "$sum", {out: {reduce: outName}});
+    for (var k in once) {
+        assert.eq(once[k] * 2, twice[k], k);
+    }
+}
+finally {
+    db.adminCommand({setParameter: 1, mapReduceMapThreads: old.mapReduceMapThreads});
+}
+
+// Unknown reducer names and values a reducer can't handle are errors.
+var res = t.runCommand("mapReduce", {map: map, reduce: "$avg", out: {inline: 1}});
+assert.commandFailed(res);
+assert.eq(17511, res.code, tojson(res));
+
+res = t.runCommand("mapReduce", {map: mapTags, reduce: "$sum", out: {inline: 1}});
+assert.commandFailed(res);
+assert.eq(17512, res.code, tojson(res));
+
+res = t.runCommand("mapReduce", {map: map, reduce: "$addToSet", out: {inline: 1}});
+assert.commandFailed(res);
+assert.eq(17513, res.code, tojson(res));
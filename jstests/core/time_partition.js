@@ -0,0 +1,130 @@
+// Test that documents inserted into a time partitioned collection land in one child collection
+// per interval, that queries on the parent collection read from the matching children, that
+// index builds, index drops and drops on the parent reach the children, and that operations
+// which aren't routed to the children fail on the parent.
+
+var t = db.time_partition;
+t.drop();
+db.getCollectionNames().forEach(function(name) {
+    if (name.indexOf("time_partition.partition.") == 0) {
+        db.getCollection(name).drop();
+    }
+});
+
+// Bad options are rejected.
+assert.commandFailed(db.createCollection("time_partition", {timePartition: {field: "ts"}}));
+assert.commandFailed(db.createCollection("time_partition",
+                                         {timePartition: {field: "ts", seconds: 60},
+                                          capped: true, size: 4096}));
+
+assert.commandWorked(db.createCollection("time_partition",
+                                         {timePartition: {field: "ts", seconds: 3600}}));
+t.ensureIndex({a: 1});
+
+// Partitions start on multiples of the interval.
+var hour = 3600 * 1000;
+var base = 1000 * hour;
+for (var i = 0; i < 30; i++) {
+    t.insert({_id: i, a: i % 3, ts: new Date(base + i * 10 * 60 * 1000)});
+    assert.gleSuccess(db);
+}
+
+// Documents without a Date in the partition field can't be placed.
+t.insert({_id: "none", a: 1});
+assert.gleError(db);
+t.insert({_id: "notDate", a: 1, ts: 5});
+assert.gleError(db);
+
+// 30 documents 10 minutes apart span five hours, six documents each.
+var partitions = db.getCollectionNames().filter(function(name) {
+    return name.indexOf("time_partition.partition.") == 0;
+}).sort();
+assert.eq(5, partitions.length, tojson(partitions));
+assert.eq("time_partition.partition." + (base / 1000), partitions[0]);
+partitions.forEach(function(name) {
+    var child = db.getCollection(name);
+    assert.eq(6, child.count(), name);
+    // Indexes on the parent are copied to each partition.
+    assert.eq(2, child.getIndexes().length, name);
+});
+
+// Queries on the parent see every partition, in time order.
+assert.eq(30, t.find().itcount());
+assert.eq(10, t.find({a: 0}).itcount());
+var ids = t.find({}, {_id: 1}).map(function(doc) { return doc._id; });
+for (i = 0; i < 30; i++) {
+    assert.eq(i, ids[i]);
+}
+
+// Small batches continue across partitions.
+assert.eq(30, t.find().batchSize(4).itcount());
+
+// Predicates on the partition field prune partitions.
+var query = {ts: {$gte: new Date(base + hour), $lt: new Date(base + 3 * hour)}};
+assert.eq(12, t.find(query).itcount());
+var explain = t.find(query).explain();
+assert.eq("TimePartitionCursor", explain.cursor);
+assert.eq(12, explain.n);
+assert.eq(12, explain.nscannedObjects);
+
+// Sort and skip aren't supported.
+assert.throws(function() { t.find().sort({ts: 1}).itcount(); });
+assert.throws(function() { t.find().skip(1).itcount(); });
+
+// An index built on the parent later is built on every existing partition too.
+t.ensureIndex({b: 1});
+assert.gleSuccess(db);
+assert.commandWorked(t.runCommand("createIndexes", {indexes: [{key: {c: 1}, name: "c_1"}]}));
+partitions.forEach(function(name) {
+    assert.eq(4, db.getCollection(name).getIndexes().length, name);
+});
+
+// Dropping an index on the parent, by name or by key, drops it from every partition too.
+assert.commandWorked(t.dropIndex("b_1"));
+assert.commandWorked(t.dropIndex({c: 1}));
+partitions.forEach(function(name) {
+    var indexes = db.getCollection(name).getIndexes();
+    assert.eq(2, indexes.length, tojson(indexes));
+    indexes.forEach(function(index) {
+        assert.neq("b_1", index.name, name);
+        assert.neq("c_1", index.name, name);
+    });
+});
+
+// Operations that would only see the parent, which holds no documents, fail rather than
+// silently doing nothing.
+var illegalOperation = 20; // ErrorCodes::IllegalOperation
+var res = t.update({a: 0}, {$set: {b: 1}}, {multi: true});
+assert.writeError(res);
+assert.eq(illegalOperation, res.getWriteError().code, tojson(res));
+res = t.update({_id: "new"}, {$set: {ts: new Date(base)}}, {upsert: true});
+assert.writeError(res);
+assert.eq(illegalOperation, res.getWriteError().code, tojson(res));
+res = t.remove({a: 0});
+assert.writeError(res);
+assert.eq(illegalOperation, res.getWriteError().code, tojson(res));
+[{count: t.getName()},
+ {count: t.getName(), query: {a: 0}},
+ {distinct: t.getName(), key: "a"},
+ {aggregate: t.getName(), pipeline: [{$match: {a: 0}}]},
+ {findAndModify: t.getName(), query: {a: 0}, remove: true}].forEach(function(cmd) {
+    res = db.runCommand(cmd);
+    assert.commandFailed(res, tojson(cmd));
+    assert.eq(illegalOperation, res.code, tojson(res));
+});
+
+// The partitions' names derive from the parent's, so it can't be renamed.
+res = t.renameCollection("time_partition_renamed");
+assert.commandFailed(res);
+assert.eq(illegalOperation, res.code, tojson(res));
+assert.eq(0, db.time_partition_renamed.count());
+
+// Partitions hold the documents, so nothing changed.
+assert.eq(30, t.find().itcount());
+assert.eq(10, t.find({a: 0}).itcount());
+
+// Dropping the parent drops its partitions.
+assert(t.drop());
+db.getCollectionNames().forEach(function(name) {
+    assert.eq(-1, name.indexOf("time_partition.partition."), name);
+});
@@ -0,0 +1,59 @@
+// Tests the latencyStats command and serverStatus section.
+
+var t = db.latency_stats;
+t.drop();
+
+assert.commandWorked(db.adminCommand({setParameter: 1, trackLatencyByNamespace: true}));
+
+var before = db.adminCommand({latencyStats: 1});
+assert.commandWorked(before);
+
+for (var i = 0; i < 100; i++) {
+    t.insert({_id: i, x: i});
+}
+t.ensureIndex({x: 1});
+for (var i = 0; i < 50; i++) {
+    t.findOne({x: i});
+}
+t.update({_id: 0}, {$set: {y: 1}});
+t.remove({_id: 1});
+
+var res = db.adminCommand({latencyStats: 1});
+assert.commandWorked(res);
+
+function count(stats, opType) {
+    return stats.ops[opType].count;
+}
+
+assert.gte(count(res, "insert") - count(before, "insert"), 100, tojson(res.ops.insert));
+assert.gte(count(res, "query") - count(before, "query"), 50, tojson(res.ops.query));
+assert.gte(count(res, "update") - count(before, "update"), 1, tojson(res.ops.update));
+assert.gte(count(res, "remove") - count(before, "remove"), 1, tojson(res.ops.remove));
+
+// The finds went through the index, so documents were fetched and locks were taken.
+assert.gt(res.storageFetch.count, 0, tojson(res.storageFetch));
+assert.gt(res.lockAcquire.count, 0, tojson(res.lockAcquire));
+
+var query = res.ops.query;
+assert.gt(query.percentiles.p50, 0, tojson(query));
+var bucketed = 0;
+query.buckets.forEach(function(bucket) { bucketed += bucket.count; });
+assert.eq(query.count, bucketed, tojson(query));
+
+var nsStats = res.namespaces[t.getFullName()];
+assert(nsStats, tojson(res.namespaces));
+assert.gte(nsStats.insert.count, 100, tojson(nsStats));
+assert.gte(nsStats.query.count, 50, tojson(nsStats));
+
+res = db.adminCommand({latencyStats: 1, namespaces: false});
+assert.commandWorked(res);
+assert.eq(undefined, res.namespaces);
+
+// serverStatus leaves out the namespaces unless asked for them.
+var status = db.serverStatus();
+assert(status.latencyStats, "no latencyStats section");
+assert.eq(undefined, status.latencyStats.namespaces);
+status = db.adminCommand({serverStatus: 1, latencyStats: {namespaces: 1}});
+assert(status.latencyStats.namespaces[t.getFullName()], tojson(status.latencyStats));
+
+assert.commandWorked(db.adminCommand({setParameter: 1, trackLatencyByNamespace: false}));
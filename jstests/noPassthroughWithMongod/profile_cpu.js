@@ -0,0 +1,51 @@
+// Tests the profileCPU command, which samples CPU use and labels samples by operation.
+
+var hostinfo = db.hostInfo();
+if (hostinfo.os.type == "Windows") {
+    assert.commandFailed(db.adminCommand({profileCPU: 1, seconds: 1}));
+}
+else {
+    var t = db.profile_cpu;
+    t.drop();
+    for (var i = 0; i < 1000; i++) {
+        t.insert({_id: i, x: "" + i});
+    }
+
+    // Keep the server busy with collection scans while the profile is taken.
+    var awaitShell = startParallelShell(
+        "var end = new Date().getTime() + 3000;" +
+        "while (new Date().getTime() < end) {" +
+        "    db.profile_cpu.find({x: /nomatch/}).itcount();" +
+        "}");
+
+    var res = db.adminCommand({profileCPU: 1, seconds: 2, frequency: 200});
+    awaitShell();
+    assert.commandWorked(res);
+    assert.eq(200, res.frequency);
+    assert.eq(2, res.seconds);
+    assert.eq(0, res.dropped);
+    assert.eq(false, res.truncated);
+
+    var sampled = 0;
+    res.operations.forEach(function(op) { sampled += op.samples; });
+    assert.eq(res.samples, sampled, tojson(res.operations));
+
+    // Every collapsed line ends with its sample count, and the counts add up.
+    var collapsedCount = 0;
+    res.collapsed.split("\n").forEach(function(line) {
+        if (line.length) {
+            collapsedCount += parseInt(line.substring(line.lastIndexOf(" ") + 1));
+        }
+    });
+    assert.eq(res.samples, collapsedCount);
+
+    // Samples are capped at maxSamples; the rest are counted as dropped.
+    res = db.adminCommand({profileCPU: 1, seconds: 1, frequency: 1000, maxSamples: 1});
+    assert.commandWorked(res);
+    assert.lte(res.samples, 1);
+
+    assert.commandFailed(db.adminCommand({profileCPU: 1, seconds: 1, frequency: 0}));
+    assert.commandFailed(db.adminCommand({profileCPU: 1, seconds: 0}));
+    assert.commandFailed(db.adminCommand({profileCPU: 1, seconds: 1, maxSamples: "a"}));
+    assert.commandFailed(db.runCommand({profileCPU: 1, seconds: 1}));  // admin only
+}
@@ -0,0 +1,74 @@
+// Test that initial sync copies every collection and index when several collections are cloned
+// at once, and that replSetGetStatus reports clone progress.
+
+var basename = "initial_sync_parallel";
+var replTest = new ReplSetTest({ name: basename, nodes: 1,
+                                 nodeOptions: {setParameter: "initialSyncCollectionCloners=3"}});
+replTest.startSet();
+replTest.initiate();
+
+var master = replTest.getMaster();
+var numColls = 10;
+var numDocs = 1000;
+
+print("1. Insert data into " + numColls + " collections in two databases");
+["a", "b"].forEach(function(dbName) {
+    var db = master.getDB(basename + dbName);
+    for (var c = 0; c < numColls; c++) {
+        var coll = db["coll" + c];
+        coll.ensureIndex({ x: 1 });
+        var bulk = coll.initializeUnorderedBulkOp();
+        for (var i = 0; i < numDocs; i++) {
+            bulk.insert({ _id: i, x: i, c: c });
+        }
+        assert.writeOK(bulk.execute());
+    }
+});
+
+print("2. Add a new member, holding its clone part way through the first database");
+// nodeOptions only cover the members the set was created with.
+var secondary = replTest.add({ setParameter: "initialSyncCollectionCloners=3" });
+assert.commandWorked(secondary.getDB("admin").runCommand(
+    { configureFailPoint: "clonerPauseAfterCollection", mode: "alwaysOn",
+      data: { db: basename + "a" } }));
+replTest.reInitiate();
+
+// Each of the 3 clone workers stops after its first collection, so the clone can't finish
+// until the fail point is turned off.
+var progress;
+assert.soon(function() {
+    var status = secondary.getDB("admin").runCommand({ replSetGetStatus: 1 });
+    if (!status.ok || !status.members) {
+        return false;
+    }
+    status.members.forEach(function(member) {
+        if (member.self && member.initialSyncStatus) {
+            progress = member.initialSyncStatus;
+        }
+    });
+    return progress && progress.docsCopied >= 3 * numDocs && progress.inProgress.length == 0;
+}, "never saw initial sync progress", 5 * 60 * 1000, 10);
+printjson(progress);
+assert.lt(progress.collectionsCloned, progress.collectionsTotal, tojson(progress));
+assert.gte(progress.collectionsTotal, numColls, tojson(progress));
+assert.gte(progress.collectionsCloned, 3, tojson(progress));
+assert.lt(progress.docsCopied, progress.docsTotal, tojson(progress));
+
+assert.commandWorked(secondary.getDB("admin").runCommand(
+    { configureFailPoint: "clonerPauseAfterCollection", mode: "off" }));
+replTest.waitForState(secondary, replTest.SECONDARY, 5 * 60 * 1000);
+
+print("3. Check the cloned data and indexes");
+replTest.awaitReplication();
+secondary.setSlaveOk();
+["a", "b"].forEach(function(dbName) {
+    var db = secondary.getDB(basename + dbName);
+    for (var c = 0; c < numColls; c++) {
+        var coll = db["coll" + c];
+        assert.eq(numDocs, coll.count(), coll.getFullName());
+        assert.eq(2, coll.getIndexes().length, coll.getFullName());
+        assert.eq(numDocs, coll.find({ c: c }).itcount(), coll.getFullName());
+    }
+});
+
+replTest.stopSet();
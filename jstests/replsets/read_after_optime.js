@@ -0,0 +1,54 @@
+// Test the afterOpTime read option, which makes a secondary wait until it has applied a
+// client-supplied optime before serving a read.
+
+var exceededTimeLimit = 50; // ErrorCodes::ExceededTimeLimit
+var badValue = 2; // ErrorCodes::BadValue
+
+var name = "read_after_optime";
+var replTest = new ReplSetTest({ name: name, nodes: 3 });
+var nodes = replTest.startSet();
+var config = replTest.getReplSetConfig();
+config.members[0].priority = 2;
+config.members[2].priority = 0;
+config.members[2].slaveDelay = 60;
+replTest.initiate(config);
+replTest.awaitSecondaryNodes();
+
+var primary = replTest.getMaster().getDB(name);
+var secondary = replTest.nodes[1].getDB(name);
+var delayed = replTest.nodes[2].getDB(name);
+secondary.getMongo().setSlaveOk();
+delayed.getMongo().setSlaveOk();
+
+// Write commands report the optime of the write.
+var res = primary.runCommand({ insert: "foo", documents: [{ _id: 1 }] });
+assert.commandWorked(res);
+var lastOp = res.lastOp;
+assert.eq("object", typeof lastOp, tojson(res));
+
+// A query on a caught-up secondary sees its own write.
+var doc = secondary.foo.find({ _id: 1 })._addSpecial("$afterOpTime", lastOp).next();
+assert.eq(1, doc._id);
+
+// So does a command.
+res = secondary.runCommand({ count: "foo", afterOpTime: lastOp });
+assert.commandWorked(res);
+assert.eq(1, res.n);
+
+// The delayed secondary can't apply the write in time, so the read times out rather than
+// returning stale data.
+res = delayed.runCommand({ count: "foo", afterOpTime: lastOp, maxTimeMS: 1000 });
+assert.commandFailed(res);
+assert.eq(exceededTimeLimit, res.code, tojson(res));
+
+assert.throws(function() {
+    delayed.foo.find()._addSpecial("$afterOpTime", lastOp)._addSpecial("$maxTimeMS", 1000)
+                      .itcount();
+});
+
+// afterOpTime must be a Timestamp.
+res = secondary.runCommand({ count: "foo", afterOpTime: 5 });
+assert.commandFailed(res);
+assert.eq(badValue, res.code, tojson(res));
+
+replTest.stopSet();
@@ -0,0 +1,40 @@
+// Tests that waits for replication are timed in the serverStatus write concern histograms, and
+// that waiters are woken as soon as the secondary catches up, and time out when it can't.
+
+var rst = new ReplSetTest({ nodes : 2 });
+rst.startSet();
+rst.initiate();
+var primary = rst.getPrimary();
+var coll = primary.getCollection("test.wtime_histograms");
+
+var histograms = function() {
+    return primary.getDB("admin").serverStatus().metrics.getLastError.wtimeHistograms;
+};
+
+var before = histograms();
+var result;
+
+for (var i = 0; i < 10; i++) {
+    result = coll.runCommand({insert: coll.getName(), documents: [{i: i}],
+                              writeConcern: {w: 2, wtimeout: 60 * 1000}});
+    assert(result.ok, tojson(result));
+    assert.eq(undefined, result.writeConcernError, tojson(result));
+}
+
+result = coll.runCommand({insert: coll.getName(), documents: [{i: 10}],
+                          writeConcern: {w: 'majority', wtimeout: 60 * 1000}});
+assert(result.ok, tojson(result));
+assert.eq(undefined, result.writeConcernError, tojson(result));
+
+var after = histograms();
+assert.eq(before.number.count + 10, after.number.count, tojson(after));
+assert.eq(before.majority.count + 1, after.majority.count, tojson(after));
+
+// A w no member can satisfy times out rather than waiting forever.
+result = coll.runCommand({insert: coll.getName(), documents: [{i: 11}],
+                          writeConcern: {w: 3, wtimeout: 500}});
+assert(result.ok, tojson(result));
+assert.neq(undefined, result.writeConcernError, tojson(result));
+assert.eq(before.number.count + 11, histograms().number.count);
+
+rst.stopSet();
@@ -0,0 +1,58 @@
+// Test that dumping and restoring several collections at once, and dumping a large collection
+// through several cursors, round trips all the documents and indexes.
+
+var t = new ToolTest("dumprestore_parallel");
+t.startDB("foo");
+
+var db = t.db;
+db.dropDatabase();
+
+var collNames = ["a", "b", "c", "d", "e", "f"];
+collNames.forEach(function(name, i) {
+    var bulk = db[name].initializeUnorderedBulkOp();
+    for (var j = 0; j < 1000 * (i + 1); j++) {
+        bulk.insert({_id: j, x: j % 10, name: name});
+    }
+    assert.writeOK(bulk.execute());
+    db[name].ensureIndex({x: 1});
+});
+
+// More documents than mongodump reads through a single cursor with --forceTableScan.
+var bulk = db.big.initializeUnorderedBulkOp();
+for (var j = 0; j < 120000; j++) {
+    bulk.insert({_id: j, y: "y" + j});
+}
+assert.writeOK(bulk.execute());
+db.big.ensureIndex({y: 1}, {unique: true});
+collNames.push("big");
+
+function snapshot() {
+    var contents = {};
+    collNames.forEach(function(name) {
+        contents[name] = {count: db[name].count(),
+                          sum: db[name].aggregate({$group: {_id: null, s: {$sum: "$_id"}}})
+                                       .toArray()[0].s,
+                          indexes: db.system.indexes.find({ns: db[name].getFullName()},
+                                                          {_id: 0, key: 1, unique: 1})
+                                                    .sort({name: 1}).toArray()};
+    });
+    return contents;
+}
+
+var expected = snapshot();
+
+[{dump: ["--numParallelCollections", "1"], restore: ["--numParallelCollections", "1"]},
+ {dump: ["-j", "4", "--forceTableScan"], restore: ["-j", "4"]}].forEach(function(opts) {
+    assert.eq(0, t.runTool.apply(t, ["dump", "--out", t.ext].concat(opts.dump)),
+              "dump " + tojson(opts));
+
+    db.dropDatabase();
+
+    assert.eq(0, t.runTool.apply(t, ["restore", "--dir", t.ext].concat(opts.restore)),
+              "restore " + tojson(opts));
+
+    assert.eq(expected, snapshot(), "after restore " + tojson(opts));
+    resetDbpath(t.ext);
+});
+
+t.stop();
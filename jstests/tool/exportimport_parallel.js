@@ -0,0 +1,64 @@
+// Test that importing through several insertion workers, and with --maintainInsertionOrder,
+// loads every document exported as JSON lines, as a JSON array and as CSV, and that upserts
+// still apply the last line for each key.
+
+var t = new ToolTest("exportimport_parallel");
+var c = t.startDB("foo");
+
+var bulk = c.initializeUnorderedBulkOp();
+for (var i = 0; i < 5000; i++) {
+    bulk.insert({_id: i, x: i % 10, s: "str, \"quoted\" " + i});
+}
+assert.writeOK(bulk.execute());
+
+function contents() {
+    return {count: c.count(),
+            sum: c.aggregate({$group: {_id: null, s: {$sum: "$_id"}}}).toArray()[0].s,
+            last: c.find().sort({_id: -1}).limit(1).toArray()};
+}
+
+var expected = contents();
+
+[{export: [], import: []},
+ {export: ["--jsonArray"], import: ["--jsonArray"]},
+ {export: ["--csv", "-f", "_id,x,s"], import: ["--type", "csv", "--headerline"]}
+].forEach(function(format) {
+    assert.eq(0, t.runTool.apply(t, ["export", "--out", t.extFile, "-d", t.baseName, "-c", "foo"]
+                                     .concat(format.export)),
+              "export " + tojson(format));
+
+    [["-j", "4"], ["-j", "4", "--maintainInsertionOrder"], ["-j", "1"]].forEach(function(opts) {
+        var label = tojson(format.import) + " " + tojson(opts);
+        c.drop();
+        assert.eq(0, t.runTool.apply(t, ["import", "--file", t.extFile, "-d", t.baseName,
+                                         "-c", "foo"].concat(format.import).concat(opts)),
+                  "import " + label);
+        assert.eq(expected, contents(), label);
+
+        // Duplicate keys are logged but don't fail the import
+        assert.eq(0, t.runTool.apply(t, ["import", "--file", t.extFile, "-d", t.baseName,
+                                         "-c", "foo"].concat(format.import).concat(opts)),
+                  "reimport " + label);
+        assert.eq(expected, contents(), "after reimport " + label);
+    });
+});
+
+// Each key appears once every 10 lines, so in many batches.  Upserts ignore -j, so the last
+// line for a key always wins, as with a single worker.
+c.drop();
+bulk = c.initializeUnorderedBulkOp();
+for (i = 0; i < 5000; i++) {
+    bulk.insert({_id: i, k: i % 10, v: i});
+}
+assert.writeOK(bulk.execute());
+assert.eq(0, t.runTool("export", "--out", t.extFile, "-d", t.baseName, "-c", "foo",
+                       "--csv", "-f", "k,v"));
+c.drop();
+assert.eq(0, t.runTool("import", "--file", t.extFile, "-d", t.baseName, "-c", "foo",
+                       "--type", "csv", "--headerline", "--upsertFields", "k", "-j", "4"));
+assert.eq(10, c.count());
+c.find().forEach(function(doc) {
+    assert.eq(4990 + doc.k, doc.v, tojson(doc));
+});
+
+t.stop();
@@ -83,6 +83,10 @@ namespace mongo {
         return (_actions & other._actions) == other._actions;
     }
 
+    bool ActionSet::intersects(const ActionSet& other) const {
+        return (_actions & other._actions).any();
+    }
+
     Status ActionSet::parseActionSetFromString(const std::string& actionsString,
                                                ActionSet* result) {
         std::vector<std::string> actionsList;
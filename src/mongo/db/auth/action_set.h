@@ -66,6 +66,10 @@ namespace mongo {
         // ActionSet.
         bool isSupersetOf(const ActionSet& other) const;
 
+        // Returns true if this ActionSet contains at least one of the actions present in the
+        // 'other' ActionSet.
+        bool intersects(const ActionSet& other) const;
+
         // Returns the std::string representation of this ActionSet
         std::string toString() const;
 
@@ -111,6 +111,22 @@ namespace {
         ASSERT_FALSE(set3.isSupersetOf(set2));
     }
 
+    TEST(ActionSetTest, Intersects) {
+        ActionSet set1, set2, set3;
+        ASSERT_OK(ActionSet::parseActionSetFromString("find,insert", &set1));
+        ASSERT_OK(ActionSet::parseActionSetFromString("insert,remove", &set2));
+        ASSERT_OK(ActionSet::parseActionSetFromString("update", &set3));
+
+        ASSERT_TRUE(set1.intersects(set2));
+        ASSERT_TRUE(set2.intersects(set1));
+        ASSERT_FALSE(set1.intersects(set3));
+        ASSERT_FALSE(set3.intersects(ActionSet()));
+
+        ActionSet all;
+        all.addAllActions();
+        ASSERT_TRUE(all.intersects(set3));
+    }
+
     TEST(ActionSetTest, anyAction) {
         ActionSet set;
 
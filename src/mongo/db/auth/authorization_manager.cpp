@@ -30,6 +30,7 @@
 
 #include "mongo/db/auth/authorization_manager.h"
 
+#include <boost/shared_ptr.hpp>
 #include <boost/thread/mutex.hpp>
 #include <memory>
 #include <string>
@@ -51,7 +52,6 @@
 #include "mongo/db/auth/user_name.h"
 #include "mongo/db/auth/user_name_hash.h"
 #include "mongo/db/jsobj.h"
-#include "mongo/platform/compiler.h"
 #include "mongo/platform/unordered_map.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
@@ -242,20 +242,114 @@ namespace mongo {
         boost::unique_lock<boost::mutex> _lock;
     };
 
+    class AuthorizationManager::UserCacheSnapshot {
+        MONGO_DISALLOW_COPYING(UserCacheSnapshot);
+    public:
+        typedef unordered_map<UserName, User*> UserMap;
+        typedef UserMap::const_iterator const_iterator;
+
+        UserCacheSnapshot() {}
+
+        ~UserCacheSnapshot() {
+            for (UserMap::iterator it = _users.begin(); it != _users.end(); ++it) {
+                if (it->second->releaseCacheReference()) {
+                    delete it->second;
+                }
+            }
+        }
+
+        /**
+         * Returns the cached User named "userName", or NULL if there is none.
+         */
+        User* find(const UserName& userName) const {
+            return mapFindWithDefault(_users, userName, static_cast<User*>(NULL));
+        }
+
+        /**
+         * Adds "user" to this snapshot, which must not already contain a user of the same name.
+         * Only valid before the snapshot is published.
+         */
+        void insert(User* user) {
+            fassert(17520, _users.insert(std::make_pair(user->getName(), user)).second);
+            user->addCacheReference();
+        }
+
+        const_iterator begin() const { return _users.begin(); }
+        const_iterator end() const { return _users.end(); }
+
+    private:
+        UserMap _users;
+    };
+
+    struct AuthorizationManager::ThreadUserCache {
+        ThreadUserCache() : manager(NULL), version(0) {}
+
+        const AuthorizationManager* manager;
+        unsigned long long version;
+        UserCacheSnapshotPtr snapshot;
+    };
+
+    boost::thread_specific_ptr<AuthorizationManager::ThreadUserCache>
+            AuthorizationManager::_threadUserCache;
+
+namespace {
+    // Source of AuthorizationManager::_userCacheVersion.
+    AtomicUInt64 nextUserCacheVersion;
+}  // namespace
+
     AuthorizationManager::AuthorizationManager(AuthzManagerExternalState* externalState) :
             _authEnabled(false),
             _externalState(externalState),
             _version(schemaVersionInvalid),
+            _userCache(new UserCacheSnapshot),
+            _userCacheVersion(nextUserCacheVersion.addAndFetch(1)),
             _isFetchPhaseBusy(false) {
         _updateCacheGeneration_inlock();
     }
 
     AuthorizationManager::~AuthorizationManager() {
-        for (unordered_map<UserName, User*>::iterator it = _userCache.begin();
-                it != _userCache.end(); ++it) {
+        for (UserCacheSnapshot::const_iterator it = _userCache->begin();
+                it != _userCache->end(); ++it) {
             fassert(17265, it->second != internalSecurity.user);
-            delete it->second ;
         }
+
+        ThreadUserCache* threadCache = _threadUserCache.get();
+        if (threadCache && threadCache->manager == this) {
+            _threadUserCache.reset();
+        }
+    }
+
+    void AuthorizationManager::_publishUserCache_inlock(const UserCacheSnapshotPtr& snapshot) {
+        boost::atomic_store(&_userCache, snapshot);
+        // A thread that sees the new version also sees the new snapshot.
+        _userCacheVersion.store(nextUserCacheVersion.addAndFetch(1));
+
+        // Replace this thread's copy of the old snapshot right away, so that users dropped from
+        // the cache are destroyed as soon as their last acquireUser() reference is released.
+        // Other threads let go of theirs on their next lookup.
+        ThreadUserCache* threadCache = _threadUserCache.get();
+        if (threadCache && threadCache->manager == this) {
+            threadCache->snapshot = snapshot;
+            threadCache->version = _userCacheVersion.loadRelaxed();
+        }
+    }
+
+    const AuthorizationManager::UserCacheSnapshot* AuthorizationManager::_getUserCacheSnapshot() {
+        ThreadUserCache* threadCache = _threadUserCache.get();
+        if (!threadCache) {
+            threadCache = new ThreadUserCache;
+            _threadUserCache.reset(threadCache);
+        }
+
+        // Read the version before the snapshot: if it changes in between, the stale version
+        // only makes the next call read the snapshot again.
+        const unsigned long long version = _userCacheVersion.load();
+        if (threadCache->manager != this || threadCache->version != version) {
+            threadCache->snapshot = boost::atomic_load(&_userCache);
+            threadCache->manager = this;
+            threadCache->version = version;
+        }
+        return threadCache->snapshot.get();
     }
 
     Status AuthorizationManager::getAuthorizationVersion(OperationContext* txn, int* version) {
@@ -522,21 +616,31 @@ namespace mongo {
             return Status::OK();
         }
 
-        unordered_map<UserName, User*>::iterator it;
+        // Cache hits only read this thread's copy of the published snapshot, which keeps its
+        // users alive while we take our reference.  A user invalidated since the snapshot was
+        // published falls through to the locked path below, which sees the current snapshot.
+        {
+            User* cachedUser = _getUserCacheSnapshot()->find(userName);
+            if (cachedUser && cachedUser->isValid()) {
+                cachedUser->incrementRefCount();
+                *acquiredUser = cachedUser;
+                return Status::OK();
+            }
+        }
+
+        User* cachedUser;
 
         CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
-        while ((_userCache.end() == (it = _userCache.find(userName))) &&
+        while (!(cachedUser = _userCache->find(userName)) &&
                guard.otherUpdateInFetchPhase()) {
 
             guard.wait();
         }
 
-        if (it != _userCache.end()) {
-            fassert(16914, it->second);
-            fassert(17003, it->second->isValid());
-            fassert(17008, it->second->getRefCount() > 0);
-            it->second->incrementRefCount();
-            *acquiredUser = it->second;
+        if (cachedUser) {
+            fassert(17003, cachedUser->isValid());
+            cachedUser->incrementRefCount();
+            *acquiredUser = cachedUser;
             return Status::OK();
         }
 
@@ -585,10 +689,20 @@ namespace mongo {
 
         guard.endFetchPhase();
 
+        boost::shared_ptr<UserCacheSnapshot> updatedCache;
+        if (guard.isSameCacheGeneration()) {
+            updatedCache.reset(new UserCacheSnapshot);
+            for (UserCacheSnapshot::const_iterator it = _userCache->begin();
+                    it != _userCache->end(); ++it) {
+                updatedCache->insert(it->second);
+            }
+        }
+
         user->incrementRefCount();
         // NOTE: It is not safe to throw an exception from here to the end of the method.
-        if (guard.isSameCacheGeneration()) {
-            _userCache.insert(make_pair(userName, user.get()));
+        if (updatedCache) {
+            updatedCache->insert(user.get());
+            _publishUserCache_inlock(updatedCache);
             if (_version == schemaVersionInvalid)
                 _version = authzVersion;
         }
@@ -629,14 +743,9 @@ namespace mongo {
             return;
         }
 
-        CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
-        user->decrementRefCount();
-        if (user->getRefCount() == 0) {
-            // If it's been invalidated then it's not in the _userCache anymore.
-            if (user->isValid()) {
-                MONGO_COMPILER_VARIABLE_UNUSED bool erased = _userCache.erase(user->getName());
-                dassert(erased);
-            }
+        // Users stay in the cache after their last session releases them, so this only
+        // destroys users that have already been invalidated out of every cache snapshot.
+        if (user->decrementRefCount()) {
             delete user;
         }
     }
@@ -644,29 +753,36 @@ namespace mongo {
     void AuthorizationManager::invalidateUserByName(const UserName& userName) {
         CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
         _updateCacheGeneration_inlock();
-        unordered_map<UserName, User*>::iterator it = _userCache.find(userName);
-        if (it == _userCache.end()) {
+        User* user = _userCache->find(userName);
+        if (!user) {
             return;
         }
 
-        User* user = it->second;
-        _userCache.erase(it);
+        boost::shared_ptr<UserCacheSnapshot> updatedCache(new UserCacheSnapshot);
+        for (UserCacheSnapshot::const_iterator it = _userCache->begin();
+                it != _userCache->end(); ++it) {
+            if (it->second != user) {
+                updatedCache->insert(it->second);
+            }
+        }
         user->invalidate();
+        _publishUserCache_inlock(updatedCache);
     }
 
     void AuthorizationManager::invalidateUsersFromDB(const std::string& dbname) {
         CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
         _updateCacheGeneration_inlock();
-        unordered_map<UserName, User*>::iterator it = _userCache.begin();
-        while (it != _userCache.end()) {
+        boost::shared_ptr<UserCacheSnapshot> updatedCache(new UserCacheSnapshot);
+        for (UserCacheSnapshot::const_iterator it = _userCache->begin();
+                it != _userCache->end(); ++it) {
             User* user = it->second;
             if (user->getName().getDB() == dbname) {
-                _userCache.erase(it++);
                 user->invalidate();
             } else {
-                ++it;
+                updatedCache->insert(user);
             }
         }
+        _publishUserCache_inlock(updatedCache);
     }
 
     void AuthorizationManager::invalidateUserCache() {
@@ -676,12 +792,12 @@ namespace mongo {
 
     void AuthorizationManager::_invalidateUserCache_inlock() {
         _updateCacheGeneration_inlock();
-        for (unordered_map<UserName, User*>::iterator it = _userCache.begin();
-                it != _userCache.end(); ++it) {
+        for (UserCacheSnapshot::const_iterator it = _userCache->begin();
+                it != _userCache->end(); ++it) {
             fassert(17266, it->second != internalSecurity.user);
             it->second->invalidate();
         }
-        _userCache.clear();
+        _publishUserCache_inlock(UserCacheSnapshotPtr(new UserCacheSnapshot));
 
         // Reread the schema version before acquiring the next user.
         _version = schemaVersionInvalid;
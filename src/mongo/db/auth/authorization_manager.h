@@ -29,8 +29,10 @@
 #pragma once
 
 #include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
 #include <boost/thread/condition_variable.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
 #include <memory>
 #include <string>
 
@@ -42,6 +44,7 @@
 #include "mongo/db/auth/resource_pattern.h"
 #include "mongo/db/auth/role_graph.h"
 #include "mongo/db/auth/user.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/db/auth/user_name.h"
 #include "mongo/db/auth/user_name_hash.h"
 #include "mongo/db/jsobj.h"
@@ -425,6 +428,31 @@ namespace mongo {
         class CacheGuard;
         friend class AuthorizationManager::CacheGuard;
 
+        /**
+         * Immutable map from user name to cached User.  Holds the cache reference on each of its
+         * users, and drops it when the snapshot is destroyed.
+         */
+        class UserCacheSnapshot;
+        typedef boost::shared_ptr<const UserCacheSnapshot> UserCacheSnapshotPtr;
+
+        /**
+         * The snapshot of some AuthorizationManager's _userCache that a thread last read, and
+         * the _userCacheVersion it was published with.
+         */
+        struct ThreadUserCache;
+
+        /**
+         * Atomically replaces _userCache with "snapshot", which readers will see from then on.
+         * Should only be called when already holding _cacheMutex.
+         */
+        void _publishUserCache_inlock(const UserCacheSnapshotPtr& snapshot);
+
+        /**
+         * Returns the current _userCache without locking.  The calling thread keeps its own
+         * reference to the snapshot, so the result stays valid until its next call.
+         */
+        const UserCacheSnapshot* _getUserCacheSnapshot();
+
         /**
          * Invalidates all User objects in the cache and removes them from the cache.
          * Should only be called when already holding _cacheMutex.
@@ -476,11 +504,30 @@ namespace mongo {
 
         /**
          * Caches User objects with information about user privileges, to avoid the need to
-         * go to disk to read user privilege documents whenever possible.  Every User object
-         * has a reference count - the AuthorizationManager must not delete a User object in the
-         * cache unless its reference count is zero.
+         * go to disk to read user privilege documents whenever possible.
+         *
+         * The snapshot is never modified once published.  Updates copy the current snapshot,
+         * modify the copy and swap it in with _publishUserCache_inlock(), while holding
+         * _cacheMutex.  A User removed from the cache stays alive until the last snapshot
+         * containing it and the last reference handed out by acquireUser() are both gone.
+         *
+         * Each thread keeps a reference to the snapshot it last read in _threadUserCache, and
+         * only reads _userCache again, through boost::atomic_load(), once _userCacheVersion
+         * changes.  So a cache hit in acquireUser() reads one atomic word and touches no lock
+         * or reference count shared with other threads, other than the User's own.  The price
+         * is that a thread holds on to a replaced snapshot, and the users only it contains,
+         * until its next lookup.
          */
-        unordered_map<UserName, User*> _userCache;
+        UserCacheSnapshotPtr _userCache;
+
+        /**
+         * Identifies the snapshot in _userCache.  Versions are unique across all
+         * AuthorizationManagers, so a thread's snapshot of one can't be mistaken for that of
+         * another.  Stored after _userCache on every update.
+         */
+        AtomicUInt64 _userCacheVersion;
+
+        static boost::thread_specific_ptr<ThreadUserCache> _threadUserCache;
 
         /**
          * Current generation of cached data.  Updated every time part of the cache gets
@@ -497,7 +544,8 @@ namespace mongo {
         bool _isFetchPhaseBusy;
 
         /**
-         * Protects _userCache, _cacheGeneration, _version and _isFetchPhaseBusy.  Manipulated
+         * Serializes updates to _userCache, and protects _cacheGeneration, _version and
+         * _isFetchPhaseBusy.  Manipulated
          * via CacheGuard.
          */
         boost::mutex _cacheMutex;
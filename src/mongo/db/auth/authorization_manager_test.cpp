@@ -29,6 +29,8 @@
  * Unit tests of the AuthorizationManager type.
  */
 
+#include <boost/thread/thread.hpp>
+
 #include "mongo/base/status.h"
 #include "mongo/bson/mutable/document.h"
 #include "mongo/db/auth/action_set.h"
@@ -40,6 +42,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context_noop.h"
+#include "mongo/stdx/functional.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/map_util.h"
 
@@ -212,5 +215,110 @@ namespace {
         authzManager->releaseUser(v2cluster);
     }
 
+    void insertUser(AuthzManagerExternalStateMock* externalState, const UserName& userName) {
+        ASSERT_OK(externalState->insertPrivilegeDocument(
+                "admin",
+                BSON("_id" << userName.getDB().toString() + "." + userName.getUser().toString() <<
+                     "user" << userName.getUser() <<
+                     "db" << userName.getDB() <<
+                     "credentials" << BSON("MONGODB-CR" << "password") <<
+                     "roles" << BSON_ARRAY(BSON("role" << "read" << "db" << "test"))),
+                BSONObj()));
+    }
+
+    TEST_F(AuthorizationManagerTest, ReleasedUsersStayCached) {
+        const UserName userName("cached", "test");
+        insertUser(externalState, userName);
+        OperationContextNoop txn;
+
+        User* user;
+        ASSERT_OK(authzManager->acquireUser(&txn, userName, &user));
+        ASSERT(user->isCached());
+        authzManager->releaseUser(user);
+        ASSERT(user->isCached());
+        ASSERT_EQUALS(0U, user->getRefCount());
+
+        User* again;
+        ASSERT_OK(authzManager->acquireUser(&txn, userName, &again));
+        ASSERT_EQUALS(user, again);
+        ASSERT_EQUALS(1U, again->getRefCount());
+        authzManager->releaseUser(again);
+    }
+
+    TEST_F(AuthorizationManagerTest, AcquireAfterInvalidateReturnsFreshUser) {
+        const UserName userName("fresh", "test");
+        insertUser(externalState, userName);
+        OperationContextNoop txn;
+
+        for (int i = 0; i < 3; ++i) {
+            User* stale;
+            ASSERT_OK(authzManager->acquireUser(&txn, userName, &stale));
+            ASSERT(stale->isValid());
+
+            if (i == 0) {
+                authzManager->invalidateUserByName(userName);
+            }
+            else if (i == 1) {
+                authzManager->invalidateUsersFromDB(userName.getDB().toString());
+            }
+            else {
+                authzManager->invalidateUserCache();
+            }
+            ASSERT_FALSE(stale->isValid());
+
+            User* fresh;
+            ASSERT_OK(authzManager->acquireUser(&txn, userName, &fresh));
+            ASSERT_NOT_EQUALS(stale, fresh);
+            ASSERT(fresh->isValid());
+            ASSERT_EQUALS(1U, fresh->getRefCount());
+
+            authzManager->releaseUser(stale);
+            authzManager->releaseUser(fresh);
+        }
+    }
+
+    TEST_F(AuthorizationManagerTest, ReleasingInvalidatedUserDeletesIt) {
+        const UserName userName("invalidated", "test");
+        insertUser(externalState, userName);
+        OperationContextNoop txn;
+
+        User* user;
+        ASSERT_OK(authzManager->acquireUser(&txn, userName, &user));
+        authzManager->invalidateUserByName(userName);
+
+        // Only our reference is left, so releasing it destroys the User.
+        ASSERT_FALSE(user->isCached());
+        ASSERT_EQUALS(1U, user->getRefCount());
+        authzManager->releaseUser(user);
+    }
+
+    void invalidateUser(AuthorizationManager* authzManager, const UserName& userName) {
+        authzManager->invalidateUserByName(userName);
+    }
+
+    TEST_F(AuthorizationManagerTest, AcquireSeesInvalidationByOtherThread) {
+        const UserName userName("otherThread", "test");
+        insertUser(externalState, userName);
+        OperationContextNoop txn;
+
+        User* stale;
+        ASSERT_OK(authzManager->acquireUser(&txn, userName, &stale));
+        boost::thread invalidator(stdx::bind(invalidateUser, authzManager.get(), userName));
+        invalidator.join();
+        ASSERT_FALSE(stale->isValid());
+
+        User* fresh;
+        ASSERT_OK(authzManager->acquireUser(&txn, userName, &fresh));
+        ASSERT_NOT_EQUALS(stale, fresh);
+        ASSERT(fresh->isValid());
+
+        // This thread let go of the snapshot holding the stale user when it looked up the
+        // fresh one.
+        ASSERT_FALSE(stale->isCached());
+
+        authzManager->releaseUser(stale);
+        authzManager->releaseUser(fresh);
+    }
+
 }  // namespace
 }  // namespace mongo
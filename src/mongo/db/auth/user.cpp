@@ -46,8 +46,10 @@ namespace mongo {
         _refCount(0),
         _isValid(1) {}
 
+    const uint64_t User::kCacheReference;
+
     User::~User() {
-        dassert(_refCount == 0);
+        dassert(_refCount.loadRelaxed() == 0);
     }
 
     const UserName& User::getName() const {
@@ -71,7 +73,11 @@ namespace mongo {
     }
 
     uint32_t User::getRefCount() const {
-        return _refCount;
+        return static_cast<uint32_t>(_refCount.load() & (kCacheReference - 1));
+    }
+
+    bool User::isCached() const {
+        return _refCount.load() >= kCacheReference;
     }
 
     const ActionSet User::getActionsForResource(const ResourcePattern& resource) const {
@@ -85,6 +91,7 @@ namespace mongo {
     User* User::clone() const {
         std::auto_ptr<User> result(new User(_name));
         result->_privileges = _privileges;
+        result->_allActions = _allActions;
         result->_roles = _roles;
         result->_credentials = _credentials;
         return result.release();
@@ -103,9 +110,11 @@ namespace mongo {
 
     void User::setPrivileges(const PrivilegeVector& privileges) {
         _privileges.clear();
+        _allActions.removeAllActions();
         for (size_t i = 0; i < privileges.size(); ++i) {
             const Privilege& privilege = privileges[i];
             _privileges[privilege.getResourcePattern()] = privilege;
+            _allActions.addAllActionsFromSet(privilege.getActions());
         }
     }
 
@@ -128,6 +137,7 @@ namespace mongo {
             dassert(it->first == privilegeToAdd.getResourcePattern());
             it->second.addActions(privilegeToAdd.getActions());
         }
+        _allActions.addAllActionsFromSet(privilegeToAdd.getActions());
     }
 
     void User::addPrivileges(const PrivilegeVector& privileges) {
@@ -142,11 +152,20 @@ namespace mongo {
     }
 
     void User::incrementRefCount() {
-        ++_refCount;
+        _refCount.fetchAndAdd(1);
+    }
+
+    bool User::decrementRefCount() {
+        dassert(getRefCount() > 0);
+        return _refCount.subtractAndFetch(1) == 0;
+    }
+
+    void User::addCacheReference() {
+        _refCount.fetchAndAdd(kCacheReference);
     }
 
-    void User::decrementRefCount() {
-        dassert(_refCount > 0);
-        --_refCount;
+    bool User::releaseCacheReference() {
+        dassert(_refCount.load() >= kCacheReference);
+        return _refCount.subtractAndFetch(kCacheReference) == 0;
     }
 } // namespace mongo
@@ -105,6 +105,13 @@ namespace mongo {
          */
         const ActionSet getActionsForResource(const ResourcePattern& resource) const;
 
+        /**
+         * Gets the union of the actions this user is allowed to perform on any resource.  Used to
+         * skip users who cannot contribute to a privilege check without searching their
+         * privileges.
+         */
+        const ActionSet& getAllActions() const { return _allActions; }
+
         /**
          * Returns true if this copy of information about this user is still valid. If this returns
          * false, this object should no longer be used and should be returned to the
@@ -113,11 +120,18 @@ namespace mongo {
         bool isValid() const;
 
         /**
-         * This returns the reference count for this User.  The AuthorizationManager should be the
-         * only caller of this.
+         * This returns the number of outstanding references handed out by acquireUser(), not
+         * counting the references held by the AuthorizationManager's user cache.  The
+         * AuthorizationManager should be the only caller of this.
          */
         uint32_t getRefCount() const;
 
+        /**
+         * Returns true if a snapshot of the AuthorizationManager's user cache still holds this
+         * User, in which case releasing the last reference from acquireUser() won't destroy it.
+         */
+        bool isCached() const;
+
         /**
          * Clones this user into a new, valid User object with refcount of 0.
          */
@@ -178,12 +192,28 @@ namespace mongo {
 
         /**
          * Decrements the reference count for this User object, which records how many threads have
-         * a reference to it.  Once the reference count goes to zero, the AuthorizationManager is
-         * allowed to destroy this instance.
+         * a reference to it.  Returns true if this released the last reference, including the
+         * user cache's, in which case the caller must destroy this instance.
          *
          * This method should *only* be called by the AuthorizationManager.
          */
-        void decrementRefCount();
+        bool decrementRefCount();
+
+        /**
+         * Records that a snapshot of the AuthorizationManager's user cache holds a reference to
+         * this User.
+         *
+         * This method should *only* be called by the AuthorizationManager.
+         */
+        void addCacheReference();
+
+        /**
+         * Drops a user cache snapshot's reference to this User.  Returns true if no references
+         * remain, in which case the caller must destroy this instance.
+         *
+         * This method should *only* be called by the AuthorizationManager.
+         */
+        bool releaseCacheReference();
 
     private:
 
@@ -195,13 +225,20 @@ namespace mongo {
         // Roles the user has privileges from
         unordered_set<RoleName> _roles;
 
+        // Union of the actions in _privileges.
+        ActionSet _allActions;
+
         // Credential information.
         CredentialData _credentials;
 
         // _refCount and _isInvalidated are modified exclusively by the AuthorizationManager
         // _isInvalidated can be read by any consumer of User, but _refCount can only be
-        // meaningfully read by the AuthorizationManager, as _refCount is guarded by the AM's _lock
-        uint32_t _refCount;
+        // meaningfully read by the AuthorizationManager.  The low bits of _refCount count the
+        // references handed out by acquireUser(), and kCacheReference is added for every
+        // user cache snapshot that contains it, so that whoever drops the last reference of any
+        // kind destroys the User without taking any lock.
+        static const uint64_t kCacheReference = 1ULL << 32;
+        AtomicUInt64 _refCount;
         AtomicUInt32 _isValid; // Using as a boolean
     };
 
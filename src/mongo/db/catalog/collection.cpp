@@ -35,9 +35,11 @@
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/curop.h"
+#include "mongo/db/dbhelpers.h"
 #include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/index_create.h"
+#include "mongo/db/catalog/oplog_ts_index.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/structure/record_store_v1_capped.h"
@@ -79,11 +81,16 @@ namespace mongo {
           _database( database ),
           _infoCache( this ),
           _indexCatalog( this ),
-          _cursorCache( fullNS ) {
+          _cursorCache( fullNS ),
+          _timePartitionMutex( "Collection::timePartition" ),
+          _timePartitionLoaded( false ) {
         _magic = 1357924;
         _indexCatalog.init(txn);
-        if ( isCapped() )
+        if ( isCapped() ) {
             _recordStore->setCappedDeleteCallback( this );
+            if ( _ns.isOplog() )
+                _oplogTsIndex.reset( new OplogTsIndex( this ) );
+        }
     }
 
     Collection::~Collection() {
@@ -161,6 +168,9 @@ namespace mongo {
         if ( !loc.isOK() )
             return loc;
 
+        if ( _oplogTsIndex )
+            _oplogTsIndex->noteInsert( docFor( loc.getValue() ), loc.getValue() );
+
         return StatusWith<DiskLoc>( loc );
     }
 
@@ -242,6 +252,9 @@ namespace mongo {
             return StatusWith<DiskLoc>( e.toStatus( "insertDocument" ) );
         }
 
+        if ( _oplogTsIndex )
+            _oplogTsIndex->noteInsert( docToInsert, loc.getValue() );
+
         return loc;
     }
 
@@ -254,6 +267,9 @@ namespace mongo {
 
         _indexCatalog.unindexRecord(txn, doc, loc, false);
 
+        if ( _oplogTsIndex )
+            _oplogTsIndex->noteDelete( loc );
+
         return Status::OK();
     }
 
@@ -282,6 +298,9 @@ namespace mongo {
 
         _indexCatalog.unindexRecord(txn, doc, loc, noWarn);
 
+        if ( _oplogTsIndex )
+            _oplogTsIndex->noteDelete( loc );
+
         _recordStore->deleteRecord( txn, loc );
 
         _infoCache.notifyOfWriteOp();
@@ -426,6 +445,28 @@ namespace mongo {
         return _recordStore->isCapped();
     }
 
+    TimePartitionOptions Collection::getTimePartitionOptions( OperationContext* txn ) {
+        SimpleMutex::scoped_lock lk( _timePartitionMutex );
+        if ( _timePartitionLoaded )
+            return _timePartition;
+
+        // The catalog itself and other system collections are never partitioned, and looking
+        // them up in system.namespaces could recurse.
+        if ( !_ns.isSystem() && _ns.ns().find( '$' ) == string::npos ) {
+            Collection* namespaces = _database->getCollection( txn, _database->_namespacesName );
+            BSONObj entry;
+            if ( namespaces &&
+                 Helpers::findOne( txn, namespaces, BSON( "name" << _ns.ns() ), entry ) ) {
+                CollectionOptions options;
+                if ( options.parse( entry.getObjectField( "options" ) ).isOK() )
+                    _timePartition = options.timePartition;
+            }
+        }
+
+        _timePartitionLoaded = true;
+        return _timePartition;
+    }
+
     uint64_t Collection::numRecords() const {
         return _recordStore->numRecords();
     }
@@ -465,6 +506,8 @@ namespace mongo {
         status = _recordStore->truncate(txn);
         if ( !status.isOK() )
             return status;
+        if ( _oplogTsIndex )
+            _oplogTsIndex->reset();
 
         // 4) re-create indexes
         for ( size_t i = 0; i < indexSpecs.size(); i++ ) {
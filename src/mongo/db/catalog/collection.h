@@ -35,6 +35,7 @@
 #include "mongo/base/string_data.h"
 #include "mongo/bson/mutable/damage_vector.h"
 #include "mongo/db/catalog/collection_cursor_cache.h"
+#include "mongo/db/catalog/collection_options.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/diskloc.h"
 #include "mongo/db/exec/collection_scan_common.h"
@@ -52,6 +53,7 @@ namespace mongo {
     class IndexCatalog;
     class MultiIndexBlock;
     class OperationContext;
+    class OplogTsIndex;
 
     class RecordIterator;
     class FlatIterator;
@@ -128,6 +130,12 @@ namespace mongo {
 
         CollectionCursorCache* cursorCache() const { return &_cursorCache; }
 
+        /**
+         * Returns the sparse 'ts' index used to find where oplog replay starts, or NULL if this
+         * isn't an oplog.
+         */
+        OplogTsIndex* getOplogTsIndex() const { return _oplogTsIndex.get(); }
+
         bool requiresIdIndex() const;
 
         BSONObj docFor(const DiskLoc& loc) const;
@@ -244,6 +252,13 @@ namespace mongo {
 
         bool isCapped() const;
 
+        /**
+         * Returns how this collection is time partitioned; the result is not set if it isn't.
+         * The options are read from the catalog on first use and cached, as they never change
+         * once the collection exists.  See time_partition.h.
+         */
+        TimePartitionOptions getTimePartitionOptions( OperationContext* txn );
+
         uint64_t numRecords() const;
 
         uint64_t dataSize() const;
@@ -292,6 +307,15 @@ namespace mongo {
         // should be about the data.
         mutable CollectionCursorCache _cursorCache;
 
+        // Only set for oplogs.
+        scoped_ptr<OplogTsIndex> _oplogTsIndex;
+
+        // Filled in on the first call to getTimePartitionOptions.  Readers share the database
+        // lock, so loading is serialized here.
+        SimpleMutex _timePartitionMutex;
+        bool _timePartitionLoaded;
+        TimePartitionOptions _timePartition;
+
         friend class Database;
         friend class FlatIterator;
         friend class CappedIterator;
@@ -32,6 +32,36 @@
 
 namespace mongo {
 
+    namespace {
+
+        Status parseTimePartition( const BSONElement& e, TimePartitionOptions* out ) {
+            if ( e.type() != Object )
+                return Status( ErrorCodes::BadValue, "timePartition has to be an object" );
+
+            BSONObj spec = e.Obj();
+            BSONElement field = spec["field"];
+            BSONElement seconds = spec["seconds"];
+            BSONElement expireAfterSeconds = spec["expireAfterSeconds"];
+
+            if ( field.type() != String || field.valuestrsize() <= 1 )
+                return Status( ErrorCodes::BadValue,
+                               "timePartition.field has to be a non-empty string" );
+            if ( !seconds.isNumber() || seconds.numberLong() <= 0 )
+                return Status( ErrorCodes::BadValue,
+                               "timePartition.seconds has to be a positive number" );
+            if ( !expireAfterSeconds.eoo() &&
+                 ( !expireAfterSeconds.isNumber() || expireAfterSeconds.numberLong() < 0 ) )
+                return Status( ErrorCodes::BadValue,
+                               "timePartition.expireAfterSeconds has to be a non-negative number" );
+
+            out->field = field.String();
+            out->seconds = seconds.numberLong();
+            out->expireAfterSeconds = expireAfterSeconds.numberLong();
+            return Status::OK();
+        }
+
+    }  // namespace
+
     // static
     bool CollectionOptions::validMaxCappedDocs( long long* max ) {
         if ( *max <= 0 ||
@@ -57,6 +87,7 @@ namespace mongo {
         flags = 0;
         flagsSet = false;
         temp = false;
+        timePartition = TimePartitionOptions();
     }
 
     Status CollectionOptions::parse( const BSONObj& options ) {
@@ -118,8 +149,17 @@ namespace mongo {
             else if ( fieldName == "temp" ) {
                 temp = e.trueValue();
             }
+            else if ( fieldName == "timePartition" ) {
+                Status status = parseTimePartition( e, &timePartition );
+                if ( !status.isOK() )
+                    return status;
+            }
         }
 
+        if ( capped && timePartition.isSet() )
+            return Status( ErrorCodes::BadValue,
+                           "a capped collection can't be time partitioned" );
+
         return Status::OK();
     }
 
@@ -147,6 +187,15 @@ namespace mongo {
         if ( temp )
             b.appendBool( "temp", true );
 
+        if ( timePartition.isSet() ) {
+            BSONObjBuilder sub( b.subobjStart( "timePartition" ) );
+            sub.append( "field", timePartition.field );
+            sub.appendNumber( "seconds", timePartition.seconds );
+            if ( timePartition.expireAfterSeconds )
+                sub.appendNumber( "expireAfterSeconds", timePartition.expireAfterSeconds );
+            sub.done();
+        }
+
         return b.obj();
     }
 
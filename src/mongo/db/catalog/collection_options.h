@@ -33,6 +33,22 @@
 
 namespace mongo {
 
+    /**
+     * Describes a time-partitioned collection: documents are stored in child collections that
+     * each cover 'seconds' worth of values of the Date field 'field', and a child is dropped as
+     * a whole once all of its documents are older than 'expireAfterSeconds' (0 means never).
+     * See time_partition.h.
+     */
+    struct TimePartitionOptions {
+        TimePartitionOptions() : seconds(0), expireAfterSeconds(0) { }
+
+        bool isSet() const { return seconds > 0; }
+
+        std::string field;
+        long long seconds;
+        long long expireAfterSeconds;
+    };
+
     struct CollectionOptions {
         CollectionOptions() {
             reset();
@@ -72,6 +88,8 @@ namespace mongo {
         bool flagsSet;
 
         bool temp;
+
+        TimePartitionOptions timePartition;
     };
 
 }
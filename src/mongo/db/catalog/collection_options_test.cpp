@@ -80,6 +80,32 @@ namespace mongo {
         ASSERT_EQUALS( options.cappedMaxDocs, 0 );
     }
 
+    TEST( CollectionOptions, TimePartitionRoundTrip ) {
+        CollectionOptions options;
+        ASSERT_OK( options.parse( fromjson( "{timePartition: {field: 'ts', seconds: 3600}}" ) ) );
+        ASSERT( options.timePartition.isSet() );
+        ASSERT_EQUALS( options.timePartition.field, "ts" );
+        ASSERT_EQUALS( options.timePartition.seconds, 3600 );
+        ASSERT_EQUALS( options.timePartition.expireAfterSeconds, 0 );
+        checkRoundTrip( options );
+
+        options.timePartition.expireAfterSeconds = 86400;
+        checkRoundTrip( options );
+    }
+
+    TEST( CollectionOptions, ErrorBadTimePartition ) {
+        ASSERT_NOT_OK( CollectionOptions().parse( fromjson( "{timePartition: 1}" ) ) );
+        ASSERT_NOT_OK( CollectionOptions().parse( fromjson( "{timePartition: {seconds: 1}}" ) ) );
+        ASSERT_NOT_OK( CollectionOptions().parse(
+                           fromjson( "{timePartition: {field: 'ts', seconds: 0}}" ) ) );
+        ASSERT_NOT_OK( CollectionOptions().parse(
+                           fromjson( "{timePartition: {field: 'ts', seconds: 60, "
+                                     "expireAfterSeconds: -1}}" ) ) );
+        ASSERT_NOT_OK( CollectionOptions().parse(
+                           fromjson( "{capped: true, size: 1024, "
+                                     "timePartition: {field: 'ts', seconds: 60}}" ) ) );
+    }
+
     TEST( CollectionOptions, IgnoreUnregisteredFields ) {
         ASSERT_OK( CollectionOptions().parse( BSON( "create" << "c" ) ) );
         ASSERT_OK( CollectionOptions().parse( BSON( "foo" << "bar" ) ) );
@@ -0,0 +1,186 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/catalog/oplog_ts_index.h"
+
+#include <algorithm>
+
+#include "mongo/base/owned_pointer_vector.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/expression_leaf.h"
+
+namespace mongo {
+
+    namespace {
+
+        struct SampleTsLess {
+            template <typename Sample>
+            bool operator()(const Sample& sample, const OpTime& ts) const {
+                return sample.ts < ts;
+            }
+
+            template <typename Sample>
+            bool operator()(const OpTime& ts, const Sample& sample) const {
+                return ts < sample.ts;
+            }
+        };
+
+    }  // namespace
+
+    OplogTsIndex::OplogTsIndex(const Collection* collection, size_t sampleInterval)
+        : _collection(collection),
+          _sampleInterval(sampleInterval),
+          _mutex("OplogTsIndex"),
+          _built(false),
+          _sinceLastSample(0) {
+        invariant(sampleInterval > 0);
+    }
+
+    void OplogTsIndex::noteInsert(const BSONObj& doc, const DiskLoc& loc) {
+        SimpleMutex::scoped_lock lk(_mutex);
+        if (!_built) {
+            // Building reads the first record of every extent, which is cheap enough to do on
+            // the first insert.  It picks up 'loc' if it starts an extent.
+            _build();
+            return;
+        }
+
+        if (++_sinceLastSample < _sampleInterval) {
+            return;
+        }
+        _add(doc, loc);
+    }
+
+    void OplogTsIndex::noteDelete(const DiskLoc& loc) {
+        SimpleMutex::scoped_lock lk(_mutex);
+        if (!_built || _sampledLocs.count(loc) == 0) {
+            return;
+        }
+
+        // Capped collections delete their oldest records when they wrap, and their newest ones
+        // when truncated after a point.  Anything else leaves a hole we don't bother patching.
+        if (_samples.front().loc == loc) {
+            _samples.pop_front();
+            _sampledLocs.erase(loc);
+        }
+        else if (_samples.back().loc == loc) {
+            _samples.pop_back();
+            _sampledLocs.erase(loc);
+        }
+        else {
+            _built = false;
+            _samples.clear();
+            _sampledLocs.clear();
+        }
+    }
+
+    void OplogTsIndex::reset() {
+        SimpleMutex::scoped_lock lk(_mutex);
+        _built = false;
+        _samples.clear();
+        _sampledLocs.clear();
+    }
+
+    bool OplogTsIndex::findStart(const MatchExpression* tsExpr, DiskLoc* start) {
+        invariant(MatchExpression::GT == tsExpr->matchType() ||
+                  MatchExpression::GTE == tsExpr->matchType());
+
+        const BSONElement bound =
+            static_cast<const ComparisonMatchExpression*>(tsExpr)->getData();
+        if (Timestamp != bound.type()) {
+            return false;
+        }
+        const OpTime ts = bound._opTime();
+
+        SimpleMutex::scoped_lock lk(_mutex);
+        if (!_built) {
+            _build();
+        }
+
+        // Find the first sample that may match, and start from the one before it, which can't.
+        std::deque<Sample>::const_iterator it;
+        if (MatchExpression::GTE == tsExpr->matchType()) {
+            it = std::lower_bound(_samples.begin(), _samples.end(), ts, SampleTsLess());
+        }
+        else {
+            it = std::upper_bound(_samples.begin(), _samples.end(), ts, SampleTsLess());
+        }
+
+        if (it == _samples.begin()) {
+            *start = DiskLoc();
+        }
+        else {
+            --it;
+            *start = it->loc;
+        }
+        return true;
+    }
+
+    size_t OplogTsIndex::numSamples() {
+        SimpleMutex::scoped_lock lk(_mutex);
+        return _samples.size();
+    }
+
+    void OplogTsIndex::_build() {
+        _samples.clear();
+        _sampledLocs.clear();
+
+        // One iterator per extent, in insertion order.
+        OwnedPointerVector<RecordIterator> iterators;
+        iterators.mutableVector() = _collection->getManyIterators();
+        for (size_t i = 0; i < iterators.size(); i++) {
+            const DiskLoc loc = iterators[i]->curr();
+            if (!loc.isNull()) {
+                _add(_collection->docFor(loc), loc);
+            }
+        }
+
+        _built = true;
+        _sinceLastSample = 0;
+    }
+
+    void OplogTsIndex::_add(const BSONObj& doc, const DiskLoc& loc) {
+        const BSONElement tsElt = doc["ts"];
+        if (Timestamp != tsElt.type()) {
+            return;
+        }
+
+        const OpTime ts = tsElt._opTime();
+        if (!_samples.empty() && !(_samples.back().ts < ts)) {
+            return;
+        }
+
+        _samples.push_back(Sample(ts, loc));
+        _sampledLocs.insert(loc);
+        _sinceLastSample = 0;
+    }
+
+}  // namespace mongo
@@ -0,0 +1,124 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <set>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/optime.h"
+#include "mongo/db/diskloc.h"
+#include "mongo/util/concurrency/mutex.h"
+
+namespace mongo {
+
+    class BSONObj;
+    class Collection;
+    class MatchExpression;
+
+    /**
+     * A sparse, in memory index from the 'ts' field of an oplog to record locations in it, used
+     * to find where an oplogReplay query should start scanning without walking the oplog
+     * backwards (see exec/oplogstart.h).
+     *
+     * The index holds a sample of the records, in insertion order, which is also 'ts' order.
+     * It is built on first use from the first record of every extent, and afterwards one of
+     * every 'sampleInterval' inserted records is added.  A sample is dropped when its record is
+     * deleted, which for a capped collection happens oldest first.  Nothing is persisted, so
+     * the index is rebuilt after a restart.
+     *
+     * All methods are thread safe.
+     */
+    class OplogTsIndex {
+        MONGO_DISALLOW_COPYING(OplogTsIndex);
+    public:
+        static const size_t kDefaultSampleInterval = 1024;
+
+        // Does not take ownership.
+        explicit OplogTsIndex(const Collection* collection,
+                              size_t sampleInterval = kDefaultSampleInterval);
+
+        /**
+         * Called after 'doc' was inserted at 'loc'.
+         */
+        void noteInsert(const BSONObj& doc, const DiskLoc& loc);
+
+        /**
+         * Called before the record at 'loc' is deleted.
+         */
+        void noteDelete(const DiskLoc& loc);
+
+        /**
+         * Forgets all samples.  The index is rebuilt on next use.
+         */
+        void reset();
+
+        /**
+         * Returns true and sets '*start' to a record that a forward scan can start from
+         * without missing any record matching 'tsExpr', a $gt or $gte predicate over 'ts'.
+         * '*start' is null if the scan has to start at the beginning of the collection.
+         *
+         * Returns false if 'tsExpr' doesn't compare 'ts' to a Timestamp.
+         */
+        bool findStart(const MatchExpression* tsExpr, DiskLoc* start);
+
+        size_t numSamples();
+
+    private:
+        struct Sample {
+            Sample(const OpTime& ts, const DiskLoc& loc) : ts(ts), loc(loc) { }
+
+            OpTime ts;
+            DiskLoc loc;
+        };
+
+        // Both require _mutex.
+        void _build();
+        void _add(const BSONObj& doc, const DiskLoc& loc);
+
+        const Collection* _collection;
+        const size_t _sampleInterval;
+
+        SimpleMutex _mutex;
+
+        // Everything below is protected by _mutex.
+
+        bool _built;
+
+        // Inserts since the last sample.
+        size_t _sinceLastSample;
+
+        // Ordered by 'ts', oldest first.
+        std::deque<Sample> _samples;
+
+        // The locations in _samples, so deletes of unsampled records are cheap to ignore.
+        std::set<DiskLoc> _sampledLocs;
+    };
+
+}  // namespace mongo
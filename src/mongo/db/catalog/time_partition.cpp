@@ -0,0 +1,447 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/catalog/time_partition.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <list>
+
+#include "mongo/base/parse_number.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/database_catalog_entry.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/d_concurrency.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/pdfile.h"
+#include "mongo/db/repl/oplog.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+    namespace {
+
+        const char kPartitionInfix[] = ".partition.";
+
+        /**
+         * Returns the spec of the index of a partition at 'ns' that mirrors 'parentSpec'.
+         * Partitions expire as a whole, so they never get TTL indexes.
+         */
+        BSONObj partitionIndexSpec( const BSONObj& parentSpec, const StringData& ns ) {
+            BSONObjBuilder b;
+            BSONObjIterator i( parentSpec );
+            while ( i.more() ) {
+                BSONElement e = i.next();
+                StringData name = e.fieldName();
+                if ( name == "ns" ) {
+                    b.append( "ns", ns );
+                }
+                else if ( name != "expireAfterSeconds" ) {
+                    b.append( e );
+                }
+            }
+            return b.obj();
+        }
+
+        /**
+         * Drops each of 'partitions', logging the drops for replication.  Stops at the first
+         * failure unless 'continueOnError', in which case failures are only logged.  Returns
+         * the number of partitions dropped and the first failure.
+         */
+        Status dropPartitions( OperationContext* txn,
+                               Database* db,
+                               const std::vector<std::string>& partitions,
+                               bool continueOnError,
+                               int* numDropped ) {
+            const std::string cmdNs = db->name() + ".$cmd";
+            Status firstError = Status::OK();
+            for ( size_t i = 0; i < partitions.size(); ++i ) {
+                Status status = db->dropCollection( txn, partitions[i] );
+                if ( !status.isOK() ) {
+                    warning() << "failed to drop time partition " << partitions[i] << ": "
+                              << status.toString();
+                    if ( firstError.isOK() ) {
+                        firstError = status;
+                    }
+                    if ( !continueOnError ) {
+                        break;
+                    }
+                    continue;
+                }
+                repl::logOp( txn,
+                             "c",
+                             cmdNs.c_str(),
+                             BSON( "drop" << nsToCollectionSubstring( partitions[i] ) ) );
+                ++*numDropped;
+            }
+            return firstError;
+        }
+
+    }  // namespace
+
+    Status checkNotTimePartitioned( OperationContext* txn,
+                                    Collection* collection,
+                                    const StringData& operation ) {
+        if ( !collection || !collection->getTimePartitionOptions( txn ).isSet() ) {
+            return Status::OK();
+        }
+        return Status( ErrorCodes::IllegalOperation,
+                       str::stream() << operation << " is not supported on time partitioned "
+                                     << "collection " << collection->ns().ns()
+                                     << "; run it on its partitions, "
+                                     << collection->ns().ns() << kPartitionInfix
+                                     << "<start>, instead" );
+    }
+
+    std::string timePartitionNs( const StringData& parentNs, long long startSeconds ) {
+        return str::stream() << parentNs << kPartitionInfix << startSeconds;
+    }
+
+    bool parseTimePartitionNs( const StringData& parentNs,
+                               const StringData& ns,
+                               long long* startSeconds ) {
+        const size_t prefixSize = parentNs.size() + strlen( kPartitionInfix );
+        if ( ns.size() <= prefixSize ||
+             !ns.startsWith( parentNs ) ||
+             ns.substr( parentNs.size(), strlen( kPartitionInfix ) ) != kPartitionInfix ) {
+            return false;
+        }
+
+        long long start;
+        if ( !parseNumberFromStringWithBase( ns.substr( prefixSize ), 10, &start ).isOK() ) {
+            return false;
+        }
+
+        // Reject other spellings of the same number, such as a leading '+' or zeros.
+        if ( timePartitionNs( parentNs, start ) != ns ) {
+            return false;
+        }
+
+        *startSeconds = start;
+        return true;
+    }
+
+    long long timePartitionStart( const TimePartitionOptions& options, long long millis ) {
+        const long long width = options.seconds * 1000;
+        long long index = millis / width;
+        if ( millis % width < 0 ) {
+            // Division truncates towards zero; partitions start at the floor.
+            --index;
+        }
+        return index * options.seconds;
+    }
+
+    void getTimePartitionBounds( const MatchExpression* root,
+                                 const StringData& field,
+                                 long long* minMillis,
+                                 long long* maxMillis ) {
+        if ( MatchExpression::AND == root->matchType() ) {
+            for ( size_t i = 0; i < root->numChildren(); ++i ) {
+                getTimePartitionBounds( root->getChild( i ), field, minMillis, maxMillis );
+            }
+            return;
+        }
+
+        switch ( root->matchType() ) {
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::EQ:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            break;
+        default:
+            return;
+        }
+
+        const ComparisonMatchExpression* cmp =
+            static_cast<const ComparisonMatchExpression*>( root );
+        if ( cmp->path() != field || cmp->getData().type() != Date ) {
+            return;
+        }
+
+        // A Date only compares with other Dates, so a document in a partition (whose field is
+        // a Date in the partition's interval) can only match if the interval does.
+        const long long millis = cmp->getData().date().asInt64();
+        if ( MatchExpression::GT != root->matchType() &&
+             MatchExpression::GTE != root->matchType() ) {
+            *maxMillis = std::min( *maxMillis, millis );
+        }
+        if ( MatchExpression::LT != root->matchType() &&
+             MatchExpression::LTE != root->matchType() ) {
+            *minMillis = std::max( *minMillis, millis );
+        }
+    }
+
+    void getTimePartitions( Database* db,
+                            const StringData& parentNs,
+                            const TimePartitionOptions& options,
+                            long long minMillis,
+                            long long maxMillis,
+                            std::vector<std::string>* out ) {
+        std::list<std::string> namespaces;
+        db->getDatabaseCatalogEntry()->getCollectionNamespaces( &namespaces );
+
+        std::vector<std::pair<long long, std::string> > partitions;
+        for ( std::list<std::string>::const_iterator it = namespaces.begin();
+              it != namespaces.end();
+              ++it ) {
+            long long start;
+            if ( !parseTimePartitionNs( parentNs, *it, &start ) ) {
+                continue;
+            }
+
+            // The partition holds values in [start, start + seconds).
+            if ( start * 1000 > maxMillis || ( start + options.seconds ) * 1000 <= minMillis ) {
+                continue;
+            }
+            partitions.push_back( std::make_pair( start, *it ) );
+        }
+
+        std::sort( partitions.begin(), partitions.end() );
+        for ( size_t i = 0; i < partitions.size(); ++i ) {
+            out->push_back( partitions[i].second );
+        }
+    }
+
+    StatusWith<Collection*> getTimePartitionForInsert( OperationContext* txn,
+                                                       Database* db,
+                                                       Collection* parent,
+                                                       const TimePartitionOptions& options,
+                                                       const BSONObj& doc ) {
+        const std::string& parentNs = parent->ns().ns();
+        Lock::assertWriteLocked( parentNs );
+
+        BSONElement timeElt = doc.getFieldDotted( options.field );
+        if ( timeElt.type() != Date ) {
+            return StatusWith<Collection*>(
+                ErrorCodes::BadValue,
+                str::stream() << "documents inserted into time partitioned collection "
+                              << parentNs << " need a Date in field '" << options.field << "'" );
+        }
+
+        const std::string ns =
+            timePartitionNs( parentNs, timePartitionStart( options, timeElt.date().asInt64() ) );
+
+        Collection* partition = db->getCollection( txn, ns );
+        if ( partition ) {
+            return StatusWith<Collection*>( partition );
+        }
+
+        LOG(1) << "creating time partition " << ns;
+
+        BSONObj createOptions;
+        if ( !parent->getIndexCatalog()->findIdIndex() ) {
+            createOptions = BSON( "autoIndexId" << false );
+        }
+        Status status = userCreateNS( txn, db, ns, createOptions, true );
+        if ( !status.isOK() ) {
+            return StatusWith<Collection*>( status );
+        }
+
+        partition = db->getCollection( txn, ns );
+        invariant( partition );
+
+        const std::string systemIndexes = partition->ns().getSystemIndexesCollection();
+        IndexCatalog::IndexIterator it = parent->getIndexCatalog()->getIndexIterator( false );
+        while ( it.more() ) {
+            const IndexDescriptor* desc = it.next();
+            if ( desc->isIdIndex() ) {
+                continue;
+            }
+
+            BSONObj spec = partitionIndexSpec( desc->infoObj(), ns );
+            status = partition->getIndexCatalog()->createIndex( txn, spec, false );
+            if ( !status.isOK() ) {
+                return StatusWith<Collection*>( status );
+            }
+            repl::logOp( txn, "i", systemIndexes.c_str(), spec );
+        }
+
+        return StatusWith<Collection*>( partition );
+    }
+
+    Status createTimePartitionIndexes( OperationContext* txn,
+                                       Database* db,
+                                       Collection* parent,
+                                       const BSONObj& parentSpec ) {
+        const TimePartitionOptions options = parent->getTimePartitionOptions( txn );
+        if ( !options.isSet() ) {
+            return Status::OK();
+        }
+
+        const std::string& parentNs = parent->ns().ns();
+        Lock::assertWriteLocked( parentNs );
+
+        std::vector<std::string> partitions;
+        getTimePartitions( db,
+                           parentNs,
+                           options,
+                           std::numeric_limits<long long>::min(),
+                           std::numeric_limits<long long>::max(),
+                           &partitions );
+
+        for ( size_t i = 0; i < partitions.size(); ++i ) {
+            Collection* partition = db->getCollection( txn, partitions[i] );
+            if ( !partition ) {
+                continue;
+            }
+
+            BSONObj spec = partitionIndexSpec( parentSpec, partitions[i] );
+            Status status = partition->getIndexCatalog()->createIndex( txn, spec, true );
+            if ( status.code() == ErrorCodes::IndexAlreadyExists ) {
+                continue;
+            }
+            if ( !status.isOK() ) {
+                return status;
+            }
+            repl::logOp( txn,
+                         "i",
+                         partition->ns().getSystemIndexesCollection().c_str(),
+                         spec );
+        }
+        return Status::OK();
+    }
+
+    Status dropTimePartitionIndexes( OperationContext* txn,
+                                     Database* db,
+                                     Collection* parent,
+                                     const BSONElement& index ) {
+        const TimePartitionOptions options = parent->getTimePartitionOptions( txn );
+        if ( !options.isSet() ) {
+            return Status::OK();
+        }
+
+        const std::string& parentNs = parent->ns().ns();
+        Lock::assertWriteLocked( parentNs );
+
+        std::vector<std::string> partitions;
+        getTimePartitions( db,
+                           parentNs,
+                           options,
+                           std::numeric_limits<long long>::min(),
+                           std::numeric_limits<long long>::max(),
+                           &partitions );
+
+        const bool allIndexes = index.type() == String && strcmp( index.valuestr(), "*" ) == 0;
+        for ( size_t i = 0; i < partitions.size(); ++i ) {
+            Collection* partition = db->getCollection( txn, partitions[i] );
+            if ( !partition ) {
+                continue;
+            }
+
+            IndexCatalog* indexCatalog = partition->getIndexCatalog();
+            Status status = Status::OK();
+            if ( allIndexes ) {
+                status = indexCatalog->dropAllIndexes( txn, false );
+            }
+            else {
+                IndexDescriptor* desc = index.type() == String ?
+                    indexCatalog->findIndexByName( index.valuestr() ) :
+                    indexCatalog->findIndexByKeyPattern( index.embeddedObject() );
+                if ( !desc || desc->isIdIndex() ) {
+                    continue;
+                }
+                status = indexCatalog->dropIndex( txn, desc );
+            }
+            if ( !status.isOK() ) {
+                return status;
+            }
+
+            BSONObjBuilder cmd;
+            cmd.append( "dropIndexes", nsToCollectionSubstring( partitions[i] ) );
+            cmd.appendAs( index, "index" );
+            repl::logOp( txn, "c", ( db->name() + ".$cmd" ).c_str(), cmd.obj() );
+        }
+        return Status::OK();
+    }
+
+    Status dropTimePartitions( OperationContext* txn, Database* db, Collection* parent ) {
+        const TimePartitionOptions options = parent->getTimePartitionOptions( txn );
+        if ( !options.isSet() ) {
+            return Status::OK();
+        }
+
+        const std::string parentNs = parent->ns().ns();
+        Lock::assertWriteLocked( parentNs );
+
+        std::vector<std::string> partitions;
+        getTimePartitions( db,
+                           parentNs,
+                           options,
+                           std::numeric_limits<long long>::min(),
+                           std::numeric_limits<long long>::max(),
+                           &partitions );
+
+        LOG(1) << "dropping " << partitions.size() << " time partitions of " << parentNs;
+
+        int numDropped = 0;
+        return dropPartitions( txn, db, partitions, false, &numDropped );
+    }
+
+    int dropExpiredTimePartitions( OperationContext* txn,
+                                   Database* db,
+                                   Collection* parent,
+                                   const TimePartitionOptions& options,
+                                   long long nowMillis ) {
+        if ( !options.expireAfterSeconds ) {
+            return 0;
+        }
+
+        const std::string parentNs = parent->ns().ns();
+        Lock::assertWriteLocked( parentNs );
+
+        // A partition has expired once the newest value it can hold has, that is when its
+        // interval ends at or before the cutoff.
+        const long long cutoffMillis = nowMillis - options.expireAfterSeconds * 1000;
+        std::vector<std::string> partitions;
+        getTimePartitions( db,
+                           parentNs,
+                           options,
+                           std::numeric_limits<long long>::min(),
+                           cutoffMillis - options.seconds * 1000,
+                           &partitions );
+
+        for ( size_t i = 0; i < partitions.size(); ++i ) {
+            LOG(1) << "dropping expired time partition " << partitions[i];
+        }
+
+        // Expiry is retried on the next pass, so one partition failing shouldn't hold back the
+        // others.
+        int numDropped = 0;
+        dropPartitions( txn, db, partitions, true, &numDropped );
+        return numDropped;
+    }
+
+}  // namespace mongo
@@ -0,0 +1,159 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/jsobj.h"
+
+namespace mongo {
+
+    class Collection;
+    class Database;
+    class MatchExpression;
+    class OperationContext;
+
+    /**
+     * Time-partitioned collections.
+     *
+     * A collection created with a 'timePartition' option (see TimePartitionOptions) holds no
+     * documents itself.  Each document inserted into it is stored in a child collection named
+     * "<parent>.partition.<start>", which covers the 'seconds' long interval of values of the
+     * partition field beginning at <start> seconds since the epoch.  Children are created on
+     * demand with the indexes of the parent.
+     *
+     * Queries on the parent only visit the children whose interval the query's predicates on
+     * the partition field can match, and expiry drops whole children, which is a single oplog
+     * entry no matter how many documents they hold.  Indexes built or dropped on the parent are
+     * built or dropped on its children too, and dropping the parent drops them.  The parent can't
+     * be renamed, since the children's names derive from its own.  Other operations, such as
+     * updates, removes, count, distinct and aggregate, aren't routed and fail on the parent; they
+     * can be run on the children directly.
+     */
+
+    /**
+     * Returns IllegalOperation if 'collection' is time partitioned, since 'operation' would only
+     * see the parent, which holds no documents.  Returns OK otherwise, including if
+     * 'collection' is NULL.
+     */
+    Status checkNotTimePartitioned( OperationContext* txn,
+                                    Collection* collection,
+                                    const StringData& operation );
+
+    /**
+     * Returns the namespace of the partition of 'parentNs' starting at 'startSeconds'.
+     */
+    std::string timePartitionNs( const StringData& parentNs, long long startSeconds );
+
+    /**
+     * Returns true and fills in '*startSeconds' if 'ns' is a partition of 'parentNs'.
+     */
+    bool parseTimePartitionNs( const StringData& parentNs,
+                               const StringData& ns,
+                               long long* startSeconds );
+
+    /**
+     * Returns the start, in seconds since the epoch, of the partition holding 'millis'.
+     */
+    long long timePartitionStart( const TimePartitionOptions& options, long long millis );
+
+    /**
+     * Narrows ['*minMillis', '*maxMillis'] to the values of 'field' that documents matching
+     * 'root' can have.  Only Date comparisons that all matching documents must satisfy are
+     * considered, so the result may be wider than necessary but never too narrow.
+     */
+    void getTimePartitionBounds( const MatchExpression* root,
+                                 const StringData& field,
+                                 long long* minMillis,
+                                 long long* maxMillis );
+
+    /**
+     * Fills 'out' with the namespaces of the existing partitions of 'parentNs' that may hold
+     * values in [minMillis, maxMillis], in increasing order of time.
+     */
+    void getTimePartitions( Database* db,
+                            const StringData& parentNs,
+                            const TimePartitionOptions& options,
+                            long long minMillis,
+                            long long maxMillis,
+                            std::vector<std::string>* out );
+
+    /**
+     * Returns the partition of 'parent' that 'doc' belongs in, creating it and its indexes if
+     * it doesn't exist yet.  The creation is logged for replication.  Fails if 'doc' has no
+     * Date in the partition field.
+     */
+    StatusWith<Collection*> getTimePartitionForInsert( OperationContext* txn,
+                                                       Database* db,
+                                                       Collection* parent,
+                                                       const TimePartitionOptions& options,
+                                                       const BSONObj& doc );
+
+    /**
+     * Builds the index described by 'parentSpec', just built on 'parent', on each existing
+     * partition of 'parent', logging each build for replication.  Does nothing if 'parent'
+     * isn't time partitioned.
+     */
+    Status createTimePartitionIndexes( OperationContext* txn,
+                                       Database* db,
+                                       Collection* parent,
+                                       const BSONObj& parentSpec );
+
+    /**
+     * Drops the index or indexes that 'index' selects, as in the dropIndexes command, from each
+     * existing partition of 'parent' that has them, logging each drop for replication.  Does
+     * nothing if 'parent' isn't time partitioned.
+     */
+    Status dropTimePartitionIndexes( OperationContext* txn,
+                                     Database* db,
+                                     Collection* parent,
+                                     const BSONElement& index );
+
+    /**
+     * Drops every partition of 'parent', logging each drop for replication, ahead of dropping
+     * 'parent' itself.  Does nothing if 'parent' isn't time partitioned.
+     */
+    Status dropTimePartitions( OperationContext* txn, Database* db, Collection* parent );
+
+    /**
+     * Drops every partition of 'parent' that only holds documents older than the expiry
+     * interval as of 'nowMillis', logging each drop for replication.  Returns the number of
+     * partitions dropped.
+     */
+    int dropExpiredTimePartitions( OperationContext* txn,
+                                   Database* db,
+                                   Collection* parent,
+                                   const TimePartitionOptions& options,
+                                   long long nowMillis );
+
+}  // namespace mongo
@@ -0,0 +1,101 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/clone_progress.h"
+
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+    CloneProgress::CloneProgress() : _mutex("cloneProgress") { }
+
+    void CloneProgress::clear() {
+        mongo::mutex::scoped_lock lk(_mutex);
+        _collections.clear();
+    }
+
+    bool CloneProgress::empty() const {
+        mongo::mutex::scoped_lock lk(_mutex);
+        return _collections.empty();
+    }
+
+    void CloneProgress::addCollection(const std::string& ns, long long docsTotal) {
+        mongo::mutex::scoped_lock lk(_mutex);
+        _collections[ns].docsTotal = docsTotal;
+    }
+
+    void CloneProgress::startCollection(const std::string& ns) {
+        mongo::mutex::scoped_lock lk(_mutex);
+        _collections[ns].started = jsTime();
+    }
+
+    void CloneProgress::addDocsCopied(const std::string& ns, long long docsCopied) {
+        mongo::mutex::scoped_lock lk(_mutex);
+        _collections[ns].docsCopied += docsCopied;
+    }
+
+    void CloneProgress::finishCollection(const std::string& ns) {
+        mongo::mutex::scoped_lock lk(_mutex);
+        _collections[ns].finished = jsTime();
+    }
+
+    void CloneProgress::append(BSONObjBuilder* builder) const {
+        mongo::mutex::scoped_lock lk(_mutex);
+
+        const Date_t now = jsTime();
+        long long collectionsCloned = 0;
+        long long docsTotal = 0;
+        long long docsCopied = 0;
+        BSONArrayBuilder inProgress;
+        for (ProgressMap::const_iterator it = _collections.begin();
+             it != _collections.end();
+             ++it) {
+            const CollectionProgress& coll = it->second;
+            docsTotal += coll.docsTotal;
+            docsCopied += coll.docsCopied;
+
+            if (coll.finished) {
+                ++collectionsCloned;
+            }
+            else if (coll.started) {
+                inProgress.append(BSON("ns" << it->first <<
+                                       "docsCopied" << coll.docsCopied <<
+                                       "docsTotal" << coll.docsTotal <<
+                                       "elapsedMillis" <<
+                                           static_cast<long long>(now - coll.started)));
+            }
+        }
+
+        builder->append("collectionsTotal", static_cast<long long>(_collections.size()));
+        builder->append("collectionsCloned", collectionsCloned);
+        builder->append("docsTotal", docsTotal);
+        builder->append("docsCopied", docsCopied);
+        builder->append("inProgress", inProgress.arr());
+    }
+
+} // namespace mongo
@@ -0,0 +1,76 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/util/concurrency/mutex.h"
+
+namespace mongo {
+
+    /**
+     * Per-collection progress of a clone.  Written by the cloning threads and read
+     * concurrently by status reporting (e.g. replSetGetStatus during initial sync).
+     */
+    class CloneProgress : boost::noncopyable {
+    public:
+        CloneProgress();
+
+        void clear();
+        bool empty() const;
+
+        /** Registers 'ns' as waiting to be cloned, with 'docsTotal' documents at the source. */
+        void addCollection(const std::string& ns, long long docsTotal);
+
+        void startCollection(const std::string& ns);
+        void addDocsCopied(const std::string& ns, long long docsCopied);
+        void finishCollection(const std::string& ns);
+
+        /**
+         * Appends overall counts and the state of every collection currently being cloned.
+         */
+        void append(BSONObjBuilder* builder) const;
+
+    private:
+        struct CollectionProgress {
+            CollectionProgress() : docsTotal(0), docsCopied(0), started(0), finished(0) { }
+            long long docsTotal;
+            long long docsCopied;
+            Date_t started;   // 0 while pending
+            Date_t finished;  // 0 until done
+        };
+        typedef std::map<std::string, CollectionProgress> ProgressMap;
+
+        mutable mongo::mutex _mutex;
+        ProgressMap _collections;  // guarded by _mutex
+    };
+
+} // namespace mongo
@@ -30,7 +30,10 @@
 
 #include "mongo/pch.h"
 
+#include <boost/thread/thread.hpp>
+
 #include "mongo/base/init.h"
+#include "mongo/base/owned_pointer_vector.h"
 #include "mongo/base/status.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/client/dbclientinterface.h"
@@ -54,11 +57,24 @@
 #include "mongo/db/pdfile.h"
 #include "mongo/db/operation_context_impl.h"
 #include "mongo/db/storage_options.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/util/fail_point_service.h"
 
 namespace mongo {
 
     BSONElement getErrField(const BSONObj& o);
 
+    // Holds the parallel clone workers of the database named by the fail point's "db" after
+    // each collection they finish, for tests that watch a clone in progress.
+    MONGO_FP_DECLARE(clonerPauseAfterCollection);
+
+    static bool pauseAfterCollection(const string& dbName) {
+        MONGO_FAIL_POINT_BLOCK(clonerPauseAfterCollection, scopedFp) {
+            return scopedFp.getData()["db"].str() == dbName;
+        }
+        return false;
+    }
+
     /* for index info object:
          { "name" : "name_1" , "ns" : "foo.index3" , "key" :  { "name" : 1.0 } }
        we need to fix up the value in the "ns" parameter so that the name prefix is correct on a
@@ -124,6 +140,7 @@ namespace mongo {
                 }
             }
 
+            long long numInserted = 0;
             while( i.moreInCurrentBatch() ) {
                 if ( numSeen % 128 == 127 ) {
                     time_t now = time(0);
@@ -163,6 +180,7 @@ namespace mongo {
                             << ' ' << loc.toString() << " obj:" << js;
                 }
                 uassertStatusOK( loc.getStatus() );
+                ++numInserted;
                 if (logForRepl)
                     repl::logOp(txn, "i", to_collection, js);
 
@@ -173,6 +191,9 @@ namespace mongo {
                     saveLast = time( 0 );
                 }
             }
+
+            if ( progress && numInserted )
+                progress->addDocsCopied( to_collection, numInserted );
         }
 
         time_t lastLog;
@@ -188,6 +209,7 @@ namespace mongo {
         bool logForRepl;
         bool _mayYield;
         bool _mayBeInterrupted;
+        CloneProgress* progress;
     };
 
     /* copy the specified collection
@@ -203,7 +225,8 @@ namespace mongo {
                       bool slaveOk,
                       bool mayYield,
                       bool mayBeInterrupted,
-                      Query query) {
+                      Query query,
+                      CloneProgress* progress) {
 
         list<BSONObj> indexesToBuild;
         LOG(2) << "\t\tcloning collection " << from_collection << " to " << to_collection << " on " << _conn->getServerAddress() << " with filter " << query.toString() << endl;
@@ -218,6 +241,7 @@ namespace mongo {
         f.logForRepl = logForRepl;
         f._mayYield = mayYield;
         f._mayBeInterrupted = mayBeInterrupted;
+        f.progress = progress;
 
         int options = QueryOption_NoCursorTimeout | ( slaveOk ? QueryOption_SlaveOk : 0 );
         {
@@ -324,6 +348,89 @@ namespace mongo {
         return true;
     }
 
+    void Cloner::copyCollectionData(OperationContext* txn,
+                                    Client::Context& ctx,
+                                    const char* from_name,
+                                    const string& to_name,
+                                    bool masterSameProcess,
+                                    const CloneOptions& opts) {
+        LOG(1) << "\t\t cloning " << from_name << " -> " << to_name << endl;
+        if ( opts.progress )
+            opts.progress->startCollection( to_name );
+
+        Query q;
+        if( opts.snapshot )
+            q.snapshot();
+        copy(txn, ctx, from_name, to_name.c_str(), false, opts.logForRepl, masterSameProcess,
+             opts.slaveOk, opts.mayYield, opts.mayBeInterrupted, q, opts.progress);
+
+        if ( opts.progress )
+            opts.progress->finishCollection( to_name );
+    }
+
+    /**
+     * Collections still to be copied by the parallel clone workers of Cloner::go, and the
+     * first error any of them hit.
+     */
+    struct Cloner::CloneQueue {
+        CloneQueue() : mutex("clonerQueue") { }
+
+        mongo::mutex mutex;
+        list<BSONObj> toClone;  // guarded by mutex
+        string errmsg;          // guarded by mutex
+    };
+
+    void Cloner::cloneWorker(CloneQueue* queue,
+                             const string& masterHost,
+                             const string& todb,
+                             const CloneOptions* opts) {
+        Client::initThread("clonerWorker");
+        try {
+            string errmsg;
+            ConnectionString cs = ConnectionString::parse( masterHost, errmsg );
+            auto_ptr<DBClientBase> con( cs.connect( errmsg ) );
+            uassert( 17521,
+                     str::stream() << "clone worker can't connect to " << masterHost << ": "
+                                   << errmsg,
+                     con.get() );
+            uassert( 17522,
+                     str::stream() << "clone worker can't authenticate to " << masterHost,
+                     repl::replAuthenticate( con.get() ) );
+            _conn = con;
+
+            OperationContextImpl txn;
+            while ( true ) {
+                BSONObj collection;
+                {
+                    mongo::mutex::scoped_lock lk( queue->mutex );
+                    if ( queue->toClone.empty() || !queue->errmsg.empty() )
+                        break;
+                    collection = queue->toClone.front();
+                    queue->toClone.pop_front();
+                }
+
+                const char* from_name = collection["name"].valuestr();
+                string to_name = todb + strchr( from_name, '.' );
+
+                {
+                    Client::WriteContext ctx( &txn, to_name );
+                    copyCollectionData( &txn, ctx.ctx(), from_name, to_name, false, *opts );
+                }
+
+                while ( pauseAfterCollection( todb ) ) {
+                    sleepmillis( 10 );
+                }
+            }
+        }
+        catch ( const std::exception& e ) {
+            mongo::mutex::scoped_lock lk( queue->mutex );
+            if ( queue->errmsg.empty() )
+                queue->errmsg = str::stream() << "error cloning " << opts->fromDB << ": "
+                                              << e.what();
+        }
+        cc().shutdown();
+    }
+
     extern bool inDBRepair;
 
     bool Cloner::go(OperationContext* txn,
@@ -450,6 +557,13 @@ namespace mongo {
 
                 if ( clonedColls ) clonedColls->insert( from_name );
                 toClone.push_back( collection.getOwned() );
+
+                if ( opts.progress ) {
+                    opts.progress->addCollection( todb + strchr( from_name, '.' ),
+                                                  _conn->count( from_name, BSONObj(),
+                                                                opts.slaveOk ?
+                                                                    QueryOption_SlaveOk : 0 ) );
+                }
             }
         }
 
@@ -472,30 +586,66 @@ namespace mongo {
                                        << createStatus.reason();
                 return false;
             }
+        }
+
+        const int numWorkers = std::min( opts.parallelCollectionClones,
+                                         static_cast<int>( toClone.size() ) );
+        if ( numWorkers > 1 && !masterSameProcess ) {
+            LOG(1) << "\t\t cloning " << toClone.size() << " collections from " << opts.fromDB
+                   << " using " << numWorkers << " connections" << endl;
 
-            LOG(1) << "\t\t cloning " << from_name << " -> " << to_name << endl;
-            Query q;
-            if( opts.snapshot )
-                q.snapshot();
-            copy(txn, context,from_name, to_name.c_str(), false, opts.logForRepl, masterSameProcess,
-                 opts.slaveOk, opts.mayYield, opts.mayBeInterrupted, q);
+            CloneQueue queue;
+            queue.toClone = toClone;
 
+            OwnedPointerVector<Cloner> workerCloners;
             {
-                /* we need dropDups to be true as we didn't do a true snapshot and this is before applying oplog operations
-                   that occur during the initial sync.  inDBRepair makes dropDups be true.
-                   */
-                bool old = inDBRepair;
-                try {
-                    inDBRepair = true;
-                    Collection* c = context.db()->getCollection( txn, to_name );
-                    if ( c )
-                        c->getIndexCatalog()->ensureHaveIdIndex(txn);
-                    inDBRepair = old;
-                }
-                catch(...) {
-                    inDBRepair = old;
-                    throw;
+                // The workers lock for each batch they insert, just like the serial copy does.
+                dbtemprelease r(txn->lockState());
+
+                boost::thread_group workers;
+                for ( int i = 0; i < numWorkers; i++ ) {
+                    workerCloners.mutableVector().push_back( new Cloner() );
+                    workers.create_thread( stdx::bind( &Cloner::cloneWorker,
+                                                       workerCloners.vector().back(),
+                                                       &queue,
+                                                       masterHost,
+                                                       todb,
+                                                       &opts ) );
                 }
+                workers.join_all();
+            }
+
+            if ( !queue.errmsg.empty() ) {
+                errmsg = queue.errmsg;
+                return false;
+            }
+        }
+        else {
+            for ( list<BSONObj>::iterator i=toClone.begin(); i != toClone.end(); i++ ) {
+                const char * from_name = (*i)["name"].valuestr();
+                string to_name = todb + strchr(from_name, '.');
+                copyCollectionData( txn, context, from_name, to_name, masterSameProcess, opts );
+            }
+        }
+
+        for ( list<BSONObj>::iterator i=toClone.begin(); i != toClone.end(); i++ ) {
+            const char * from_name = (*i)["name"].valuestr();
+            string to_name = todb + strchr(from_name, '.');
+
+            /* we need dropDups to be true as we didn't do a true snapshot and this is before applying oplog operations
+               that occur during the initial sync.  inDBRepair makes dropDups be true.
+               */
+            bool old = inDBRepair;
+            try {
+                inDBRepair = true;
+                Collection* c = context.db()->getCollection( txn, to_name );
+                if ( c )
+                    c->getIndexCatalog()->ensureHaveIdIndex(txn);
+                inDBRepair = old;
+            }
+            catch(...) {
+                inDBRepair = old;
+                throw;
             }
         }
 
@@ -32,6 +32,7 @@
 
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/client.h"
+#include "mongo/db/clone_progress.h"
 #include "mongo/db/jsobj.h"
 
 namespace mongo {
@@ -69,6 +70,28 @@ namespace mongo {
                             bool logForRepl = true );
 
     private:
+        struct CloneQueue;
+
+        /**
+         * Copies the documents of 'from_name' into the already created 'to_name', reporting
+         * progress to opts.progress.  Does not build the _id index.
+         */
+        void copyCollectionData(OperationContext* txn,
+                                Client::Context& ctx,
+                                const char* from_name,
+                                const std::string& to_name,
+                                bool masterSameProcess,
+                                const CloneOptions& opts);
+
+        /**
+         * Body of a parallel clone thread: opens its own connection to 'masterHost' and copies
+         * collections from 'queue' into 'todb' until the queue is empty or any worker fails.
+         */
+        void cloneWorker(CloneQueue* queue,
+                         const std::string& masterHost,
+                         const std::string& todb,
+                         const CloneOptions* opts);
+
         void copy(OperationContext* txn,
                   Client::Context& ctx,
                   const char *from_ns,
@@ -79,7 +102,8 @@ namespace mongo {
                   bool slaveOk,
                   bool mayYield,
                   bool mayBeInterrupted,
-                  Query q);
+                  Query q,
+                  CloneProgress* progress = NULL);
 
         struct Fun;
         std::auto_ptr<DBClientBase> _conn;
@@ -91,6 +115,9 @@ namespace mongo {
      *  snapshot    - use $snapshot mode for copying collections.  note this should not be used
      *                when it isn't required, as it will be slower.  for example,
      *                repairDatabase need not use it.
+     *  parallelCollectionClones - number of collections copied at once, each over its own
+     *                connection.  Ignored when cloning from this same process.
+     *  progress    - if not NULL, receives per-collection progress of the data copy.
      */
     struct CloneOptions {
         CloneOptions() {
@@ -103,6 +130,9 @@ namespace mongo {
 
             syncData = true;
             syncIndexes = true;
+
+            parallelCollectionClones = 1;
+            progress = NULL;
         }
 
         std::string fromDB;
@@ -117,6 +147,9 @@ namespace mongo {
 
         bool syncData;
         bool syncIndexes;
+
+        int parallelCollectionClones;
+        CloneProgress* progress;
     };
 
 } // namespace mongo
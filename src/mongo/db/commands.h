@@ -267,7 +267,6 @@ namespace mutablebson {
     bool _runCommands(OperationContext* txn,
                       const char* ns,
                       BSONObj& jsobj,
-                      BufBuilder& b,
                       BSONObjBuilder& anObjBuilder,
                       bool fromRepl,
                       int queryOptions);
@@ -39,6 +39,9 @@
  * The following command disables the already-enabled profiler:
  *     { _cpuProfilerStop: 1}
  *
+ * The profiler can't run while a profileCPU sample is being taken, since both use
+ * SIGPROF and ITIMER_PROF.
+ *
  * The commands defined here, and profiling, are only available when enabled at
  * build-time with the "--use-cpu-profiler" argument to scons.
  *
@@ -61,6 +64,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/stats/cpu_sampler.h"
 
 namespace mongo {
 
@@ -138,8 +142,17 @@ namespace mongo {
             Lock::DBWrite dbXLock(db);
             Client::Context ctx(db);
 
+            Status status = CpuSampler::claimExternalProfiler();
+            if ( !status.isOK() ) {
+                return appendCommandStatus( result, status );
+            }
+
             std::string profileFilename = cmdObj[commandName]["profileFilename"].String();
             if ( ! ::ProfilerStart( profileFilename.c_str() ) ) {
+                // ProfilerStart() also fails when the profiler is already running.
+                if ( !::ProfilingIsEnabledForAllThreads() ) {
+                    CpuSampler::releaseExternalProfiler();
+                }
                 errmsg = "Failed to start profiler";
                 return false;
             }
@@ -157,6 +170,7 @@ namespace mongo {
             Client::Context ctx(db);
 
             ::ProfilerStop();
+            CpuSampler::releaseExternalProfiler();
             return true;
         }
 
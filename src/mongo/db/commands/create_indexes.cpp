@@ -31,6 +31,7 @@
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/time_partition.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/ops/insert.h"
@@ -201,6 +202,14 @@ namespace mongo {
                 if ( !fromRepl ) {
                     std::string systemIndexes = ns.getSystemIndexesCollection();
                     repl::logOp(txn, "i", systemIndexes.c_str(), spec);
+
+                    // The partitions' builds are logged on their own, so a secondary gets
+                    // them from the oplog rather than from here.
+                    status = createTimePartitionIndexes( txn, db, collection, spec );
+                    if ( !status.isOK() ) {
+                        appendCommandStatus( result, status );
+                        return false;
+                    }
                 }
             }
 
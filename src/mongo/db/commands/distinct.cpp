@@ -35,6 +35,7 @@
 #include "mongo/db/auth/action_type.h"
 #include "mongo/db/auth/privilege.h"
 #include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/time_partition.h"
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/instance.h"
@@ -102,6 +103,8 @@ namespace mongo {
                 return true;
             }
 
+            uassertStatusOK(checkNotTimePartitioned(txn, collection, "distinct"));
+
             Runner* rawRunner;
             Status status = getRunnerDistinct(collection, query, key, &rawRunner);
             if (!status.isOK()) {
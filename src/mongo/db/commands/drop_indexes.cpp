@@ -37,6 +37,7 @@
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/catalog/index_key_validate.h"
+#include "mongo/db/catalog/time_partition.h"
 #include "mongo/db/pdfile.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/operation_context_impl.h"
@@ -96,8 +97,21 @@ namespace mongo {
         bool run(OperationContext* txn, const string& dbname, BSONObj& jsobj, int, string& errmsg, BSONObjBuilder& anObjBuilder, bool fromRepl) {
             Lock::DBWrite dbXLock(txn->lockState(), dbname);
             bool ok = wrappedRun(txn, dbname, jsobj, errmsg, anObjBuilder);
-            if (ok && !fromRepl)
+            if (ok && !fromRepl) {
                 repl::logOp(txn, "c",(dbname + ".$cmd").c_str(), jsobj);
+
+                // The partitions' drops are logged on their own, so a secondary gets them from
+                // the oplog rather than from here.
+                const string ns = dbname + '.' + jsobj.firstElement().valuestr();
+                Client::Context ctx(ns);
+                Collection* collection = ctx.db()->getCollection(txn, ns);
+                if (collection) {
+                    Status s = dropTimePartitionIndexes(txn, ctx.db(), collection,
+                                                        jsobj.getField("index"));
+                    if (!s.isOK())
+                        return appendCommandStatus(anObjBuilder, s);
+                }
+            }
             return ok;
         }
         bool wrappedRun(OperationContext* txn,
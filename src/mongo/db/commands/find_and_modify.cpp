@@ -32,6 +32,7 @@
 
 #include "mongo/db/commands/find_and_modify.h"
 
+#include "mongo/db/catalog/time_partition.h"
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/dbhelpers.h"
@@ -136,6 +137,7 @@ namespace mongo {
             Lock::DBWrite lk(txn->lockState(), ns);
             Client::Context cx( ns );
             Collection* collection = cx.db()->getCollection( txn, ns );
+            uassertStatusOK( checkNotTimePartitioned( txn, collection, "findAndModify" ) );
 
             const WhereCallbackReal whereCallback = WhereCallbackReal(StringData(ns));
 
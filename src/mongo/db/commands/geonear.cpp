@@ -32,6 +32,7 @@
 #include "mongo/db/auth/action_type.h"
 #include "mongo/db/auth/privilege.h"
 #include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/time_partition.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/geo/geoconstants.h"
@@ -90,6 +91,8 @@ namespace mongo {
                 return false;
             }
 
+            uassertStatusOK( checkNotTimePartitioned( txn, collection, "geoNear" ) );
+
             IndexCatalog* indexCatalog = collection->getIndexCatalog();
 
             // cout << "raw cmd " << cmdObj.toString() << endl;
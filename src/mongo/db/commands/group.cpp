@@ -40,6 +40,7 @@
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/time_partition.h"
 #include "mongo/db/instance.h"
 #include "mongo/db/query/get_runner.h"
 #include "mongo/db/catalog/collection.h"
@@ -140,6 +141,8 @@ namespace mongo {
             list<BSONObj> blah;
 
             if (collection) {
+                uassertStatusOK(checkNotTimePartitioned(txn, collection, "group"));
+
                 CanonicalQuery* cq;
                 if (!CanonicalQuery::canonicalize(ns, query, &cq, whereCallback).isOK()) {
                     uasserted(17212, "Can't canonicalize query " + query.toString());
@@ -0,0 +1,107 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * Reports the latency histograms kept by OperationLatencyStats, through the "latencyStats"
+ * serverStatus section and the latencyStats command:
+ *     { latencyStats: 1, namespaces: true }
+ *
+ * Per namespace histograms are only kept while the trackLatencyByNamespace server parameter
+ * is set.  serverStatus includes them when asked with { latencyStats: { namespaces: 1 } }.
+ */
+
+#include <string>
+#include <vector>
+
+#include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/stats/operation_latency.h"
+
+namespace mongo {
+
+    class LatencyStatsServerStatusSection : public ServerStatusSection {
+    public:
+        LatencyStatsServerStatusSection() : ServerStatusSection("latencyStats") {}
+        virtual bool includeByDefault() const { return true; }
+
+        BSONObj generateSection(const BSONElement& configElement) const {
+            const bool includeNamespaces = configElement.type() == Object &&
+                                           configElement.Obj()["namespaces"].trueValue();
+            return globalLatencyStats.getReport(includeNamespaces);
+        }
+
+    } latencyStatsServerStatusSection;
+
+    class CmdLatencyStats : public Command {
+    public:
+        CmdLatencyStats() : Command("latencyStats") {}
+
+        virtual bool slaveOk() const { return true; }
+        virtual bool adminOnly() const { return true; }
+        virtual bool isWriteCommandForConfigServer() const { return false; }
+        virtual void addRequiredPrivileges(const std::string& dbname,
+                                           const BSONObj& cmdObj,
+                                           std::vector<Privilege>* out) {
+            ActionSet actions;
+            actions.addAction(ActionType::serverStatus);
+            out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+        }
+        virtual void help(stringstream& help) const {
+            help << "latency histograms by operation type, and by namespace when the\n"
+                 << "trackLatencyByNamespace parameter is set\n"
+                 << "{ latencyStats: 1, namespaces: true }";
+        }
+
+        virtual bool run(OperationContext* txn,
+                         const string& db,
+                         BSONObj& cmdObj,
+                         int options,
+                         string& errmsg,
+                         BSONObjBuilder& result,
+                         bool fromRepl) {
+            bool includeNamespaces;
+            Status status = bsonExtractBooleanFieldWithDefault(cmdObj,
+                                                               "namespaces",
+                                                               true,
+                                                               &includeNamespaces);
+            if (!status.isOK()) {
+                return appendCommandStatus(result, status);
+            }
+
+            result.appendElements(globalLatencyStats.getReport(includeNamespaces));
+            return true;
+        }
+
+    } cmdLatencyStats;
+
+}  // namespace mongo
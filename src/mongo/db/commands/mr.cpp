@@ -32,10 +32,12 @@
 
 #include "mongo/db/commands/mr.h"
 
+#include "mongo/base/owned_pointer_vector.h"
 #include "mongo/client/connpool.h"
 #include "mongo/client/parallel.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog/time_partition.h"
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/db.h"
@@ -48,18 +50,50 @@
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/range_preserver.h"
 #include "mongo/db/operation_context_impl.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage_options.h"
 #include "mongo/scripting/engine.h"
 #include "mongo/s/collection_metadata.h"
 #include "mongo/s/d_logic.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/stale_exception.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
     namespace mr {
 
+        // How many threads run the map function of a map/reduce that isn't in jsMode, each with
+        // its own JS scope.  0 or 1 maps on the thread running the command.
+        MONGO_EXPORT_SERVER_PARAMETER(mapReduceMapThreads, int, 1);
+
+        namespace {
+            // Bounds on how many documents are held back to be mapped in parallel at a time.
+            const size_t kMaxPendingDocs = 1000;
+            const size_t kMaxPendingBytes = 16 * 1024 * 1024;
+
+            /**
+             * Returns the value of a (key, value) tuple.
+             */
+            BSONElement tupleValue( const BSONObj& tuple ) {
+                BSONObjIterator it( tuple );
+                it.next();
+                return it.next();
+            }
+
+            /**
+             * Orders spilled tuples by key, the way the in memory map does.
+             */
+            class TupleSortComparator {
+            public:
+                typedef std::pair<BSONObj, BSONObj> Data;
+                int operator()( const Data& l, const Data& r ) const {
+                    return l.first.firstElement().woCompare( r.first.firstElement() , false );
+                }
+            };
+        }
+
         AtomicUInt Config::JOB_NUMBER;
 
         JSFunction::JSFunction( const std::string& type , const BSONElement& e ) {
@@ -71,7 +105,11 @@ namespace mongo {
         }
 
         void JSFunction::init( State * state ) {
-            _scope = state->scope();
+            init( state->scope() );
+        }
+
+        void JSFunction::init( Scope * scope ) {
+            _scope = scope;
             verify( _scope );
             _scope->init( &_wantedScope );
 
@@ -239,6 +277,132 @@ namespace mongo {
             _reduce( x , key , endSizeEstimate );
         }
 
+        NativeReducer* NativeReducer::parse( const BSONElement& e ) {
+            if ( e.type() != String || e.valuestr()[0] != '$' )
+                return NULL;
+
+            const StringData name = StringData( e.valuestr() , e.valuestrsize() - 1 );
+            if ( name == "$sum" )
+                return new NativeReducer( SUM );
+            if ( name == "$min" )
+                return new NativeReducer( MIN );
+            if ( name == "$max" )
+                return new NativeReducer( MAX );
+            if ( name == "$addToSet" )
+                return new NativeReducer( ADD_TO_SET );
+
+            uasserted( 17511 , str::stream() << "unknown built in reducer: " << name );
+            return NULL;
+        }
+
+        /**
+         * Reduces a list of tuple objects (key, value) to a single tuple {"0": key, "1": value}
+         */
+        BSONObj NativeReducer::reduce( const BSONList& tuples ) {
+            if (tuples.size() <= 1)
+                return tuples[0];
+
+            BSONObjBuilder b;
+            b.appendAs( tuples[0].firstElement() , "0" );
+            _reduce( tuples , b , "1" );
+            return b.obj();
+        }
+
+        /**
+         * Reduces a list of tuple object (key, value) to a single tuple {_id: key, value: val}
+         * Also applies a finalizer method if present.
+         */
+        BSONObj NativeReducer::finalReduce( const BSONList& tuples , Finalizer * finalizer ) {
+            BSONObjBuilder b;
+            b.appendAs( tuples[0].firstElement() , "_id" );
+            if ( tuples.size() == 1 ) {
+                // 1 obj, just use it
+                b.appendAs( tupleValue( tuples[0] ) , "value" );
+            }
+            else {
+                _reduce( tuples , b , "value" );
+            }
+
+            BSONObj res = b.obj();
+            if ( finalizer ) {
+                res = finalizer->finalize( res );
+            }
+
+            return res;
+        }
+
+        void NativeReducer::_reduce( const BSONList& tuples ,
+                                     BSONObjBuilder& b ,
+                                     const StringData& fieldName ) {
+            uassert( 17523 ,  "need values" , tuples.size() );
+            ++numReduces;
+
+            switch ( _op ) {
+            case SUM: {
+                // same widening as $sum in aggregation: int, then long, then double
+                BSONType totalType = NumberInt;
+                long long longTotal = 0;
+                double doubleTotal = 0;
+                for ( BSONList::const_iterator it = tuples.begin(); it != tuples.end(); ++it ) {
+                    const BSONElement value = tupleValue( *it );
+                    uassert( 17512 ,
+                             str::stream() << "$sum reducer needs numeric values, not: "
+                                           << value.toString( false ) ,
+                             value.isNumber() );
+
+                    if ( value.type() == NumberDouble )
+                        totalType = NumberDouble;
+                    else if ( value.type() == NumberLong && totalType == NumberInt )
+                        totalType = NumberLong;
+
+                    longTotal += value.numberLong();
+                    doubleTotal += value.numberDouble();
+                }
+
+                if ( totalType == NumberDouble )
+                    b.append( fieldName , doubleTotal );
+                else if ( totalType == NumberLong || longTotal != static_cast<int>( longTotal ) )
+                    b.append( fieldName , longTotal );
+                else
+                    b.append( fieldName , static_cast<int>( longTotal ) );
+                return;
+            }
+            case MIN:
+            case MAX: {
+                BSONElement best = tupleValue( tuples[0] );
+                for ( size_t i = 1; i < tuples.size(); i++ ) {
+                    const BSONElement value = tupleValue( tuples[i] );
+                    const int cmp = value.woCompare( best , false );
+                    if ( _op == MIN ? cmp < 0 : cmp > 0 )
+                        best = value;
+                }
+                b.appendAs( best , fieldName );
+                return;
+            }
+            case ADD_TO_SET: {
+                BSONElementSet values;
+                for ( BSONList::const_iterator it = tuples.begin(); it != tuples.end(); ++it ) {
+                    const BSONElement value = tupleValue( *it );
+                    uassert( 17513 ,
+                             str::stream() << "$addToSet reducer needs array values, not: "
+                                           << value.toString( false ) ,
+                             value.type() == Array );
+
+                    BSONObjIterator j( value.embeddedObject() );
+                    while ( j.more() )
+                        values.insert( j.next() );
+                }
+
+                BSONArrayBuilder arr( b.subarrayStart( fieldName ) );
+                for ( BSONElementSet::const_iterator it = values.begin(); it != values.end(); ++it )
+                    arr.append( *it );
+                arr.done();
+                return;
+            }
+            }
+            verify( 0 );
+        }
+
         Config::Config( const string& _dbname , const BSONObj& cmdObj )
         {
             dbname = _dbname;
@@ -273,7 +437,6 @@ namespace mongo {
                         << cmdObj.firstElement().String()
                         << "_"
                         << JOB_NUMBER++;
-                incLong = tempNamespace + "_inc";
             }
 
             {
@@ -282,8 +445,17 @@ namespace mongo {
                 if ( cmdObj["scope"].type() == Object )
                     scopeSetup = cmdObj["scope"].embeddedObjectUserCheck();
 
-                mapper.reset( new JSMapper( cmdObj["map"] ) );
-                reducer.reset( new JSReducer( cmdObj["reduce"] ) );
+                mapCode = cmdObj["map"].wrap();
+                mapper.reset( new JSMapper( mapCode.firstElement() ) );
+
+                reducer.reset( NativeReducer::parse( cmdObj["reduce"] ) );
+                if ( reducer ) {
+                    // a built in reducer can't be called from JS
+                    jsMode = false;
+                }
+                else {
+                    reducer.reset( new JSReducer( cmdObj["reduce"] ) );
+                }
                 if ( cmdObj["finalize"].type() && cmdObj["finalize"].trueValue() )
                     finalizer.reset( new JSFinalizer( cmdObj["finalize"] ) );
 
@@ -291,6 +463,7 @@ namespace mongo {
                     mapParams = cmdObj["mapparams"].embeddedObjectUserCheck();
                 }
 
+                mapThreads = mapReduceMapThreads;
             }
 
             {
@@ -316,19 +489,12 @@ namespace mongo {
         }
 
         /**
-         * Clean up the temporary and incremental collections
+         * Clean up the temporary collection
          */
         void State::dropTempCollections() {
             _db.dropCollection(_config.tempNamespace);
             // Always forget about temporary namespaces, so we don't cache lots of them
             ShardConnection::forgetNS( _config.tempNamespace );
-            if (_useIncremental) {
-                // NOTE: this will log the deletion of the inc collection which is unnecessary, but
-                // harmless.
-                _db.dropCollection(_config.incLong);
-                ShardConnection::forgetNS( _config.incLong );
-            }
-
         }
 
         /**
@@ -340,24 +506,15 @@ namespace mongo {
 
             dropTempCollections();
             if (_useIncremental) {
-                // Create the inc collection and make sure we have index on "0" key.
-                // Intentionally not replicating the inc collection to secondaries.
-                Client::WriteContext incCtx(_txn, _config.incLong);
-                Collection* incColl = incCtx.ctx().db()->getCollection( _txn, _config.incLong );
-                if ( !incColl ) {
-                    CollectionOptions options;
-                    options.setNoIdIndex();
-                    options.temp = true;
-                    incColl = incCtx.ctx().db()->createCollection( _txn, _config.incLong, options );
-                }
-
-                BSONObj indexSpec = BSON( "key" << BSON( "0" << 1 ) << "ns" << _config.incLong
-                                          << "name" << "_temp_0" );
-                Status status = incColl->getIndexCatalog()->createIndex(_txn, indexSpec, false);
-                if ( !status.isOK() ) {
-                    uasserted( 17305 , str::stream() << "createIndex failed for mr incLong ns: " <<
-                            _config.incLong << " err: " << status.code() );
-                }
+                // Tuples that don't fit in memory go to an external sorter, which hands them back
+                // grouped by key for the final reduce.  Nothing spilled is written to the
+                // database, so none of it is replicated or needs a lock.
+                _spilled.reset(TupleSorter::make(
+                            SortOptions().TempDir(storageGlobalParams.dbpath + "/_tmp")
+                                         .ExtSortAllowed()
+                                         .MaxMemoryUsageBytes(100*1024*1024),
+                            TupleSortComparator()));
+                _numSpilled = 0;
             }
 
             vector<BSONObj> indexesToInsert;
@@ -503,7 +660,10 @@ namespace mongo {
 
             if (_config.outputOptions.outNonAtomic)
                 return postProcessCollectionNonAtomic(txn, op, pm);
-            Lock::GlobalWrite lock(txn->lockState()); // TODO(erh): this is how it was, but seems it doesn't need to be global
+
+            // The temp collection is always in the same database as the final one, so holding
+            // that database is enough to make the output appear at once.
+            Lock::DBWrite lock(txn->lockState(), _config.outputOptions.finalNamespace);
             return postProcessCollectionNonAtomic(txn, op, pm);
         }
 
@@ -541,20 +701,36 @@ namespace mongo {
             if (_config.outputOptions.outType == Config::REPLACE ||
                     _safeCount(_db, _config.outputOptions.finalNamespace) == 0) {
 
-                Lock::GlobalWrite lock(txn->lockState()); // TODO(erh): why global???
-                // replace: just rename from temp to final collection name, dropping previous collection
-                _db.dropCollection( _config.outputOptions.finalNamespace );
-                BSONObj info;
-
-                if ( ! _db.runCommand( "admin"
-                                      , BSON( "renameCollection" << _config.tempNamespace <<
-                                              "to" << _config.outputOptions.finalNamespace <<
-                                              "stayTemp" << _config.shardedFirstPass )
-                                      , info ) ) {
-                    uasserted( 10076 ,  str::stream() << "rename failed: " << info );
+                // replace: just rename from temp to final collection name, dropping previous
+                // collection.  Both are in the same database, so the renameCollection command
+                // and the global lock it takes aren't needed.
+                Lock::DBWrite lock(txn->lockState(), _config.outputOptions.finalNamespace);
+                Client::Context ctx(_config.outputOptions.finalNamespace);
+                Database* db = ctx.db();
+
+                const string& finalNs = _config.outputOptions.finalNamespace;
+                if ( db->getCollection( _txn, finalNs ) ) {
+                    Status status = db->dropCollection( _txn, finalNs );
+                    if ( !status.isOK() ) {
+                        uasserted( 10076 , str::stream() << "rename failed: " << status.reason() );
+                    }
                 }
-                         
-                _db.dropCollection( _config.tempNamespace );
+
+                Status status = db->renameCollection( _txn,
+                                                      _config.tempNamespace,
+                                                      finalNs,
+                                                      _config.shardedFirstPass );
+                if ( !status.isOK() ) {
+                    uasserted( 17524 , str::stream() << "rename failed: " << status.reason() );
+                }
+
+                repl::logOp( _txn,
+                             "c",
+                             "admin.$cmd",
+                             BSON( "renameCollection" << _config.tempNamespace <<
+                                   "to" << finalNs <<
+                                   "stayTemp" << _config.shardedFirstPass <<
+                                   "dropTarget" << true ) );
             }
             else if ( _config.outputOptions.outType == Config::MERGE ) {
                 // merge: upsert new docs into old collection
@@ -581,7 +757,7 @@ namespace mongo {
                                _safeCount(_db, _config.tempNamespace, BSONObj()));
                 auto_ptr<DBClientCursor> cursor = _db.query( _config.tempNamespace , BSONObj() );
                 while ( cursor->more() ) {
-                    Lock::GlobalWrite lock(txn->lockState()); // TODO(erh) why global?
+                    Lock::DBWrite lock(_txn->lockState(), _config.outputOptions.finalNamespace);
                     BSONObj temp = cursor->nextSafe();
                     BSONObj old;
 
@@ -646,20 +822,14 @@ namespace mongo {
         }
 
         /**
-         * Insert doc into the inc collection. This should not be replicated.
+         * Spill a tuple to the sorter, for the final reduce.
          */
         void State::_insertToInc( BSONObj& o ) {
             verify( _onDisk );
+            verify( _spilled );
 
-            Client::WriteContext ctx(_txn,  _config.incLong );
-            Collection* coll = ctx.ctx().db()->getCollection( _txn, _config.incLong );
-            if ( !coll )
-                uasserted(13631, str::stream() << "attempted to insert into nonexistent"
-                                                  " collection during a mr operation." <<
-                                                  " collection expected: " << _config.incLong );
-
-            coll->insertDocument( _txn, o, true );
-            _txn->recoveryUnit()->commitIfNeeded();
+            _spilled->add( o.getOwned() , BSONObj() );
+            _numSpilled++;
         }
 
         State::State(OperationContext* txn, const Config& c) :
@@ -668,6 +838,7 @@ namespace mongo {
                 _txn(txn),
                 _size(0),
                 _dupCount(0),
+                _numSpilled(0),
                 _numEmits(0) {
             _temp.reset( new InMemory() );
             _onDisk = _config.outputOptions.outType != Config::INMEMORY;
@@ -922,96 +1093,38 @@ namespace mongo {
                 return;
             }
 
-            // use index on "0" to pull sorted data
+            // the sorter hands back all spilled tuples grouped by key
             verify( _temp->size() == 0 );
-            BSONObj sortKey = BSON( "0" << 1 );
+            verify( _spilled );
 
-            {
-                Client::WriteContext incCtx(_txn, _config.incLong );
-                Collection* incColl = incCtx.ctx().db()->getCollection( _txn, _config.incLong );
-
-                bool foundIndex = false;
-                IndexCatalog::IndexIterator ii =
-                    incColl->getIndexCatalog()->getIndexIterator( true );
-                // Iterate over incColl's indexes.
-                while ( ii.more() ) {
-                    IndexDescriptor* currIndex = ii.next();
-                    BSONObj x = currIndex->infoObj();
-                    if ( sortKey.woCompare( x["key"].embeddedObject() ) == 0 ) {
-                        foundIndex = true;
-                        break;
-                    }
-                }
-
-                verify( foundIndex );
-            }
+            verify(pm == op->setMessage("m/r: (3/3) final reduce to collection",
+                                        "M/R: (3/3) Final Reduce Progress",
+                                        _numSpilled));
 
-            scoped_ptr<Client::ReadContext> ctx(new Client::ReadContext(_txn, _config.incLong));
+            scoped_ptr<TupleSorter::Iterator> it( _spilled->done() );
+            _spilled.reset();
 
-            BSONObj prev;
             BSONList all;
-
-            verify(pm == op->setMessage("m/r: (3/3) final reduce to collection",
-                                        "M/R: (3/3) Final Reduce Progress",
-                                        _db.count(_config.incLong, BSONObj(), QueryOption_SlaveOk)));
-
-            const NamespaceString nss(_config.incLong);
-            const WhereCallbackReal whereCallback(nss.db());
-
-            CanonicalQuery* cq;
-            verify(CanonicalQuery::canonicalize(_config.incLong,
-                                                BSONObj(),
-                                                sortKey,
-                                                BSONObj(),
-                                                &cq,
-                                                whereCallback).isOK());
-
-            Runner* rawRunner;
-            verify(getRunner(ctx->ctx().db()->getCollection(_txn, _config.incLong),
-                             cq, &rawRunner, QueryPlannerParams::NO_TABLE_SCAN).isOK());
-
-            auto_ptr<Runner> runner(rawRunner);
-            const ScopedRunnerRegistration safety(runner.get());
-
-            // iterate over all sorted objects
-            BSONObj o;
-            Runner::RunnerState state;
-            while (Runner::RUNNER_ADVANCED == (state = runner->getNext(&o, NULL))) {
+            while ( it->more() ) {
+                BSONObj o = it->next().first.getOwned();
                 pm.hit();
 
-                if ( o.woSortOrder( prev , sortKey ) == 0 ) {
-                    // object is same as previous, add to array
-                    all.push_back( o );
-                    if ( pm->hits() % 100 == 0 ) {
-                        _txn->checkForInterrupt();
-                    }
-                    continue;
+                if ( !all.empty() &&
+                        o.firstElement().woCompare( all[0].firstElement() , false ) != 0 ) {
+                    // reduce a finalize array
+                    finalReduce( all );
+                    all.clear();
+                    _txn->checkForInterrupt();
                 }
-
-                runner->saveState();
-
-                ctx.reset();
-
-                // reduce a finalize array
-                finalReduce( all );
-
-                ctx.reset(new Client::ReadContext(_txn, _config.incLong));
-
-                all.clear();
-                prev = o;
-                all.push_back( o );
-
-                if (!runner->restoreState(_txn)) {
-                    break;
+                else if ( pm->hits() % 100 == 0 ) {
+                    _txn->checkForInterrupt();
                 }
 
-                _txn->checkForInterrupt();
+                all.push_back( o );
             }
 
-            ctx.reset();
             // reduce and finalize last array
             finalReduce( all );
-            ctx.reset(new Client::ReadContext(_txn, _config.incLong));
 
             pm.finished();
         }
@@ -1039,7 +1152,7 @@ namespace mongo {
                 if ( all.size() == 1 ) {
                     // only 1 value for this key
                     if ( _onDisk ) {
-                        // this key has low cardinality, so just write to collection
+                        // this key has low cardinality, so just spill it
                         _insertToInc( *(all.begin()) );
                     }
                     else {
@@ -1060,14 +1173,12 @@ namespace mongo {
         }
 
         /**
-         * Dumps the entire in memory map to the inc collection.
+         * Dumps the entire in memory map to the spill sorter.
          */
         void State::dumpToInc() {
             if ( ! _onDisk )
                 return;
 
-            Lock::DBWrite kl(_txn->lockState(), _config.incLong);
-
             for ( InMemory::iterator i=_temp->begin(); i!=_temp->end(); i++ ) {
                 BSONList& all = i->second;
                 if ( all.size() < 1 )
@@ -1143,24 +1254,29 @@ namespace mongo {
         }
 
         /**
-         * emit that will be called by js function
+         * Checks the arguments of an emit() and returns the (key, value) tuple for them.
          */
-        BSONObj fast_emit( const BSONObj& args, void* data ) {
+        static BSONObj _emitTuple( const BSONObj& args ) {
             uassert( 10077 , "fast_emit takes 2 args" , args.nFields() == 2 );
             uassert( 13069 , "an emit can't be more than half max bson size" , args.objsize() < ( BSONObjMaxUserSize / 2 ) );
-            
-            State* state = (State*) data;
+
             if ( args.firstElement().type() == Undefined ) {
                 BSONObjBuilder b( args.objsize() );
                 b.appendNull( "" );
                 BSONObjIterator i( args );
                 i.next();
                 b.append( i.next() );
-                state->emit( b.obj() );
-            }
-            else {
-                state->emit( args );
+                return b.obj();
             }
+            return args;
+        }
+
+        /**
+         * emit that will be called by js function
+         */
+        BSONObj fast_emit( const BSONObj& args, void* data ) {
+            State* state = (State*) data;
+            state->emit( _emitTuple( args ) );
             return BSONObj();
         }
 
@@ -1178,6 +1294,161 @@ namespace mongo {
             return BSONObj();
         }
 
+        /**
+         * Runs the map function of a mixed mode map/reduce on several threads, each with its own
+         * JS scope.  Documents are queued while the collection is read locked and mapped in a
+         * batch once the lock is released.  Emitted tuples reach the State in the order their
+         * documents were queued, so the result doesn't depend on the number of threads.
+         *
+         * The map function can't access the database from these scopes.
+         */
+        class ParallelMapper {
+            MONGO_DISALLOW_COPYING(ParallelMapper);
+        public:
+            ParallelMapper( State* state , int numThreads );
+
+            /**
+             * Queues a copy of 'doc' to be mapped.  Returns true once enough documents are
+             * queued that the caller should flush().
+             */
+            bool add( const BSONObj& doc );
+
+            /**
+             * Maps all queued documents and emits the results into the State.  Must be called
+             * without holding any locks.
+             */
+            void flush();
+
+        private:
+            struct Worker {
+                Worker() : errorCode( 0 ) {}
+
+                scoped_ptr<Scope> scope;
+                scoped_ptr<JSFunction> func;
+
+                // tuples emitted for the slice of the batch this worker mapped
+                BSONList emitted;
+
+                int errorCode;
+                std::string errorMsg;
+            };
+
+            static void _map( Worker* worker , const BSONObj* params ,
+                              const BSONObj* begin , const BSONObj* end );
+            static BSONObj _emit( const BSONObj& args , void* data );
+
+            State* const _state;
+            OwnedPointerVector<Worker> _workers;
+            ThreadPool _pool;
+
+            std::vector<BSONObj> _pending;
+            size_t _pendingBytes;
+        };
+
+        ParallelMapper::ParallelMapper( State* state , int numThreads )
+            : _state( state ),
+              _pool( numThreads ),
+              _pendingBytes( 0 ) {
+            const Config& config = state->config();
+            const string userToken = ClientBasic::getCurrent()->getAuthorizationSession()
+                                                              ->getAuthenticatedUserNamesToken();
+
+            for ( int i = 0; i < numThreads; i++ ) {
+                Worker* worker = new Worker();
+                _workers.mutableVector().push_back( worker );
+
+                worker->scope.reset( globalScriptEngine->getPooledScope(
+                                        config.dbname, "mapreduce" + userToken ).release() );
+                if ( ! config.scopeSetup.isEmpty() )
+                    worker->scope->init( &config.scopeSetup );
+
+                worker->func.reset( new JSFunction( "_map" , config.mapCode.firstElement() ) );
+                worker->func->init( worker->scope.get() );
+                worker->scope->injectNative( "emit" , _emit , worker );
+            }
+
+            _pending.reserve( kMaxPendingDocs );
+        }
+
+        bool ParallelMapper::add( const BSONObj& doc ) {
+            _pending.push_back( doc.getOwned() );
+            _pendingBytes += doc.objsize();
+            return _pending.size() >= kMaxPendingDocs || _pendingBytes >= kMaxPendingBytes;
+        }
+
+        void ParallelMapper::flush() {
+            if ( _pending.empty() )
+                return;
+
+            // Hand each worker a contiguous slice of the batch.
+            const size_t numDocs = _pending.size();
+            const size_t sliceSize = ( numDocs + _workers.size() - 1 ) / _workers.size();
+            size_t numSlices = 0;
+            for ( size_t start = 0; start < numDocs; start += sliceSize ) {
+                const BSONObj* begin = &_pending[start];
+                const BSONObj* end = begin + std::min( sliceSize , numDocs - start );
+                _pool.schedule( &ParallelMapper::_map , _workers[numSlices++] ,
+                                &_state->config().mapParams , begin , end );
+            }
+            _pool.join();
+
+            for ( size_t i = 0; i < numSlices; i++ ) {
+                Worker* worker = _workers[i];
+                if ( worker->errorCode ) {
+                    // fails the map/reduce, as it would have if the map had run on our thread
+                    uasserted( worker->errorCode , worker->errorMsg );
+                }
+
+                for ( BSONList::const_iterator it = worker->emitted.begin();
+                        it != worker->emitted.end(); ++it ) {
+                    _state->emit( *it );
+                }
+                worker->emitted.clear();
+            }
+
+            _pending.clear();
+            _pendingBytes = 0;
+        }
+
+        void ParallelMapper::_map( Worker* worker , const BSONObj* params ,
+                                   const BSONObj* begin , const BSONObj* end ) {
+            // Pool threads have no Client of their own; give them one so that code reached from
+            // the map function that calls cc() finds one.  Note this does not make the map
+            // interruptible: JS interrupt checking is compiled out (see db.cpp).
+            Client::initThreadIfNotAlready( "mapReduceMapper" );
+
+            worker->errorCode = 0;
+            worker->errorMsg.clear();
+            try {
+                Scope* s = worker->func->scope();
+                Scope::NoDBAccess no = s->disableDBAccess( "can't access db inside parallel map" );
+                for ( const BSONObj* doc = begin; doc != end; ++doc ) {
+                    if ( s->invoke( worker->func->func() , params , doc , 0 , true ) )
+                        uasserted( 17525 , str::stream() << "map invoke failed: " << s->getError() );
+                }
+            }
+            catch ( const DBException& e ) {
+                worker->errorCode = e.getCode() ? e.getCode() : 17526;
+                worker->errorMsg = e.what();
+            }
+            catch ( const std::exception& e ) {
+                // Anything thrown out of here would be swallowed by the ThreadPool, losing this
+                // slice's emits without failing the map/reduce.
+                worker->errorCode = 17526;
+                worker->errorMsg = str::stream() << "map failed: " << e.what();
+            }
+            catch ( ... ) {
+                worker->errorCode = 17526;
+                worker->errorMsg = "map failed with an unknown exception";
+            }
+        }
+
+        BSONObj ParallelMapper::_emit( const BSONObj& args , void* data ) {
+            Worker* worker = static_cast<Worker*>( data );
+            worker->emitted.push_back( _emitTuple( args ) );
+            return BSONObj();
+        }
+
         /**
          * This class represents a map/reduce command executed on a single server
          */
@@ -1223,6 +1494,7 @@ namespace mongo {
                 {
                     Client::ReadContext ctx(txn, config.ns);
                     Collection* collection = ctx.ctx().db()->getCollection( txn, config.ns );
+                    uassertStatusOK( checkNotTimePartitioned( txn, collection, "mapReduce" ) );
                     if ( collection )
                         rangePreserver.reset(new RangePreserver(collection));
 
@@ -1279,6 +1551,11 @@ namespace mongo {
                     long long mapTime = 0;
                     long long reduceTime = 0;
                     long long numInputs = 0;
+
+                    scoped_ptr<ParallelMapper> parallelMapper;
+                    if ( !state.jsMode() && config.mapThreads > 1 )
+                        parallelMapper.reset( new ParallelMapper( &state , config.mapThreads ) );
+
                     {
                         // We've got a cursor preventing migrations off, now re-establish our useful cursor
 
@@ -1327,16 +1604,23 @@ namespace mongo {
                             }
 
                             // do map
-                            if ( config.verbose ) mt.reset();
-                            config.mapper->map( o );
-                            if ( config.verbose ) mapTime += mt.micros();
+                            bool batchFull = false;
+                            if ( parallelMapper ) {
+                                // mapped below, once the lock is released
+                                batchFull = parallelMapper->add( o );
+                            }
+                            else {
+                                if ( config.verbose ) mt.reset();
+                                config.mapper->map( o );
+                                if ( config.verbose ) mapTime += mt.micros();
+                            }
 
                             // Check if the state accumulated so far needs to be written to a
                             // collection. This may yield the DB lock temporarily and then 
                             // acquire it again.
                             //
                             numInputs++;
-                            if (numInputs % 100 == 0) {
+                            if (parallelMapper ? batchFull : numInputs % 100 == 0) {
                                 Timer t;
 
                                 // TODO: As an optimization, we might want to do the save/restore
@@ -1344,6 +1628,11 @@ namespace mongo {
                                 // it only happens if necessary.
                                 ctx.reset();
                                 lock.reset();
+                                if ( parallelMapper ) {
+                                    mt.reset();
+                                    parallelMapper->flush();
+                                    mapTime += mt.micros();
+                                }
                                 state.reduceAndSpillInMemoryStateIfNeeded();
                                 lock.reset(new Lock::DBRead(txn->lockState(), config.ns));
                                 ctx.reset(new Client::Context(config.ns, storageGlobalParams.dbpath, false));
@@ -1359,6 +1648,13 @@ namespace mongo {
                                 break;
                         }
                     }
+
+                    if ( parallelMapper ) {
+                        Timer mt;
+                        parallelMapper->flush();
+                        mapTime += mt.micros();
+                        parallelMapper.reset();
+                    }
                     pm.finished();
 
                     txn->checkForInterrupt();
@@ -1462,9 +1758,8 @@ namespace mongo {
                 State state(txn, config);
                 state.init();
 
-                // no need for incremental collection because records are already sorted
+                // no need for the spill sorter because records are already sorted
                 state._useIncremental = false;
-                config.incLong = config.tempNamespace;
 
                 BSONObj shardCounts = cmdObj["shardCounts"].embeddedObjectUserCheck();
                 BSONObj counts = cmdObj["counts"].embeddedObjectUserCheck();
@@ -1596,3 +1891,5 @@ namespace mongo {
 
 }
 
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
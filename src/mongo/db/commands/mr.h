@@ -38,6 +38,7 @@
 #include "mongo/db/curop.h"
 #include "mongo/db/instance.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/sorter/sorter.h"
 #include "mongo/scripting/engine.h"
 
 namespace mongo {
@@ -100,6 +101,11 @@ namespace mongo {
 
             virtual void init( State * state );
 
+            /**
+             * Compiles the function in 'scope', which is not owned and has to outlive us.
+             */
+            void init( Scope * scope );
+
             Scope * scope() const { return _scope; }
             ScriptingFunction func() const { return _func; }
 
@@ -153,6 +159,45 @@ namespace mongo {
 
         };
 
+        // ------------  native implementations -----------
+
+        /**
+         * A reducer built into the server, picked by passing its name instead of a function as
+         * 'reduce'.  It doesn't call into JS at all.
+         *
+         *   "$sum"      - adds up numeric values
+         *   "$min"      - keeps the smallest value
+         *   "$max"      - keeps the largest value
+         *   "$addToSet" - takes arrays and keeps the distinct elements of all of them
+         */
+        class NativeReducer : public Reducer {
+        public:
+            enum Op { SUM, MIN, MAX, ADD_TO_SET };
+
+            /**
+             * Returns a new reducer if 'e' names a built in one, NULL if it isn't a name.
+             * uasserts if it is a name, but not one we know.
+             */
+            static NativeReducer* parse( const BSONElement& e );
+
+            explicit NativeReducer( Op op ) : _op( op ) {}
+
+            virtual void init( State * state ) {}
+
+            virtual BSONObj reduce( const BSONList& tuples );
+            virtual BSONObj finalReduce( const BSONList& tuples , Finalizer * finalizer );
+
+        private:
+            /**
+             * Appends the reduction of the values of 'tuples' to 'b' as 'fieldName'.
+             */
+            void _reduce( const BSONList& tuples ,
+                          BSONObjBuilder& b ,
+                          const StringData& fieldName );
+
+            const Op _op;
+        };
+
         // -----------------
 
 
@@ -196,8 +241,13 @@ namespace mongo {
             BSONObj mapParams;
             BSONObj scopeSetup;
 
+            // The map function, as the only field, so more mappers can be made from it.
+            BSONObj mapCode;
+
+            // number of threads mapping documents at once, each with its own scope
+            int mapThreads;
+
             // output tables
-            std::string incLong;
             std::string tempNamespace;
 
             enum OutputType {
@@ -272,10 +322,9 @@ namespace mongo {
             void reduceInMemory();
 
             /**
-             * transfers in memory storage to temp collection
+             * transfers in memory storage to the spill sorter
              */
             void dumpToInc();
-            void insertToInc( BSONObj& o );
             void _insertToInc( BSONObj& o );
 
             // ------ reduce stage -----------
@@ -289,7 +338,7 @@ namespace mongo {
             // ------- cleanup/data positioning ----------
 
             /**
-             * Clean up the temporary and incremental collections
+             * Clean up the temporary collection
              */
             void dropTempCollections();
 
@@ -333,7 +382,7 @@ namespace mongo {
 
             const Config& _config;
             DBDirectClient _db;
-            bool _useIncremental;   // use an incremental collection
+            bool _useIncremental;   // spill tuples to a sorter before the final reduce
 
         protected:
 
@@ -353,6 +402,11 @@ namespace mongo {
             long _size; // bytes in _temp
             long _dupCount; // number of duplicate key entries
 
+            // Tuples spilled from _temp, sorted by key for the final reduce.  The value is unused.
+            typedef Sorter<BSONObj, BSONObj> TupleSorter;
+            scoped_ptr<TupleSorter> _spilled;
+            long long _numSpilled;
+
             long long _numEmits;
 
             bool _jsMode;
@@ -35,11 +35,13 @@
 #include "mongo/db/auth/action_type.h"
 #include "mongo/db/auth/privilege.h"
 #include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/time_partition.h"
 #include "mongo/db/client.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_buffer_pool.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/expression.h"
@@ -136,6 +138,7 @@ namespace {
 
     private:
         boost::optional<BSONObj> getNextBson() {
+            DocumentBufferPool::Scope bufferPoolScope;
             if (boost::optional<Document> next = _pipeline->output()->getNext()) {
                 if (_includeMetaData) {
                     return next->toBsonWithMetaData();
@@ -201,6 +204,9 @@ namespace {
                                     ? batchSizeElem.numberLong()
                                     : 101; // same as query
 
+        // Documents freed while building this batch are recycled until the batch is done.
+        DocumentBufferPool::Scope bufferPoolScope;
+
         // can't use result BSONObjBuilder directly since it won't handle exceptions correctly.
         BSONArrayBuilder resultsArray;
         const int byteLimit = MaxBytesToReturnToClientAtOnce;
@@ -321,6 +327,7 @@ namespace {
                 Client::ReadContext ctx(txn, ns);
 
                 Collection* collection = ctx.ctx().db()->getCollection(txn, ns);
+                uassertStatusOK(checkNotTimePartitioned(txn, collection, "aggregate"));
 
                 // This does mongod-specific stuff like creating the input Runner and adding to the
                 // front of the pipeline if needed.
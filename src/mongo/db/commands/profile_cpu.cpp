@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * The profileCPU command samples the server's CPU use for a while and returns the sampled
+ * stacks, labeled with the operation each thread was running, in the collapsed format read by
+ * flame graph tools:
+ *     { profileCPU: 1, seconds: 10, frequency: 99, maxSamples: 50000 }
+ *
+ * Unlike _cpuProfilerStart and _cpuProfilerStop, it needs no special build and no access to
+ * the server's filesystem.
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/stats/cpu_sampler.h"
+
+namespace mongo {
+
+    class CmdProfileCPU : public Command {
+    public:
+        CmdProfileCPU() : Command("profileCPU") {}
+
+        virtual bool slaveOk() const { return true; }
+        virtual bool adminOnly() const { return true; }
+        virtual bool isWriteCommandForConfigServer() const { return false; }
+        virtual void addRequiredPrivileges(const std::string& dbname,
+                                           const BSONObj& cmdObj,
+                                           std::vector<Privilege>* out) {
+            ActionSet actions;
+            actions.addAction(ActionType::cpuProfiler);
+            out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+        }
+        virtual void help(stringstream& help) const {
+            help << "samples CPU use for a number of seconds and returns the sampled stacks\n"
+                 << "{ profileCPU: 1, seconds: 10, frequency: 99, maxSamples: 50000 }";
+        }
+
+        virtual bool run(OperationContext* txn,
+                         const string& db,
+                         BSONObj& cmdObj,
+                         int options,
+                         string& errmsg,
+                         BSONObjBuilder& result,
+                         bool fromRepl) {
+            long long seconds;
+            Status status = bsonExtractIntegerFieldWithDefault(cmdObj, "seconds", 10, &seconds);
+            if (!status.isOK())
+                return appendCommandStatus(result, status);
+
+            long long frequency;
+            status = bsonExtractIntegerFieldWithDefault(cmdObj, "frequency", 99, &frequency);
+            if (!status.isOK())
+                return appendCommandStatus(result, status);
+
+            long long maxSamples;
+            status = bsonExtractIntegerFieldWithDefault(cmdObj, "maxSamples", 50000, &maxSamples);
+            if (!status.isOK())
+                return appendCommandStatus(result, status);
+
+            // Values that don't fit in an int are clamped so that profile() rejects them.
+            const long long kMax = 1LL << 30;
+            status = CpuSampler::profile(static_cast<int>(std::min(frequency, kMax)),
+                                         static_cast<int>(std::min(seconds, kMax)),
+                                         static_cast<int>(std::min(maxSamples, kMax)),
+                                         &result);
+            if (!status.isOK())
+                return appendCommandStatus(result, status);
+            return true;
+        }
+    } cmdProfileCPU;
+
+}  // namespace mongo
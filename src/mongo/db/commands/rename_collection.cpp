@@ -31,6 +31,7 @@
 #include "mongo/client/dbclientcursor.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog/time_partition.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/rename_collection.h"
 #include "mongo/db/dbhelpers.h"
@@ -147,6 +148,15 @@ namespace mongo {
                     return false;
                 }
 
+                // The partitions' names derive from the parent's, so renaming it would orphan
+                // them.
+                if ( sourceColl->getTimePartitionOptions( txn ).isSet() ) {
+                    return appendCommandStatus( result,
+                        Status( ErrorCodes::IllegalOperation,
+                                str::stream() << "can't rename time partitioned collection "
+                                              << source ) );
+                }
+
                 // Ensure that collection name does not exceed maximum length.
                 // Ensure that index names do not push the length over the max.
                 // Iterator includes unfinished indexes.
@@ -43,6 +43,7 @@
 #include "mongo/db/stats/counters.h"
 #include "mongo/platform/process_id.h"
 #include "mongo/util/net/listen.h"
+#include "mongo/util/net/message_buffer_pool.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/ramlog.h"
 #include "mongo/util/version.h"
@@ -252,6 +253,9 @@ namespace mongo {
             BSONObj generateSection(const BSONElement& configElement) const {
                 BSONObjBuilder b;
                 networkCounter.append( b );
+                BSONObjBuilder messageBuffers( b.subobjStart( "messageBuffers" ) );
+                MessageBufferPool::appendStats( &messageBuffers );
+                messageBuffers.done();
                 return b.obj();
             }
                 
@@ -31,6 +31,7 @@
 #include <memory>
 
 #include "mongo/base/error_codes.h"
+#include "mongo/db/catalog/time_partition.h"
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/instance.h"
@@ -623,11 +624,13 @@ namespace mongo {
 
     static void singleInsert( OperationContext* txn,
                               const BSONObj& docToInsert,
+                              Database* database,
                               Collection* collection,
                               WriteOpResult* result );
 
     static void singleCreateIndex( OperationContext* txn,
                                    const BSONObj& indexDesc,
+                                   Database* database,
                                    Collection* collection,
                                    WriteOpResult* result );
 
@@ -690,6 +693,11 @@ namespace mongo {
          */
         Collection* getCollection() { return _collection; }
 
+        /**
+         * Gets the target database.  Value is undefined unless hasLock() is true.
+         */
+        Database* getDatabase() { return _context->db(); }
+
         OperationContext* txn;
 
         // Request object describing the inserts.
@@ -964,10 +972,18 @@ namespace mongo {
         try {
             if (state->lockAndCheck(result)) {
                 if (!state->request->isInsertIndexRequest()) {
-                    singleInsert(state->txn, insertDoc, state->getCollection(), result);
+                    singleInsert(state->txn,
+                                 insertDoc,
+                                 state->getDatabase(),
+                                 state->getCollection(),
+                                 result);
                 }
                 else {
-                    singleCreateIndex(state->txn, insertDoc, state->getCollection(), result);
+                    singleCreateIndex(state->txn,
+                                      insertDoc,
+                                      state->getDatabase(),
+                                      state->getCollection(),
+                                      result);
                 }
             }
         }
@@ -1014,15 +1030,28 @@ namespace mongo {
 
     /**
      * Perform a single insert into a collection.  Requires the insert be preprocessed and the
-     * collection already has been created.
+     * collection already has been created.  Inserts into a time partitioned collection go to
+     * the partition of the document, which is created if needed.
      *
      * Might fault or error, otherwise populates the result.
      */
     static void singleInsert( OperationContext* txn,
                               const BSONObj& docToInsert,
+                              Database* database,
                               Collection* collection,
                               WriteOpResult* result ) {
 
+        const TimePartitionOptions timePartition = collection->getTimePartitionOptions( txn );
+        if ( timePartition.isSet() ) {
+            StatusWith<Collection*> partition =
+                getTimePartitionForInsert( txn, database, collection, timePartition, docToInsert );
+            if ( !partition.isOK() ) {
+                result->setError(toWriteError(partition.getStatus()));
+                return;
+            }
+            collection = partition.getValue();
+        }
+
         const string& insertNS = collection->ns().ns();
 
         Lock::assertWriteLocked( insertNS );
@@ -1041,12 +1070,14 @@ namespace mongo {
 
     /**
      * Perform a single index insert into a collection.  Requires the index descriptor be
-     * preprocessed and the collection already has been created.
+     * preprocessed and the collection already has been created.  An index on a time
+     * partitioned collection is also built on its existing partitions.
      *
      * Might fault or error, otherwise populates the result.
      */
     static void singleCreateIndex( OperationContext* txn,
                                    const BSONObj& indexDesc,
+                                   Database* database,
                                    Collection* collection,
                                    WriteOpResult* result ) {
 
@@ -1064,6 +1095,11 @@ namespace mongo {
         }
         else {
             repl::logOp( txn, "i", indexNS.c_str(), indexDesc );
+            status = createTimePartitionIndexes( txn, database, collection, indexDesc );
+            if ( !status.isOK() ) {
+                result->setError(toWriteError(status));
+                return;
+            }
             result->getStats().n = 1;
         }
     }
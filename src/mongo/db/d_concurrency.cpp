@@ -36,6 +36,7 @@
 #include "mongo/db/d_globals.h"
 #include "mongo/db/lockstat.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/stats/operation_latency.h"
 #include "mongo/server.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/concurrency/mapsf.h"
@@ -237,6 +238,7 @@ namespace mongo {
 
         // increment the operation level statistics
         cc().curop()->lockStat().recordAcquireTimeMicros( _type , acquisitionTime );
+        globalLatencyStats.recordLockAcquire( acquisitionTime );
 
         return acquisitionTime;
     }
@@ -75,6 +75,7 @@
 #include "mongo/db/repl/repl_start.h"
 #include "mongo/db/repl/rs.h"
 #include "mongo/db/restapi.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/startup_warnings.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/db/stats/snapshots.h"
@@ -84,6 +85,7 @@
 #include "mongo/db/storage/mmap_v1/mmap_v1_extent_manager.h"
 #include "mongo/db/storage_options.h"
 #include "mongo/db/ttl.h"
+#include "mongo/logger/buffered_log_writer.h"
 #include "mongo/platform/process_id.h"
 #include "mongo/s/d_writeback.h"
 #include "mongo/scripting/engine.h"
@@ -595,6 +597,10 @@ namespace mongo {
         } memJournalServerStatusMetric;
     }
 
+    // How many JS scopes to keep created ahead of time, so that $where, map/reduce and eval
+    // don't pay for setting up a new scope when none of the pooled ones can be reused.
+    MONGO_EXPORT_STARTUP_SERVER_PARAMETER(jsPrewarmedScopes, int, 0);
+
 
 #if 0 // TODO SERVER-14143 figure out something better. For now just disabling js interruption.
     const char * jsInterruptCallback() {
@@ -732,6 +738,9 @@ namespace mongo {
             globalScriptEngine->setCheckInterruptCallback( jsInterruptCallback );
             globalScriptEngine->setGetCurrentOpIdCallback( jsGetCurrentOpIdCallback );
 #endif
+            if (jsPrewarmedScopes > 0) {
+                globalScriptEngine->setNumPrewarmedScopes(jsPrewarmedScopes);
+            }
         }
 
         // On replica set members we only clear temp collections on DBs other than "local" during
@@ -835,11 +844,13 @@ static int mongoDbMain(int argc, char* argv[], char** envp);
 int wmain(int argc, wchar_t* argvW[], wchar_t* envpW[]) {
     WindowsCommandLine wcl(argc, argvW, envpW);
     int exitCode = mongoDbMain(argc, wcl.argv(), wcl.envp());
+    logger::BufferedLogWriter::flushAll();
     ::_exit(exitCode);
 }
 #else
 int main(int argc, char* argv[], char** envp) {
     int exitCode = mongoDbMain(argc, argv, envp);
+    logger::BufferedLogWriter::flushAll();
     ::_exit(exitCode);
 }
 #endif
@@ -1023,8 +1034,10 @@ static int mongoDbMain(int argc, char* argv[], char **envp) {
     startupConfigActions(std::vector<std::string>(argv, argv + argc));
     cmdline_utils::censorArgvArray(argc, argv);
 
-    if (!initializeServerGlobalState())
+    if (!initializeServerGlobalState()) {
+        logger::BufferedLogWriter::flushAll();
         ::_exit(EXIT_FAILURE);
+    }
 
     // Per SERVER-7434, startSignalProcessingThread() must run after any forks
     // (initializeServerGlobalState()) and before creation of any other threads.
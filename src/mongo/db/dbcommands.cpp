@@ -70,6 +70,7 @@
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/catalog/database_catalog_entry.h"
+#include "mongo/db/catalog/time_partition.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/s/d_logic.h"
 #include "mongo/s/d_writeback.h"
@@ -480,6 +481,15 @@ namespace mongo {
             result.append( "ns", nsToDrop );
             result.append( "nIndexesWas", numIndexes );
 
+            // Drop the partitions of a time partitioned collection first.  Each drop is logged
+            // on its own, so a secondary has already dropped them when it replays this.
+            if ( !fromRepl ) {
+                Status s = dropTimePartitions( txn, db, coll );
+                if ( !s.isOK() ) {
+                    return appendCommandStatus( result, s );
+                }
+            }
+
             Status s = db->dropCollection( txn, nsToDrop );
 
             if ( s.isOK() ) {
@@ -1479,6 +1489,20 @@ namespace mongo {
             return;
         }
 
+        // Handle command option afterOpTime.  Waits before _execCommand takes any locks.
+        StatusWith<OpTime> afterOpTime = LiteParsedQuery::parseAfterOpTimeCommand(cmdObj);
+        if (!afterOpTime.isOK()) {
+            appendCommandStatus(result, afterOpTime.getStatus());
+            return;
+        }
+        Status afterOpTimeStatus = repl::waitForReadAfterOptime(txn,
+                                                                afterOpTime.getValue(),
+                                                                maxTimeMS.getValue());
+        if (!afterOpTimeStatus.isOK()) {
+            appendCommandStatus(result, afterOpTimeStatus);
+            return;
+        }
+
         std::string errmsg;
         bool retval = false;
 
@@ -1507,12 +1531,11 @@ namespace mongo {
        usage:
          abc.$cmd.findOne( { ismaster:1 } );
 
-       returns true if ran a cmd
+       returns true if ran a cmd, with the reply in anObjBuilder
     */
     bool _runCommands(OperationContext* txn,
                       const char* ns,
                       BSONObj& _cmdobj,
-                      BufBuilder& b,
                       BSONObjBuilder& anObjBuilder,
                       bool fromRepl, int queryOptions) {
         string dbname = nsToDatabase( ns );
@@ -1537,8 +1560,7 @@ namespace mongo {
                                                  "cannot use $maxTimeMS query option with "
                                                     "commands; use maxTimeMS command option "
                                                     "instead");
-                    BSONObj x = anObjBuilder.done();
-                    b.appendBuf(x.objdata(), x.objsize());
+                    anObjBuilder.done();
                     return true;
                 }
             }
@@ -1570,8 +1592,7 @@ namespace mongo {
             anObjBuilder.append("bad cmd" , _cmdobj );
         }
 
-        BSONObj x = anObjBuilder.done();
-        b.appendBuf(x.objdata(), x.objsize());
+        anObjBuilder.done();
 
         return true;
     }
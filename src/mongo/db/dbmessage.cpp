@@ -65,6 +65,92 @@ namespace mongo {
         return ss.str();
     }
 
+    const int ReplyBuilder::kMinChunkBytes =
+        16 * 1024 - MessageBufferPool::kOverheadBytes;
+    const int ReplyBuilder::kMaxChunkBytes =
+        MessageBufferPool::kMaxClassBytes - MessageBufferPool::kOverheadBytes;
+
+    ReplyBuilder::ReplyBuilder()
+        : _lastChunkCapacity(0),
+          _nextChunkBytes(kMinChunkBytes),
+          _len(0) {
+        _newChunk(sizeof(QueryResult));
+        _chunks.back().second = sizeof(QueryResult);
+        _len = sizeof(QueryResult);
+    }
+
+    ReplyBuilder::~ReplyBuilder() {
+        for (size_t i = 0; i < _chunks.size(); ++i) {
+            MessageBufferPool::release(_chunks[i].first);
+        }
+    }
+
+    void ReplyBuilder::appendBuf(const void* data, int size) {
+        if (size <= 0) {
+            return;
+        }
+        verify(!_chunks.empty());
+        if (_chunks.back().second + size > _lastChunkCapacity) {
+            _newChunk(size);
+        }
+        std::pair<char*, int>& chunk = _chunks.back();
+        memcpy(chunk.first + chunk.second, data, size);
+        chunk.second += size;
+        _len += size;
+    }
+
+    void ReplyBuilder::_newChunk(int minSize) {
+        const int capacity = std::max(minSize, _nextChunkBytes);
+        _nextChunkBytes = std::min(_nextChunkBytes * 2, kMaxChunkBytes);
+
+        _chunks.reserve(_chunks.size() + 1);
+        _chunks.push_back(std::make_pair(static_cast<char*>(MessageBufferPool::allocate(capacity)),
+                                         0));
+        _lastChunkCapacity = capacity;
+    }
+
+    void ReplyBuilder::done(Message* result,
+                            int queryResultFlags,
+                            long long cursorId,
+                            int startingFrom,
+                            int nReturned) {
+        verify(!_chunks.empty());
+        verify(result->empty());
+
+        // Every chunk holds at least one byte, so the message takes each of them.  An entry is
+        // cleared once handed over, leaving the destructor to release the rest if that throws.
+        for (size_t i = 0; i < _chunks.size(); ++i) {
+            result->appendPooledData(_chunks[i].first, _chunks[i].second);
+            _chunks[i].first = NULL;
+        }
+        _chunks.clear();
+
+        QueryResult* qr = static_cast<QueryResult*>(result->header());
+        qr->setOperation(opReply);
+        qr->_resultFlags() = queryResultFlags;
+        qr->cursorId = cursorId;
+        qr->startingFrom = startingFrom;
+        qr->nReturned = nReturned;
+    }
+
+    /**
+     * Builds an opReply carrying "data" in a buffer from MessageBufferPool.
+     */
+    static QueryResult* newPooledReply(int queryResultFlags,
+                                       const void* data, int size,
+                                       int nReturned, int startingFrom,
+                                       long long cursorId) {
+        const int len = sizeof(QueryResult) + size;
+        QueryResult* qr = static_cast<QueryResult*>(MessageBufferPool::allocate(len));
+        memcpy(reinterpret_cast<char*>(qr) + sizeof(QueryResult), data, size);
+        qr->_resultFlags() = queryResultFlags;
+        qr->len = len;
+        qr->setOperation(opReply);
+        qr->cursorId = cursorId;
+        qr->startingFrom = startingFrom;
+        qr->nReturned = nReturned;
+        return qr;
+    }
 
     void replyToQuery(int queryResultFlags,
                       AbstractMessagingPort* p, Message& requestMsg,
@@ -72,18 +158,9 @@ namespace mongo {
                       int nReturned, int startingFrom,
                       long long cursorId 
                       ) {
-        BufBuilder b(32768);
-        b.skip(sizeof(QueryResult));
-        b.appendBuf(data, size);
-        QueryResult *qr = (QueryResult *) b.buf();
-        qr->_resultFlags() = queryResultFlags;
-        qr->len = b.len();
-        qr->setOperation(opReply);
-        qr->cursorId = cursorId;
-        qr->startingFrom = startingFrom;
-        qr->nReturned = nReturned;
-        b.decouple();
-        Message resp(qr, true);
+        Message resp;
+        resp.setPooledData(newPooledReply(queryResultFlags, data, size,
+                                          nReturned, startingFrom, cursorId));
         p->reply(requestMsg, resp, requestMsg.header()->id);
     }
 
@@ -103,22 +180,10 @@ namespace mongo {
     }
 
     void replyToQuery( int queryResultFlags, Message& response, const BSONObj& resultObj ) {
-        BufBuilder bufBuilder;
-        bufBuilder.skip( sizeof( QueryResult ));
-        bufBuilder.appendBuf( reinterpret_cast< void *>(
-                const_cast< char* >( resultObj.objdata() )), resultObj.objsize() );
-
-        QueryResult* queryResult = reinterpret_cast< QueryResult* >( bufBuilder.buf() );
-        bufBuilder.decouple();
-
-        queryResult->_resultFlags() = queryResultFlags;
-        queryResult->len = bufBuilder.len();
-        queryResult->setOperation( opReply );
-        queryResult->cursorId = 0;
-        queryResult->startingFrom = 0;
-        queryResult->nReturned = 1;
-
-        response.setData( queryResult, true ); // transport will free
+        // transport will release
+        response.setPooledData( newPooledReply( queryResultFlags,
+                                                resultObj.objdata(), resultObj.objsize(),
+                                                1, 0, 0 ) );
     }
 
 }
@@ -30,6 +30,10 @@
 
 #pragma once
 
+#include <utility>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
 #include "mongo/bson/bson_validate.h"
 #include "mongo/client/constants.h"
 #include "mongo/db/jsobj.h"
@@ -293,6 +297,51 @@ namespace mongo {
         ~DbResponse() { delete response; }
     };
 
+    /**
+     * Builds the documents of an OP_REPLY in a chain of pooled buffers rather than one growing
+     * buffer, so a large batch is copied into place once instead of again on every realloc(),
+     * and the chain goes out with a single scatter-gather send.
+     *
+     * Buffers start at kMinChunkBytes and double up to kMaxChunkBytes; a document larger than
+     * the buffer being filled gets one of its own.
+     */
+    class ReplyBuilder {
+        MONGO_DISALLOW_COPYING(ReplyBuilder);
+    public:
+        static const int kMinChunkBytes;
+        static const int kMaxChunkBytes;
+
+        ReplyBuilder();
+        ~ReplyBuilder();
+
+        void appendBuf(const void* data, int size);
+        void append(const BSONObj& obj) { appendBuf(obj.objdata(), obj.objsize()); }
+
+        /**
+         * Bytes in the reply so far, including its header.
+         */
+        int len() const { return _len; }
+
+        /**
+         * Hands the reply to the empty message 'result' and fills in its header.  Nothing may be
+         * appended afterwards.
+         */
+        void done(Message* result,
+                  int queryResultFlags,
+                  long long cursorId,
+                  int startingFrom,
+                  int nReturned);
+
+    private:
+        void _newChunk(int minSize);
+
+        // Each buffer with the number of bytes written to it.
+        std::vector<std::pair<char*, int> > _chunks;
+        int _lastChunkCapacity;
+        int _nextChunkBytes;
+        int _len;
+    };
+
     void replyToQuery(int queryResultFlags,
                       AbstractMessagingPort* p, Message& requestMsg,
                       void *data, int size,
@@ -0,0 +1,139 @@
+/*    Copyright 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+
+#include "mongo/db/dbmessage.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+    using mongo::BSONObj;
+    using mongo::BSONObjBuilder;
+    using mongo::Message;
+    using mongo::QueryResult;
+    using mongo::ReplyBuilder;
+
+    BSONObj makeDoc(int i, int padding) {
+        BSONObjBuilder b;
+        b.append("_id", i);
+        b.append("pad", std::string(padding, 'x'));
+        return b.obj();
+    }
+
+    /**
+     * Checks that the flattened reply in 'm' holds 'n' documents made by makeDoc().
+     */
+    void assertReplyHolds(Message& m, int n, int padding) {
+        m.concat();
+        QueryResult* qr = reinterpret_cast<QueryResult*>(m.singleData());
+        ASSERT_EQUALS(mongo::opReply, qr->operation());
+        ASSERT_EQUALS(n, qr->nReturned);
+
+        const char* data = qr->data();
+        for (int i = 0; i < n; ++i) {
+            BSONObj doc(data);
+            ASSERT_EQUALS(makeDoc(i, padding), doc);
+            data += doc.objsize();
+        }
+        ASSERT_EQUALS(reinterpret_cast<const char*>(qr) + qr->len, data);
+    }
+
+    TEST(ReplyBuilder, EmptyReplyIsJustHeader) {
+        ReplyBuilder bb;
+        ASSERT_EQUALS(static_cast<int>(sizeof(QueryResult)), bb.len());
+
+        Message m;
+        bb.done(&m, mongo::ResultFlag_AwaitCapable, 0, 0, 0);
+        ASSERT_EQUALS(static_cast<int>(sizeof(QueryResult)), m.size());
+        ASSERT_EQUALS(m.size(), m.header()->len);
+        assertReplyHolds(m, 0, 0);
+    }
+
+    TEST(ReplyBuilder, SmallReplyIsOneBuffer) {
+        ReplyBuilder bb;
+        for (int i = 0; i < 10; ++i) {
+            bb.append(makeDoc(i, 10));
+        }
+
+        Message m;
+        bb.done(&m, mongo::ResultFlag_AwaitCapable, 42, 7, 10);
+        m.singleData();
+        QueryResult* qr = static_cast<QueryResult*>(m.header());
+        ASSERT_EQUALS(42, qr->cursorId);
+        ASSERT_EQUALS(7, qr->startingFrom);
+        ASSERT_EQUALS(mongo::ResultFlag_AwaitCapable, qr->resultFlags());
+        assertReplyHolds(m, 10, 10);
+    }
+
+    TEST(ReplyBuilder, LargeReplySpansBuffers) {
+        ReplyBuilder bb;
+        const int n = 500;
+        for (int i = 0; i < n; ++i) {
+            bb.append(makeDoc(i, 1000));
+        }
+        ASSERT_GREATER_THAN(bb.len(), ReplyBuilder::kMaxChunkBytes);
+
+        Message m;
+        const int len = bb.len();
+        bb.done(&m, mongo::ResultFlag_AwaitCapable, 0, 0, n);
+        ASSERT_EQUALS(len, m.size());
+        ASSERT_EQUALS(len, m.header()->len);
+        assertReplyHolds(m, n, 1000);
+    }
+
+    TEST(ReplyBuilder, OversizedDocumentGetsItsOwnBuffer) {
+        ReplyBuilder bb;
+        bb.append(makeDoc(0, 10));
+        bb.append(makeDoc(1, ReplyBuilder::kMaxChunkBytes * 2));
+        bb.append(makeDoc(2, 10));
+
+        Message m;
+        bb.done(&m, mongo::ResultFlag_AwaitCapable, 0, 0, 3);
+        ASSERT_EQUALS(m.header()->len, m.size());
+
+        m.concat();
+        QueryResult* qr = reinterpret_cast<QueryResult*>(m.singleData());
+        const char* data = qr->data();
+        for (int i = 0; i < 3; ++i) {
+            BSONObj doc(data);
+            ASSERT_EQUALS(i, doc["_id"].numberInt());
+            data += doc.objsize();
+        }
+    }
+
+    TEST(ReplyBuilder, UnfinishedReplyIsReleased) {
+        ReplyBuilder bb;
+        for (int i = 0; i < 100; ++i) {
+            bb.append(makeDoc(i, 1000));
+        }
+    }
+
+}  // namespace
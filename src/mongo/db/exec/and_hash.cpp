@@ -500,6 +500,7 @@ namespace mongo {
 
         _specificStats.memLimit = _maxMemUsage;
         _specificStats.memUsage = _memUsage;
+        _specificStats.workingSetMemUsage = _ws->getMemUsage();
 
         auto_ptr<PlanStageStats> ret(new PlanStageStats(_commonStats, STAGE_AND_HASH));
         ret->specific.reset(new AndHashStats(_specificStats));
@@ -33,6 +33,7 @@
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/util/fail_point_service.h"
 
 #include "mongo/db/client.h" // XXX-ERH
@@ -45,7 +46,15 @@ namespace mongo {
         : _workingSet(workingSet),
           _filter(filter),
           _params(params),
-          _nsDropped(false) { }
+          _nsDropped(false) {
+
+        if (NULL != _filter && internalQueryCompileMatchExpressions) {
+            _compiledFilter.reset(new CompiledMatcher(_filter));
+            if (!_compiledFilter->hasCompiledSteps()) {
+                _compiledFilter.reset();
+            }
+        }
+    }
 
     PlanStage::StageState CollectionScan::work(WorkingSetID* out) {
         ++_commonStats.works;
@@ -95,7 +104,9 @@ namespace mongo {
 
         ++_specificStats.docsTested;
 
-        if (Filter::passes(member, _filter)) {
+        const bool passes = _compiledFilter ? _compiledFilter->matchesBSON(member->obj)
+                                            : Filter::passes(member, _filter);
+        if (passes) {
             *out = id;
             ++_commonStats.advanced;
             return PlanStage::ADVANCED;
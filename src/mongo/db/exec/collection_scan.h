@@ -31,6 +31,7 @@
 #include "mongo/db/diskloc.h"
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/matcher/compiled_matcher.h"
 #include "mongo/db/matcher/expression.h"
 
 namespace mongo {
@@ -70,6 +71,9 @@ namespace mongo {
         // The filter is not owned by us.
         const MatchExpression* _filter;
 
+        // '_filter' flattened for faster evaluation over each record, if worth it. May be NULL.
+        scoped_ptr<CompiledMatcher> _compiledFilter;
+
         scoped_ptr<RecordIterator> _iter;
 
         CollectionScanParams _params;
@@ -32,8 +32,10 @@
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/pdfile.h"
+#include "mongo/db/stats/operation_latency.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -76,7 +78,11 @@ namespace mongo {
 
                 // Don't need index data anymore as we have an obj.
                 member->keyData.clear();
+                // Constructing the BSONObj reads the record's size, so a page fault on the
+                // record is taken, and timed, here.
+                Timer fetchTimer;
                 member->obj = _collection->docFor(member->loc);
+                globalLatencyStats.recordStorageFetch(fetchTimer.micros());
                 member->state = WorkingSetMember::LOC_AND_UNOWNED_OBJ;
             }
 
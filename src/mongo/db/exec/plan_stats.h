@@ -127,7 +127,8 @@ namespace mongo {
         AndHashStats() : flaggedButPassed(0),
                          flaggedInProgress(0),
                          memUsage(0),
-                         memLimit(0) { }
+                         memLimit(0),
+                         workingSetMemUsage(0) { }
 
         virtual ~AndHashStats() { }
 
@@ -156,6 +157,9 @@ namespace mongo {
 
         // What's our memory limit?
         size_t memLimit;
+
+        // How much memory does the working set we share with the rest of the plan use?
+        size_t workingSetMemUsage;
     };
 
     struct AndSortedStats : public SpecificStats {
@@ -323,7 +327,12 @@ namespace mongo {
     };
 
     struct SortStats : public SpecificStats {
-        SortStats() : forcedFetches(0), memUsage(0), memLimit(0) { }
+        SortStats() : forcedFetches(0),
+                      memUsage(0),
+                      memLimit(0),
+                      workingSetMemUsage(0),
+                      spilledBytes(0),
+                      spillFiles(0) { }
 
         virtual ~SortStats() { }
 
@@ -340,6 +349,14 @@ namespace mongo {
 
         // What's our memory limit?
         size_t memLimit;
+
+        // How much memory does the working set we share with the rest of the plan use?
+        size_t workingSetMemUsage;
+
+        // How much buffered data did we write to disk, and in how many sorted runs?  Both are 0
+        // unless we exceeded memLimit with disk use allowed.
+        unsigned long long spilledBytes;
+        size_t spillFiles;
     };
 
     struct MergeSortStats : public SpecificStats {
@@ -412,7 +429,7 @@ namespace mongo {
     };
 
     struct TextStats : public SpecificStats {
-        TextStats() : keysExamined(0), fetches(0), parsedTextQuery() { }
+        TextStats() : keysExamined(0), fetches(0), topK(0), parsedTextQuery() { }
 
         virtual SpecificStats* clone() const {
             TextStats* specific = new TextStats(*this);
@@ -423,6 +440,9 @@ namespace mongo {
 
         size_t fetches;
 
+        // How many of the highest scoring documents were asked for, or 0 if all of them were.
+        size_t topK;
+
         // Human-readable form of the FTSQuery associated with the text stage.
         BSONObj parsedTextQuery;
     };
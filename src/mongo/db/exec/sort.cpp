@@ -43,7 +43,58 @@ namespace mongo {
 
     using std::vector;
 
-    const size_t kMaxBytes = 32 * 1024 * 1024;
+    const size_t SortStageParams::kDefaultMaxMemoryUsageBytes;
+
+namespace {
+
+    /**
+     * Orders spilled documents the same way WorkingSetComparator orders buffered ones.
+     */
+    class SpillComparator {
+    public:
+        typedef std::pair<BSONObj, SortStageSpilledDocument> Data;
+
+        explicit SpillComparator(const BSONObj& pattern) : _pattern(pattern) { }
+
+        int operator()(const Data& lhs, const Data& rhs) const {
+            // False means ignore field names.
+            int result = lhs.first.woCompare(rhs.first, _pattern, false);
+            if (0 != result) {
+                return result;
+            }
+            return lhs.second.loc.compare(rhs.second.loc);
+        }
+
+    private:
+        BSONObj _pattern;
+    };
+
+}  // namespace
+
+    void SortStageSpilledDocument::serializeForSorter(BufBuilder& buf) const {
+        loc.serializeForSorter(buf);
+        obj.serializeForSorter(buf);
+    }
+
+    SortStageSpilledDocument SortStageSpilledDocument::deserializeForSorter(
+            BufReader& buf,
+            const SorterDeserializeSettings&) {
+        const DiskLoc dl = DiskLoc::deserializeForSorter(buf, DiskLoc::SorterDeserializeSettings());
+        const BSONObj o = BSONObj::deserializeForSorter(buf, BSONObj::SorterDeserializeSettings());
+        return SortStageSpilledDocument(dl, o);
+    }
+
+    int SortStageSpilledDocument::memUsageForSorter() const {
+        return loc.memUsageForSorter() + obj.memUsageForSorter();
+    }
+
+    SortStageSpilledDocument SortStageSpilledDocument::getOwned() const {
+        return SortStageSpilledDocument(loc, obj.getOwned());
+    }
+
+    std::ostream& operator<<(std::ostream& stream, const SortStageSpilledDocument& doc) {
+        return stream << doc.loc << ' ' << doc.obj;
+    }
 
     SortStageKeyGenerator::SortStageKeyGenerator(const Collection* collection,
                                                  const BSONObj& sortSpec,
@@ -284,6 +335,9 @@ namespace mongo {
           _pattern(params.pattern),
           _query(params.query),
           _limit(params.limit),
+          _maxMemoryUsageBytes(params.maxMemoryUsageBytes),
+          _allowDiskUse(params.allowDiskUse),
+          _tempDir(params.tempDir),
           _sorted(false),
           _resultIterator(_data.end()),
           _memUsage(0) {
@@ -294,7 +348,13 @@ namespace mongo {
     bool SortStage::isEOF() {
         // We're done when our child has no more results, we've sorted the child's results, and
         // we've returned all sorted results.
-        return _child->isEOF() && _sorted && (_data.end() == _resultIterator);
+        if (!_child->isEOF() || !_sorted) {
+            return false;
+        }
+        if (_spillIterator) {
+            return !_spillIterator->more();
+        }
+        return _data.end() == _resultIterator;
     }
 
     PlanStage::StageState SortStage::work(WorkingSetID* out) {
@@ -313,13 +373,21 @@ namespace mongo {
             return PlanStage::NEED_TIME;
         }
 
-        if (_memUsage > kMaxBytes) {
-            mongoutils::str::stream ss;
-            ss << "sort stage buffered data usage of " << _memUsage
-               << " bytes exceeds internal limit of " << kMaxBytes << " bytes";
-            Status status(ErrorCodes::Overflow, ss);
-            *out = WorkingSetCommon::allocateStatusMember( _ws, status);
-            return PlanStage::FAILURE;
+        if (_memUsage > _maxMemoryUsageBytes) {
+            if (!_allowDiskUse) {
+                mongoutils::str::stream ss;
+                ss << "sort stage buffered data usage of " << _memUsage
+                   << " bytes exceeds internal limit of " << _maxMemoryUsageBytes << " bytes";
+                Status status(ErrorCodes::Overflow, ss);
+                *out = WorkingSetCommon::allocateStatusMember( _ws, status);
+                return PlanStage::FAILURE;
+            }
+
+            Status status = startSpilling();
+            if (!status.isOK()) {
+                *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+                return PlanStage::FAILURE;
+            }
         }
 
         if (isEOF()) { return PlanStage::IS_EOF; }
@@ -346,10 +414,22 @@ namespace mongo {
                 // The data remains in the WorkingSet and we wrap the WSID with the sort key.
                 SortableDataItem item;
                 Status sortKeyStatus = _sortKeyGen->getSortKey(*member, &item.sortKey);
-                if (!_sortKeyGen->getSortKey(*member, &item.sortKey).isOK()) {
+                if (!sortKeyStatus.isOK()) {
                     *out = WorkingSetCommon::allocateStatusMember(_ws, sortKeyStatus);
                     return PlanStage::FAILURE;
                 }
+
+                // Once we've spilled, everything else goes straight to the sorter.
+                if (_sorter) {
+                    Status spillStatus = spill(id, item.sortKey);
+                    if (!spillStatus.isOK()) {
+                        *out = WorkingSetCommon::allocateStatusMember(_ws, spillStatus);
+                        return PlanStage::FAILURE;
+                    }
+                    ++_commonStats.needTime;
+                    return PlanStage::NEED_TIME;
+                }
+
                 item.wsid = id;
                 if (member->hasLoc()) {
                     // The DiskLoc breaks ties when sorting two WSMs with the same sort key.
@@ -364,8 +444,22 @@ namespace mongo {
             else if (PlanStage::IS_EOF == code) {
                 // TODO: We don't need the lock for this.  We could ask for a yield and do this work
                 // unlocked.  Also, this is performing a lot of work for one call to work(...)
-                sortBuffer();
-                _resultIterator = _data.begin();
+                if (_sorter) {
+                    try {
+                        _spillIterator.reset(_sorter->done());
+                    }
+                    catch (const DBException& e) {
+                        *out = WorkingSetCommon::allocateStatusMember(_ws, e.toStatus());
+                        return PlanStage::FAILURE;
+                    }
+                    _specificStats.spilledBytes = _sorter->spilledBytes();
+                    _specificStats.spillFiles = _sorter->numFiles();
+                    _sorter.reset();
+                }
+                else {
+                    sortBuffer();
+                    _resultIterator = _data.begin();
+                }
                 _sorted = true;
                 ++_commonStats.needTime;
                 return PlanStage::NEED_TIME;
@@ -392,6 +486,28 @@ namespace mongo {
         }
 
         // Returning results.
+        if (_spillIterator) {
+            verify(_sorted);
+            SpillSorter::Data data;
+            try {
+                data = _spillIterator->next();
+            }
+            catch (const DBException& e) {
+                *out = WorkingSetCommon::allocateStatusMember(_ws, e.toStatus());
+                return PlanStage::FAILURE;
+            }
+
+            // Spilled results are always owned, and their DiskLocs are not tracked for
+            // invalidation.
+            *out = _ws->allocate();
+            WorkingSetMember* member = _ws->get(*out);
+            member->obj = data.second.obj.getOwned();
+            member->state = WorkingSetMember::OWNED_OBJ;
+
+            ++_commonStats.advanced;
+            return PlanStage::ADVANCED;
+        }
+
         verify(_resultIterator != _data.end());
         verify(_sorted);
         *out = _resultIterator->wsid;
@@ -447,8 +563,13 @@ namespace mongo {
 
     PlanStageStats* SortStage::getStats() {
         _commonStats.isEOF = isEOF();
-        _specificStats.memLimit = kMaxBytes;
-        _specificStats.memUsage = _memUsage;
+        _specificStats.memLimit = _maxMemoryUsageBytes;
+        _specificStats.memUsage = _sorter ? _sorter->memUsed() : _memUsage;
+        if (_sorter) {
+            _specificStats.spilledBytes = _sorter->spilledBytes();
+            _specificStats.spillFiles = _sorter->numFiles();
+        }
+        _specificStats.workingSetMemUsage = _ws->getMemUsage();
 
         auto_ptr<PlanStageStats> ret(new PlanStageStats(_commonStats, STAGE_SORT));
         ret->specific.reset(new SortStats(_specificStats));
@@ -539,6 +660,66 @@ namespace mongo {
         }
     }
 
+    Status SortStage::startSpilling() {
+        SortOptions opts;
+        opts.limit = _limit;
+        opts.maxMemoryUsageBytes = _maxMemoryUsageBytes;
+        opts.extSortAllowed = true;
+        opts.tempDir = _tempDir;
+        _sorter.reset(SpillSorter::make(opts,
+                                        SpillComparator(_sortKeyGen->getSortComparator())));
+
+        vector<SortableDataItem> buffered;
+        if (_dataSet) {
+            buffered.assign(_dataSet->begin(), _dataSet->end());
+            _dataSet.reset();
+        }
+        else {
+            buffered.swap(_data);
+        }
+        _memUsage = 0;
+
+        for (size_t i = 0; i < buffered.size(); ++i) {
+            Status status = spill(buffered[i].wsid, buffered[i].sortKey);
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+        return Status::OK();
+    }
+
+    Status SortStage::spill(WorkingSetID id, const BSONObj& sortKey) {
+        WorkingSetMember* member = _ws->get(id);
+
+        // The sorter only carries the document, so computed data such as a text score would be
+        // lost.
+        for (size_t i = 0; i < WSM_COMPUTED_NUM_TYPES; ++i) {
+            if (member->hasComputed(WorkingSetComputedDataType(i))) {
+                mongoutils::str::stream ss;
+                ss << "sort stage buffered data usage exceeds internal limit of "
+                   << _maxMemoryUsageBytes << " bytes, and results with computed data"
+                   << " can't be sorted on disk";
+                return Status(ErrorCodes::Overflow, ss);
+            }
+        }
+
+        try {
+            _sorter->add(sortKey.getOwned(),
+                         SortStageSpilledDocument(member->hasLoc() ? member->loc : DiskLoc(),
+                                                  member->obj.getOwned()));
+        }
+        catch (const DBException& e) {
+            return e.toStatus();
+        }
+
+        // The sorter has its own copy, so invalidations no longer concern us.
+        if (member->hasLoc()) {
+            _wsidByDiskLoc.erase(member->loc);
+        }
+        _ws->free(id);
+        return Status::OK();
+    }
+
     void SortStage::sortBuffer() {
         if (_limit == 0) {
             const WorkingSetComparator& cmp = *_sortKeyComparator;
@@ -559,3 +740,6 @@ namespace mongo {
     }
 
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
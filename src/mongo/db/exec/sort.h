@@ -37,6 +37,7 @@
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/query/index_bounds.h"
+#include "mongo/db/sorter/sorter.h"
 #include "mongo/platform/unordered_map.h"
 
 
@@ -47,7 +48,12 @@ namespace mongo {
     // Parameters that must be provided to a SortStage
     class SortStageParams {
     public:
-        SortStageParams() : collection(NULL), limit(0) { }
+        SortStageParams() : collection(NULL),
+                            limit(0),
+                            maxMemoryUsageBytes(kDefaultMaxMemoryUsageBytes),
+                            allowDiskUse(false) { }
+
+        static const size_t kDefaultMaxMemoryUsageBytes = 32 * 1024 * 1024;
 
         // Used for resolving DiskLocs to BSON
         const Collection* collection;
@@ -60,8 +66,38 @@ namespace mongo {
 
         // Equal to 0 for no limit.
         size_t limit;
+
+        // How much data we buffer in memory before spilling it to disk, or failing if
+        // 'allowDiskUse' is false.
+        size_t maxMemoryUsageBytes;
+
+        // May we spill to files in 'tempDir' instead of failing when we run out of memory?
+        bool allowDiskUse;
+        std::string tempDir;
     };
 
+    /**
+     * A document handed to the external Sorter by a SortStage that has spilled.  The DiskLoc only
+     * breaks ties between equal sort keys; the document is always returned as an owned object.
+     */
+    struct SortStageSpilledDocument {
+        SortStageSpilledDocument() { }
+        SortStageSpilledDocument(const DiskLoc& dl, const BSONObj& o) : loc(dl), obj(o) { }
+
+        DiskLoc loc;
+        BSONObj obj;
+
+        // Members for Sorter.
+        struct SorterDeserializeSettings {}; // unused
+        void serializeForSorter(BufBuilder& buf) const;
+        static SortStageSpilledDocument deserializeForSorter(BufReader& buf,
+                                                             const SorterDeserializeSettings&);
+        int memUsageForSorter() const;
+        SortStageSpilledDocument getOwned() const;
+    };
+
+    std::ostream& operator<<(std::ostream& stream, const SortStageSpilledDocument& doc);
+
     /**
      * Maps a WSM value to a BSONObj key that can then be sorted via BSONObjCmp.
      */
@@ -137,6 +173,11 @@ namespace mongo {
     /**
      * Sorts the input received from the child according to the sort pattern provided.
      *
+     * Results are buffered in the WorkingSet.  If they outgrow maxMemoryUsageBytes and
+     * allowDiskUse is set, everything buffered so far and all further input is handed to an
+     * external Sorter instead, which spills sorted runs to tempDir and merges them, and results
+     * come back as OWNED_OBJ members.  Otherwise the stage fails.
+     *
      * Preconditions: For each field in 'pattern', all inputs in the child must handle a
      * getFieldDotted for that field.
      */
@@ -156,6 +197,7 @@ namespace mongo {
         PlanStageStats* getStats();
 
     private:
+        typedef Sorter<BSONObj, SortStageSpilledDocument> SpillSorter;
 
         //
         // Query Stage
@@ -179,6 +221,10 @@ namespace mongo {
         // Equal to 0 for no limit.
         size_t _limit;
 
+        size_t _maxMemoryUsageBytes;
+        bool _allowDiskUse;
+        std::string _tempDir;
+
         //
         // Sort key generation
         //
@@ -228,6 +274,18 @@ namespace mongo {
          */
         void sortBuffer();
 
+        /**
+         * Moves everything buffered in the WorkingSet into a new _sorter, through which all
+         * further input will go.  Returns a non-OK status if some buffered result can't be
+         * spilled.
+         */
+        Status startSpilling();
+
+        /**
+         * Hands the result in WSM 'id' to _sorter and frees it.
+         */
+        Status spill(WorkingSetID id, const BSONObj& sortKey);
+
         // Comparator for data buffer
         // Initialization follows sort key generator
         scoped_ptr<WorkingSetComparator> _sortKeyComparator;
@@ -250,6 +308,11 @@ namespace mongo {
         typedef unordered_map<DiskLoc, WorkingSetID, DiskLoc::Hasher> DataMap;
         DataMap _wsidByDiskLoc;
 
+        // Once we have spilled, all input goes here rather than into _data or _dataSet, and once
+        // the input is exhausted the sorted results come out of _spillIterator.
+        boost::scoped_ptr<SpillSorter> _sorter;
+        boost::scoped_ptr<SpillSorter::Iterator> _spillIterator;
+
         //
         // Stats
         //
@@ -34,6 +34,7 @@
 
 #include "mongo/db/json.h"
 #include "mongo/db/exec/mock_stage.h"
+#include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 
 using namespace mongo;
@@ -238,4 +239,91 @@ namespace {
                  "{output: [{a: 3}]}");
     }
 
+    //
+    // Sorting more data than fits in memory
+    //
+
+    /**
+     * Sorts 'numDocs' documents of about 100 bytes each, whose 'a' values are a permutation of
+     * 0..numDocs-1, by {a: 1}.  Stores the 'a' values returned into 'out' and returns the final
+     * state of the sort stage.
+     */
+    PlanStage::StageState sortManyDocs(SortStageParams params, int numDocs,
+                                       std::vector<int>* out, SortStats* statsOut) {
+        WorkingSet ws;
+
+        MockStage* ms = new MockStage(&ws);
+        for (int i = 0; i < numDocs; ++i) {
+            WorkingSetMember wsm;
+            wsm.state = WorkingSetMember::OWNED_OBJ;
+            wsm.obj = BSON("a" << (i * 7919) % numDocs << "pad" << std::string(100, 'x'));
+            ms->pushBack(wsm);
+        }
+
+        params.pattern = BSON("a" << 1);
+        SortStage sort(params, &ws, ms);
+
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState state = PlanStage::NEED_TIME;
+        while (state == PlanStage::NEED_TIME || state == PlanStage::ADVANCED) {
+            state = sort.work(&id);
+            if (state == PlanStage::ADVANCED) {
+                WorkingSetMember* member = ws.get(id);
+                ASSERT_EQUALS(WorkingSetMember::OWNED_OBJ, member->state);
+                out->push_back(member->obj["a"].numberInt());
+                ws.free(id);
+            }
+        }
+
+        boost::scoped_ptr<PlanStageStats> stats(sort.getStats());
+        *statsOut = *static_cast<SortStats*>(stats->specific.get());
+        return state;
+    }
+
+    TEST(SortStageTest, SortFailsOverMemoryLimitWithoutDiskUse) {
+        SortStageParams params;
+        params.maxMemoryUsageBytes = 16 * 1024;
+
+        std::vector<int> results;
+        SortStats stats;
+        ASSERT_EQUALS(PlanStage::FAILURE, sortManyDocs(params, 1000, &results, &stats));
+        ASSERT(results.empty());
+    }
+
+    TEST(SortStageTest, SortSpillsToDisk) {
+        unittest::TempDir tempDir("sortStageTests");
+        SortStageParams params;
+        params.maxMemoryUsageBytes = 16 * 1024;
+        params.allowDiskUse = true;
+        params.tempDir = tempDir.path();
+
+        std::vector<int> results;
+        SortStats stats;
+        ASSERT_EQUALS(PlanStage::IS_EOF, sortManyDocs(params, 1000, &results, &stats));
+        ASSERT_EQUALS(1000U, results.size());
+        for (int i = 0; i < 1000; ++i) {
+            ASSERT_EQUALS(i, results[i]);
+        }
+        ASSERT_GREATER_THAN(stats.spillFiles, 1U);
+        ASSERT_GREATER_THAN(stats.spilledBytes, 1000ULL * 100);
+    }
+
+    TEST(SortStageTest, SortWithLimitSpillsToDisk) {
+        unittest::TempDir tempDir("sortStageTests");
+        SortStageParams params;
+        params.maxMemoryUsageBytes = 16 * 1024;
+        params.allowDiskUse = true;
+        params.tempDir = tempDir.path();
+        params.limit = 500;
+
+        std::vector<int> results;
+        SortStats stats;
+        ASSERT_EQUALS(PlanStage::IS_EOF, sortManyDocs(params, 1000, &results, &stats));
+        ASSERT_EQUALS(500U, results.size());
+        for (int i = 0; i < 500; ++i) {
+            ASSERT_EQUALS(i, results[i]);
+        }
+        ASSERT_GREATER_THAN(stats.spillFiles, 0U);
+    }
+
 }  // namespace
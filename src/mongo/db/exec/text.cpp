@@ -28,6 +28,8 @@
 
 #include "mongo/db/exec/text.h"
 
+#include <algorithm>
+
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/working_set.h"
@@ -38,6 +40,22 @@
 
 namespace mongo {
 
+    namespace {
+
+        // A document that might make the top k: its score so far, the most it can still score,
+        // and where it lives.
+        struct TopKCandidate {
+            double score;
+            double bound;
+            DiskLoc loc;
+        };
+
+        bool higherScore(const TopKCandidate& lhs, const TopKCandidate& rhs) {
+            return lhs.score > rhs.score;
+        }
+
+    }  // namespace
+
     TextStage::TextStage(const TextStageParams& params,
                          WorkingSet* ws,
                          const MatchExpression* filter)
@@ -46,7 +64,9 @@ namespace mongo {
           _ws(ws),
           _filter(filter),
           _internalState(INIT_SCANS),
-          _currentIndexScanner(0) {
+          _currentIndexScanner(0),
+          _liveScanners(0),
+          _keysSinceCheck(0) {
 
         _scoreIterator = _scores.end();
     }
@@ -123,7 +143,12 @@ namespace mongo {
         // changes.
         // TODO: If we're RETURNING_RESULTS we could somehow buffer the object.
         ScoreMap::iterator scoreIt = _scores.find(dl);
-        if (scoreIt != _scores.end()) {
+        if (scoreIt != _scores.end() && 0 != _params.topK && READING_TERMS == _internalState) {
+            // Forgetting what we've read for this document would leave its bound too low to be
+            // trusted if more of its keys turn up, so drop it for good instead.
+            scoreIt->second.score = -1;
+        }
+        else if (scoreIt != _scores.end()) {
             if (scoreIt == _scoreIterator) {
                 _scoreIterator++;
             }
@@ -168,6 +193,13 @@ namespace mongo {
             return PlanStage::IS_EOF;
         }
 
+        if (0 != _params.topK) {
+            _specificStats.topK = _params.topK;
+            _termBounds.assign(_scanners.size(), MAX_WEIGHT);
+            _scannerDone.assign(_scanners.size(), false);
+            _liveScanners = _scanners.size();
+        }
+
         // Transition to the next state.
         _internalState = READING_TERMS;
         return PlanStage::NEED_TIME;
@@ -186,11 +218,41 @@ namespace mongo {
             invariant(1 == wsm->keyData.size());
             invariant(wsm->hasLoc());
             IndexKeyDatum& keyDatum = wsm->keyData.back();
-            addTerm(keyDatum.keyData, wsm->loc);
+            addTerm(keyDatum.keyData, wsm->loc, _currentIndexScanner);
             _ws->free(id);
+
+            if (0 != _params.topK) {
+                // Looking for the top documents takes time linear in the number of documents
+                // seen, so we look less often as that number grows.
+                ++_keysSinceCheck;
+                if (_keysSinceCheck >= std::max(_params.topK, _scores.size() / 4)) {
+                    if (selectTopK(false)) {
+                        doneReadingTerms();
+                        return PlanStage::NEED_TIME;
+                    }
+                    _keysSinceCheck = 0;
+                }
+                nextScanner();
+            }
             return PlanStage::NEED_TIME;
         }
         else if (PlanStage::IS_EOF == childState) {
+            if (0 != _params.topK) {
+                // No document can get any more weight from this term.
+                _termBounds[_currentIndexScanner] = 0;
+                _scannerDone[_currentIndexScanner] = true;
+                --_liveScanners;
+
+                if (_liveScanners > 0) {
+                    nextScanner();
+                    return PlanStage::NEED_TIME;
+                }
+
+                verify(selectTopK(true));
+                doneReadingTerms();
+                return PlanStage::NEED_TIME;
+            }
+
             // Done with this scan.
             ++_currentIndexScanner;
 
@@ -200,11 +262,7 @@ namespace mongo {
             }
 
             // If we're here we are done reading results.  Move to the next state.
-            _scoreIterator = _scores.begin();
-            _internalState = RETURNING_RESULTS;
-
-            // Don't need to keep these around.
-            _scanners.clear();
+            doneReadingTerms();
             return PlanStage::NEED_TIME;
         }
         else {
@@ -225,6 +283,101 @@ namespace mongo {
         }
     }
 
+    void TextStage::doneReadingTerms() {
+        _scoreIterator = _scores.begin();
+        _internalState = RETURNING_RESULTS;
+
+        // Don't need to keep these around.
+        _scanners.clear();
+    }
+
+    void TextStage::nextScanner() {
+        invariant(_liveScanners > 0);
+        do {
+            _currentIndexScanner = (_currentIndexScanner + 1) % _scanners.size();
+        } while (_scannerDone[_currentIndexScanner]);
+    }
+
+    bool TextStage::selectTopK(bool allTermsRead) {
+        // A document none of whose keys have been read yet can score at most this much.
+        double unseenBound = 0;
+        for (size_t i = 0; i < _termBounds.size(); ++i) {
+            unseenBound += _termBounds[i];
+        }
+
+        vector<TopKCandidate> candidates;
+        candidates.reserve(_scores.size());
+        for (ScoreMap::const_iterator it = _scores.begin(); it != _scores.end(); ++it) {
+            const TextRecord& record = it->second;
+            if (record.score < 0) {
+                continue;
+            }
+
+            TopKCandidate candidate;
+            candidate.score = record.score;
+            candidate.bound = record.score;
+            candidate.loc = it->first;
+            for (size_t i = 0; i < _termBounds.size(); ++i) {
+                if (i >= 64 || !(record.termsSeen & (1ULL << i))) {
+                    candidate.bound += _termBounds[i];
+                }
+            }
+            candidates.push_back(candidate);
+        }
+
+        if (!allTermsRead && candidates.size() < _params.topK) {
+            return false;
+        }
+
+        const size_t numResults = std::min(_params.topK, candidates.size());
+        if (numResults > 0 && numResults < candidates.size()) {
+            std::nth_element(candidates.begin(),
+                             candidates.begin() + (numResults - 1),
+                             candidates.end(),
+                             higherScore);
+        }
+
+        if (!allTermsRead) {
+            // The first 'numResults' candidates are known to make the cut if neither an unseen
+            // document nor any of the other candidates can overtake the lowest of them.
+            const double cutoff = candidates[numResults - 1].score;
+            if (unseenBound > cutoff) {
+                return false;
+            }
+            for (size_t i = numResults; i < candidates.size(); ++i) {
+                if (candidates[i].bound > cutoff) {
+                    return false;
+                }
+            }
+        }
+
+        // Some keys of the documents we keep may never have been read, and the ones that were
+        // were not necessarily read in term order.  Scoring the documents themselves gives the
+        // weights the index holds, summed in the same order as when every key is read.
+        ScoreMap topScores;
+        const vector<string>& terms = _params.query.getTerms();
+        for (size_t i = 0; i < numResults; ++i) {
+            const DiskLoc& loc = candidates[i].loc;
+            fts::TermFrequencyMap termFreqs;
+            _params.spec.scoreDocument(_params.index->getCollection()->docFor(loc), &termFreqs);
+
+            double score = 0;
+            for (size_t j = 0; j < terms.size(); ++j) {
+                fts::TermFrequencyMap::const_iterator freqIt = termFreqs.find(terms[j]);
+                if (freqIt != termFreqs.end()) {
+                    score += freqIt->second;
+                }
+            }
+            topScores[loc].score = score;
+        }
+
+        // Each of the documents we keep is fetched when it is returned.
+        _specificStats.fetches += numResults;
+
+        _scores.swap(topScores);
+        return true;
+    }
+
     PlanStage::StageState TextStage::returnResults(WorkingSetID* out) {
         if (_scoreIterator == _scores.end()) {
             _internalState = DONE;
@@ -233,7 +386,7 @@ namespace mongo {
 
         // Filter for phrases and negative terms, score and truncate.
         DiskLoc loc = _scoreIterator->first;
-        double score = _scoreIterator->second;
+        double score = _scoreIterator->second.score;
         _scoreIterator++;
 
         // Ignore non-matched documents.
@@ -241,8 +394,9 @@ namespace mongo {
             return PlanStage::NEED_TIME;
         }
 
-        // Filter for phrases and negated terms
-        if (_params.query.hasNonTermPieces()) {
+        // Filter for phrases and negated terms.  In top-k mode this was done as the document was
+        // found.
+        if (_params.query.hasNonTermPieces() && 0 == _params.topK) {
             if (!_ftsMatcher.matchesNonTerm(_params.index->getCollection()->docFor(loc))) {
                 return PlanStage::NEED_TIME;
             }
@@ -312,22 +466,21 @@ namespace mongo {
         bool* _fetched;
     };
 
-    void TextStage::addTerm(const BSONObj& key, const DiskLoc& loc) {
-        double *documentAggregateScore = &_scores[loc];
+    void TextStage::addTerm(const BSONObj& key, const DiskLoc& loc, size_t termIndex) {
+        TextRecord* textRecord = &_scores[loc];
+        double *documentAggregateScore = &textRecord->score;
 
         ++_specificStats.keysExamined;
 
         // Locate score within possibly compound key: {prefix,term,score,suffix}.
-        BSONObjIterator keyIt(key);
-        for (unsigned i = 0; i < _params.spec.numExtraBefore(); i++) {
-            keyIt.next();
-        }
+        double documentTermScore = FTSIndexFormat::getKeyWeight(key,
+                                                                _params.spec.numExtraBefore());
 
-        keyIt.next(); // Skip past 'term'.
+        if (0 != _params.topK) {
+            // Keys of a term come in order of decreasing weight.
+            _termBounds[termIndex] = documentTermScore;
+        }
 
-        BSONElement scoreElement = keyIt.next();
-        double documentTermScore = scoreElement.number();
-        
         // Handle filtering.
         if (*documentAggregateScore < 0) {
             // We have already rejected this document.
@@ -353,14 +506,28 @@ namespace mongo {
                     return;
                 }
             }
-            else {
+            else if (0 == _params.topK) {
                 // If we're here, we're going to return the doc, and we do a fetch later.
                 ++_specificStats.fetches;
             }
+
+            if (0 != _params.topK && _params.query.hasNonTermPieces()) {
+                // A document counts towards the top k only if it is going to be returned, so
+                // phrases and negated terms have to be checked now.
+                ++_specificStats.fetches;
+                BSONObj obj = _params.index->getCollection()->docFor(loc);
+                if (!_ftsMatcher.matchesNonTerm(obj)) {
+                    *documentAggregateScore = -1;
+                    return;
+                }
+            }
         }
 
         // Aggregate relevance score, term keys.
         *documentAggregateScore += documentTermScore;
+        if (0 != _params.topK && termIndex < 64) {
+            textRecord->termsSeen |= 1ULL << termIndex;
+        }
     }
 
 }  // namespace mongo
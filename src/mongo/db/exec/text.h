@@ -53,7 +53,7 @@ namespace mongo {
     using fts::MAX_WEIGHT;
 
     struct TextStageParams {
-        TextStageParams(const FTSSpec& s) : spec(s) {}
+        TextStageParams(const FTSSpec& s) : spec(s), topK(0) {}
 
         // Text index descriptor.  IndexCatalog owns this.
         IndexDescriptor* index;
@@ -66,11 +66,21 @@ namespace mongo {
 
         // The text query.
         FTSQuery query;
+
+        // If nonzero, only the 'topK' highest scoring documents need to be returned.  Ties for
+        // the last place are broken arbitrarily.
+        size_t topK;
     };
 
     /**
      * Implements a blocking stage that returns text search results.
      *
+     * By default every key of every query term is read before any result is returned.  When
+     * only the top k documents are wanted, the terms are read round-robin, and reading stops as
+     * soon as the k best scores so far can no longer be beaten.  This relies on the index
+     * returning the keys of a term in order of decreasing weight, which bounds the weight a
+     * document can still pick up from each term.
+     *
      * Prerequisites: None; is a leaf node.
      * Output type: LOC_AND_OBJ_UNOWNED.
      */
@@ -123,7 +133,26 @@ namespace mongo {
          * score) pair for this document.  Also rejects documents that don't match this stage's
          * filter.
          */
-        void addTerm(const BSONObj& key, const DiskLoc& loc);
+        void addTerm(const BSONObj& key, const DiskLoc& loc, size_t termIndex);
+
+        /**
+         * Called once no more terms need to be read.  Transitions to RETURNING_RESULTS.
+         */
+        void doneReadingTerms();
+
+        /**
+         * Only used in top-k mode.  If the top '_params.topK' documents are known, drops every
+         * other document from '_scores', makes the scores of the remaining ones exact, and
+         * returns true.  Otherwise returns false and changes nothing.
+         *
+         * The top documents are always known if 'allTermsRead' is true.
+         */
+        bool selectTopK(bool allTermsRead);
+
+        /**
+         * Moves '_currentIndexScanner' to the next scanner that still has keys, round-robin.
+         */
+        void nextScanner();
 
         /**
          * Possibly return a result.  FYI, this may perform a fetch directly if it is needed to
@@ -157,12 +186,38 @@ namespace mongo {
         // Which _scanners are we currently reading from?
         size_t _currentIndexScanner;
 
+        // What we know about a document found by the sub-scans.
+        struct TextRecord {
+            TextRecord() : score(0), termsSeen(0) { }
+
+            // Sum of the term weights read so far, or -1 if the document has been rejected.
+            double score;
+
+            // Bit i is set once a key for term i has been read.  Only kept in top-k mode, and
+            // only for the first 64 terms.
+            unsigned long long termsSeen;
+        };
+
         // Temporary score data filled out by sub-scans.  Used in READING_TERMS and
         // RETURNING_RESULTS.
         // Maps from diskloc -> aggregate score for doc.
-        typedef unordered_map<DiskLoc, double, DiskLoc::Hasher> ScoreMap;
+        typedef unordered_map<DiskLoc, TextRecord, DiskLoc::Hasher> ScoreMap;
         ScoreMap _scores;
         ScoreMap::const_iterator _scoreIterator;
+
+        //
+        // Top-k mode only.
+        //
+
+        // For each of _scanners, an upper bound on the weight of any key it has yet to return.
+        std::vector<double> _termBounds;
+
+        // Which of _scanners have hit EOF, and how many have yet to.
+        std::vector<bool> _scannerDone;
+        size_t _liveScanners;
+
+        // Keys read since selectTopK() last failed to find the top documents.
+        size_t _keysSinceCheck;
     };
 
 } // namespace mongo
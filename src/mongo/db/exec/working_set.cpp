@@ -32,26 +32,32 @@
 
 namespace mongo {
 
+    const size_t WorkingSet::kMembersPerSlab;
+
     WorkingSet::MemberHolder::MemberHolder() : member(NULL) { }
     WorkingSet::MemberHolder::~MemberHolder() {}
 
     WorkingSet::WorkingSet() : _freeList(INVALID_ID) { }
 
     WorkingSet::~WorkingSet() {
-        for (size_t i = 0; i < _data.size(); i++) {
-            delete _data[i].member;
+        for (size_t i = 0; i < _slabs.size(); i++) {
+            delete[] _slabs[i];
         }
     }
 
     WorkingSetID WorkingSet::allocate() {
         if (_freeList == INVALID_ID) {
-            // The free list is empty so we need to make a single new WSM to return. This relies on
-            // vector::resize being amortized O(1) for efficient allocation. Note that the free list
-            // remains empty until something is returned by a call to free().
+            // The free list is empty so we need to hand out a new WSM, from a new slab if the last
+            // one is full. This relies on vector::resize being amortized O(1) for efficient
+            // allocation. Note that the free list remains empty until something is returned by a
+            // call to free().
             WorkingSetID id = _data.size();
+            if (0 == id % kMembersPerSlab) {
+                _slabs.push_back(new WorkingSetMember[kMembersPerSlab]);
+            }
             _data.resize(_data.size() + 1);
             _data.back().nextFreeOrSelf = id;
-            _data.back().member = new WorkingSetMember();
+            _data.back().member = &_slabs.back()[id % kMembersPerSlab];
             return id;
         }
 
@@ -88,6 +94,11 @@ namespace mongo {
         return _flagged.end() != _flagged.find(id);
     }
 
+    size_t WorkingSet::getMemUsage() const {
+        return _slabs.size() * kMembersPerSlab * sizeof(WorkingSetMember)
+             + _data.capacity() * sizeof(MemberHolder);
+    }
+
     WorkingSetMember::WorkingSetMember() : state(WorkingSetMember::INVALID) { }
 
     WorkingSetMember::~WorkingSetMember() { }
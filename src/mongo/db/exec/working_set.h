@@ -101,6 +101,17 @@ namespace mongo {
          */
         const unordered_set<WorkingSetID>& getFlagged() const;
 
+        /**
+         * Returns the bytes used by the members and bookkeeping of this WorkingSet, not counting
+         * the objects and keys the members refer to.  This only grows, since freed members are
+         * kept for reuse.
+         */
+        size_t getMemUsage() const;
+
+        // Members are allocated in slabs of this many, and are never deallocated before the
+        // WorkingSet is destroyed.
+        static const size_t kMembersPerSlab = 64;
+
     private:
         struct MemberHolder {
             MemberHolder();
@@ -109,10 +120,15 @@ namespace mongo {
             // Free list link if freed. Points to self if in use.
             WorkingSetID nextFreeOrSelf;
 
-            // Owning pointer
+            // Points into one of _slabs.
             WorkingSetMember* member;
         };
 
+        // Owned arrays of kMembersPerSlab members each.  _data[i].member is element
+        // i % kMembersPerSlab of _slabs[i / kMembersPerSlab], so members with nearby IDs are
+        // contiguous in memory.
+        std::vector<WorkingSetMember*> _slabs;
+
         // All WorkingSetIDs are indexes into this, except for INVALID_ID.
         // Elements are added to _freeList rather than removed when freed.
         std::vector<MemberHolder> _data;
@@ -132,6 +148,7 @@ namespace mongo {
      * the key.
      */
     struct IndexKeyDatum {
+        IndexKeyDatum() { }
         IndexKeyDatum(const BSONObj& keyPattern, const BSONObj& key) : indexKeyPattern(keyPattern),
                                                                        keyData(key) { }
 
@@ -142,6 +159,53 @@ namespace mongo {
         BSONObj keyData;
     };
 
+    /**
+     * The index key data of a WorkingSetMember.  Nearly every member has at most one key, so the
+     * first is stored inline and only the rest go to the heap.  clear() keeps the heap storage so
+     * that a recycled member doesn't have to reallocate it.
+     */
+    class IndexKeyDatumVector {
+    public:
+        IndexKeyDatumVector() : _size(0) { }
+
+        size_t size() const { return _size; }
+        bool empty() const { return 0 == _size; }
+
+        IndexKeyDatum& operator[](size_t i) {
+            dassert(i < _size);
+            return 0 == i ? _first : _rest[i - 1];
+        }
+
+        const IndexKeyDatum& operator[](size_t i) const {
+            dassert(i < _size);
+            return 0 == i ? _first : _rest[i - 1];
+        }
+
+        IndexKeyDatum& back() { return (*this)[_size - 1]; }
+        const IndexKeyDatum& back() const { return (*this)[_size - 1]; }
+
+        void push_back(const IndexKeyDatum& datum) {
+            if (0 == _size) {
+                _first = datum;
+            }
+            else {
+                _rest.push_back(datum);
+            }
+            ++_size;
+        }
+
+        void clear() {
+            _first = IndexKeyDatum();
+            _rest.clear();
+            _size = 0;
+        }
+
+    private:
+        IndexKeyDatum _first;
+        std::vector<IndexKeyDatum> _rest;
+        size_t _size;
+    };
+
     /**
      * What types of computed data can we have?
      */
@@ -221,7 +285,7 @@ namespace mongo {
 
         DiskLoc loc;
         BSONObj obj;
-        std::vector<IndexKeyDatum> keyData;
+        IndexKeyDatumVector keyData;
         MemberState state;
 
         bool hasLoc() const;
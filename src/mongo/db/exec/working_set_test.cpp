@@ -147,4 +147,51 @@ namespace {
         ASSERT_FALSE(member->getFieldDotted("y", &elt));
     }
 
+    TEST_F(WorkingSetFixture, keyDataSurvivesClear) {
+        member->keyData.push_back(IndexKeyDatum(BSON("x" << 1), BSON("" << 1)));
+        member->keyData.push_back(IndexKeyDatum(BSON("y" << 1), BSON("" << 2)));
+        member->keyData.push_back(IndexKeyDatum(BSON("z" << 1), BSON("" << 3)));
+        ASSERT_EQUALS(3U, member->keyData.size());
+        ASSERT_EQUALS(BSON("y" << 1), member->keyData[1].indexKeyPattern);
+        ASSERT_EQUALS(BSON("" << 3), member->keyData.back().keyData);
+
+        member->clear();
+        ASSERT(member->keyData.empty());
+
+        member->keyData.push_back(IndexKeyDatum(BSON("w" << 1), BSON("" << 4)));
+        ASSERT_EQUALS(1U, member->keyData.size());
+        ASSERT_EQUALS(BSON("w" << 1), member->keyData[0].indexKeyPattern);
+    }
+
+    TEST(WorkingSetTest, membersAreAllocatedInSlabs) {
+        WorkingSet ws;
+        ASSERT_EQUALS(0U, ws.getMemUsage());
+
+        std::vector<WorkingSetID> ids;
+        for (size_t i = 0; i < WorkingSet::kMembersPerSlab; ++i) {
+            ids.push_back(ws.allocate());
+        }
+        const size_t oneSlab = ws.getMemUsage();
+        ASSERT_GREATER_THAN_OR_EQUALS(oneSlab,
+                                      WorkingSet::kMembersPerSlab * sizeof(WorkingSetMember));
+
+        // Members of a slab are contiguous.
+        for (size_t i = 1; i < ids.size(); ++i) {
+            ASSERT_EQUALS(ws.get(ids[0]) + i, ws.get(ids[i]));
+        }
+
+        // A freed member is recycled rather than growing the set.
+        ws.get(ids[3])->obj = BSON("x" << 1);
+        ws.get(ids[3])->state = WorkingSetMember::OWNED_OBJ;
+        ws.free(ids[3]);
+        WorkingSetID reused = ws.allocate();
+        ASSERT_EQUALS(ids[3], reused);
+        ASSERT_EQUALS(WorkingSetMember::INVALID, ws.get(reused)->state);
+        ASSERT_EQUALS(oneSlab, ws.getMemUsage());
+
+        // Going past the first slab allocates another.
+        ws.allocate();
+        ASSERT_GREATER_THAN(ws.getMemUsage(), oneSlab);
+    }
+
 }  // namespace
@@ -32,6 +32,7 @@
 
 #include "mongo/db/client.h"
 #include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/time_partition.h"
 #include "mongo/db/fts/fts_command.h"
 #include "mongo/db/fts/fts_util.h"
 #include "mongo/db/pdfile.h"
@@ -95,6 +96,13 @@ namespace mongo {
 
             Client::ReadContext ctx(txn, ns);
 
+            Status timePartitionStatus =
+                checkNotTimePartitioned(txn, ctx.ctx().db()->getCollection(txn, ns), "text");
+            if (!timePartitionStatus.isOK()) {
+                errmsg = timePartitionStatus.reason();
+                return false;
+            }
+
             CanonicalQuery* cq;
             Status canonicalizeStatus = 
                     CanonicalQuery::canonicalize(ns, 
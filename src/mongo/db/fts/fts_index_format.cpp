@@ -179,6 +179,15 @@ namespace mongo {
             return b.obj();
         }
 
+        double FTSIndexFormat::getKeyWeight( const BSONObj& key, unsigned numExtraBefore ) {
+            BSONObjIterator i( key );
+            for ( unsigned k = 0; k < numExtraBefore; k++ ) {
+                i.next();
+            }
+            i.next(); // skip past the term
+            return i.next().number();
+        }
+
         void FTSIndexFormat::_appendIndexKey( BSONObjBuilder& b, double weight, const string& term,
                                               TextIndexVersion textIndexVersion ) {
             verify( weight >= 0 && weight <= MAX_WEIGHT ); // FTSmaxweight =  defined in fts_header
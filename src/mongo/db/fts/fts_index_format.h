@@ -55,6 +55,17 @@ namespace mongo {
                                         const BSONObj& indexPrefix,
                                         TextIndexVersion textIndexVersion );
 
+            /*
+             * Returns the weight stored in an index key
+             * @param key, an index key as produced by getKeys()
+             * @param numExtraBefore, the number of fields that precede the term in the key
+             *
+             * Within a term, keys are ordered by weight, so a scan that walks a term from
+             * MAX_WEIGHT down to 0 sees weights that never increase.  The weight of the last
+             * key read is then an upper bound on the weight of every key left to read.
+             */
+            static double getKeyWeight( const BSONObj& key, unsigned numExtraBefore );
+
         private:
             /*
              * Helper method to get return entry from the FTSIndex as a BSONObj
@@ -108,6 +108,27 @@ namespace mongo {
             ASSERT( i.next().numberDouble() > 0 );
         }
 
+        TEST( FTSIndexFormat, KeyWeight ) {
+            FTSSpec spec( FTSSpec::fixSpec( BSON( "key" << BSON( "x" << 1 <<
+                                                                 "data" << "text" <<
+                                                                 "y" << 1 ) ) ) );
+            BSONObjSet keys;
+            FTSIndexFormat::getKeys( spec, BSON( "data" << "cat" << "x" << 5 << "y" << 7 ),
+                                     &keys );
+
+            ASSERT_EQUALS( 1U, keys.size() );
+            BSONObj key = *(keys.begin());
+            BSONObjIterator i( key );
+            i.next();
+            i.next();
+            ASSERT_EQUALS( i.next().numberDouble(),
+                           FTSIndexFormat::getKeyWeight( key, spec.numExtraBefore() ) );
+
+            BSONObj boundKey = FTSIndexFormat::getIndexKey( MAX_WEIGHT, "cat", BSON( "" << 5 ),
+                                                            spec.getTextIndexVersion() );
+            ASSERT_EQUALS( MAX_WEIGHT, FTSIndexFormat::getKeyWeight( boundKey, 1 ) );
+        }
+
         TEST( FTSIndexFormat, StopWords1 ) {
             FTSSpec spec( FTSSpec::fixSpec( BSON( "key" << BSON( "data" << "text" ) ) ) );
 
@@ -81,7 +81,7 @@ namespace mongo {
                 Token t = i.next();
                 if ( t.type != Token::TEXT )
                     continue;
-                string word = stemmer.stem( tolowerString( t.data ) );
+                string word = stemmer.stem( tolowerString( t.data ) ).toString();
                 if ( _query.getNegatedTerms().count( word ) > 0 )
                     return true;
             }
@@ -163,10 +163,20 @@ namespace mongo {
 
             FTSElementIterator it( *this, obj );
 
+            // Creating a stemmer is not free, so keep the last one around; most documents
+            // use a single language for all of their fields.
+            const FTSLanguage* stemmerLanguage = NULL;
+            scoped_ptr<Stemmer> stemmer;
+
             while ( it.more() ) {
                 FTSIteratorValue val = it.next();
-                Stemmer stemmer( *val._language );
-                Tools tools( *val._language, &stemmer, StopWords::getStopWords( *val._language ) );
+                if ( val._language != stemmerLanguage ) {
+                    stemmer.reset( new Stemmer( *val._language ) );
+                    stemmerLanguage = val._language;
+                }
+                Tools tools( *val._language,
+                             stemmer.get(),
+                             StopWords::getStopWords( *val._language ) );
                 _scoreStringV2( tools, val._text, term_freqs, val._weight );
             }
         }
@@ -180,20 +190,23 @@ namespace mongo {
 
             unsigned numTokens = 0;
 
+            // Reused for every token, so lowercasing does not allocate once it has grown to
+            // the size of the longest token.
+            string lower;
+
             Tokenizer i( tools.language, raw );
             while ( i.more() ) {
                 Token t = i.next();
                 if ( t.type != Token::TEXT )
                     continue;
 
-                string term = t.data.toString();
-                makeLower( &term );
-                if ( tools.stopwords->isStopWord( term ) ) {
+                lower.assign( t.data.rawData(), t.data.size() );
+                makeLower( &lower );
+                if ( tools.stopwords->isStopWord( lower ) ) {
                     continue;
                 }
-                term = tools.stemmer->stem( term );
 
-                ScoreHelperStruct& data = terms[term];
+                ScoreHelperStruct& data = terms[tools.stemmer->stem( lower )];
 
                 if ( data.exp ) {
                     data.exp *= 2;
@@ -40,6 +40,7 @@
 #include "mongo/db/fts/stop_words.h"
 #include "mongo/db/fts/tokenizer.h"
 #include "mongo/platform/unordered_map.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -60,7 +61,8 @@ namespace mongo {
             double count;
             double exp;
         };
-        typedef unordered_map<std::string,ScoreHelperStruct> ScoreHelperMap;
+        // Keyed by StringData on lookup, so only a term's first occurrence allocates.
+        typedef StringMap<ScoreHelperStruct> ScoreHelperMap;
 
         class FTSSpec {
 
@@ -80,7 +80,7 @@ namespace mongo {
                 makeLower( &term );
                 if ( tools.stopwords->isStopWord( term ) )
                     continue;
-                term = tools.stemmer->stem( term );
+                term = tools.stemmer->stem( term ).toString();
 
                 ScoreHelperStruct& data = terms[term];
 
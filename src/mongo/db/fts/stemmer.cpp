@@ -51,9 +51,9 @@ namespace mongo {
             }
         }
 
-        string Stemmer::stem( const StringData& word ) const {
+        StringData Stemmer::stem( const StringData& word ) const {
             if ( !_stemmer )
-                return word.toString();
+                return word;
 
             const sb_symbol* sb_sym = sb_stemmer_stem( _stemmer,
                                                        (const sb_symbol*)word.rawData(),
@@ -64,7 +64,7 @@ namespace mongo {
                 abort();
             }
 
-            return string( (const char*)(sb_sym), sb_stemmer_length( _stemmer ) );
+            return StringData( (const char*)(sb_sym), sb_stemmer_length( _stemmer ) );
         }
 
     }
@@ -51,7 +51,11 @@ namespace mongo {
             Stemmer( const FTSLanguage& language );
             ~Stemmer();
 
-            std::string stem( const StringData& word ) const;
+            /**
+             * Returns the stem of 'word'. The result may point into 'word' or into a buffer
+             * owned by this Stemmer, and is only valid until the next call to stem().
+             */
+            StringData stem( const StringData& word ) const;
         private:
             struct sb_stemmer* _stemmer;
         };
@@ -49,5 +49,23 @@ namespace mongo {
             ASSERT_EQUALS( "Unite", s.stem( "United" ) );
         }
 
+        TEST( English, StemIsValidUntilNextCall ) {
+            Stemmer s( languageEnglishV2 );
+            std::string first = s.stem( "running" ).toString();
+            ASSERT_EQUALS( "jump", s.stem( "jumping" ) );
+            ASSERT_EQUALS( "run", first );
+        }
+
+        TEST( None, ReturnsInput ) {
+            StatusWithFTSLanguage swl = FTSLanguage::make( "none", TEXT_INDEX_VERSION_2 );
+            ASSERT_OK( swl.getStatus() );
+            Stemmer s( *swl.getValue() );
+
+            std::string word = "running";
+            StringData stem = s.stem( word );
+            ASSERT_EQUALS( "running", stem );
+            ASSERT_EQUALS( word.data(), stem.rawData() );
+        }
+
     }
 }
@@ -112,6 +112,13 @@ namespace mongo {
 
         virtual void getKeys(const BSONObj &obj, BSONObjSet *keys) = 0;
 
+        /**
+         * Returns true if getKeys is expensive enough that bulk builds should generate keys for
+         * several documents concurrently.  Implementations returning true must have a getKeys
+         * that is safe to call from multiple threads at once.
+         */
+        virtual bool parallelKeyGeneration() const { return false; }
+
         IndexCatalogEntry* _btreeState; // owned by IndexCatalogEntry
         scoped_ptr<RecordStore> _recordStore; // owned by us
         const IndexDescriptor* _descriptor;
@@ -28,15 +28,29 @@
 
 #include "mongo/db/index/btree_based_bulk_access_method.h"
 
+#include <algorithm>
+
 #include "mongo/db/curop.h"
 #include "mongo/db/pdfile_private.h"  // This is for inDBRepair.
 #include "mongo/db/repl/rs.h"         // This is for ignoreUniqueIndex.
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage_options.h"
+#include "mongo/util/mongoutils/str.h"
 #include "mongo/util/progress_meter.h"
 
 namespace mongo {
 
+    // How many threads generate keys during a bulk build of an index whose access method
+    // supports it (currently text indexes).  0 or 1 generates keys on the building thread.
+    MONGO_EXPORT_SERVER_PARAMETER(bulkIndexBuildKeyGenThreads, int, 4);
+
+    namespace {
+        // Bounds on how many documents are held back for parallel key generation at a time.
+        const size_t kMaxPendingDocs = 1024;
+        const size_t kMaxPendingBytes = 16 * 1024 * 1024;
+    }
+
     //
     // Comparison for external sorter interface
     //
@@ -78,6 +92,18 @@ namespace mongo {
         _docsInserted = 0;
         _keysInserted = 0;
         _isMultiKey = false;
+        _keyGenThreads = 0;
+        _pendingBytes = 0;
+
+        // With dropDups, a document whose keys can't be generated is deleted by our caller as
+        // soon as insert() fails, so its keys have to be generated right away.
+        if (real->parallelKeyGeneration()
+            && !descriptor->dropDups()
+            && bulkIndexBuildKeyGenThreads > 1) {
+            _keyGenThreads = bulkIndexBuildKeyGenThreads;
+            _keyGenPool.reset(new ThreadPool(_keyGenThreads));
+            _pending.reserve(kMaxPendingDocs);
+        }
 
         _sorter.reset(BSONObjExternalSorter::make(
                     SortOptions().TempDir(storageGlobalParams.dbpath + "/_tmp")
@@ -91,28 +117,99 @@ namespace mongo {
                                               const DiskLoc& loc,
                                               const InsertDeleteOptions& options,
                                               int64_t* numInserted) {
+        if (_keyGenPool) {
+            // The keys aren't known yet, so 'numInserted' is left alone.
+            _pending.push_back(PendingDoc(obj.getOwned(), loc));
+            _pendingBytes += obj.objsize();
+            if (_pending.size() >= kMaxPendingDocs || _pendingBytes >= kMaxPendingBytes) {
+                _flushPending();
+            }
+            return Status::OK();
+        }
+
         BSONObjSet keys;
         _real->getKeys(obj, &keys);
+        _addKeys(keys, loc);
 
+        if (NULL != numInserted) {
+            *numInserted += keys.size();
+        }
+
+        return Status::OK();
+    }
+
+    void BtreeBasedBulkAccessMethod::_addKeys(const BSONObjSet& keys, const DiskLoc& loc) {
         _isMultiKey = _isMultiKey || (keys.size() > 1);
 
-        for (BSONObjSet::iterator it = keys.begin(); it != keys.end(); ++it) {
+        for (BSONObjSet::const_iterator it = keys.begin(); it != keys.end(); ++it) {
             // False is for mayInterrupt.
             _sorter->add(*it, loc);
             _keysInserted++;
         }
 
         _docsInserted++;
+    }
 
-        if (NULL != numInserted) {
-            *numInserted += keys.size();
+    void BtreeBasedBulkAccessMethod::_generateKeys(BtreeBasedAccessMethod* real,
+                                                   PendingDoc* begin,
+                                                   PendingDoc* end) {
+        for (PendingDoc* doc = begin; doc != end; ++doc) {
+            try {
+                real->getKeys(doc->obj, &doc->keys);
+            }
+            catch (const DBException& e) {
+                doc->errorCode = e.getCode() ? e.getCode() : 17527;
+                doc->errorMsg = e.what();
+                return;
+            }
+            catch (const std::exception& e) {
+                // Nothing may escape: the ThreadPool would swallow it and this document's keys
+                // would silently be missing from the index.
+                doc->errorCode = 17527;
+                doc->errorMsg = str::stream() << "index key generation failed: " << e.what();
+                return;
+            }
+            catch (...) {
+                doc->errorCode = 17527;
+                doc->errorMsg = "index key generation failed with an unknown exception";
+                return;
+            }
         }
+    }
 
-        return Status::OK();
+    void BtreeBasedBulkAccessMethod::_flushPending() {
+        if (_pending.empty()) {
+            return;
+        }
+
+        // Hand each thread a contiguous slice of the batch; the sorter only sees the keys once
+        // all slices are done, in the order the documents came in.
+        const size_t numDocs = _pending.size();
+        const size_t sliceSize = (numDocs + _keyGenThreads - 1) / _keyGenThreads;
+        for (size_t start = 0; start < numDocs; start += sliceSize) {
+            PendingDoc* begin = &_pending[start];
+            PendingDoc* end = begin + std::min(sliceSize, numDocs - start);
+            _keyGenPool->schedule(&BtreeBasedBulkAccessMethod::_generateKeys, _real, begin, end);
+        }
+        _keyGenPool->join();
+
+        for (size_t i = 0; i < numDocs; ++i) {
+            const PendingDoc& doc = _pending[i];
+            if (doc.errorCode) {
+                // The build fails here, as it would have if getKeys had thrown in insert().
+                uasserted(doc.errorCode, doc.errorMsg);
+            }
+            _addKeys(doc.keys, doc.loc);
+        }
+
+        _pending.clear();
+        _pendingBytes = 0;
     }
 
     Status BtreeBasedBulkAccessMethod::commit(set<DiskLoc>* dupsToDrop,
                                               bool mayInterrupt) {
+        _flushPending();
+
         DiskLoc oldHead = _real->_btreeState->head();
 
         // XXX: do we expect the tree to be empty but have a head set?  Looks like so from old code.
@@ -37,6 +37,7 @@
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/structure/btree/btree_interface.h"
+#include "mongo/util/concurrency/thread_pool.h"
 
 namespace mongo {
 
@@ -124,10 +125,42 @@ namespace mongo {
     private:
         typedef Sorter<BSONObj, DiskLoc> BSONObjExternalSorter;
 
+        /**
+         * A document waiting for its keys to be generated by the key generation pool.  If
+         * getKeys threw, 'errorCode' and 'errorMsg' describe the exception.
+         */
+        struct PendingDoc {
+            PendingDoc(const BSONObj& o, const DiskLoc& l) : obj(o), loc(l), errorCode(0) { }
+
+            BSONObj obj;
+            DiskLoc loc;
+            BSONObjSet keys;
+            int errorCode;
+            std::string errorMsg;
+        };
+
         Status _notAllowed() const {
             return Status(ErrorCodes::InternalError, "cannot use bulk for this yet");
         }
 
+        /**
+         * Adds the keys of one document to the sorter.
+         */
+        void _addKeys(const BSONObjSet& keys, const DiskLoc& loc);
+
+        /**
+         * Generates the keys of every document in _pending on the key generation pool, then
+         * adds them to the sorter in insertion order.  Throws the first error hit by getKeys.
+         */
+        void _flushPending();
+
+        /**
+         * Runs on a key generation thread.  Fills in the keys of docs [begin, end).
+         */
+        static void _generateKeys(BtreeBasedAccessMethod* real,
+                                  PendingDoc* begin,
+                                  PendingDoc* end);
+
         // Not owned here.
         BtreeBasedAccessMethod* _real;
 
@@ -146,6 +179,13 @@ namespace mongo {
         // Does any document have >1 key?
         bool _isMultiKey;
 
+        // Only set if the index opts in to parallelKeyGeneration.  Documents are batched in
+        // _pending, whose owned copies account for _pendingBytes, until _flushPending.
+        boost::scoped_ptr<ThreadPool> _keyGenPool;
+        int _keyGenThreads;
+        std::vector<PendingDoc> _pending;
+        size_t _pendingBytes;
+
         OperationContext* _txn;
     };
 
@@ -47,6 +47,9 @@ namespace mongo {
         // Implemented:
         virtual void getKeys(const BSONObj& obj, BSONObjSet* keys);
 
+        // Tokenizing and stemming dominate text index builds, and getKeys only reads _ftsSpec.
+        virtual bool parallelKeyGeneration() const { return true; }
+
         fts::FTSSpec _ftsSpec;
     };
 
@@ -45,6 +45,7 @@
 #include "mongo/db/auth/authorization_manager_global.h"
 #include "mongo/db/auth/security_key.h"
 #include "mongo/logger/logger.h"
+#include "mongo/logger/buffered_log_writer.h"
 #include "mongo/logger/console_appender.h"
 #include "mongo/logger/message_event.h"
 #include "mongo/logger/message_event_utf8_encoder.h"
@@ -191,6 +192,8 @@ namespace mongo {
                               ("default"))(
             InitializerContext*) {
 
+        using logger::BufferedLogAppender;
+        using logger::BufferedLogWriter;
         using logger::LogManager;
         using logger::MessageEventEphemeral;
         using logger::MessageEventDetailsEncoder;
@@ -271,14 +274,28 @@ namespace mongo {
 
             LogManager* manager = logger::globalLogManager();
             manager->getGlobalDomain()->clearAppenders();
-            manager->getGlobalDomain()->attachAppender(
-                    MessageLogDomain::AppenderAutoPtr(
-                            new RotatableFileAppender<MessageEventEphemeral>(
-                                    new MessageEventDetailsEncoder, writer.getValue())));
-            manager->getNamedDomain("javascriptOutput")->attachAppender(
-                    MessageLogDomain::AppenderAutoPtr(
-                            new RotatableFileAppender<MessageEventEphemeral>(
-                                    new MessageEventDetailsEncoder, writer.getValue())));
+            if (serverGlobalParams.logBufferedWrites) {
+                // Lives for the rest of the process; flushed by dbexit.
+                BufferedLogWriter* bufferedWriter = new BufferedLogWriter(writer.getValue());
+                manager->getGlobalDomain()->attachAppender(
+                        MessageLogDomain::AppenderAutoPtr(
+                                new BufferedLogAppender(
+                                        new MessageEventDetailsEncoder, bufferedWriter)));
+                manager->getNamedDomain("javascriptOutput")->attachAppender(
+                        MessageLogDomain::AppenderAutoPtr(
+                                new BufferedLogAppender(
+                                        new MessageEventDetailsEncoder, bufferedWriter)));
+            }
+            else {
+                manager->getGlobalDomain()->attachAppender(
+                        MessageLogDomain::AppenderAutoPtr(
+                                new RotatableFileAppender<MessageEventEphemeral>(
+                                        new MessageEventDetailsEncoder, writer.getValue())));
+                manager->getNamedDomain("javascriptOutput")->attachAppender(
+                        MessageLogDomain::AppenderAutoPtr(
+                                new RotatableFileAppender<MessageEventEphemeral>(
+                                        new MessageEventDetailsEncoder, writer.getValue())));
+            }
 
             if (serverGlobalParams.logAppend && exists) {
                 log() << "***** SERVER RESTARTED *****" << endl;
@@ -46,6 +46,7 @@
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/background.h"
+#include "mongo/db/catalog/time_partition.h"
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands/fsync.h"
 #include "mongo/db/d_concurrency.h"
@@ -77,8 +78,12 @@
 #include "mongo/db/repl/is_master.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/repl_coordinator_global.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/db/stats/cpu_sampler.h"
+#include "mongo/db/stats/operation_latency.h"
 #include "mongo/db/storage_options.h"
+#include "mongo/logger/buffered_log_writer.h"
 #include "mongo/platform/process_id.h"
 #include "mongo/s/d_logic.h"
 #include "mongo/s/stale_exception.h" // for SendStaleConfigException
@@ -117,6 +122,9 @@ namespace mongo {
 
     MONGO_FP_DECLARE(rsStopGetMore);
 
+    // Whether to keep latency histograms for each namespace as well as each type of operation.
+    MONGO_EXPORT_SERVER_PARAMETER(trackLatencyByNamespace, bool, false);
+
     void inProgCmd( Message &m, DbResponse &dbresponse ) {
         DbMessage d(m);
         QueryMessage q(d);
@@ -331,6 +339,66 @@ namespace mongo {
         ::abort();
     }
 
+    /**
+     * Label for the CPU samples taken while running "m", e.g. "query test.foo" or
+     * "command test.count".
+     */
+    static string cpuSampleLabel(Message& m, int op, bool isCommand, const char* ns) {
+        if (!isCommand) {
+            return str::stream() << opToString(op) << ' ' << ns;
+        }
+        try {
+            DbMessage d(m);
+            QueryMessage q(d);
+            BSONObj cmdObj = q.query;
+            if (cmdObj.hasField("$query")) {
+                cmdObj = cmdObj.getObjectField("$query");
+            }
+            return str::stream() << "command " << nsToDatabaseSubstring(ns) << '.'
+                                 << cmdObj.firstElementFieldName();
+        }
+        catch (const DBException&) {
+            return str::stream() << "command " << ns;
+        }
+    }
+
+    /**
+     * Returns the type under which the latency of "m" is recorded.  If "latencyNs" is given it
+     * is set to the namespace to record it under: "ns", or for a write command the collection
+     * written.
+     */
+    static OperationLatencyStats::OpType getLatencyOpType(Message& m,
+                                                          int op,
+                                                          bool isCommand,
+                                                          const char* ns,
+                                                          string* latencyNs) {
+        if (latencyNs) {
+            *latencyNs = ns;
+        }
+        if (!isCommand) {
+            return OperationLatencyStats::opTypeFor(op, isCommand);
+        }
+        try {
+            DbMessage d(m);
+            QueryMessage q(d);
+            BSONObj cmdObj = q.query;
+            if (cmdObj.hasField("$query")) {
+                cmdObj = cmdObj.getObjectField("$query");
+            }
+            BSONElement first = cmdObj.firstElement();
+            const OperationLatencyStats::OpType opType =
+                OperationLatencyStats::opTypeForCommand(first.fieldNameStringData());
+            if (latencyNs && opType != OperationLatencyStats::kCommand &&
+                first.type() == String) {
+                *latencyNs = str::stream() << nsToDatabaseSubstring(ns) << '.' << first.str();
+            }
+            return opType;
+        }
+        catch (const DBException&) {
+            return OperationLatencyStats::kCommand;
+        }
+    }
+
     // Returns false when request includes 'end'
     void assembleResponse( OperationContext* txn,
                            Message& m,
@@ -380,6 +448,10 @@ namespace mongo {
             opwrite(m);
         }
 
+        string latencyNs;
+        const OperationLatencyStats::OpType latencyOpType =
+            getLatencyOpType(m, op, isCommand, ns, trackLatencyByNamespace ? &latencyNs : NULL);
+
         // Increment op counters.
         switch (op) {
         case dbQuery:
@@ -422,6 +494,11 @@ namespace mongo {
         OpDebug& debug = currentOp.debug();
         debug.op = op;
 
+        CpuSampler::OperationScope sampledOperation;
+        if (CpuSampler::isSampling()) {
+            sampledOperation.setLabel(cpuSampleLabel(m, op, isCommand, ns));
+        }
+
         long long logThreshold = serverGlobalParams.slowMS;
         bool shouldLog = logger::globalLogDomain()->shouldLog(logger::LogSeverity::Debug(1));
 
@@ -498,6 +575,8 @@ namespace mongo {
         currentOp.done();
         debug.executionTime = currentOp.totalTimeMillis();
 
+        globalLatencyStats.recordOperation(latencyOpType, latencyNs, currentOp.totalTimeMicros());
+
         logThreshold += currentOp.getExpectedLatencyMs();
 
         if ( shouldLog || debug.executionTime > logThreshold ) {
@@ -682,7 +761,8 @@ namespace mongo {
         scoped_ptr<Timer> timer;
         int pass = 0;
         bool exhaust = false;
-        QueryResult* msgdata = 0;
+        Message resp;
+        bool haveResults = false;
         OpTime last;
         while( 1 ) {
             bool isCursorAuthorized = false;
@@ -700,22 +780,24 @@ namespace mongo {
                         sleepmillis(0);
                     }
 
-                    if (pass == 0) {
-                        last = getLastSetOptime();
-                    }
-                    else {
+                    // Block until something is written to the oplog after our last look,
+                    // rather than polling.  'last' is taken before reading, so a write that
+                    // lands while we read is still noticed.
+                    if (pass > 0) {
                         repl::waitForOptimeChange(last, 1000/*ms*/);
                     }
+                    last = getLastSetOptime();
                 }
 
-                msgdata = newGetMore(txn,
-                                     ns,
-                                     ntoreturn,
-                                     cursorid,
-                                     curop,
-                                     pass,
-                                     exhaust,
-                                     &isCursorAuthorized);
+                haveResults = newGetMore(txn,
+                                         ns,
+                                         ntoreturn,
+                                         cursorid,
+                                         curop,
+                                         pass,
+                                         exhaust,
+                                         &isCursorAuthorized,
+                                         &resp);
             }
             catch ( AssertionException& e ) {
                 if ( isCursorAuthorized ) {
@@ -731,7 +813,7 @@ namespace mongo {
                 break;
             }
             
-            if (msgdata == 0) {
+            if (!haveResults) {
                 // this should only happen with QueryOption_AwaitData
                 exhaust = false;
                 massert(13073, "shutting down", !inShutdown() );
@@ -746,10 +828,12 @@ namespace mongo {
                     }
                 }
                 pass++;
-                if (debug)
-                    sleepmillis(20);
-                else
-                    sleepmillis(2);
+                if (!str::startsWith(ns, "local.oplog.")) {
+                    if (debug)
+                        sleepmillis(20);
+                    else
+                        sleepmillis(2);
+                }
                 
                 // note: the 1100 is beacuse of the waitForDifferent above
                 // should eventually clean this up a bit
@@ -773,12 +857,11 @@ namespace mongo {
             return ok;
         }
 
-        Message *resp = new Message();
-        resp->setData(msgdata, true);
-        curop.debug().responseLength = resp->header()->dataLen();
-        curop.debug().nreturned = msgdata->nReturned;
+        curop.debug().responseLength = resp.header()->dataLen();
+        curop.debug().nreturned = static_cast<QueryResult*>(resp.header())->nReturned;
 
-        dbresponse.response = resp;
+        // Takes over the buffers of 'resp'.
+        dbresponse.response = new Message(resp);
         dbresponse.responseTo = m.header()->id;
         
         if( exhaust ) {
@@ -819,6 +902,7 @@ namespace mongo {
 
             uassertStatusOK( status );
             repl::logOp(txn, "i", ns, js);
+            uassertStatusOK( createTimePartitionIndexes( txn, ctx.db(), collection, js ) );
             return;
         }
 
@@ -833,9 +917,17 @@ namespace mongo {
             verify( collection );
         }
 
+        const TimePartitionOptions timePartition = collection->getTimePartitionOptions( txn );
+        if ( timePartition.isSet() ) {
+            StatusWith<Collection*> partition =
+                getTimePartitionForInsert( txn, ctx.db(), collection, timePartition, js );
+            uassertStatusOK( partition.getStatus() );
+            collection = partition.getValue();
+        }
+
         StatusWith<DiskLoc> status = collection->insertDocument( txn, js, true );
         uassertStatusOK( status.getStatus() );
-        repl::logOp(txn, "i", ns, js);
+        repl::logOp(txn, "i", collection->ns().ns().c_str(), js);
     }
 
     NOINLINE_DECL void insertMulti(OperationContext* txn,
@@ -1153,6 +1245,7 @@ namespace {
                 }
                 log() << "dbexit: " << why << "; exiting immediately";
                 if ( c ) c->shutdown();
+                logger::BufferedLogWriter::flushAll();
                 ::_exit( rc );
             }
         }
@@ -1188,6 +1281,7 @@ namespace {
 #endif
         log() << "dbexit: really exiting now";
         if ( c ) c->shutdown();
+        logger::BufferedLogWriter::flushAll();
         ::_exit(rc);
     }
 
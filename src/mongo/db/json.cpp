@@ -50,6 +50,29 @@ namespace mongo {
 #define CONTROL "\a\b\f\n\r\t\v"
 #define JOPTIONS "gims"
 
+    namespace {
+        /**
+         * Converts the two byte Unicode code point to its UTF8 character encoding
+         * representation, which takes one to three characters.
+         */
+        std::string encodeUTF8CodePoint(unsigned char first, unsigned char second) {
+            std::ostringstream oss;
+            if (first == 0 && second < 0x80) {
+                oss << second;
+            }
+            else if (first < 0x08) {
+                oss << char( 0xc0 | (first << 2 | second >> 6) );
+                oss << char( 0x80 | (~0xc0 & second) );
+            }
+            else {
+                oss << char( 0xe0 | (first >> 4) );
+                oss << char( 0x80 | (~0xc0 & (first << 2 | second >> 6) ) );
+                oss << char( 0x80 | (~0xc0 & second) );
+            }
+            return oss.str();
+        }
+    }
+
     // Size hints given to char vectors
     enum {
         ID_RESERVE_SIZE = 64,
@@ -1096,22 +1119,10 @@ namespace mongo {
     }
 
     std::string JParse::encodeUTF8(unsigned char first, unsigned char second) const {
-        std::ostringstream oss;
-        if (first == 0 && second < 0x80) {
-            oss << second;
-        }
-        else if (first < 0x08) {
-            oss << char( 0xc0 | (first << 2 | second >> 6) );
-            oss << char( 0x80 | (~0xc0 & second) );
-        }
-        else {
-            oss << char( 0xe0 | (first >> 4) );
-            oss << char( 0x80 | (~0xc0 & (first << 2 | second >> 6) ) );
-            oss << char( 0x80 | (~0xc0 & second) );
-        }
-        return oss.str();
+        return encodeUTF8CodePoint(first, second);
     }
 
+
     inline bool JParse::peekToken(const char* token) {
         return readTokenImpl(token, false);
     }
@@ -1221,4 +1232,259 @@ namespace mongo {
         return fromjson( str.c_str() );
     }
 
+    namespace {
+
+        /**
+         * Single pass parser for plain JSON, which reads field names and unescaped strings in
+         * place rather than copying them.  Each method returns false as soon as the input is
+         * anything but plain JSON, leaving the builder half built; the caller then starts over
+         * with JParse, which either handles the extension or reports the parse error.
+         */
+        class PlainJsonParser {
+        public:
+            explicit PlainJsonParser(const char* input) : _input(input) {}
+
+            const char* position() const { return _input; }
+
+            bool object(BSONObjBuilder& builder) {
+                if (!readChar('{')) {
+                    return false;
+                }
+                if (readChar('}')) {
+                    return true;
+                }
+                do {
+                    StringData fieldName;
+                    if (!field(&fieldName) || !readChar(':') || !value(fieldName, builder)) {
+                        return false;
+                    }
+                } while (readChar(','));
+                return readChar('}');
+            }
+
+        private:
+            bool value(const StringData& fieldName, BSONObjBuilder& builder) {
+                skipSpace();
+                switch (*_input) {
+                case '{': {
+                    BSONObjBuilder sub(builder.subobjStart(fieldName));
+                    if (!object(sub)) {
+                        return false;
+                    }
+                    sub.done();
+                    return true;
+                }
+                case '[':
+                    return array(fieldName, builder);
+                case '"':
+                    return string(fieldName, builder);
+                case 't':
+                    if (!readWord("true")) {
+                        return false;
+                    }
+                    builder.append(fieldName, true);
+                    return true;
+                case 'f':
+                    if (!readWord("false")) {
+                        return false;
+                    }
+                    builder.append(fieldName, false);
+                    return true;
+                case 'n':
+                    if (!readWord("null")) {
+                        return false;
+                    }
+                    builder.appendNull(fieldName);
+                    return true;
+                default:
+                    return number(fieldName, builder);
+                }
+            }
+
+            bool array(const StringData& fieldName, BSONObjBuilder& builder) {
+                ++_input; // '['
+                BSONObjBuilder sub(builder.subarrayStart(fieldName));
+                if (!readChar(']')) {
+                    int index = 0;
+                    do {
+                        if (!value(BSONObjBuilder::numStr(index++), sub)) {
+                            return false;
+                        }
+                    } while (readChar(','));
+                    if (!readChar(']')) {
+                        return false;
+                    }
+                }
+                sub.done();
+                return true;
+            }
+
+            // Only double quoted names without escapes or '$', which JParse treats specially
+            bool field(StringData* fieldName) {
+                skipSpace();
+                if (*_input != '"') {
+                    return false;
+                }
+                const char* start = ++_input;
+                while (*_input != '"') {
+                    if (*_input == '\\' || isControl(*_input)) {
+                        return false;
+                    }
+                    ++_input;
+                }
+                *fieldName = StringData(start, _input - start);
+                ++_input;
+                return fieldName->empty() || (*fieldName)[0] != '$';
+            }
+
+            bool string(const StringData& fieldName, BSONObjBuilder& builder) {
+                const char* start = ++_input; // '"'
+                while (*_input != '"' && *_input != '\\') {
+                    if (isControl(*_input)) {
+                        return false;
+                    }
+                    ++_input;
+                }
+                if (*_input == '"') {
+                    builder.append(fieldName, StringData(start, _input - start));
+                    ++_input;
+                    return true;
+                }
+
+                _scratch.assign(start, _input - start);
+                while (*_input != '"') {
+                    if (isControl(*_input)) {
+                        return false;
+                    }
+                    if (*_input == '\\') {
+                        if (!escape()) {
+                            return false;
+                        }
+                    }
+                    else {
+                        _scratch.push_back(*_input++);
+                    }
+                }
+                ++_input;
+                builder.append(fieldName, _scratch);
+                return true;
+            }
+
+            // Same escapes as JParse::chars
+            bool escape() {
+                const char c = *++_input;
+                switch (c) {
+                case 'b': _scratch.push_back('\b'); break;
+                case 'f': _scratch.push_back('\f'); break;
+                case 'n': _scratch.push_back('\n'); break;
+                case 'r': _scratch.push_back('\r'); break;
+                case 't': _scratch.push_back('\t'); break;
+                case 'v': _scratch.push_back('\v'); break;
+                case 'u': {
+                    for (int i = 1; i <= 4; i++) {
+                        if (!isxdigit(static_cast<unsigned char>(_input[i]))) {
+                            return false;
+                        }
+                    }
+                    const unsigned char first = fromHex(_input + 1);
+                    const unsigned char second = fromHex(_input + 3);
+                    _scratch += encodeUTF8CodePoint(first, second);
+                    _input += 4;
+                    break;
+                }
+                case '\0':
+                case 'x':
+                case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7':
+                    return false;
+                default:
+                    _scratch.push_back(c);
+                    break;
+                }
+                ++_input;
+                return true;
+            }
+
+            // Picks the type exactly as JParse::number does, from the same strtod and strtoll calls
+            bool number(const StringData& fieldName, BSONObjBuilder& builder) {
+                const char* end = _input;
+                while (*end != '\0' && strchr("0123456789+-.eE", *end)) {
+                    ++end;
+                }
+                if (end == _input) {
+                    return false;
+                }
+
+                char* endptrd;
+                errno = 0;
+                const double retd = strtod(_input, &endptrd);
+                if (endptrd != end || errno == ERANGE) {
+                    // e.g. "Infinity" or hex, or out of range
+                    return false;
+                }
+
+                char* endptrll;
+                errno = 0;
+                const long long retll = strtoll(_input, &endptrll, 10);
+                if (endptrll < endptrd || errno == ERANGE) {
+                    builder.append(fieldName, retd);
+                }
+                else if (retll == static_cast<int>(retll)) {
+                    builder.append(fieldName, static_cast<int>(retll));
+                }
+                else {
+                    builder.append(fieldName, retll);
+                }
+                _input = end;
+                return true;
+            }
+
+            bool readChar(char c) {
+                skipSpace();
+                if (*_input != c) {
+                    return false;
+                }
+                ++_input;
+                return true;
+            }
+
+            bool readWord(const char* word) {
+                const size_t len = strlen(word);
+                if (strncmp(_input, word, len) != 0) {
+                    return false;
+                }
+                _input += len;
+                return true;
+            }
+
+            void skipSpace() {
+                while (isspace(*reinterpret_cast<const unsigned char*>(_input))) {
+                    ++_input;
+                }
+            }
+
+            static bool isControl(char c) {
+                return 0x00 <= c && c <= 0x1F;
+            }
+
+            const char* _input;
+            std::string _scratch;
+        };
+
+    }  // namespace
+
+    BSONObj fromjsonFast(const char* jsonString, int* len) {
+        PlainJsonParser parser(jsonString);
+        try {
+            BSONObjBuilder builder;
+            if (parser.object(builder)) {
+                if (len) *len = parser.position() - jsonString;
+                return builder.obj();
+            }
+        }
+        catch (const std::exception&) {
+            // fromjson will throw the error the way it does
+        }
+        return fromjson(jsonString, len);
+    }
+
 }  /* namespace mongo */
@@ -54,6 +54,14 @@ namespace mongo {
     /** @param len will be size of JSON object in text chars. */
     MONGO_CLIENT_API BSONObj fromjson(const char* str, int* len=NULL);
 
+    /**
+     * Same result as fromjson, but parses plain JSON (objects, arrays, double quoted field names
+     * and strings, numbers, true, false and null) in a single pass without JParse's
+     * backtracking and copying.  Input using any of the extensions, or that doesn't parse, is
+     * handed to fromjson instead.  Meant for hot paths such as mongoimport.
+     */
+    MONGO_CLIENT_API BSONObj fromjsonFast(const char* str, int* len=NULL);
+
     /**
      * Parser class.  A BSONObj is constructed incrementally by passing a
      * BSONObjBuilder to the recursive parsing methods.  The grammar for the
@@ -0,0 +1,226 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/matcher/compiled_matcher.h"
+
+#include <algorithm>
+
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/path_internal.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+    CompiledMatcher::CompiledMatcher(const MatchExpression* root) {
+        addConjunct(root);
+
+        for (size_t i = 0; i < _steps.size(); ++i) {
+            _steps[i].rank = rankStep(_steps[i]);
+        }
+        std::stable_sort(_steps.begin(), _steps.end(), rankLess);
+    }
+
+    void CompiledMatcher::addConjunct(const MatchExpression* expr) {
+        if (MatchExpression::AND == expr->matchType()) {
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                addConjunct(expr->getChild(i));
+            }
+            return;
+        }
+
+        if (!isFusableLeaf(expr)) {
+            Step step;
+            step.opaque = expr;
+            _steps.push_back(step);
+            return;
+        }
+
+        // Find the step over the same path, if any, so the leaves can share the extraction.
+        Step* step = NULL;
+        for (size_t i = 0; i < _steps.size(); ++i) {
+            if (_steps[i].pathSlot >= 0 &&
+                _paths[_steps[i].pathSlot]->equalsDottedField(expr->path())) {
+                step = &_steps[i];
+                break;
+            }
+        }
+
+        if (NULL == step) {
+            _steps.push_back(Step());
+            step = &_steps.back();
+            step->pathSlot = _paths.size();
+            _paths.push_back(new FieldRef(expr->path()));
+        }
+
+        switch (expr->matchType()) {
+        case MatchExpression::LTE:
+        case MatchExpression::LT:
+        case MatchExpression::EQ:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            step->comparisons.push_back(static_cast<const ComparisonMatchExpression*>(expr));
+            break;
+        default:
+            step->leaves.push_back(static_cast<const LeafMatchExpression*>(expr));
+            break;
+        }
+    }
+
+    bool CompiledMatcher::matchesBSON(const BSONObj& doc) const {
+        for (std::vector<Step>::const_iterator it = _steps.begin(); it != _steps.end(); ++it) {
+            if (NULL != it->opaque) {
+                if (!it->opaque->matchesBSON(doc)) {
+                    return false;
+                }
+            }
+            else if (!matchesStep(*it, doc)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool CompiledMatcher::matchesStep(const Step& step, const BSONObj& doc) const {
+        size_t idxPath = 0;
+        const BSONElement elt = getFieldDottedOrArray(doc, *_paths[step.pathSlot], &idxPath);
+
+        // Arrays may yield any number of elements to each leaf. Let the interpreter sort
+        // those out.
+        if (Array == elt.type()) {
+            for (size_t i = 0; i < step.comparisons.size(); ++i) {
+                if (!step.comparisons[i]->matchesBSON(doc)) {
+                    return false;
+                }
+            }
+            for (size_t i = 0; i < step.leaves.size(); ++i) {
+                if (!step.leaves[i]->matchesBSON(doc)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Otherwise 'elt' is the single element, possibly EOO, that the path iterator would
+        // have handed to each leaf.
+        for (size_t i = 0; i < step.comparisons.size(); ++i) {
+            if (!step.comparisons[i]->ComparisonMatchExpression::matchesSingleElement(elt)) {
+                return false;
+            }
+        }
+        for (size_t i = 0; i < step.leaves.size(); ++i) {
+            if (!step.leaves[i]->matchesSingleElement(elt)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // static
+    bool CompiledMatcher::isFusableLeaf(const MatchExpression* expr) {
+        // These are exactly the LeafMatchExpressions that rely on the default path iteration
+        // of LeafMatchExpression::matches.
+        switch (expr->matchType()) {
+        case MatchExpression::LTE:
+        case MatchExpression::LT:
+        case MatchExpression::EQ:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+        case MatchExpression::REGEX:
+        case MatchExpression::MOD:
+        case MatchExpression::EXISTS:
+        case MatchExpression::MATCH_IN:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // static
+    CompiledMatcher::Rank CompiledMatcher::rankStep(const Step& step) {
+        if (NULL != step.opaque) {
+            return MatchExpression::WHERE == step.opaque->matchType() ? RANK_WHERE : RANK_OPAQUE;
+        }
+
+        bool hasLower = false;
+        bool hasUpper = false;
+        for (size_t i = 0; i < step.comparisons.size(); ++i) {
+            switch (step.comparisons[i]->matchType()) {
+            case MatchExpression::EQ:
+                return RANK_EQUALITY;
+            case MatchExpression::GT:
+            case MatchExpression::GTE:
+                hasLower = true;
+                break;
+            default:
+                hasUpper = true;
+                break;
+            }
+        }
+
+        if (hasLower && hasUpper) {
+            return RANK_BOUNDED_RANGE;
+        }
+
+        bool allRegex = true;
+        for (size_t i = 0; i < step.leaves.size(); ++i) {
+            if (MatchExpression::MATCH_IN == step.leaves[i]->matchType()) {
+                return RANK_IN;
+            }
+            allRegex = allRegex && (MatchExpression::REGEX == step.leaves[i]->matchType());
+        }
+
+        if (hasLower || hasUpper) {
+            return RANK_RANGE;
+        }
+
+        return allRegex ? RANK_REGEX : RANK_OTHER_LEAF;
+    }
+
+    // static
+    bool CompiledMatcher::rankLess(const Step& lhs, const Step& rhs) {
+        return lhs.rank < rhs.rank;
+    }
+
+    std::string CompiledMatcher::debugString() const {
+        mongoutils::str::stream ss;
+        for (size_t i = 0; i < _steps.size(); ++i) {
+            const Step& step = _steps[i];
+            ss << i << ": ";
+            if (NULL != step.opaque) {
+                ss << "interpret " << step.opaque->toString();
+                continue;
+            }
+
+            ss << "path " << _paths[step.pathSlot]->dottedField()
+               << " comparisons: " << step.comparisons.size()
+               << " leaves: " << step.leaves.size() << "\n";
+        }
+        return ss;
+    }
+
+}  // namespace mongo
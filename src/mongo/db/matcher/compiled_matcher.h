@@ -0,0 +1,138 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/owned_pointer_vector.h"
+#include "mongo/db/field_ref.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/expression.h"
+
+namespace mongo {
+
+    class ComparisonMatchExpression;
+    class LeafMatchExpression;
+
+    /**
+     * A CompiledMatcher flattens a MatchExpression tree into a linear program that answers
+     * the same question as MatchExpression::matchesBSON, but without re-walking the tree and
+     * the field paths for every document.
+     *
+     * The top-level conjunction of the expression is flattened into a list of steps. All
+     * the leaves over the same path are fused into a single step, so that the path is
+     * extracted from the document only once and then tested against each of them. Steps are
+     * ordered so that those more likely to reject a document, and cheaper to run, go first.
+     * Anything that cannot be compiled -- $or, $not, $elemMatch, $where, and so on -- becomes
+     * an opaque step evaluated by the interpreter.
+     *
+     * Arrays are not compiled: whenever a path runs into an array in a given document, the
+     * leaves of that step fall back to the interpreter for that document.
+     *
+     * A CompiledMatcher does not own the expression it was built from, which must outlive it.
+     * It cannot produce MatchDetails.
+     */
+    class CompiledMatcher {
+        MONGO_DISALLOW_COPYING(CompiledMatcher);
+    public:
+        explicit CompiledMatcher(const MatchExpression* root);
+
+        /**
+         * Returns the same as 'root->matchesBSON(doc)' for the 'root' this was built from.
+         */
+        bool matchesBSON(const BSONObj& doc) const;
+
+        /**
+         * Returns true if at least one step is not opaque, that is, if using the compiled
+         * program is expected to beat the interpreter.
+         */
+        bool hasCompiledSteps() const { return !_paths.empty(); }
+
+        size_t numSteps() const { return _steps.size(); }
+
+        std::string debugString() const;
+
+    private:
+        /**
+         * Relative cost of evaluating a step, lower first. Steps of equal rank keep their
+         * order in the original expression.
+         */
+        enum Rank {
+            RANK_EQUALITY = 0,
+            RANK_BOUNDED_RANGE,
+            RANK_IN,
+            RANK_RANGE,
+            RANK_OTHER_LEAF,
+            RANK_REGEX,
+            RANK_OPAQUE,
+            RANK_WHERE
+        };
+
+        struct Step {
+            Step() : pathSlot(-1), opaque(NULL), rank(RANK_OPAQUE) {}
+
+            // Index in '_paths' of the path all 'leaves' are over, or -1 if opaque.
+            int pathSlot;
+
+            // The fused leaves. Comparisons are kept apart from other leaves so that they
+            // can be evaluated without a virtual call.
+            std::vector<const ComparisonMatchExpression*> comparisons;
+            std::vector<const LeafMatchExpression*> leaves;
+
+            // Set only for opaque steps.
+            const MatchExpression* opaque;
+
+            Rank rank;
+        };
+
+        /**
+         * Adds 'expr', a conjunct of the top-level expression, to the program.
+         */
+        void addConjunct(const MatchExpression* expr);
+
+        /**
+         * Returns true if all the leaves in 'step' are satisfied by 'doc'.
+         */
+        bool matchesStep(const Step& step, const BSONObj& doc) const;
+
+        static bool isFusableLeaf(const MatchExpression* expr);
+
+        static Rank rankStep(const Step& step);
+
+        static bool rankLess(const Step& lhs, const Step& rhs);
+
+        std::vector<Step> _steps;
+
+        // The distinct paths referenced by the program, parsed once.
+        OwnedPointerVector<FieldRef> _paths;
+    };
+
+}  // namespace mongo
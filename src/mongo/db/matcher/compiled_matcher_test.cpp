@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/** Unit tests for CompiledMatcher. */
+
+#include "mongo/unittest/unittest.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/compiled_matcher.h"
+#include "mongo/db/matcher/expression_parser.h"
+
+namespace mongo {
+
+    namespace {
+
+        /**
+         * Asserts that the compiled form of 'query' agrees with the interpreter on every one
+         * of 'docs'.
+         */
+        void assertSameAsInterpreter(const char* query, const std::vector<BSONObj>& docs) {
+            const BSONObj queryObj = fromjson(query);
+            StatusWithMatchExpression result = MatchExpressionParser::parse(queryObj);
+            ASSERT_OK(result.getStatus());
+            boost::scoped_ptr<MatchExpression> expr(result.getValue());
+            CompiledMatcher compiled(expr.get());
+
+            for (size_t i = 0; i < docs.size(); ++i) {
+                ASSERT_EQUALS(expr->matchesBSON(docs[i]), compiled.matchesBSON(docs[i]));
+            }
+        }
+
+        std::vector<BSONObj> sampleDocs() {
+            std::vector<BSONObj> docs;
+            docs.push_back(fromjson("{}"));
+            docs.push_back(fromjson("{a: 1}"));
+            docs.push_back(fromjson("{a: 5, b: 'x'}"));
+            docs.push_back(fromjson("{a: null, b: 'y'}"));
+            docs.push_back(fromjson("{a: [1, 5, 9], b: 'x'}"));
+            docs.push_back(fromjson("{a: {b: 3}, c: 2}"));
+            docs.push_back(fromjson("{a: [{b: 3}, {b: 7}], c: 2}"));
+            docs.push_back(fromjson("{a: 7.5, b: 'xyz', c: [2]}"));
+            docs.push_back(fromjson("{a: 'str', b: 1}"));
+            return docs;
+        }
+
+        size_t numStepsFor(const char* query) {
+            const BSONObj queryObj = fromjson(query);
+            StatusWithMatchExpression result = MatchExpressionParser::parse(queryObj);
+            ASSERT_OK(result.getStatus());
+            boost::scoped_ptr<MatchExpression> expr(result.getValue());
+            return CompiledMatcher(expr.get()).numSteps();
+        }
+
+    } // namespace
+
+    TEST(CompiledMatcherTest, AgreesWithInterpreter) {
+        const std::vector<BSONObj> docs = sampleDocs();
+        assertSameAsInterpreter("{a: 5}", docs);
+        assertSameAsInterpreter("{a: null}", docs);
+        assertSameAsInterpreter("{a: {$gt: 1, $lt: 8}}", docs);
+        assertSameAsInterpreter("{a: {$gte: 1}, b: 'x'}", docs);
+        assertSameAsInterpreter("{a: {$in: [1, 9]}, b: {$exists: true}}", docs);
+        assertSameAsInterpreter("{'a.b': {$gt: 5}}", docs);
+        assertSameAsInterpreter("{'a.b': 3, c: 2}", docs);
+        assertSameAsInterpreter("{b: /^x/, a: {$mod: [2, 1]}}", docs);
+        assertSameAsInterpreter("{$or: [{a: 1}, {b: 'y'}], c: {$exists: false}}", docs);
+        assertSameAsInterpreter("{a: {$not: {$gt: 3}}, b: {$ne: 'x'}}", docs);
+        assertSameAsInterpreter("{a: {$elemMatch: {$gt: 4}}}", docs);
+        assertSameAsInterpreter("{c: {$size: 1}, a: {$type: 1}}", docs);
+        assertSameAsInterpreter("{$and: [{a: {$gt: 0}}, {$and: [{a: {$lt: 6}}, {b: 'x'}]}]}",
+                                docs);
+    }
+
+    TEST(CompiledMatcherTest, FusesLeavesOverTheSamePath) {
+        ASSERT_EQUALS(1U, numStepsFor("{a: {$gt: 1, $lt: 8}}"));
+        ASSERT_EQUALS(1U,
+                      numStepsFor("{$and: [{a: {$gt: 1}}, {a: {$exists: true}}, {a: {$lt: 8}}]}"));
+        ASSERT_EQUALS(2U, numStepsFor("{a: {$gt: 1}, 'a.b': {$lt: 8}}"));
+    }
+
+    TEST(CompiledMatcherTest, OnlyOpaqueSteps) {
+        const BSONObj queryObj = fromjson("{$or: [{a: 1}, {b: 1}]}");
+        StatusWithMatchExpression result = MatchExpressionParser::parse(queryObj);
+        ASSERT_OK(result.getStatus());
+        boost::scoped_ptr<MatchExpression> expr(result.getValue());
+        CompiledMatcher compiled(expr.get());
+        ASSERT_EQUALS(1U, compiled.numSteps());
+        ASSERT_FALSE(compiled.hasCompiledSteps());
+        ASSERT_TRUE(compiled.matchesBSON(fromjson("{b: 1}")));
+        ASSERT_FALSE(compiled.matchesBSON(fromjson("{b: 2}")));
+    }
+
+    TEST(CompiledMatcherTest, EmptyConjunctionMatchesEverything) {
+        const BSONObj queryObj = fromjson("{}");
+        StatusWithMatchExpression result = MatchExpressionParser::parse(queryObj);
+        ASSERT_OK(result.getStatus());
+        boost::scoped_ptr<MatchExpression> expr(result.getValue());
+        CompiledMatcher compiled(expr.get());
+        ASSERT_EQUALS(0U, compiled.numSteps());
+        ASSERT_TRUE(compiled.matchesBSON(fromjson("{a: 1}")));
+    }
+
+}  // namespace mongo
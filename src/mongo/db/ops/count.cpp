@@ -34,6 +34,7 @@
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/time_partition.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/query/get_runner.h"
 #include "mongo/db/query/type_explain.h"
@@ -80,6 +81,13 @@ namespace mongo {
             return -1;
         }
 
+        const Status timePartitionStatus = checkNotTimePartitioned(txn, collection, "count");
+        if (!timePartitionStatus.isOK()) {
+            err = timePartitionStatus.reason();
+            errCode = timePartitionStatus.code();
+            return -2;
+        }
+
         BSONObj query = cmd.getObjectField("query");
         const std::string hint = cmd.getStringField("hint");
         const BSONObj hintObj = hint.empty() ? BSONObj() : BSON("$hint" << hint);
@@ -31,6 +31,7 @@
 #include "mongo/db/ops/delete_executor.h"
 
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/time_partition.h"
 #include "mongo/db/client.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/ops/delete_request.h"
@@ -108,6 +109,8 @@ namespace mongo {
                 str::stream() << "cannot remove from a capped collection: " << ns.ns(),
                 !collection->isCapped());
 
+        uassertStatusOK(checkNotTimePartitioned(txn, collection, "remove"));
+
         uassert(ErrorCodes::NotMaster,
                 str::stream() << "Not primary while removing from " << ns.ns(),
                 !logop || repl::isMasterNs(ns.ns().c_str()));
@@ -38,6 +38,7 @@
 #include "mongo/bson/mutable/document.h"
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/catalog/time_partition.h"
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/index_set.h"
 #include "mongo/db/ops/update_driver.h"
@@ -440,6 +441,7 @@ namespace mongo {
         UpdateLifecycle* lifecycle = request.getLifecycle();
 
         Collection* collection = db->getCollection(txn, nsString.ns());
+        uassertStatusOK(checkNotTimePartitioned(txn, collection, "update"));
 
         validateUpdate(nsString.ns().c_str(), request.getUpdates(), request.getQuery());
 
@@ -545,76 +547,84 @@ namespace mongo {
             opDebug->nscannedObjects++;
             numMatched++;
 
-            // Ask the driver to apply the mods. It may be that the driver can apply those "in
-            // place", that is, some values of the old document just get adjusted without any
-            // change to the binary layout on the bson layer. It may be that a whole new
-            // document is needed to accomodate the new bson layout of the resulting document.
-            doc.reset(oldObj, mutablebson::Document::kInPlaceEnabled);
+            // For simple mods over fixed-width fields, the driver can compute the changes
+            // straight from the old document, without building a mutable one. We call those
+            // changes "damages". :)
             BSONObj logObj;
+            const char* source = NULL;
+            bool docWasModified = false;
+            BSONObj newObj;
+            bool inPlace = !driver->needMatchDetails() &&
+                           driver->updateInPlace(oldObj, &damages, &source, &logObj);
+
+            if (!inPlace) {
+                // Ask the driver to apply the mods. It may be that the driver can apply those
+                // "in place", that is, some values of the old document just get adjusted without
+                // any change to the binary layout on the bson layer. It may be that a whole new
+                // document is needed to accomodate the new bson layout of the resulting
+                // document.
+                doc.reset(oldObj, mutablebson::Document::kInPlaceEnabled);
+
+                FieldRefSet updatedFields;
+
+                Status status = Status::OK();
+                if (!driver->needMatchDetails()) {
+                    // If we don't need match details, avoid doing the rematch
+                    status = driver->update(StringData(), &doc, &logObj, &updatedFields);
+                }
+                else {
+                    // If there was a matched field, obtain it.
+                    MatchDetails matchDetails;
+                    matchDetails.requestElemMatchKey();
 
+                    dassert(cq);
+                    verify(cq->root()->matchesBSON(oldObj, &matchDetails));
 
-            FieldRefSet updatedFields;
-
-            Status status = Status::OK();
-            if (!driver->needMatchDetails()) {
-                // If we don't need match details, avoid doing the rematch
-                status = driver->update(StringData(), &doc, &logObj, &updatedFields);
-            }
-            else {
-                // If there was a matched field, obtain it.
-                MatchDetails matchDetails;
-                matchDetails.requestElemMatchKey();
-
-                dassert(cq);
-                verify(cq->root()->matchesBSON(oldObj, &matchDetails));
-
-                string matchedField;
-                if (matchDetails.hasElemMatchKey())
-                    matchedField = matchDetails.elemMatchKey();
+                    string matchedField;
+                    if (matchDetails.hasElemMatchKey())
+                        matchedField = matchDetails.elemMatchKey();
 
-                // TODO: Right now, each mod checks in 'prepare' that if it needs positional
-                // data, that a non-empty StringData() was provided. In principle, we could do
-                // that check here in an else clause to the above conditional and remove the
-                // checks from the mods.
+                    // TODO: Right now, each mod checks in 'prepare' that if it needs
+                    // positional data, that a non-empty StringData() was provided. In
+                    // principle, we could do that check here in an else clause to the above
+                    // conditional and remove the checks from the mods.
 
-                status = driver->update(matchedField, &doc, &logObj, &updatedFields);
-            }
+                    status = driver->update(matchedField, &doc, &logObj, &updatedFields);
+                }
 
-            if (!status.isOK()) {
-                uasserted(16837, status.reason());
-            }
+                if (!status.isOK()) {
+                    uasserted(16837, status.reason());
+                }
 
-            // Ensure _id exists and is first
-            uassertStatusOK(ensureIdAndFirst(doc));
+                // Ensure _id exists and is first
+                uassertStatusOK(ensureIdAndFirst(doc));
 
-            // If the driver applied the mods in place, we can ask the mutable for what
-            // changed. We call those changes "damages". :) We use the damages to inform the
-            // journal what was changed, and then apply them to the original document
-            // ourselves. If, however, the driver applied the mods out of place, we ask it to
-            // generate a new, modified document for us. In that case, the file manager will
-            // take care of the journaling details for us.
-            //
-            // This code flow is admittedly odd. But, right now, journaling is baked in the file
-            // manager. And if we aren't using the file manager, we have to do jounaling
-            // ourselves.
-            bool docWasModified = false;
-            BSONObj newObj;
-            const char* source = NULL;
-            bool inPlace = doc.getInPlaceUpdates(&damages, &source);
-
-            // If something changed in the document, verify that no immutable fields were changed
-            // and data is valid for storage.
-            if ((!inPlace || !damages.empty()) ) {
-                if (!(request.isFromReplication() || request.isFromMigration())) {
-                    const std::vector<FieldRef*>* immutableFields = NULL;
-                    if (lifecycle)
-                        immutableFields = lifecycle->getImmutableFields();
-
-                    uassertStatusOK(validate(oldObj,
-                                             updatedFields,
-                                             doc,
-                                             immutableFields,
-                                             driver->modOptions()) );
+                // If the driver applied the mods in place, we can ask the mutable for what
+                // changed. We use the damages to inform the journal what was changed, and then
+                // apply them to the original document ourselves. If, however, the driver
+                // applied the mods out of place, we ask it to generate a new, modified document
+                // for us. In that case, the file manager will take care of the journaling
+                // details for us.
+                //
+                // This code flow is admittedly odd. But, right now, journaling is baked in the
+                // file manager. And if we aren't using the file manager, we have to do
+                // jounaling ourselves.
+                inPlace = doc.getInPlaceUpdates(&damages, &source);
+
+                // If something changed in the document, verify that no immutable fields were
+                // changed and data is valid for storage.
+                if ((!inPlace || !damages.empty()) ) {
+                    if (!(request.isFromReplication() || request.isFromMigration())) {
+                        const std::vector<FieldRef*>* immutableFields = NULL;
+                        if (lifecycle)
+                            immutableFields = lifecycle->getImmutableFields();
+
+                        uassertStatusOK(validate(oldObj,
+                                                 updatedFields,
+                                                 doc,
+                                                 immutableFields,
+                                                 driver->modOptions()) );
+                    }
                 }
             }
 
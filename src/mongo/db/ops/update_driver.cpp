@@ -33,6 +33,7 @@
 #include "mongo/bson/mutable/algorithm.h"
 #include "mongo/bson/mutable/document.h"
 #include "mongo/db/field_ref.h"
+#include "mongo/db/global_optime.h"
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/ops/log_builder.h"
 #include "mongo/db/ops/modifier_object_replace.h"
@@ -40,14 +41,49 @@
 #include "mongo/db/ops/path_support.h"
 #include "mongo/util/embedded_builder.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/safe_num.h"
 
 namespace mongo {
 
     namespace str = mongoutils::str;
     namespace mb = mongo::mutablebson;
 
+    namespace {
+
+        /**
+         * Returns true if values of type 'type' always have the same size, so that replacing
+         * one such value by another of the same type never changes the document layout.
+         */
+        bool isFixedWidthType(BSONType type) {
+            switch (type) {
+            case NumberDouble:
+            case NumberInt:
+            case NumberLong:
+            case Bool:
+            case Date:
+            case Timestamp:
+            case jstOID:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        /**
+         * Returns true if the $currentDate argument 'modExpr' requests a Date, as opposed to
+         * a Timestamp. Assumes 'modExpr' was already validated by ModifierCurrentDate.
+         */
+        bool currentDateWantsDate(const BSONElement& modExpr) {
+            if (modExpr.type() != Object)
+                return true;
+            return modExpr.embeddedObject()["$type"].str() != "timestamp";
+        }
+
+    } // namespace
+
     UpdateDriver::UpdateDriver(const Options& opts)
         : _replacementMode(false)
+        , _inPlaceEligible(false)
         , _indexedFields(NULL)
         , _logOp(opts.logOp)
         , _modOptions(opts.modOptions)
@@ -90,6 +126,9 @@ namespace mongo {
 
         // The update expression is made of mod operators, that is
         // { <$mod>: {...}, <$mod>: {...}, ...  }
+        // Each mod parsed below gets a chance to rule out the in-place fast path.
+        _inPlaceEligible = true;
+
         BSONObjIterator outerIter(updateExpr);
         while (outerIter.more()) {
             BSONElement outerModElem = outerIter.next();
@@ -160,6 +199,24 @@ namespace mongo {
 
         _mods.push_back(mod.release());
 
+        // Keep what 'updateInPlace' needs to redo this mod straight over a BSONObj, as long
+        // as all the mods seen so far allow it.
+        if (_inPlaceEligible) {
+            const bool fastType = (type == modifiertable::MOD_INC) ||
+                                  (type == modifiertable::MOD_CURRENTDATE) ||
+                                  (type == modifiertable::MOD_SET &&
+                                   isFixedWidthType(elem.type()));
+            if (fastType && !positional) {
+                _inPlaceExprs.push_back(std::make_pair(type, elem.wrap()));
+                _inPlacePaths.push_back(new FieldRef(elem.fieldNameStringData()));
+            }
+            else {
+                _inPlaceEligible = false;
+                _inPlaceExprs.clear();
+                _inPlacePaths.clear();
+            }
+        }
+
         return Status::OK();
     }
 
@@ -378,6 +435,125 @@ namespace mongo {
         return Status::OK();
     }
 
+    bool UpdateDriver::updateInPlace(const BSONObj& original,
+                                     mutablebson::DamageVector* damages,
+                                     const char** source,
+                                     BSONObj* logOpRec) {
+        if (!_inPlaceEligible) {
+            return false;
+        }
+
+        FieldRefSet targetFields;
+        std::vector<BSONElement> targets;
+        BSONObjBuilder newValues;
+
+        for (size_t i = 0; i < _inPlaceExprs.size(); ++i) {
+            const modifiertable::ModifierType type = _inPlaceExprs[i].first;
+            const BSONElement modExpr = _inPlaceExprs[i].second.firstElement();
+            const FieldRef* path = _inPlacePaths[i];
+
+            // Conflicting mods are reported by the regular path.
+            const FieldRef* other;
+            if (!targetFields.insert(path, &other)) {
+                return false;
+            }
+
+            // Immutable and indexed fields need the validation and index maintenance that
+            // only the regular path provides.
+            if (path->getPart(0) == "_id" ||
+                (_indexedFields && _indexedFields->mightBeIndexed(path->dottedField()))) {
+                return false;
+            }
+
+            const BSONElement current = original.getFieldDotted(path->dottedField());
+            if (current.eoo() || !isFixedWidthType(current.type())) {
+                return false;
+            }
+
+            switch (type) {
+            case modifiertable::MOD_SET:
+                if (modExpr.type() != current.type()) {
+                    return false;
+                }
+
+                // Same no-op rule as ModifierSet.
+                if (current.woCompare(modExpr, false) == 0) {
+                    continue;
+                }
+                newValues.appendAs(modExpr, path->dottedField());
+                break;
+
+            case modifiertable::MOD_INC: {
+                const SafeNum currentValue(current);
+                if (!currentValue.isValid()) {
+                    return false;
+                }
+
+                // Overflows and type promotions change the layout, so they are not in place.
+                const SafeNum newValue = currentValue + SafeNum(modExpr);
+                if (!newValue.isValid() || newValue.type() != current.type()) {
+                    return false;
+                }
+
+                // Same no-op rule as ModifierInc.
+                if (newValue.isIdentical(currentValue)) {
+                    continue;
+                }
+                newValue.toBSON(path->dottedField(), &newValues);
+                break;
+            }
+
+            case modifiertable::MOD_CURRENTDATE:
+                if (currentDateWantsDate(modExpr)) {
+                    if (current.type() != Date) {
+                        return false;
+                    }
+                    newValues.appendDate(path->dottedField(), jsTime());
+                }
+                else {
+                    if (current.type() != Timestamp) {
+                        return false;
+                    }
+                    newValues.append(path->dottedField(), getNextGlobalOptime());
+                }
+                break;
+
+            default:
+                dassert(false);
+                return false;
+            }
+
+            targets.push_back(current);
+        }
+
+        // From here on the update is known to be in place. Each new value in '_inPlaceSource'
+        // lines up, in order, with the element of 'original' it replaces.
+        _affectIndices = false;
+        _inPlaceSource = newValues.obj();
+
+        damages->clear();
+        BSONObjIterator it(_inPlaceSource);
+        for (std::vector<BSONElement>::const_iterator target = targets.begin();
+             target != targets.end();
+             ++target) {
+            const BSONElement newElem = it.next();
+            dassert(newElem.valuesize() == target->valuesize());
+
+            mutablebson::DamageEvent damage;
+            damage.sourceOffset = newElem.value() - _inPlaceSource.objdata();
+            damage.targetOffset = target->value() - original.objdata();
+            damage.size = newElem.valuesize();
+            damages->push_back(damage);
+        }
+        *source = _inPlaceSource.objdata();
+
+        if (_logOp && logOpRec && !_inPlaceSource.isEmpty()) {
+            *logOpRec = BSON("$set" << _inPlaceSource);
+        }
+
+        return true;
+    }
+
     size_t UpdateDriver::numMods() const {
         return _mods.size();
     }
@@ -442,6 +618,9 @@ namespace mongo {
             delete *it;
         }
         _mods.clear();
+        _inPlaceEligible = false;
+        _inPlaceExprs.clear();
+        _inPlacePaths.clear();
         _indexedFields = NULL;
         _replacementMode = false;
         _positional = false;
@@ -33,7 +33,9 @@
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/base/status.h"
+#include "mongo/bson/mutable/damage_vector.h"
 #include "mongo/bson/mutable/document.h"
+#include "mongo/db/field_ref.h"
 #include "mongo/db/field_ref_set.h"
 #include "mongo/db/index_set.h"
 #include "mongo/db/jsobj.h"
@@ -98,6 +100,25 @@ namespace mongo {
                       BSONObj* logOpRec = NULL,
                       FieldRefSet* updatedFields = NULL);
 
+        /**
+         * Returns true and fills in 'damages' if '_mods' could be applied over 'original'
+         * without materializing a mutable document. That is only possible when every mod is
+         * a non-positional $set, $inc, or $currentDate whose target field already exists in
+         * 'original', holds a fixed-width value, and keeps its type after the mod. Targets
+         * that are '_id' or that may be indexed are never handled here.
+         *
+         * The source of the damages is returned in '*source' and stays valid until the next
+         * call to this method. If the driver's '_logOp' mode is on and 'logOpRec' is not
+         * NULL, the latter is filled with the oplog entry for the update, as in 'update'.
+         *
+         * Returns false if the fast path does not apply. In that case nothing was changed
+         * and the caller should fall back to 'update', which also reports any errors.
+         */
+        bool updateInPlace(const BSONObj& original,
+                           mutablebson::DamageVector* damages,
+                           const char** source,
+                           BSONObj* logOpRec = NULL);
+
         //
         // Accessors
         //
@@ -149,6 +170,16 @@ namespace mongo {
         // Collection of update mod instances. Owned here.
         std::vector<ModifierInterface*> _mods;
 
+        // Are all of '_mods' non-positional $set, $inc, or $currentDate mods, with fixed-width
+        // $set values? If so, 'updateInPlace' may try to bypass '_objDoc' entirely.
+        bool _inPlaceEligible;
+
+        // For each of '_mods', in order, its type and an owned copy of the update expression
+        // element it was parsed from (as the sole field of the object), along with the parsed
+        // target path. Only kept while '_inPlaceEligible' holds.
+        std::vector<std::pair<modifiertable::ModifierType, BSONObj> > _inPlaceExprs;
+        OwnedPointerVector<FieldRef> _inPlacePaths;
+
         // What are the list of fields in the collection over which the update is going to be
         // applied that participate in indices?
         //
@@ -180,6 +211,10 @@ namespace mongo {
 
         // The document used to build the oplog entry for the update.
         mutablebson::Document _logDoc;
+
+        // The new values written by the last successful 'updateInPlace' call, in the form of
+        // a $set oplog payload. The damages produced by that call point into this object.
+        BSONObj _inPlaceSource;
     };
 
     struct UpdateDriver::Options {
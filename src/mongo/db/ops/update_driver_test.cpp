@@ -28,7 +28,11 @@
 
 #include "mongo/db/ops/update_driver.h"
 
+#include <cstring>
+#include <string>
+
 #include "mongo/base/string_data.h"
+#include "mongo/bson/mutable/damage_vector.h"
 #include "mongo/bson/mutable/document.h"
 #include "mongo/bson/mutable/mutable_bson_test_utils.h"
 #include "mongo/db/index_set.h"
@@ -40,6 +44,7 @@ namespace {
     using mongo::BSONObj;
     using mongo::fromjson;
     using mongo::IndexPathSet;
+    using mongo::mutablebson::DamageVector;
     using mongo::mutablebson::Document;
     using mongo::StringData;
     using mongo::UpdateDriver;
@@ -170,4 +175,126 @@ namespace {
 
         ASSERT_NOT_OK(driver.populateDocumentWithQueryFields(fromjson("{a:{$all:[1, 2]}}"), doc));
     }
+
+    // Returns a copy of 'original' with 'damages' from 'source' applied over it.
+    BSONObj applyDamages(const BSONObj& original,
+                         const DamageVector& damages,
+                         const char* source) {
+        std::string buf(original.objdata(), original.objsize());
+        for (DamageVector::const_iterator it = damages.begin(); it != damages.end(); ++it) {
+            std::memcpy(&buf[it->targetOffset], source + it->sourceOffset, it->size);
+        }
+        return BSONObj(buf.data()).getOwned();
+    }
+
+    TEST(InPlace, IncTopLevelField) {
+        UpdateDriver::Options opts;
+        UpdateDriver driver(opts);
+        ASSERT_OK(driver.parse(fromjson("{$inc:{a:1}}")));
+
+        const BSONObj original = fromjson("{_id:1, a:5, b:'x'}");
+        DamageVector damages;
+        const char* source = NULL;
+        ASSERT_TRUE(driver.updateInPlace(original, &damages, &source));
+        ASSERT_EQUALS(damages.size(), 1U);
+        ASSERT_EQUALS(applyDamages(original, damages, source), fromjson("{_id:1, a:6, b:'x'}"));
+    }
+
+    TEST(InPlace, SetAndIncDottedFieldsWithLog) {
+        UpdateDriver::Options opts;
+        opts.logOp = true;
+        UpdateDriver driver(opts);
+        ASSERT_OK(driver.parse(fromjson("{$set:{'a.b':true}, $inc:{'c.0':2.5}}")));
+
+        const BSONObj original = fromjson("{_id:1, a:{b:false}, c:[1.5]}");
+        DamageVector damages;
+        const char* source = NULL;
+        BSONObj logObj;
+        ASSERT_TRUE(driver.updateInPlace(original, &damages, &source, &logObj));
+        ASSERT_EQUALS(damages.size(), 2U);
+        ASSERT_EQUALS(applyDamages(original, damages, source),
+                      fromjson("{_id:1, a:{b:true}, c:[4.0]}"));
+        ASSERT_EQUALS(logObj, fromjson("{$set:{'a.b':true, 'c.0':4.0}}"));
+    }
+
+    TEST(InPlace, NoOpProducesNoDamages) {
+        UpdateDriver::Options opts;
+        opts.logOp = true;
+        UpdateDriver driver(opts);
+        ASSERT_OK(driver.parse(fromjson("{$set:{a:5}, $inc:{b:0}}")));
+
+        DamageVector damages;
+        const char* source = NULL;
+        BSONObj logObj;
+        ASSERT_TRUE(driver.updateInPlace(fromjson("{_id:1, a:5, b:1}"),
+                                         &damages, &source, &logObj));
+        ASSERT_TRUE(damages.empty());
+        ASSERT_TRUE(logObj.isEmpty());
+    }
+
+    TEST(InPlace, CurrentDateOverExistingDate) {
+        UpdateDriver::Options opts;
+        UpdateDriver driver(opts);
+        ASSERT_OK(driver.parse(fromjson("{$currentDate:{d:true}}")));
+
+        const BSONObj original = fromjson("{_id:1, d:{$date:0}}");
+        DamageVector damages;
+        const char* source = NULL;
+        ASSERT_TRUE(driver.updateInPlace(original, &damages, &source));
+        ASSERT_EQUALS(damages.size(), 1U);
+        ASSERT_NOT_EQUALS(applyDamages(original, damages, source)["d"].date().millis, 0ULL);
+    }
+
+    TEST(InPlace, IneligibleMods) {
+        UpdateDriver::Options opts;
+        UpdateDriver driver(opts);
+        DamageVector damages;
+        const char* source = NULL;
+        const BSONObj original = fromjson("{_id:1, a:[1], s:'abc'}");
+
+        ASSERT_OK(driver.parse(fromjson("{$push:{a:2}}")));
+        ASSERT_FALSE(driver.updateInPlace(original, &damages, &source));
+
+        ASSERT_OK(driver.parse(fromjson("{$set:{s:'xyz'}}")));
+        ASSERT_FALSE(driver.updateInPlace(original, &damages, &source));
+
+        ASSERT_OK(driver.parse(fromjson("{$inc:{'a.$':1}}")));
+        ASSERT_FALSE(driver.updateInPlace(original, &damages, &source));
+    }
+
+    TEST(InPlace, FallsBackWhenLayoutChanges) {
+        UpdateDriver::Options opts;
+        UpdateDriver driver(opts);
+        DamageVector damages;
+        const char* source = NULL;
+
+        // Missing field.
+        ASSERT_OK(driver.parse(fromjson("{$inc:{a:1}}")));
+        ASSERT_FALSE(driver.updateInPlace(fromjson("{_id:1}"), &damages, &source));
+
+        // Int overflow promotes to long.
+        ASSERT_FALSE(driver.updateInPlace(fromjson("{_id:1, a:2147483647}"), &damages, &source));
+
+        // Type change.
+        ASSERT_OK(driver.parse(fromjson("{$set:{a:1.5}}")));
+        ASSERT_FALSE(driver.updateInPlace(fromjson("{_id:1, a:1}"), &damages, &source));
+    }
+
+    TEST(InPlace, FallsBackForIdAndIndexedFields) {
+        UpdateDriver::Options opts;
+        UpdateDriver driver(opts);
+        DamageVector damages;
+        const char* source = NULL;
+        const BSONObj original = fromjson("{_id:1, a:1}");
+
+        ASSERT_OK(driver.parse(fromjson("{$set:{_id:2}}")));
+        ASSERT_FALSE(driver.updateInPlace(original, &damages, &source));
+
+        IndexPathSet indexedFields;
+        indexedFields.addPath("a");
+        ASSERT_OK(driver.parse(fromjson("{$inc:{a:1}}")));
+        driver.refreshIndexKeys(&indexedFields);
+        ASSERT_FALSE(driver.updateInPlace(original, &damages, &source));
+    }
+
 } // unnamed namespace
@@ -45,6 +45,13 @@ namespace mongo {
             processInternal(input, merging);
         }
 
+        /** Same as calling process() on each of the 'count' Values starting at 'inputs', in
+         *  order.
+         */
+        void processBatch(const Value* inputs, size_t count, bool merging) {
+            processBatchInternal(inputs, count, merging);
+        }
+
         /** Marks the end of the evaluate() phase and return accumulated result.
          *  toBeMerged should be true when the outputs will be merged by process().
          */
@@ -67,6 +74,13 @@ namespace mongo {
         /// Update subclass's internal state based on input
         virtual void processInternal(const Value& input, bool merging) = 0;
 
+        /// Subclasses with simple state override this to process a batch in a tight loop
+        virtual void processBatchInternal(const Value* inputs, size_t count, bool merging) {
+            for (size_t i = 0; i < count; i++) {
+                processInternal(inputs[i], merging);
+            }
+        }
+
         /// subclasses are expected to update this as necessary
         int _memUsageBytes;
     };
@@ -123,6 +137,7 @@ namespace mongo {
     class AccumulatorSum : public Accumulator {
     public:
         virtual void processInternal(const Value& input, bool merging);
+        virtual void processBatchInternal(const Value* inputs, size_t count, bool merging);
         virtual Value getValue(bool toBeMerged) const;
         virtual const char* getOpName() const;
         virtual void reset();
@@ -175,6 +190,7 @@ namespace mongo {
     class AccumulatorAvg : public Accumulator {
     public:
         virtual void processInternal(const Value& input, bool merging);
+        virtual void processBatchInternal(const Value* inputs, size_t count, bool merging);
         virtual Value getValue(bool toBeMerged) const;
         virtual const char* getOpName() const;
         virtual void reset();
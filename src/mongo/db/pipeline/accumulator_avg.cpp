@@ -58,6 +58,30 @@ namespace {
         }
     }
 
+    void AccumulatorAvg::processBatchInternal(const Value* inputs, size_t count, bool merging) {
+        if (merging) {
+            for (size_t i = 0; i < count; i++) {
+                processInternal(inputs[i], merging);
+            }
+            return;
+        }
+
+        // Same as processInternal() on each input, with the running state kept in locals.
+        double total = _total;
+        long long numInputs = _count;
+        for (size_t i = 0; i < count; i++) {
+            // non numeric types have no impact on average
+            if (!inputs[i].numeric())
+                continue;
+
+            total += inputs[i].getDouble();
+            numInputs += 1;
+        }
+
+        _total = total;
+        _count = numInputs;
+    }
+
     intrusive_ptr<Accumulator> AccumulatorAvg::create() {
         return new AccumulatorAvg();
     }
@@ -56,6 +56,33 @@ namespace mongo {
         }
     }
 
+    void AccumulatorSum::processBatchInternal(const Value* inputs, size_t count, bool merging) {
+        // Same as processInternal() on each input, with the running totals kept in locals.
+        BSONType type = totalType;
+        long long longSum = longTotal;
+        double doubleSum = doubleTotal;
+
+        for (size_t i = 0; i < count; i++) {
+            const Value& input = inputs[i];
+            if (!input.numeric())
+                continue;
+
+            type = Value::getWidestNumeric(type, input.getType());
+            if (type == NumberDouble) {
+                doubleSum += input.coerceToDouble();
+            }
+            else {
+                long long v = input.coerceToLong();
+                longSum += v;
+                doubleSum += v;
+            }
+        }
+
+        totalType = type;
+        longTotal = longSum;
+        doubleTotal = doubleSum;
+    }
+
     intrusive_ptr<Accumulator> AccumulatorSum::create() {
         return new AccumulatorSum();
     }
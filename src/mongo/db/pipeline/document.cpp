@@ -129,6 +129,7 @@ namespace mongo {
         const bool firstAlloc = !_buffer;
         const bool doingRehash = needRehash();
         const size_t oldCapacity = _bufferEnd - _buffer;
+        const size_t oldAllocatedBytes = allocatedBytes();
 
         // make new bucket count big enough
         while (needRehash() || hashTabBuckets() < HASH_TAB_INIT_SIZE)
@@ -142,13 +143,13 @@ namespace mongo {
         uassert(16490, "Tried to make oversized document",
                 capacity <= size_t(BufferMaxSize));
 
-        boost::scoped_array<char> oldBuf(_buffer);
-        _buffer = new char[capacity];
+        char* const oldBuf = _buffer;
+        _buffer = static_cast<char*>(DocumentBufferPool::allocate(capacity));
         _bufferEnd = _buffer + capacity - hashTabBytes();
 
         if (!firstAlloc) {
             // This just copies the elements
-            memcpy(_buffer, oldBuf.get(), _usedBytes);
+            memcpy(_buffer, oldBuf, _usedBytes);
 
             if (_numFields >= HASH_TAB_MIN) {
                 // if we were hashing, deal with the hash table
@@ -157,9 +158,11 @@ namespace mongo {
                 }
                 else {
                     // no rehash needed so just slide table down to new position
-                    memcpy(_hashTab, oldBuf.get() + oldCapacity, hashTabBytes());
+                    memcpy(_hashTab, oldBuf + oldCapacity, hashTabBytes());
                 }
             }
+
+            DocumentBufferPool::deallocate(oldBuf, oldAllocatedBytes);
         }
     }
 
@@ -177,8 +180,10 @@ namespace mongo {
         uassert(16491, "Tried to make oversized document",
                 newSize <= size_t(BufferMaxSize));
 
-        _buffer = new char[newSize + hashTabBytes()];
-        _bufferEnd = _buffer + newSize;
+        // Any rounding up by the pool becomes extra space for fields.
+        const size_t capacity = DocumentBufferPool::roundUp(newSize + hashTabBytes());
+        _buffer = static_cast<char*>(DocumentBufferPool::allocate(capacity));
+        _bufferEnd = _buffer + capacity - hashTabBytes();
     }
 
     intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
@@ -186,8 +191,8 @@ namespace mongo {
 
         // Make a copy of the buffer.
         // It is very important that the positions of each field are the same after cloning.
-        const size_t bufferBytes = (_bufferEnd + hashTabBytes()) - _buffer;
-        out->_buffer = new char[bufferBytes];
+        const size_t bufferBytes = allocatedBytes();
+        out->_buffer = static_cast<char*>(DocumentBufferPool::allocate(bufferBytes));
         out->_bufferEnd = out->_buffer + (_bufferEnd - _buffer);
         memcpy(out->_buffer, _buffer, bufferBytes);
 
@@ -207,11 +212,11 @@ namespace mongo {
     }
 
     DocumentStorage::~DocumentStorage() {
-        boost::scoped_array<char> deleteBufferAtScopeEnd (_buffer);
-
         for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
             it->val.~Value(); // explicit destructor call
         }
+
+        DocumentBufferPool::deallocate(_buffer, allocatedBytes());
     }
 
     Document::Document(const BSONObj& bson) {
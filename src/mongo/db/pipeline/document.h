@@ -245,8 +245,8 @@ namespace mongo {
         explicit MutableValue(Value& val): _val(val) {}
 
         /// Used by MutableDocument(MutableValue)
-        const RefCountable*& getDocPtr() {
-            if (_val.getType() != Object || _val._storage.genericRCPtr == NULL) {
+        const ThreadLocalRefCountable*& getDocPtr() {
+            if (_val.getType() != Object || _val._storage.threadLocalRCPtr == NULL) {
                 // If the current value isn't an object we replace it with a Object-typed Value.
                 // Note that we can't just use Document() here because that is a NULL pointer and
                 // Value doesn't refcount NULL pointers. This led to a memory leak (SERVER-10554)
@@ -258,7 +258,7 @@ namespace mongo {
                 _val = Value(Document(new DocumentStorage()));
             }
 
-            return _val._storage.genericRCPtr;
+            return _val._storage.threadLocalRCPtr;
         }
 
         MutableValue& operator= (const MutableValue&); // not assignable with another MutableValue
@@ -447,8 +447,9 @@ namespace mongo {
 
         // These are both const to prevent modifications bypassing storage() method.
         // They always point to NULL or an object with dynamic type DocumentStorage.
-        const RefCountable* _storageHolder; // Only used in constructors and destructor
-        const RefCountable*& _storage; // references either above member or genericRCPtr in a Value
+        const ThreadLocalRefCountable* _storageHolder; // Only used in constructors and destructor
+        // references either above member or threadLocalRCPtr in a Value
+        const ThreadLocalRefCountable*& _storage;
     };
 
     /// This is the public iterator over a document
@@ -0,0 +1,155 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/pch.h"
+
+#include "mongo/db/pipeline/document_buffer_pool.h"
+
+#include <new>
+#include <vector>
+
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/threadlocal.h"
+
+namespace mongo {
+
+namespace {
+    struct ThreadBufferPool {
+        ThreadBufferPool() : scopeDepth(0) {}
+
+        void releaseAll() {
+            for (size_t i = 0; i < DocumentBufferPool::NumSizeClasses; i++) {
+                for (size_t j = 0; j < freeLists[i].size(); j++) {
+                    free(freeLists[i][j]);
+                }
+                freeLists[i].clear();
+            }
+        }
+
+        int scopeDepth;
+        std::vector<void*> freeLists[DocumentBufferPool::NumSizeClasses];
+    };
+
+    /// Returns the size class for 'bytes', or -1 if blocks of that size are not pooled.
+    int sizeClassFor(size_t bytes) {
+        size_t blockSize = DocumentBufferPool::MinBlockSize;
+        for (int i = 0; i < DocumentBufferPool::NumSizeClasses; i++) {
+            if (bytes <= blockSize)
+                return i;
+            blockSize *= 2;
+        }
+        return -1;
+    }
+
+    size_t blockSizeFor(int sizeClass) {
+        return size_t(DocumentBufferPool::MinBlockSize) << sizeClass;
+    }
+
+    /// Throws std::bad_alloc on failure, like the new char[] this pool replaced.
+    void* mallocOrThrow(size_t bytes) {
+        void* block = malloc(bytes);
+        if (!block)
+            throw std::bad_alloc();
+        return block;
+    }
+
+}  // namespace
+
+    TSP_DECLARE(ThreadBufferPool, threadBufferPool);
+    TSP_DEFINE(ThreadBufferPool, threadBufferPool);
+
+    /// Returns the current thread's pool if pooling is enabled on it, otherwise NULL.
+    static ThreadBufferPool* activePool() {
+        ThreadBufferPool* pool = threadBufferPool.get();
+        return (pool && pool->scopeDepth > 0) ? pool : NULL;
+    }
+
+    DocumentBufferPool::Scope::Scope() {
+        threadBufferPool.getMake()->scopeDepth++;
+    }
+
+    DocumentBufferPool::Scope::~Scope() {
+        ThreadBufferPool* pool = threadBufferPool.get();
+        dassert(pool && pool->scopeDepth > 0);
+        if (--pool->scopeDepth == 0) {
+            pool->releaseAll();
+        }
+    }
+
+    void* DocumentBufferPool::allocate(size_t bytes) {
+        const int sizeClass = sizeClassFor(bytes);
+        if (sizeClass < 0)
+            return mallocOrThrow(bytes);
+
+        if (ThreadBufferPool* pool = activePool()) {
+            std::vector<void*>& freeList = pool->freeLists[sizeClass];
+            if (!freeList.empty()) {
+                void* block = freeList.back();
+                freeList.pop_back();
+                return block;
+            }
+        }
+
+        return mallocOrThrow(blockSizeFor(sizeClass));
+    }
+
+    void DocumentBufferPool::deallocate(void* ptr, size_t bytes) {
+        if (!ptr)
+            return;
+
+        const int sizeClass = sizeClassFor(bytes);
+        if (sizeClass >= 0) {
+            if (ThreadBufferPool* pool = activePool()) {
+                std::vector<void*>& freeList = pool->freeLists[sizeClass];
+                if (freeList.size() < size_t(MaxBlocksPerSizeClass)) {
+                    freeList.push_back(ptr);
+                    return;
+                }
+            }
+        }
+
+        free(ptr);
+    }
+
+    size_t DocumentBufferPool::roundUp(size_t bytes) {
+        const int sizeClass = sizeClassFor(bytes);
+        return sizeClass < 0 ? bytes : blockSizeFor(sizeClass);
+    }
+
+    size_t DocumentBufferPool::pooledBlocks() {
+        ThreadBufferPool* pool = threadBufferPool.get();
+        if (!pool)
+            return 0;
+
+        size_t count = 0;
+        for (size_t i = 0; i < NumSizeClasses; i++) {
+            count += pool->freeLists[i].size();
+        }
+        return count;
+    }
+}
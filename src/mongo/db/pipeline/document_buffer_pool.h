@@ -0,0 +1,84 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "mongo/base/disallow_copying.h"
+
+namespace mongo {
+
+    /**
+     * Thread-local free lists for the small memory blocks backing DocumentStorage, so that
+     * pipelines which create and drop many Documents recycle the same blocks instead of going
+     * through the allocator for each one.
+     *
+     * Pooling is only enabled on a thread while a Scope is alive on it. Blocks freed outside of
+     * a Scope, or once a free list is full, go straight back to the allocator, and all pooled
+     * blocks are released when the outermost Scope on the thread ends. Since every block comes
+     * from malloc, a block may be freed on a different thread or outside the Scope it was
+     * allocated in.
+     */
+    class DocumentBufferPool {
+    public:
+        /**
+         * Enables pooling on the current thread for the lifetime of this object. Scopes nest;
+         * only the end of the outermost one releases the pooled blocks.
+         */
+        class Scope {
+            MONGO_DISALLOW_COPYING(Scope);
+        public:
+            Scope();
+            ~Scope();
+        };
+
+        /**
+         * Returns a block of at least 'bytes' bytes. It must be freed by calling deallocate()
+         * with the same 'bytes'. Throws std::bad_alloc if memory is exhausted; never returns NULL.
+         */
+        static void* allocate(size_t bytes);
+
+        static void deallocate(void* ptr, size_t bytes);
+
+        /**
+         * Returns the size of the block that allocate() would hand out for 'bytes'. Callers
+         * that can use the extra space should ask for this much.
+         */
+        static size_t roundUp(size_t bytes);
+
+        /// Number of blocks pooled on the current thread. For testing.
+        static size_t pooledBlocks();
+
+        enum {
+            MinBlockSize = 64, // size of the smallest pooled block
+            NumSizeClasses = 7, // powers of two up to MinBlockSize << (NumSizeClasses - 1)
+            MaxBlocksPerSizeClass = 128,
+        };
+    };
+}
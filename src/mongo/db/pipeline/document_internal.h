@@ -31,6 +31,8 @@
 #include <third_party/murmurhash3/MurmurHash3.h>
 
 #include "mongo/util/intrusive_counter.h"
+#include "mongo/db/pipeline/document_buffer_pool.h"
+#include "mongo/db/pipeline/thread_local_ref_countable.h"
 #include "mongo/db/pipeline/value.h"
 
 namespace mongo {
@@ -158,7 +160,7 @@ namespace mongo {
     };
 
     /// Storage class used by both Document and MutableDocument
-    class DocumentStorage :  public RefCountable {
+    class DocumentStorage :  public ThreadLocalRefCountable {
     public:
         // Note: default constructor should zero-init to support emptyDoc()
         DocumentStorage() : _buffer(NULL)
@@ -171,6 +173,12 @@ namespace mongo {
         {}
         ~DocumentStorage();
 
+        // DocumentStorage objects and their buffers come from the DocumentBufferPool.
+        static void* operator new(size_t bytes) { return DocumentBufferPool::allocate(bytes); }
+        static void operator delete(void* ptr, size_t bytes) {
+            DocumentBufferPool::deallocate(ptr, bytes);
+        }
+
         static const DocumentStorage& emptyDoc() {
             static const char emptyBytes[sizeof(DocumentStorage)] = {0};
             return *reinterpret_cast<const DocumentStorage*>(emptyBytes);
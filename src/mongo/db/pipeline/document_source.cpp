@@ -57,6 +57,18 @@ namespace mongo {
     void DocumentSource::optimize() {
     }
 
+    bool DocumentSource::getNextBatch(vector<Document>* batch) {
+        batch->clear();
+        while (batch->size() < MaxBatchSize) {
+            boost::optional<Document> next = getNext();
+            if (!next)
+                break;
+
+            batch->push_back(*next);
+        }
+        return !batch->empty();
+    }
+
     void DocumentSource::dispose() {
         if ( pSource ) {
             pSource->dispose();
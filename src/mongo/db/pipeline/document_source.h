@@ -66,6 +66,20 @@ namespace mongo {
          */
         virtual boost::optional<Document> getNext() = 0;
 
+        /**
+         * Replaces the contents of 'batch' with up to MaxBatchSize of the next Documents, in
+         * order. Returns false, leaving 'batch' empty, at EOF.
+         *
+         * The default implementation calls getNext() repeatedly. Sources that produce or
+         * transform many Documents at a time override this so that a consumer which reads whole
+         * batches, such as $group, pays for one virtual call per batch rather than per Document.
+         * Calls to getNext() and getNextBatch() may be mixed freely.
+         */
+        virtual bool getNextBatch(std::vector<Document>* batch);
+
+        /// The largest batch getNextBatch() returns.
+        static const size_t MaxBatchSize = 128;
+
         /**
          * Inform the source that it is no longer needed and may release its resources.  After
          * dispose() is called the source must still be able to handle iteration requests, but may
@@ -343,6 +357,7 @@ namespace mongo {
         // virtuals from DocumentSource
         virtual ~DocumentSourceCursor();
         virtual boost::optional<Document> getNext();
+        virtual bool getNextBatch(std::vector<Document>* batch);
         virtual const char *getSourceName() const;
         virtual Value serialize(bool explain = false) const;
         virtual void setSource(DocumentSource *pSource);
@@ -506,9 +521,10 @@ namespace mongo {
         void parseIdExpression(BSONElement groupField, const VariablesParseState& vps);
 
         /**
-         * Computes the internal representation of the group key.
+         * Computes the internal representation of the group key for each Document in 'batch',
+         * replacing the contents of 'ids'.
          */
-        Value computeId(Variables* vars);
+        void computeIds(const std::vector<Document>& batch, std::vector<Value>* ids);
 
         /**
          * Converts the internal representation of the group key to the _id shape specified by the
@@ -563,6 +579,7 @@ namespace mongo {
     public:
         // virtuals from DocumentSource
         virtual boost::optional<Document> getNext();
+        virtual bool getNextBatch(std::vector<Document>* batch);
         virtual const char *getSourceName() const;
         virtual bool coalesce(const intrusive_ptr<DocumentSource>& nextSource);
         virtual Value serialize(bool explain = false) const;
@@ -722,6 +739,7 @@ namespace mongo {
     public:
         // virtuals from DocumentSource
         virtual boost::optional<Document> getNext();
+        virtual bool getNextBatch(std::vector<Document>* batch);
         virtual const char *getSourceName() const;
         virtual void optimize();
         virtual Value serialize(bool explain = false) const;
@@ -751,6 +769,9 @@ namespace mongo {
         DocumentSourceProject(const intrusive_ptr<ExpressionContext>& pExpCtx,
                               const intrusive_ptr<ExpressionObject>& exprObj);
 
+        /// Applies the projection to a single input. Leaves ROOT in '_variables' set to it.
+        Document project(const Document& input);
+
         // configuration state
         boost::scoped_ptr<Variables> _variables;
         intrusive_ptr<ExpressionObject> pEO;
@@ -64,6 +64,24 @@ namespace mongo {
         return out;
     }
 
+    bool DocumentSourceCursor::getNextBatch(vector<Document>* batch) {
+        pExpCtx->checkForInterrupt();
+
+        batch->clear();
+        if (_currentBatch.empty()) {
+            loadBatch();
+
+            if (_currentBatch.empty()) // exhausted the cursor
+                return false;
+        }
+
+        // Hand out the front of what loadBatch() already materialized.
+        const size_t numDocs = std::min(_currentBatch.size(), size_t(MaxBatchSize));
+        batch->assign(_currentBatch.begin(), _currentBatch.begin() + numDocs);
+        _currentBatch.erase(_currentBatch.begin(), _currentBatch.begin() + numDocs);
+        return true;
+    }
+
     void DocumentSourceCursor::dispose() {
         // Can't call in to Runner or ClientCursor registries from this function since it will be
         // called when an agg cursor is killed which would cause a deadlock.
@@ -355,67 +355,89 @@ namespace mongo {
         vector<shared_ptr<Sorter<Value, Value>::Iterator> > sortedFiles;
         int memoryUsageBytes = 0;
 
-        // This loop consumes all input from pSource and buckets it based on pIdExpression.
-        while (boost::optional<Document> input = pSource->getNext()) {
-            if (memoryUsageBytes > _maxMemoryUsageBytes) {
-                uassert(16945, "Exceeded memory limit for $group, but didn't allow external sort."
-                               " Pass allowDiskUse:true to opt in.",
-                        _extSortAllowed);
-                sortedFiles.push_back(spill());
-                memoryUsageBytes = 0;
+        // Reused across batches. 'inputs[i][j]' is the argument of accumulator 'i' for the 'j'th
+        // Document of the current batch.
+        vector<Document> batch;
+        vector<Value> ids;
+        vector<vector<Value> > inputs(numAccumulators);
+
+        // This loop consumes all input from pSource a batch at a time and buckets it based on
+        // pIdExpression. Each expression is evaluated over the whole batch at once.
+        while (pSource->getNextBatch(&batch)) {
+            const size_t batchSize = batch.size();
+            computeIds(batch, &ids);
+            for (size_t i = 0; i < numAccumulators; i++) {
+                vpExpression[i]->evaluateBatch(batch, _variables.get(), &inputs[i]);
             }
 
-            _variables->setRoot(*input);
+            // We are done with the ROOT documents so release them.
+            _variables->clearRoot();
 
-            /* get the _id value */
-            Value id = computeId(_variables.get());
+            // Consecutive inputs with the same _id, such as every input when the _id is a
+            // constant, go to their group's accumulators in a single call.
+            size_t runStart = 0;
+            while (runStart < batchSize) {
+                size_t runEnd = runStart + 1;
+                while (runEnd < batchSize && ids[runEnd] == ids[runStart]) {
+                    runEnd++;
+                }
 
-            /* treat missing values the same as NULL SERVER-4674 */
-            if (id.missing())
-                id = Value(BSONNULL);
+                if (memoryUsageBytes > _maxMemoryUsageBytes) {
+                    uassert(16945, "Exceeded memory limit for $group, but didn't allow external"
+                                   " sort. Pass allowDiskUse:true to opt in.",
+                            _extSortAllowed);
+                    sortedFiles.push_back(spill());
+                    memoryUsageBytes = 0;
+                }
 
-            /*
-              Look for the _id value in the map; if it's not there, add a
-              new entry with a blank accumulator.
-            */
-            const size_t oldSize = groups.size();
-            vector<intrusive_ptr<Accumulator> >& group = groups[id];
-            const bool inserted = groups.size() != oldSize;
+                /* treat missing values the same as NULL SERVER-4674 */
+                Value& id = ids[runStart];
+                if (id.missing())
+                    id = Value(BSONNULL);
 
-            if (inserted) {
-                memoryUsageBytes += id.getApproximateSize();
+                /*
+                  Look for the _id value in the map; if it's not there, add a
+                  new entry with a blank accumulator.
+                */
+                const size_t oldSize = groups.size();
+                vector<intrusive_ptr<Accumulator> >& group = groups[id];
+                const bool inserted = groups.size() != oldSize;
 
-                // Add the accumulators
-                group.reserve(numAccumulators);
-                for (size_t i = 0; i < numAccumulators; i++) {
-                    group.push_back(vpAccumulatorFactory[i]());
+                if (inserted) {
+                    memoryUsageBytes += id.getApproximateSize();
+
+                    // Add the accumulators
+                    group.reserve(numAccumulators);
+                    for (size_t i = 0; i < numAccumulators; i++) {
+                        group.push_back(vpAccumulatorFactory[i]());
+                    }
+                } else {
+                    for (size_t i = 0; i < numAccumulators; i++) {
+                        // subtract old mem usage. New usage added back after processing.
+                        memoryUsageBytes -= group[i]->memUsageForSorter();
+                    }
                 }
-            } else {
+
+                /* tickle all the accumulators for the group we found */
+                dassert(numAccumulators == group.size());
                 for (size_t i = 0; i < numAccumulators; i++) {
-                    // subtract old mem usage. New usage added back after processing.
-                    memoryUsageBytes -= group[i]->memUsageForSorter();
+                    group[i]->processBatch(&inputs[i][runStart], runEnd - runStart, _doingMerge);
+                    memoryUsageBytes += group[i]->memUsageForSorter();
                 }
-            }
-
-            /* tickle all the accumulators for the group we found */
-            dassert(numAccumulators == group.size());
-            for (size_t i = 0; i < numAccumulators; i++) {
-                group[i]->process(vpExpression[i]->evaluate(_variables.get()), _doingMerge);
-                memoryUsageBytes += group[i]->memUsageForSorter();
-            }
 
-            // We are done with the ROOT document so release it.
-            _variables->clearRoot();
-
-            DEV {
-                // In debug mode, spill every time we have a duplicate id to stress merge logic.
-                if (!inserted // is a dup
-                        && !pExpCtx->inRouter // can't spill to disk in router
-                        && !_extSortAllowed // don't change behavior when testing external sort
-                        && sortedFiles.size() < 20 // don't open too many FDs
-                        ) {
-                    sortedFiles.push_back(spill());
+                DEV {
+                    // In debug mode, spill every time we have a duplicate id to stress merge
+                    // logic.
+                    if (!inserted // is a dup
+                            && !pExpCtx->inRouter // can't spill to disk in router
+                            && !_extSortAllowed // don't change behavior when testing external sort
+                            && sortedFiles.size() < 20 // don't open too many FDs
+                            ) {
+                        sortedFiles.push_back(spill());
+                    }
                 }
+
+                runStart = runEnd;
             }
         }
 
@@ -530,18 +552,30 @@ namespace mongo {
         }
     }
 
-    Value DocumentSourceGroup::computeId(Variables* vars) {
-        // If only one expression return result directly
-        if (_idExpressions.size() == 1)
-            return _idExpressions[0]->evaluate(vars);
+    void DocumentSourceGroup::computeIds(const vector<Document>& batch, vector<Value>* ids) {
+        // If only one expression return results directly
+        if (_idExpressions.size() == 1) {
+            _idExpressions[0]->evaluateBatch(batch, _variables.get(), ids);
+            return;
+        }
 
         // Multiple expressions get results wrapped in a vector
-        vector<Value> vals;
-        vals.reserve(_idExpressions.size());
-        for (size_t i = 0; i < _idExpressions.size(); i++) {
-            vals.push_back(_idExpressions[i]->evaluate(vars));
+        const size_t numExpressions = _idExpressions.size();
+        vector<vector<Value> > columns(numExpressions);
+        for (size_t i = 0; i < numExpressions; i++) {
+            _idExpressions[i]->evaluateBatch(batch, _variables.get(), &columns[i]);
+        }
+
+        ids->clear();
+        ids->reserve(batch.size());
+        for (size_t j = 0; j < batch.size(); j++) {
+            vector<Value> vals;
+            vals.reserve(numExpressions);
+            for (size_t i = 0; i < numExpressions; i++) {
+                vals.push_back(columns[i][j]);
+            }
+            ids->push_back(Value::consume(vals));
         }
-        return Value::consume(vals);
     }
 
     Value DocumentSourceGroup::expandId(const Value& val) {
@@ -66,6 +66,32 @@ namespace mongo {
         return boost::none;
     }
 
+    bool DocumentSourceMatch::getNextBatch(vector<Document>* batch) {
+        pExpCtx->checkForInterrupt();
+
+        // The user facing error should have been generated earlier.
+        massert(17510, "Should never call getNextBatch on a $match stage with $text clause",
+                !_isTextQuery);
+
+        // Filter each input batch in place, skipping batches where nothing matched.
+        while (pSource->getNextBatch(batch)) {
+            size_t numMatched = 0;
+            for (size_t i = 0; i < batch->size(); i++) {
+                if (matcher->matches((*batch)[i].toBson())) {
+                    if (numMatched != i)
+                        (*batch)[numMatched].swap((*batch)[i]);
+                    numMatched++;
+                }
+            }
+            batch->resize(numMatched);
+
+            if (!batch->empty())
+                return true;
+        }
+
+        return false;
+    }
+
     bool DocumentSourceMatch::coalesce(const intrusive_ptr<DocumentSource>& nextSource) {
         DocumentSourceMatch* otherMatch = dynamic_cast<DocumentSourceMatch*>(nextSource.get());
         if (!otherMatch)
@@ -55,10 +55,32 @@ namespace mongo {
         if (!input)
             return boost::none;
 
+        Document out = project(*input);
+        _variables->clearRoot();
+
+        return out;
+    }
+
+    bool DocumentSourceProject::getNextBatch(vector<Document>* batch) {
+        pExpCtx->checkForInterrupt();
+
+        if (!pSource->getNextBatch(batch))
+            return false;
+
+        // Each output replaces its input in the batch.
+        for (size_t i = 0; i < batch->size(); i++) {
+            (*batch)[i] = project((*batch)[i]);
+        }
+        _variables->clearRoot();
+
+        return true;
+    }
+
+    Document DocumentSourceProject::project(const Document& input) {
         /* create the result document */
         const size_t sizeHint = pEO->getSizeHint();
         MutableDocument out (sizeHint);
-        out.copyMetaDataFrom(*input);
+        out.copyMetaDataFrom(input);
 
         /*
           Use the ExpressionObject to create the base result.
@@ -66,9 +88,8 @@ namespace mongo {
           If we're excluding fields at the top level, leave out the _id if
           it is found, because we took care of it above.
         */
-        _variables->setRoot(*input);
-        pEO->addToDocument(out, *input, _variables.get());
-        _variables->clearRoot();
+        _variables->setRoot(input);
+        pEO->addToDocument(out, input, _variables.get());
 
         return out.freeze();
     }
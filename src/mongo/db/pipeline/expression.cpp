@@ -176,6 +176,17 @@ namespace mongo {
         return ((options & INCLUSION_OK) != 0);
     }
 
+    void Expression::evaluateBatch(const vector<Document>& roots,
+                                   Variables* vars,
+                                   vector<Value>* out) const {
+        out->clear();
+        out->reserve(roots.size());
+        for (size_t i = 0; i < roots.size(); i++) {
+            vars->setRoot(roots[i]);
+            out->push_back(evaluateInternal(vars));
+        }
+    }
+
     string Expression::removeFieldPrefix(const string &prefixedField) {
         uassert(16419, str::stream()<<"field path must not contain embedded null characters" << prefixedField.find("\0") << "," ,
                 prefixedField.find('\0') == string::npos);
@@ -372,23 +383,29 @@ namespace {
 
     /* ------------------------- ExpressionAdd ----------------------------- */
 
-    Value ExpressionAdd::evaluateInternal(Variables* vars) const {
-
-        /*
-          We'll try to return the narrowest possible result value.  To do that
-          without creating intermediate Values, do the arithmetic for double
-          and integral types in parallel, tracking the current narrowest
-          type.
+namespace {
+    /**
+     * The running sum of an $add, shared by the single Document and batch implementations.
+     *
+     * We'll try to return the narrowest possible result value.  To do that
+     * without creating intermediate Values, do the arithmetic for double
+     * and integral types in parallel, tracking the current narrowest
+     * type.
+     */
+    class AddState {
+    public:
+        AddState()
+            : doubleTotal(0)
+            , longTotal(0)
+            , totalType(NumberInt)
+            , haveDate(false)
+        {}
+
+        /**
+         * Adds the next operand. Returns false if the result is null, in which case no more
+         * operands should be added.
          */
-        double doubleTotal = 0;
-        long long longTotal = 0;
-        BSONType totalType = NumberInt;
-        bool haveDate = false;
-
-        const size_t n = vpOperand.size();
-        for (size_t i = 0; i < n; ++i) {
-            Value val = vpOperand[i]->evaluateInternal(vars);
-
+        bool add(const Value& val) {
             if (val.numeric()) {
                 totalType = Value::getWidestNumeric(totalType, val.getType());
 
@@ -406,30 +423,84 @@ namespace {
                 doubleTotal += val.getDate();
             }
             else if (val.nullish()) {
-                return Value(BSONNULL);
+                return false;
             }
             else {
                 uasserted(16554, str::stream() << "$add only supports numeric or date types, not "
                                                << typeName(val.getType()));
             }
+            return true;
         }
 
-        if (haveDate) {
-            if (totalType == NumberDouble)
-                longTotal = static_cast<long long>(doubleTotal);
-            return Value(Date_t(longTotal));
+        Value getValue() {
+            if (haveDate) {
+                if (totalType == NumberDouble)
+                    longTotal = static_cast<long long>(doubleTotal);
+                return Value(Date_t(longTotal));
+            }
+            else if (totalType == NumberLong) {
+                return Value(longTotal);
+            }
+            else if (totalType == NumberDouble) {
+                return Value(doubleTotal);
+            }
+            else if (totalType == NumberInt) {
+                return Value::createIntOrLong(longTotal);
+            }
+            else {
+                massert(16417, "$add resulted in a non-numeric type", false);
+            }
         }
-        else if (totalType == NumberLong) {
-            return Value(longTotal);
+
+    private:
+        double doubleTotal;
+        long long longTotal;
+        BSONType totalType;
+        bool haveDate;
+    };
+}
+
+    Value ExpressionAdd::evaluateInternal(Variables* vars) const {
+        AddState state;
+        const size_t n = vpOperand.size();
+        for (size_t i = 0; i < n; ++i) {
+            if (!state.add(vpOperand[i]->evaluateInternal(vars)))
+                return Value(BSONNULL);
         }
-        else if (totalType == NumberDouble) {
-            return Value(doubleTotal);
+
+        return state.getValue();
+    }
+
+    void ExpressionAdd::evaluateBatch(const vector<Document>& roots,
+                                      Variables* vars,
+                                      vector<Value>* out) const {
+        // A null operand ends the evaluation of a single Document before the later operands
+        // are evaluated. Evaluating whole columns of operands up front is only equivalent if
+        // none of them can fail, which is the case for field paths and constants.
+        const size_t n = vpOperand.size();
+        for (size_t i = 0; i < n; ++i) {
+            const Expression* operand = vpOperand[i].get();
+            if (!dynamic_cast<const ExpressionFieldPath*>(operand)
+                    && !dynamic_cast<const ExpressionConstant*>(operand)) {
+                Expression::evaluateBatch(roots, vars, out);
+                return;
+            }
         }
-        else if (totalType == NumberInt) {
-            return Value::createIntOrLong(longTotal);
+
+        vector<vector<Value> > columns(n);
+        for (size_t i = 0; i < n; ++i) {
+            vpOperand[i]->evaluateBatch(roots, vars, &columns[i]);
         }
-        else {
-            massert(16417, "$add resulted in a non-numeric type", false);
+
+        out->clear();
+        out->reserve(roots.size());
+        for (size_t j = 0; j < roots.size(); ++j) {
+            AddState state;
+            bool isNull = false;
+            for (size_t i = 0; i < n && !isNull; ++i) {
+                isNull = !state.add(columns[i][j]);
+            }
+            out->push_back(isNull ? Value(BSONNULL) : state.getValue());
         }
     }
 
@@ -662,7 +733,27 @@ namespace {
         Value pLeft(vpOperand[0]->evaluateInternal(vars));
         Value pRight(vpOperand[1]->evaluateInternal(vars));
 
-        int cmp = Value::compare(pLeft, pRight);
+        return compare(pLeft, pRight);
+    }
+
+    void ExpressionCompare::evaluateBatch(const vector<Document>& roots,
+                                          Variables* vars,
+                                          vector<Value>* out) const {
+        // Both operands are always evaluated, so they can be evaluated a column at a time.
+        vector<Value> left;
+        vector<Value> right;
+        vpOperand[0]->evaluateBatch(roots, vars, &left);
+        vpOperand[1]->evaluateBatch(roots, vars, &right);
+
+        out->clear();
+        out->reserve(roots.size());
+        for (size_t j = 0; j < roots.size(); ++j) {
+            out->push_back(compare(left[j], right[j]));
+        }
+    }
+
+    Value ExpressionCompare::compare(const Value& left, const Value& right) const {
+        int cmp = Value::compare(left, right);
 
         // Make cmp one of 1, 0, or -1.
         if (cmp == 0) {
@@ -789,6 +880,12 @@ namespace {
         return pValue;
     }
 
+    void ExpressionConstant::evaluateBatch(const vector<Document>& roots,
+                                           Variables* vars,
+                                           vector<Value>* out) const {
+        out->assign(roots.size(), pValue);
+    }
+
     Value ExpressionConstant::serialize(bool explain) const {
         return serializeConstant(pValue);
     }
@@ -1273,6 +1370,22 @@ namespace {
         }
     }
 
+    void ExpressionFieldPath::evaluateBatch(const vector<Document>& roots,
+                                            Variables* vars,
+                                            vector<Value>* out) const {
+        if (_fieldPath.getPathLength() == 1 || _variable != Variables::ROOT_ID) {
+            Expression::evaluateBatch(roots, vars, out);
+            return;
+        }
+
+        // Paths into ROOT don't need ROOT to be set.
+        out->clear();
+        out->reserve(roots.size());
+        for (size_t i = 0; i < roots.size(); i++) {
+            out->push_back(evaluatePath(1, roots[i]));
+        }
+    }
+
     Value ExpressionFieldPath::serialize(bool explain) const {
         if (_fieldPath.getFieldName(0) == "CURRENT" && _fieldPath.getPathLength() > 1) {
             // use short form for "$$CURRENT.foo" but not just "$$CURRENT"
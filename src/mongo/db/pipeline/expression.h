@@ -203,6 +203,19 @@ namespace mongo {
          */
         Value evaluate(Variables* vars) const { return evaluateInternal(vars); }
 
+        /**
+         * Evaluate expression once for each Document in 'roots', as evaluate() would with ROOT
+         * set to that Document, and replace the contents of 'out' with the results in order.
+         * ROOT may be left set to any Document of 'roots'.
+         *
+         * The default implementation evaluates one Document at a time. Expressions that can
+         * work column by column, over the results of their operands for the whole batch,
+         * override this.
+         */
+        virtual void evaluateBatch(const std::vector<Document>& roots,
+                                   Variables* vars,
+                                   std::vector<Value>* out) const;
+
         /*
           Utility class for parseObject() below.
 
@@ -364,6 +377,9 @@ namespace mongo {
     public:
         // virtuals from Expression
         virtual Value evaluateInternal(Variables* vars) const;
+        virtual void evaluateBatch(const std::vector<Document>& roots,
+                                   Variables* vars,
+                                   std::vector<Value>* out) const;
         virtual const char *getOpName() const;
         virtual bool isAssociativeAndCommutative() const { return true; }
     };
@@ -432,6 +448,9 @@ namespace mongo {
 
         // virtuals from ExpressionNary
         virtual Value evaluateInternal(Variables* vars) const;
+        virtual void evaluateBatch(const std::vector<Document>& roots,
+                                   Variables* vars,
+                                   std::vector<Value>* out) const;
         virtual const char *getOpName() const;
 
         static intrusive_ptr<Expression> parse(
@@ -442,6 +461,9 @@ namespace mongo {
         ExpressionCompare(CmpOp cmpOp);
 
     private:
+        /// The result of this comparison for the given operand values.
+        Value compare(const Value& left, const Value& right) const;
+
         CmpOp cmpOp;
     };
 
@@ -473,6 +495,9 @@ namespace mongo {
         virtual intrusive_ptr<Expression> optimize();
         virtual void addDependencies(DepsTracker* deps, std::vector<std::string>* path=NULL) const;
         virtual Value evaluateInternal(Variables* vars) const;
+        virtual void evaluateBatch(const std::vector<Document>& roots,
+                                   Variables* vars,
+                                   std::vector<Value>* out) const;
         virtual const char *getOpName() const;
         virtual Value serialize(bool explain) const;
 
@@ -533,6 +558,9 @@ namespace mongo {
         virtual intrusive_ptr<Expression> optimize();
         virtual void addDependencies(DepsTracker* deps, std::vector<std::string>* path=NULL) const;
         virtual Value evaluateInternal(Variables* vars) const;
+        virtual void evaluateBatch(const std::vector<Document>& roots,
+                                   Variables* vars,
+                                   std::vector<Value>* out) const;
         virtual Value serialize(bool explain) const;
 
         /*
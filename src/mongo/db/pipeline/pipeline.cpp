@@ -38,6 +38,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_buffer_pool.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
@@ -114,8 +115,9 @@ namespace mongo {
                 continue;
             }
 
-            // maxTimeMS is also for the command processor.
-            if (pFieldName == LiteParsedQuery::cmdOptionMaxTimeMS) {
+            // maxTimeMS and afterOpTime are also for the command processor.
+            if (pFieldName == LiteParsedQuery::cmdOptionMaxTimeMS
+                    || pFieldName == LiteParsedQuery::cmdOptionAfterOpTime) {
                 continue;
             }
 
@@ -497,6 +499,7 @@ namespace mongo {
         // the array in which the aggregation results reside
         // cant use subArrayStart() due to error handling
         BSONArrayBuilder resultArray;
+        DocumentBufferPool::Scope bufferPoolScope;
         DocumentSource* finalSource = sources.back().get();
         while (boost::optional<Document> next = finalSource->getNext()) {
             // add the document to the result set
@@ -73,6 +73,89 @@ namespace {
         intrusive_ptr<ExpressionContext> _ctx;
         DBDirectClient _client;
     };
+
+    /**
+     * Returns true if no document with 'path' missing or null can satisfy the predicate 'pred'
+     * on 'path' from a query.
+     */
+    bool predicateRequiresValue(const BSONElement& pred) {
+        // Comparisons with null or the extreme keys can also match missing fields.
+        const BSONType type = pred.type();
+        const bool mayMatchMissing =
+            type == jstNULL || type == Undefined || type == MinKey || type == MaxKey;
+
+        if (type != Object || pred.Obj().firstElementFieldName()[0] != '$') {
+            // An equality or a regex.
+            return !mayMatchMissing;
+        }
+
+        BSONForEach(op, pred.Obj()) {
+            const StringData name = op.fieldNameStringData();
+            const BSONType opType = op.type();
+            if (name == "$gt" || name == "$gte" || name == "$lt" || name == "$lte") {
+                if (opType != jstNULL && opType != Undefined
+                        && opType != MinKey && opType != MaxKey) {
+                    return true;
+                }
+            }
+            else if (name == "$exists") {
+                if (op.trueValue()) {
+                    return true;
+                }
+            }
+            else if (name == "$regex" || name == "$mod") {
+                return true;
+            }
+            else if (name == "$in" && opType == Array) {
+                bool hasNull = false;
+                BSONForEach(value, op.Obj()) {
+                    hasNull = hasNull || value.isNull() || value.type() == Undefined;
+                }
+                if (!hasNull) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Returns true if every document matching 'query' has a non null value at 'path'.  Only
+     * top level conjuncts naming exactly 'path' are considered, so this may return false for a
+     * query that does guarantee a value.
+     */
+    bool queryRequiresValue(const BSONObj& query, const string& path) {
+        BSONForEach(e, query) {
+            const StringData name = e.fieldNameStringData();
+            if (name == "$and" && e.type() == Array) {
+                BSONForEach(clause, e.Obj()) {
+                    if (clause.type() == Object && queryRequiresValue(clause.Obj(), path)) {
+                        return true;
+                    }
+                }
+            }
+            else if (name == path && predicateRequiresValue(e)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Returns true if answering from an index can't change the values of the fields in 'deps'.
+     * A covered projection takes each field from the index key, where a missing field is
+     * indexed as null, so it reports null where the document has no value.  That is only
+     * invisible if 'query' rules out documents missing any of the fields.  Every document has
+     * an _id.
+     */
+    bool canCoverDependencies(const DepsTracker& deps, const BSONObj& query) {
+        for (set<string>::const_iterator it = deps.fields.begin(); it != deps.fields.end(); ++it) {
+            if (*it != "_id" && !queryRequiresValue(query, *it)) {
+                return false;
+            }
+        }
+        return true;
+    }
 }
 
     boost::shared_ptr<Runner> PipelineD::prepareCursorSource(
@@ -120,10 +203,23 @@ namespace {
         // Find the set of fields in the source documents depended on by this pipeline.
         const DepsTracker deps = pPipeline->getDependencies(queryObj);
 
-        // Passing query an empty projection since it is faster to use ParsedDeps::extractFields().
-        // This will need to change to support covering indexes (SERVER-12015). There is an
-        // exception for textScore since that can only be retrieved by a query projection.
-        const BSONObj projectionForQuery = deps.needTextScore ? deps.toProjection() : BSONObj();
+        // Give the query our dependencies as a projection so that it can answer from an index
+        // alone when one covers every field we need. Projecting fetched documents is slower than
+        // ParsedDeps::extractFields(), so NO_UNCOVERED_PROJECTIONS below has the query hand back
+        // whole documents whenever it would have to fetch. An empty set of fields can't be
+        // expressed as a coverable projection, so it is left out, as are fields the query
+        // doesn't guarantee a value for (see canCoverDependencies()). textScore is the
+        // exception: it can only be retrieved by a query projection.
+        BSONObj projectionForQuery;
+        bool coverableProjection = false;
+        if (deps.needTextScore) {
+            projectionForQuery = deps.toProjection();
+        }
+        else if (!deps.needWholeDocument && !deps.fields.empty()
+                 && canCoverDependencies(deps, queryObj)) {
+            projectionForQuery = deps.toProjection();
+            coverableProjection = true;
+        }
 
         /*
           Look for an initial sort; we'll try to add this to the
@@ -160,10 +256,12 @@ namespace {
         // LATER - we should be able to find this out before we create the
         // cursor.  Either way, we can then apply other optimizations there
         // are tickets for, such as SERVER-4507.
-        const size_t runnerOptions = QueryPlannerParams::DEFAULT
-                                   | QueryPlannerParams::INCLUDE_SHARD_FILTER
-                                   | QueryPlannerParams::NO_BLOCKING_SORT
-                                   ;
+        size_t runnerOptions = QueryPlannerParams::DEFAULT
+                             | QueryPlannerParams::INCLUDE_SHARD_FILTER
+                             | QueryPlannerParams::NO_BLOCKING_SORT
+                             ;
+        if (coverableProjection)
+            runnerOptions |= QueryPlannerParams::NO_UNCOVERED_PROJECTIONS;
         boost::shared_ptr<Runner> runner;
         bool sortInRunner = false;
 
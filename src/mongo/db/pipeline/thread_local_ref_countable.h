@@ -0,0 +1,68 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+
+namespace mongo {
+
+    /**
+     * Like RefCountable, but with a plain counter instead of an atomic one.
+     *
+     * Only for the storage of pipeline Documents and arrays (DocumentStorage and RCVector),
+     * which belong to the single operation that built them and only move between threads with
+     * that operation, under the cursor pin. Anything that may be shared by concurrent operations
+     * must use RefCountable.
+     */
+    class ThreadLocalRefCountable : boost::noncopyable {
+    public:
+        /// If false you have exclusive access to this object. This is useful for implementing COW.
+        bool isShared() const {
+            return _count > 1;
+        }
+
+        friend void intrusive_ptr_add_ref(const ThreadLocalRefCountable* ptr) {
+            ++ptr->_count;
+        };
+
+        friend void intrusive_ptr_release(const ThreadLocalRefCountable* ptr) {
+            if (--ptr->_count == 0) {
+                delete ptr; // uses subclass destructor and operator delete
+            }
+        };
+
+    protected:
+        ThreadLocalRefCountable() : _count(0) {}
+        virtual ~ThreadLocalRefCountable() {}
+
+    private:
+        mutable unsigned _count;
+    };
+
+}  // namespace mongo
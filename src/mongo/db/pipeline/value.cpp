@@ -76,7 +76,7 @@ namespace mongo {
 
         case Object:
             // Objects either hold a NULL ptr or should be ref-counting
-            verify(refCounter == bool(genericRCPtr));
+            verify(refCounter == bool(threadLocalRCPtr));
             break;
         }
     }
@@ -99,12 +99,12 @@ namespace mongo {
     }
 
     void ValueStorage::putDocument(const Document& d) {
-        putRefCountable(d._storage);
+        putThreadLocalRefCountable(d._storage.get());
     }
 
     void ValueStorage::putVector(const RCVector* vec) {
         fassert(16485, vec);
-        putRefCountable(vec);
+        putThreadLocalRefCountable(vec);
     }
 
     void ValueStorage::putRegEx(const BSONRegEx& re) {
@@ -120,11 +120,12 @@ namespace mongo {
     }
 
     Document ValueStorage::getDocument() const {
-        if (!genericRCPtr)
+        if (!threadLocalRCPtr)
             return Document();
 
-        dassert(typeid(*genericRCPtr) == typeid(const DocumentStorage));
-        const DocumentStorage* documentPtr = static_cast<const DocumentStorage*>(genericRCPtr);
+        dassert(typeid(*threadLocalRCPtr) == typeid(const DocumentStorage));
+        const DocumentStorage* documentPtr =
+            static_cast<const DocumentStorage*>(threadLocalRCPtr);
         return Document(documentPtr);
     }
 
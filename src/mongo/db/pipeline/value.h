@@ -272,7 +272,7 @@ namespace mongo {
         StringData getStringData() const; // May contain embedded NUL bytes
 
         ValueStorage _storage;
-        friend class MutableValue; // gets and sets _storage.genericRCPtr
+        friend class MutableValue; // gets and sets _storage.threadLocalRCPtr
     };
     BOOST_STATIC_ASSERT(sizeof(Value) == 16);
 
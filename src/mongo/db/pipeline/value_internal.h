@@ -35,6 +35,7 @@
 #include "bson/oid.h"
 #include "util/intrusive_counter.h"
 #include "mongo/bson/optime.h"
+#include "mongo/db/pipeline/thread_local_ref_countable.h"
 
 
 namespace mongo {
@@ -44,7 +45,7 @@ namespace mongo {
 
     //TODO: a MutableVector, similar to MutableDocument
     /// A heap-allocated reference-counted std::vector
-    class RCVector : public RefCountable {
+    class RCVector : public ThreadLocalRefCountable {
     public:
         RCVector() {}
         RCVector(const std::vector<Value>& v) :vec(v) {}
@@ -103,7 +104,7 @@ namespace mongo {
         ~ValueStorage() {
             DEV verifyRefCountingIfShould();
             if (refCounter)
-                intrusive_ptr_release(genericRCPtr);
+                releaseRef();
             DEV memset(this, 0xee, sizeof(*this));
         }
 
@@ -124,7 +125,7 @@ namespace mongo {
         void memcpyed() const {
             DEV verifyRefCountingIfShould();
             if (refCounter)
-                intrusive_ptr_add_ref(genericRCPtr);
+                addRef();
         }
 
         /// These are only to be called during Value construction on an empty Value
@@ -157,6 +158,36 @@ namespace mongo {
             DEV verifyRefCountingIfShould();
         }
 
+        /// Used for Object and Array, whose storage is ThreadLocalRefCountable.
+        void putThreadLocalRefCountable(const ThreadLocalRefCountable* ptr) {
+            threadLocalRCPtr = ptr;
+
+            if (threadLocalRCPtr) {
+                intrusive_ptr_add_ref(threadLocalRCPtr);
+                refCounter = true;
+            }
+            DEV verifyRefCountingIfShould();
+        }
+
+        /// Objects and Arrays point at ThreadLocalRefCountables, every other type at RefCountables.
+        bool usesThreadLocalRefCount() const {
+            return type == Object || type == Array;
+        }
+
+        void addRef() const {
+            if (usesThreadLocalRefCount())
+                intrusive_ptr_add_ref(threadLocalRCPtr);
+            else
+                intrusive_ptr_add_ref(genericRCPtr);
+        }
+
+        void releaseRef() const {
+            if (usesThreadLocalRefCount())
+                intrusive_ptr_release(threadLocalRCPtr);
+            else
+                intrusive_ptr_release(genericRCPtr);
+        }
+
         StringData getString() const {
             if (shortStr) {
                 return StringData(shortStrStorage, shortStrSize);
@@ -169,8 +200,8 @@ namespace mongo {
         }
 
         const std::vector<Value>& getArray() const {
-            dassert(typeid(*genericRCPtr) == typeid(const RCVector));
-            const RCVector* arrayPtr = static_cast<const RCVector*>(genericRCPtr);
+            dassert(typeid(*threadLocalRCPtr) == typeid(const RCVector));
+            const RCVector* arrayPtr = static_cast<const RCVector*>(threadLocalRCPtr);
             return arrayPtr->vec;
         }
 
@@ -242,6 +273,7 @@ namespace mongo {
                         union { // 8 bytes long and 8-byte aligned
                             // There should be no pointers to non-const data
                             const RefCountable* genericRCPtr;
+                            const ThreadLocalRefCountable* threadLocalRCPtr; // Object and Array
 
                             double doubleValue;
                             bool boolValue;
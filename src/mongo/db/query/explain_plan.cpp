@@ -475,6 +475,7 @@ namespace mongo {
             bob->appendNumber("flaggedInProgress", spec->flaggedInProgress);
             bob->appendNumber("memUsage", spec->memUsage);
             bob->appendNumber("memLimit", spec->memLimit);
+            bob->appendNumber("workingSetMemUsage", spec->workingSetMemUsage);
             for (size_t i = 0; i < spec->mapAfterChild.size(); ++i) {
                 bob->appendNumber(string(stream() << "mapAfterChild_" << i), spec->mapAfterChild[i]);
             }
@@ -549,6 +550,9 @@ namespace mongo {
             bob->appendNumber("forcedFetches", spec->forcedFetches);
             bob->appendNumber("memUsage", spec->memUsage);
             bob->appendNumber("memLimit", spec->memLimit);
+            bob->appendNumber("workingSetMemUsage", spec->workingSetMemUsage);
+            bob->appendNumber("spilledBytes", static_cast<long long>(spec->spilledBytes));
+            bob->appendNumber("spillFiles", spec->spillFiles);
         }
         else if (STAGE_SORT_MERGE == stats.stageType) {
             MergeSortStats* spec = static_cast<MergeSortStats*>(stats.specific.get());
@@ -560,6 +564,7 @@ namespace mongo {
             TextStats* spec = static_cast<TextStats*>(stats.specific.get());
             bob->appendNumber("keysExamined", spec->keysExamined);
             bob->appendNumber("fetches", spec->fetches);
+            bob->appendNumber("topK", spec->topK);
             bob->append("parsedTextQuery", spec->parsedTextQuery);
         }
 
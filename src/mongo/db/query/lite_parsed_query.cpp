@@ -38,6 +38,9 @@ namespace mongo {
     const string LiteParsedQuery::cmdOptionMaxTimeMS("maxTimeMS");
     const string LiteParsedQuery::queryOptionMaxTimeMS("$maxTimeMS");
 
+    const string LiteParsedQuery::cmdOptionAfterOpTime("afterOpTime");
+    const string LiteParsedQuery::queryOptionAfterOpTime("$afterOpTime");
+
     const string LiteParsedQuery::metaTextScore("textScore");
     const string LiteParsedQuery::metaGeoNearDistance("geoNearDistance");
     const string LiteParsedQuery::metaGeoNearPoint("geoNearPoint");
@@ -111,6 +114,30 @@ namespace mongo {
         return StatusWith<int>(static_cast<int>(maxTimeMSLongLong));
     }
 
+    // static
+    StatusWith<OpTime> LiteParsedQuery::parseAfterOpTimeCommand(const BSONObj& cmdObj) {
+        return parseAfterOpTime(cmdObj[cmdOptionAfterOpTime]);
+    }
+
+    // static
+    StatusWith<OpTime> LiteParsedQuery::parseAfterOpTimeQuery(const BSONObj& queryObj) {
+        return parseAfterOpTime(queryObj[queryOptionAfterOpTime]);
+    }
+
+    // static
+    StatusWith<OpTime> LiteParsedQuery::parseAfterOpTime(const BSONElement& afterOpTimeElt) {
+        if (afterOpTimeElt.eoo()) {
+            return StatusWith<OpTime>(OpTime());
+        }
+        if (afterOpTimeElt.type() != mongo::Timestamp) {
+            return StatusWith<OpTime>(ErrorCodes::BadValue,
+                                      (StringBuilder()
+                                          << afterOpTimeElt.fieldNameStringData()
+                                          << " must be a Timestamp").str());
+        }
+        return StatusWith<OpTime>(afterOpTimeElt._opTime());
+    }
+
     // static
     bool LiteParsedQuery::isTextScoreMeta(BSONElement elt) {
         // elt must be foo: {$meta: "textScore"}
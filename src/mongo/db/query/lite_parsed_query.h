@@ -78,6 +78,18 @@ namespace mongo {
          */
         static StatusWith<int> parseMaxTimeMSQuery(const BSONObj& queryObj);
 
+        /**
+         * Helper functions to parse the afterOpTime read option from a command object.  Returns
+         * the OpTime the read must observe, or an error if the option is not a Timestamp.  When
+         * the option is absent, returns a null OpTime (meaning "don't wait").
+         */
+        static StatusWith<OpTime> parseAfterOpTimeCommand(const BSONObj& cmdObj);
+
+        /**
+         * Same as parseAfterOpTimeCommand, but for a query object.
+         */
+        static StatusWith<OpTime> parseAfterOpTimeQuery(const BSONObj& queryObj);
+
         /**
          * Helper function to identify text search sort key
          * Example: {a: {$meta: "textScore"}}
@@ -118,6 +130,10 @@ namespace mongo {
         static const std::string cmdOptionMaxTimeMS;
         static const std::string queryOptionMaxTimeMS;
 
+        // Names of the afterOpTime command and query option.
+        static const std::string cmdOptionAfterOpTime;
+        static const std::string queryOptionAfterOpTime;
+
         // Names of the $meta projection values.
         static const std::string metaTextScore;
         static const std::string metaGeoNearDistance;
@@ -160,6 +176,8 @@ namespace mongo {
 
         static StatusWith<int> parseMaxTimeMS(const BSONElement& maxTimeMSElt);
 
+        static StatusWith<OpTime> parseAfterOpTime(const BSONElement& afterOpTimeElt);
+
         std::string _ns;
         int _ntoskip;
         int _ntoreturn;
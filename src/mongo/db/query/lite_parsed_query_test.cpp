@@ -271,4 +271,30 @@ namespace {
         testSortOrder(false, "{'': -1}", "{'': -1}");
     }
 
+    TEST(LiteParsedQueryTest, ParseAfterOpTime) {
+        // Absent means "don't wait".
+        StatusWith<OpTime> result = LiteParsedQuery::parseAfterOpTimeQuery(fromjson("{a: 1}"));
+        ASSERT_OK(result.getStatus());
+        ASSERT_TRUE(result.getValue().isNull());
+
+        BSONObjBuilder bob;
+        bob.append("$query", BSON("a" << 1));
+        bob.appendTimestamp("$afterOpTime", OpTime(5, 3).asDate());
+        result = LiteParsedQuery::parseAfterOpTimeQuery(bob.obj());
+        ASSERT_OK(result.getStatus());
+        ASSERT_TRUE(OpTime(5, 3) == result.getValue());
+
+        BSONObjBuilder cmdBob;
+        cmdBob.append("count", "coll");
+        cmdBob.appendTimestamp("afterOpTime", OpTime(7, 1).asDate());
+        result = LiteParsedQuery::parseAfterOpTimeCommand(cmdBob.obj());
+        ASSERT_OK(result.getStatus());
+        ASSERT_TRUE(OpTime(7, 1) == result.getValue());
+
+        // Must be a Timestamp.
+        result = LiteParsedQuery::parseAfterOpTimeCommand(fromjson("{count: 'coll', "
+                                                                   "afterOpTime: 5}"));
+        ASSERT_EQUALS(ErrorCodes::BadValue, result.getStatus().code());
+    }
+
 }  // namespace
@@ -42,11 +42,14 @@
 #include "mongo/db/query/qlog.h"
 #include "mongo/db/query/query_planner_params.h"
 #include "mongo/db/query/single_solution_runner.h"
+#include "mongo/db/query/time_partition_runner.h"
 #include "mongo/db/query/type_explain.h"
+#include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/repl_reads_ok.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/storage_options.h"
+#include "mongo/db/catalog/oplog_ts_index.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/s/chunk_version.h"
 #include "mongo/s/d_logic.h"
@@ -113,12 +116,11 @@ namespace mongo {
                             const char *ns,
                             BSONObj& jsobj,
                             CurOp& curop,
-                            BufBuilder &b,
                             BSONObjBuilder& anObjBuilder,
                             bool fromRepl,
                             int queryOptions) {
         try {
-            return _runCommands(txn, ns, jsobj, b, anObjBuilder, fromRepl, queryOptions);
+            return _runCommands(txn, ns, jsobj, anObjBuilder, fromRepl, queryOptions);
         }
         catch( SendStaleConfigException& ){
             throw;
@@ -129,8 +131,7 @@ namespace mongo {
             Command::appendCommandStatus(anObjBuilder, e.toStatus());
             curop.debug().exceptionInfo = e.getInfo();
         }
-        BSONObj x = anObjBuilder.done();
-        b.appendBuf((void*) x.objdata(), x.objsize());
+        anObjBuilder.done();
         return true;
     }
 
@@ -141,14 +142,15 @@ namespace mongo {
      *        when this method returns an empty result, incrementing pass on each call.  
      *        Thus, pass == 0 indicates this is the first "attempt" before any 'awaiting'.
      */
-    QueryResult* newGetMore(OperationContext* txn,
-                            const char* ns,
-                            int ntoreturn,
-                            long long cursorid,
-                            CurOp& curop,
-                            int pass,
-                            bool& exhaust,
-                            bool* isCursorAuthorized) {
+    bool newGetMore(OperationContext* txn,
+                    const char* ns,
+                    int ntoreturn,
+                    long long cursorid,
+                    CurOp& curop,
+                    int pass,
+                    bool& exhaust,
+                    bool* isCursorAuthorized,
+                    Message* result) {
         exhaust = false;
 
         // This is a read lock.
@@ -176,9 +178,7 @@ namespace mongo {
         int numResults = 0;
         int startingResult = 0;
 
-        const int InitialBufSize = 512 + sizeof(QueryResult) + MaxBytesToReturnToClientAtOnce;
-        BufBuilder bb(InitialBufSize);
-        bb.skip(sizeof(QueryResult));
+        ReplyBuilder bb;
 
         if (NULL == cc) {
             cursorid = 0;
@@ -228,7 +228,7 @@ namespace mongo {
             Runner::RunnerState state;
             while (Runner::RUNNER_ADVANCED == (state = runner->getNext(&obj, NULL))) {
                 // Add result to output buffer.
-                bb.appendBuf((void*)obj.objdata(), obj.objsize());
+                bb.append(obj);
 
                 // Count the result.
                 ++numResults;
@@ -252,7 +252,7 @@ namespace mongo {
                 && (queryOptions & QueryOption_AwaitData) && (pass < 1000)) {
                 // If the cursor is tailable we don't kill it if it's eof.  We let it try to get
                 // data some # of times first.
-                return 0;
+                return false;
             }
 
             bool saveClientCursor = false;
@@ -325,16 +325,9 @@ namespace mongo {
             }
         }
 
-        QueryResult* qr = reinterpret_cast<QueryResult*>(bb.buf());
-        qr->len = bb.len();
-        qr->setOperation(opReply);
-        qr->_resultFlags() = resultFlags;
-        qr->cursorId = cursorid;
-        qr->startingFrom = startingResult;
-        qr->nReturned = numResults;
-        bb.decouple();
+        bb.done(result, resultFlags, cursorid, startingResult, numResults);
         QLOG() << "getMore returned " << numResults << " results\n";
-        return qr;
+        return true;
     }
 
     Status getOplogStartHack(Collection* collection, CanonicalQuery* cq, Runner** runnerOut) {
@@ -368,24 +361,33 @@ namespace mongo {
                           "$gt or $gte over the 'ts' field.");
         }
 
-        // Make an oplog start finding stage.
-        WorkingSet* oplogws = new WorkingSet();
-        OplogStart* stage = new OplogStart(collection, tsExpr, oplogws);
+        DiskLoc startLoc;
+
+        // Oplogs keep a sparse index over 'ts' that gets us close to the start directly.
+        OplogTsIndex* tsIndex = collection->getOplogTsIndex();
+        if (NULL != tsIndex && tsIndex->findStart(tsExpr, &startLoc)) {
+            // This is normal.  The start of the oplog is the beginning of the collection.
+            if (startLoc.isNull()) { return getRunner(collection, cq, runnerOut); }
+        }
+        else {
+            // Make an oplog start finding stage.
+            WorkingSet* oplogws = new WorkingSet();
+            OplogStart* stage = new OplogStart(collection, tsExpr, oplogws);
 
-        // Takes ownership of ws and stage.
-        auto_ptr<InternalRunner> runner(new InternalRunner(collection, stage, oplogws));
+            // Takes ownership of ws and stage.
+            auto_ptr<InternalRunner> runner(new InternalRunner(collection, stage, oplogws));
 
-        // The stage returns a DiskLoc of where to start.
-        DiskLoc startLoc;
-        Runner::RunnerState state = runner->getNext(NULL, &startLoc);
+            // The stage returns a DiskLoc of where to start.
+            Runner::RunnerState state = runner->getNext(NULL, &startLoc);
 
-        // This is normal.  The start of the oplog is the beginning of the collection.
-        if (Runner::RUNNER_EOF == state) { return getRunner(collection, cq, runnerOut); }
+            // This is normal.  The start of the oplog is the beginning of the collection.
+            if (Runner::RUNNER_EOF == state) { return getRunner(collection, cq, runnerOut); }
 
-        // This is not normal.  An error was encountered.
-        if (Runner::RUNNER_ADVANCED != state) {
-            return Status(ErrorCodes::InternalError,
-                          "quick oplog start location had error...?");
+            // This is not normal.  An error was encountered.
+            if (Runner::RUNNER_ADVANCED != state) {
+                return Status(ErrorCodes::InternalError,
+                              "quick oplog start location had error...?");
+            }
         }
 
         // cout << "diskloc is " << startLoc.toString() << endl;
@@ -431,11 +433,8 @@ namespace mongo {
 
             curop.markCommand();
 
-            BufBuilder bb;
-            bb.skip(sizeof(QueryResult));
-
             BSONObjBuilder cmdResBuf;
-            if (!runCommands(txn, ns, q.query, curop, bb, cmdResBuf, false, q.queryOptions)) {
+            if (!runCommands(txn, ns, q.query, curop, cmdResBuf, false, q.queryOptions)) {
                 uasserted(13530, "bad or malformed command request?");
             }
 
@@ -443,19 +442,24 @@ namespace mongo {
             // TODO: Does this get overwritten/do we really need to set this twice?
             curop.debug().query = q.query;
 
-            QueryResult* qr = reinterpret_cast<QueryResult*>(bb.buf());
-            bb.decouple();
-            qr->setResultFlagsToOk();
-            qr->len = bb.len();
-            curop.debug().responseLength = bb.len();
-            qr->setOperation(opReply);
-            qr->cursorId = 0;
-            qr->startingFrom = 0;
-            qr->nReturned = 1;
-            result.setData(qr, true);
+            replyToQuery(ResultFlag_AwaitCapable, result, cmdResBuf.done());
+            curop.debug().responseLength = result.header()->len;
             return "";
         }
 
+        // Handle query option $afterOpTime: block until this node has applied the client's
+        // writes.  This has to happen before taking the read lock below, which would otherwise
+        // hold off the application of the very ops we are waiting for.
+        {
+            StatusWith<OpTime> afterOpTime = LiteParsedQuery::parseAfterOpTimeQuery(q.query);
+            uassertStatusOK(afterOpTime.getStatus());
+            StatusWith<int> maxTimeMS = LiteParsedQuery::parseMaxTimeMSQuery(q.query);
+            uassertStatusOK(maxTimeMS.getStatus());
+            uassertStatusOK(repl::waitForReadAfterOptime(txn,
+                                                         afterOpTime.getValue(),
+                                                         maxTimeMS.getValue()));
+        }
+
         // This is a read lock.  We require this because if we're parsing a $where, the
         // where-specific parsing code assumes we have a lock and creates execution machinery that
         // requires it.
@@ -491,6 +495,9 @@ namespace mongo {
         // that uses a specifically designed stage that skips extents faster (see details in
         // exec/oplogstart.h)
         //
+        // (c) If the collection is time partitioned, its documents live in its partitions, and
+        // we get a TimePartitionRunner that queries them in turn.
+        //
         // Otherwise we go through the selection of which runner is most suited to the
         // query + run-time context at hand.
         Status status = Status::OK();
@@ -500,6 +507,10 @@ namespace mongo {
         else if (pq.hasOption(QueryOption_OplogReplay)) {
             status = getOplogStartHack(collection, cq, &rawRunner);
         }
+        else if (collection->getTimePartitionOptions(txn).isSet()) {
+            // Takes ownership of cq.
+            status = TimePartitionRunner::make(txn, ctx.ctx().db(), collection, cq, &rawRunner);
+        }
         else {
             // Takes ownership of cq.
             size_t options = QueryPlannerParams::DEFAULT;
@@ -543,8 +554,7 @@ namespace mongo {
         // bb is used to hold query results
         // this buffer should contain either requested documents per query or
         // explain information, but not both
-        BufBuilder bb(32768);
-        bb.skip(sizeof(QueryResult));
+        ReplyBuilder bb;
 
         // How many results have we obtained from the runner?
         int numResults = 0;
@@ -576,7 +586,7 @@ namespace mongo {
         while (Runner::RUNNER_ADVANCED == (state = runner->getNext(&obj, NULL))) {
             // Add result to output buffer. This is unnecessary if explain info is requested
             if (!isExplain) {
-                bb.appendBuf((void*)obj.objdata(), obj.objsize());
+                bb.append(obj);
             }
 
             // Count the result.
@@ -714,8 +724,7 @@ namespace mongo {
                         << "', error: " << res.reason();
                 // If numResults and the data in bb don't correspond, we'll crash later when rooting
                 // through the reply msg.
-                BSONObj emptyObj;
-                bb.appendBuf((void*)emptyObj.objdata(), emptyObj.objsize());
+                bb.append(BSONObj());
                 // The explain output is actually a result.
                 numResults = 1;
                 // TODO: we can fill out millis etc. here just fine even if the plan screwed up.
@@ -737,7 +746,7 @@ namespace mongo {
             explain->setMillis(elapsedMillis);
 
             BSONObj explainObj = explain->toBSON();
-            bb.appendBuf((void*)explainObj.objdata(), explainObj.objsize());
+            bb.append(explainObj);
 
             // The explain output is actually a result.
             numResults = 1;
@@ -783,18 +792,9 @@ namespace mongo {
             QLOG() << "Not caching runner but returning " << numResults << " results.\n";
         }
 
-        // Add the results from the query into the output buffer.
-        result.appendData(bb.buf(), bb.len());
-        bb.decouple();
-
-        // Fill out the output buffer's header.
-        QueryResult* qr = static_cast<QueryResult*>(result.header());
-        qr->cursorId = ccId;
+        // Hand the results from the query to the output message and fill out its header.
+        bb.done(&result, ResultFlag_AwaitCapable, ccId, 0, numResults);
         curop.debug().cursorid = (0 == ccId ? -1 : ccId);
-        qr->setResultFlagsToOk();
-        qr->setOperation(opReply);
-        qr->startingFrom = 0;
-        qr->nReturned = numResults;
 
         // Set debug information for consumption by the profiler.
         curop.debug().ntoskip = pq.getSkip();
@@ -42,16 +42,19 @@ namespace mongo {
     class OperationContext;
 
     /**
-     * Called from the getMore entry point in ops/query.cpp.
+     * Called from the getMore entry point in ops/query.cpp.  Places the reply in the empty
+     * message 'result', or returns false, leaving it empty, when a tailable cursor awaiting
+     * data should be retried.
      */
-    QueryResult* newGetMore(OperationContext* txn,
-                            const char* ns,
-                            int ntoreturn,
-                            long long cursorid,
-                            CurOp& curop,
-                            int pass,
-                            bool& exhaust,
-                            bool* isCursorAuthorized);
+    bool newGetMore(OperationContext* txn,
+                    const char* ns,
+                    int ntoreturn,
+                    long long cursorid,
+                    CurOp& curop,
+                    int pass,
+                    bool& exhaust,
+                    bool* isCursorAuthorized,
+                    Message* result);
 
     /**
      * Run the query 'q' and place the result in 'result'.
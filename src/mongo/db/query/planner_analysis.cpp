@@ -31,6 +31,7 @@
 #include <vector>
 
 #include "mongo/db/jsobj.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/qlog.h"
@@ -443,6 +444,17 @@ namespace mongo {
             sort->limit = size_t(query.getParsed().getNumToReturn()) +
                           size_t(query.getParsed().getSkip());
 
+            // If we're sorting text results by nothing but their score, the text stage only has
+            // to produce the documents that make the cut.  It can't do this from beneath any
+            // other stage, since that stage might drop some of them.
+            if (internalQueryTextTopK
+                && STAGE_TEXT == sort->children[0]->getType()
+                && 1 == sortObj.nFields()
+                && LiteParsedQuery::isTextScoreMeta(sortObj.firstElement())) {
+                TextNode* textNode = static_cast<TextNode*>(sort->children[0]);
+                textNode->topK = sort->limit;
+            }
+
             // This is a SORT with a limit. The wire protocol has a single quantity
             // called "numToReturn" which could mean either limit or batchSize.
             // We have no idea what the client intended. One way to handle the ambiguity
@@ -651,14 +663,22 @@ namespace mongo {
                 }
             }
 
-            // We now know we have whatever data is required for the projection.
-            ProjectionNode* projNode = new ProjectionNode();
-            projNode->children.push_back(solnRoot);
-            projNode->fullExpression = query.root();
-            projNode->projection = query.getParsed().getProj();
-            projNode->projType = projType;
-            projNode->coveredKeyObj = coveredKeyObj;
-            solnRoot = projNode;
+            if ((params.options & QueryPlannerParams::NO_UNCOVERED_PROJECTIONS)
+                && solnRoot->fetched()) {
+                // The caller would rather pick fields out of the whole document than have us
+                // build a projected copy of it.
+                QLOG() << "PROJECTION: not covered, returning whole documents.\n";
+            }
+            else {
+                // We now know we have whatever data is required for the projection.
+                ProjectionNode* projNode = new ProjectionNode();
+                projNode->children.push_back(solnRoot);
+                projNode->fullExpression = query.root();
+                projNode->projection = query.getParsed().getProj();
+                projNode->projType = projType;
+                projNode->coveredKeyObj = coveredKeyObj;
+                solnRoot = projNode;
+            }
         }
         else {
             // If there's no projection, we must fetch, as the user wants the entire doc.
@@ -60,4 +60,10 @@ namespace mongo {
 
     MONGO_EXPORT_SERVER_PARAMETER(internalQueryMaxScansToExplode, int, 200);
 
+    MONGO_EXPORT_SERVER_PARAMETER(internalQueryCompileMatchExpressions, bool, true);
+
+    MONGO_EXPORT_SERVER_PARAMETER(internalQueryTextTopK, bool, true);
+
+    MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecSortAllowDiskUse, bool, false);
+
 }  // namespace mongo
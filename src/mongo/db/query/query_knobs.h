@@ -89,4 +89,19 @@ namespace mongo {
     // during explodeForSort?
     extern int internalQueryMaxScansToExplode;
 
+    //
+    // Execution.
+    //
+
+    // Do collection scans evaluate their filter through a CompiledMatcher?
+    extern bool internalQueryCompileMatchExpressions;
+
+    // Do text stages beneath a limited sort on textScore stop reading the index once the top
+    // results are known?
+    extern bool internalQueryTextTopK;
+
+    // May blocking sort stages spill to disk once they exceed their memory limit, rather than
+    // failing the query?
+    extern bool internalQueryExecSortAllowDiskUse;
+
 }  // namespace mongo
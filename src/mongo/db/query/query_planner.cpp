@@ -92,7 +92,10 @@ namespace mongo {
             ss << "INDEX_INTERSECTION ";
         }
         if (options & QueryPlannerParams::KEEP_MUTATIONS) {
-            ss << "KEEP_MUTATIONS";
+            ss << "KEEP_MUTATIONS ";
+        }
+        if (options & QueryPlannerParams::NO_UNCOVERED_PROJECTIONS) {
+            ss << "NO_UNCOVERED_PROJECTIONS";
         }
 
         return ss;
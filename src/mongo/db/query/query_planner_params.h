@@ -81,7 +81,12 @@ namespace mongo {
             // Set this if you want to handle batchSize properly with sort(). If limits on SORT
             // stages are always actually limits, then this should be left off. If they are
             // sometimes to be interpreted as batchSize, then this should be turned on.
-            SPLIT_LIMITED_SORT = 1 << 7
+            SPLIT_LIMITED_SORT = 1 << 7,
+
+            // Set this if the caller only wants the projection applied when the index data
+            // covers it.  Plans that would have to fetch in order to project return the whole
+            // document instead, and the caller is expected to pick out the fields it needs.
+            NO_UNCOVERED_PROJECTIONS = 1 << 8
         };
 
         // See Options enum above.
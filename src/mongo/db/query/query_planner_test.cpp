@@ -3956,6 +3956,30 @@ namespace {
                                 "{filter: null, pattern: {a: 1}}}}}]}}}}");
     }
 
+    TEST_F(QueryPlannerTest, NoUncoveredProjectionsCovered) {
+        params.options = QueryPlannerParams::INCLUDE_COLLSCAN
+                       | QueryPlannerParams::NO_UNCOVERED_PROJECTIONS;
+        addIndex(BSON("x" << 1 << "y" << 1));
+        runQuerySortProj(fromjson("{x: {$gt: 1}}"), BSONObj(), fromjson("{_id: 0, x: 1, y: 1}"));
+
+        ASSERT_EQUALS(getNumSolutions(), 2U);
+        assertSolutionExists("{proj: {spec: {_id: 0, x: 1, y: 1}, node: {ixscan: "
+                                "{filter: null, pattern: {x: 1, y: 1}}}}}");
+        assertSolutionExists("{cscan: {dir: 1, filter: {x: {$gt: 1}}}}");
+    }
+
+    TEST_F(QueryPlannerTest, NoUncoveredProjectionsNotCovered) {
+        params.options = QueryPlannerParams::INCLUDE_COLLSCAN
+                       | QueryPlannerParams::NO_UNCOVERED_PROJECTIONS;
+        addIndex(BSON("x" << 1));
+        runQuerySortProj(fromjson("{x: {$gt: 1}}"), BSONObj(), fromjson("{_id: 0, x: 1, y: 1}"));
+
+        ASSERT_EQUALS(getNumSolutions(), 2U);
+        assertSolutionExists("{fetch: {filter: null, node: {ixscan: "
+                                "{filter: null, pattern: {x: 1}}}}}");
+        assertSolutionExists("{cscan: {dir: 1, filter: {x: {$gt: 1}}}}");
+    }
+
     //
     // Index Intersection.
     //
@@ -270,7 +270,7 @@ namespace mongo {
             return geoObj == node->indexKeyPattern;
         }
         else if (STAGE_TEXT == trueSoln->getType()) {
-            // {text: {search: "somestr", language: "something", filter: {blah: 1}}}
+            // {text: {search: "somestr", language: "something", filter: {blah: 1}, topK: 10}}
             const TextNode* node = static_cast<const TextNode*>(trueSoln);
             BSONElement el = testSoln["text"];
             if (el.eoo() || !el.isABSONObj()) { return false; }
@@ -301,6 +301,13 @@ namespace mongo {
                 }
             }
 
+            BSONElement topK = textObj["topK"];
+            if (!topK.eoo()) {
+                if (!topK.isNumber() || size_t(topK.numberLong()) != node->topK) {
+                    return false;
+                }
+            }
+
             BSONElement filter = textObj["filter"];
             if (!filter.eoo()) {
                 if (filter.isNull()) {
@@ -563,6 +563,43 @@ namespace {
         assertSolutionExists("{fetch: {node: {text: {search: 'foo'}}}}");
     }
 
+    // A limited sort on the text score lets the text stage stop early.
+    TEST_F(QueryPlannerTest, TextScoreSortWithLimit) {
+        addIndex(BSON("_fts" << "text" << "_ftsx" << 1));
+        runQuerySortProjSkipLimit(fromjson("{$text: {$search: 'blah'}}"),
+                                  fromjson("{score: {$meta: 'textScore'}}"),
+                                  fromjson("{score: {$meta: 'textScore'}}"),
+                                  5, 10);
+
+        assertNumSolutions(1U);
+        assertSolutionExists("{skip: {n: 5, node: {proj: {spec: {score: {$meta: 'textScore'}}, "
+                                "node: {sort: {pattern: {score: {$meta: 'textScore'}}, limit: 15, "
+                                    "node: {text: {search: 'blah', topK: 15}}}}}}}}");
+    }
+
+    // Without a limit, or when sorting on anything else as well, every result is needed.
+    TEST_F(QueryPlannerTest, TextScoreSortNoTopK) {
+        addIndex(BSON("_fts" << "text" << "_ftsx" << 1));
+        runQuerySortProj(fromjson("{$text: {$search: 'blah'}}"),
+                         fromjson("{score: {$meta: 'textScore'}}"),
+                         fromjson("{score: {$meta: 'textScore'}}"));
+
+        assertNumSolutions(1U);
+        assertSolutionExists("{proj: {spec: {score: {$meta: 'textScore'}}, "
+                                "node: {sort: {pattern: {score: {$meta: 'textScore'}}, limit: 0, "
+                                    "node: {text: {search: 'blah', topK: 0}}}}}}");
+
+        runQuerySortProjSkipLimit(fromjson("{$text: {$search: 'blah'}}"),
+                                  fromjson("{score: {$meta: 'textScore'}, a: 1}"),
+                                  fromjson("{score: {$meta: 'textScore'}}"),
+                                  0, 10);
+
+        assertNumSolutions(1U);
+        assertSolutionExists("{proj: {spec: {score: {$meta: 'textScore'}}, "
+                                "node: {sort: {pattern: {score: {$meta: 'textScore'}, a: 1}, "
+                                    "limit: 10, node: {text: {search: 'blah', topK: 0}}}}}}");
+    }
+
     // SERVER-13960: $text beneath $or with exact predicates.
     TEST_F(QueryPlannerTest, OrTextExact) {
         addIndex(BSON("pre" << 1 << "_fts" << "text" << "_ftsx" << 1));
@@ -72,6 +72,10 @@ namespace mongo {
         *ss << "language = " << language << '\n';
         addIndent(ss, indent + 1);
         *ss << "indexPrefix = " << indexPrefix.toString() << '\n';
+        if (0 != topK) {
+            addIndent(ss, indent + 1);
+            *ss << "topK = " << topK << '\n';
+        }
         if (NULL != filter) {
             addIndent(ss, indent + 1);
             *ss << " filter = " << filter->toString();
@@ -88,6 +92,7 @@ namespace mongo {
         copy->query = this->query;
         copy->language = this->language;
         copy->indexPrefix = this->indexPrefix;
+        copy->topK = this->topK;
 
         return copy;
     }
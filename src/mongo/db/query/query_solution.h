@@ -215,7 +215,7 @@ namespace mongo {
     };
 
     struct TextNode : public QuerySolutionNode {
-        TextNode() { }
+        TextNode() : topK(0) { }
         virtual ~TextNode() { }
 
         virtual StageType getType() const { return STAGE_TEXT; }
@@ -240,6 +240,10 @@ namespace mongo {
         // text node while creating the text leaf node and convert them into a BSONObj index prefix
         // when we finish the text leaf node.
         BSONObj indexPrefix;
+
+        // If nonzero, the parent only wants the 'topK' highest scoring documents, and the text
+        // stage may stop reading the index once no other document can score higher.
+        size_t topK;
     };
 
     struct CollectionScanNode : public QuerySolutionNode {
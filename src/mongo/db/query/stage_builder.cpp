@@ -49,6 +49,8 @@
 #include "mongo/db/exec/skip.h"
 #include "mongo/db/exec/text.h"
 #include "mongo/db/index/fts_access_method.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/storage_options.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
 
@@ -107,6 +109,10 @@ namespace mongo {
             params.pattern = sn->pattern;
             params.query = sn->query;
             params.limit = sn->limit;
+            if (internalQueryExecSortAllowDiskUse) {
+                params.allowDiskUse = true;
+                params.tempDir = storageGlobalParams.dbpath + "/_tmp";
+            }
             return new SortStage(params, ws, childStage);
         }
         else if (STAGE_PROJECTION == root->getType()) {
@@ -244,6 +250,7 @@ namespace mongo {
             params.index = index;
             params.spec = fam->getSpec();
             params.indexPrefix = node->indexPrefix;
+            params.topK = node->topK;
 
             const std::string& language = ("" == node->language
                                            ? fam->getSpec().defaultLanguage().str()
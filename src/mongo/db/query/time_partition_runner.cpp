@@ -0,0 +1,289 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/time_partition_runner.h"
+
+#include <limits>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/time_partition.h"
+#include "mongo/db/diskloc.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/get_runner.h"
+#include "mongo/db/query/type_explain.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+    // static
+    Status TimePartitionRunner::make(OperationContext* txn,
+                                     Database* db,
+                                     Collection* parent,
+                                     CanonicalQuery* cq,
+                                     Runner** out) {
+        auto_ptr<CanonicalQuery> autoCq(cq);
+        const LiteParsedQuery& pq = cq->getParsed();
+
+        if (!pq.getSort().isEmpty() || pq.getSkip() != 0 ||
+            !pq.getMin().isEmpty() || !pq.getMax().isEmpty() || pq.isSnapshot()) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "sort, skip, min, max and snapshot are not supported"
+                                        << " on time partitioned collection " << cq->ns());
+        }
+
+        TimePartitionOptions options = parent->getTimePartitionOptions(txn);
+        long long minMillis = std::numeric_limits<long long>::min();
+        long long maxMillis = std::numeric_limits<long long>::max();
+        getTimePartitionBounds(cq->root(), options.field, &minMillis, &maxMillis);
+
+        std::vector<std::string> partitions;
+        getTimePartitions(db, cq->ns(), options, minMillis, maxMillis, &partitions);
+
+        *out = new TimePartitionRunner(txn, db, parent, autoCq.release(), partitions);
+        return Status::OK();
+    }
+
+    TimePartitionRunner::TimePartitionRunner(OperationContext* txn,
+                                             Database* db,
+                                             Collection* parent,
+                                             CanonicalQuery* cq,
+                                             const std::vector<std::string>& partitions)
+        : _db(db),
+          _parent(parent),
+          _txn(txn),
+          _cq(cq),
+          _ns(cq->ns()),
+          _partitions(partitions),
+          _nextPartition(0),
+          _n(0),
+          _nScanned(0),
+          _nScannedObjects(0) {
+    }
+
+    TimePartitionRunner::~TimePartitionRunner() {
+        // Deregister before the runner goes away.
+        _childRegistration.reset();
+    }
+
+    Status TimePartitionRunner::_openNextPartition() {
+        invariant(NULL == _child.get());
+
+        const LiteParsedQuery& pq = _cq->getParsed();
+        while (_nextPartition < _partitions.size()) {
+            const std::string& childNs = _partitions[_nextPartition++];
+
+            // The partition may have expired since we listed them.
+            Collection* child = _db->getCollection(_txn, childNs);
+            if (NULL == child) {
+                continue;
+            }
+
+            CanonicalQuery* childCq;
+            Status status = CanonicalQuery::canonicalize(childNs,
+                                                         pq.getFilter(),
+                                                         BSONObj(),
+                                                         pq.getProj(),
+                                                         0,
+                                                         0,
+                                                         pq.getHint(),
+                                                         BSONObj(),
+                                                         BSONObj(),
+                                                         false,
+                                                         pq.isExplain(),
+                                                         &childCq,
+                                                         WhereCallbackReal(_db->name()));
+            if (!status.isOK()) {
+                return status;
+            }
+
+            Runner* rawChild;
+            status = getRunner(child, childCq, &rawChild);
+            if (!status.isOK()) {
+                return status;
+            }
+
+            _child.reset(rawChild);
+            _childRegistration.reset(new ScopedRunnerRegistration(_child.get()));
+            _childNs = childNs;
+            return Status::OK();
+        }
+
+        return Status::OK();
+    }
+
+    void TimePartitionRunner::_closePartition() {
+        TypeExplain* rawExplain;
+        if (_child->getInfo(&rawExplain, NULL).isOK()) {
+            scoped_ptr<TypeExplain> explain(rawExplain);
+            _n += explain->getN();
+            _nScanned += explain->getNScanned();
+            _nScannedObjects += explain->getNScannedObjects();
+        }
+
+        _childRegistration.reset();
+        _child.reset();
+        _childNs.clear();
+    }
+
+    Runner::RunnerState TimePartitionRunner::getNext(BSONObj* objOut, DiskLoc* dlOut) {
+        if (NULL == _parent) {
+            return Runner::RUNNER_DEAD;
+        }
+
+        while (true) {
+            if (NULL == _child.get()) {
+                Status status = _openNextPartition();
+                if (!status.isOK()) {
+                    if (NULL != objOut) {
+                        BSONObjBuilder bob;
+                        bob.append("ok", 0.0);
+                        bob.append("code", status.code());
+                        bob.append("errmsg", status.reason());
+                        *objOut = bob.obj();
+                    }
+                    return Runner::RUNNER_ERROR;
+                }
+                if (NULL == _child.get()) {
+                    return Runner::RUNNER_EOF;
+                }
+            }
+
+            Runner::RunnerState state = _child->getNext(objOut, dlOut);
+            if (Runner::RUNNER_EOF != state) {
+                return state;
+            }
+            _closePartition();
+        }
+    }
+
+    bool TimePartitionRunner::isEOF() {
+        if (NULL == _parent) {
+            return true;
+        }
+        if (NULL != _child.get() && !_child->isEOF()) {
+            return false;
+        }
+        // Partitions we haven't opened yet may still turn out to be empty, but we can't tell
+        // without running the query over them.
+        return _nextPartition >= _partitions.size();
+    }
+
+    void TimePartitionRunner::saveState() {
+        if (NULL != _child.get()) {
+            _child->saveState();
+        }
+    }
+
+    bool TimePartitionRunner::restoreState(OperationContext* opCtx) {
+        if (NULL == _parent) {
+            return false;
+        }
+
+        _txn = opCtx;
+        if (NULL == _child.get() || _child->restoreState(opCtx)) {
+            return true;
+        }
+
+        // The current partition's runner was killed.  If that's because the partition expired
+        // and was dropped, move on to the next one.  Anything else, such as an index the
+        // partition's plan uses being dropped, kills us too.
+        if (NULL != _db->getCollection(opCtx, _childNs)) {
+            return false;
+        }
+
+        _childRegistration.reset();
+        _child.reset();
+        _childNs.clear();
+        return true;
+    }
+
+    const std::string& TimePartitionRunner::ns() {
+        return _ns;
+    }
+
+    void TimePartitionRunner::kill() {
+        _childRegistration.reset();
+        if (NULL != _child.get()) {
+            _child->kill();
+        }
+        _db = NULL;
+        _parent = NULL;
+    }
+
+    Status TimePartitionRunner::getInfo(TypeExplain** explain,
+                                        PlanInfo** planInfo) const {
+        if (NULL != explain) {
+            long long n = _n;
+            long long nScanned = _nScanned;
+            long long nScannedObjects = _nScannedObjects;
+
+            if (NULL != _child.get()) {
+                TypeExplain* rawChildExplain;
+                if (_child->getInfo(&rawChildExplain, NULL).isOK()) {
+                    scoped_ptr<TypeExplain> childExplain(rawChildExplain);
+                    n += childExplain->getN();
+                    nScanned += childExplain->getNScanned();
+                    nScannedObjects += childExplain->getNScannedObjects();
+                }
+            }
+
+            *explain = new TypeExplain;
+
+            // Fill in mandatory fields.
+            (*explain)->setN(n);
+            (*explain)->setNScannedObjects(nScannedObjects);
+            (*explain)->setNScanned(nScanned);
+
+            // Fill in all the main fields that don't have a default in the explain data structure.
+            (*explain)->setCursor("TimePartitionCursor");
+            (*explain)->setScanAndOrder(false);
+            (*explain)->setIsMultiKey(false);
+            (*explain)->setIndexOnly(false);
+            (*explain)->setNYields(0);
+            (*explain)->setNChunkSkips(0);
+
+            TypeExplain* allPlans = new TypeExplain;
+            allPlans->setCursor("TimePartitionCursor");
+            (*explain)->addToAllPlans(allPlans); // ownership xfer
+
+            (*explain)->setNScannedObjectsAllPlans(nScannedObjects);
+            (*explain)->setNScannedAllPlans(nScanned);
+        }
+        else if (NULL != planInfo) {
+            *planInfo = new PlanInfo();
+            (*planInfo)->planSummary = str::stream() << "TIME_PARTITIONS " << _partitions.size();
+        }
+
+        return Status::OK();
+    }
+
+}  // namespace mongo
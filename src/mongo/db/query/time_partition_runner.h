@@ -0,0 +1,142 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/scoped_ptr.hpp>
+#include <string>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/db/query/runner.h"
+
+namespace mongo {
+
+    class BSONObj;
+    class CanonicalQuery;
+    class Collection;
+    class Database;
+    class DiskLoc;
+    struct ScopedRunnerRegistration;
+    class TypeExplain;
+    struct PlanInfo;
+
+    /**
+     * Runs a query over a time partitioned collection (see db/catalog/time_partition.h) by
+     * running it over each partition that the query's predicates on the partition field can
+     * match, one after the other, in time order.
+     *
+     * Each partition's runner is registered with the partition's collection, so it receives
+     * invalidations while yielded.  A partition that is dropped while the query is yielded
+     * (because it expired) is skipped.
+     */
+    class TimePartitionRunner : public Runner {
+    public:
+        /**
+         * Creates a runner for 'cq' over the time partitioned collection 'parent'.  Sorting,
+         * skipping, min/max bounds and snapshot aren't supported, since results come from one
+         * partition after another.
+         *
+         * Takes ownership of 'cq', even on failure.  On success the caller owns '*out'.
+         */
+        static Status make(OperationContext* txn,
+                           Database* db,
+                           Collection* parent,
+                           CanonicalQuery* cq,
+                           Runner** out);
+
+        virtual ~TimePartitionRunner();
+
+        virtual Runner::RunnerState getNext(BSONObj* objOut, DiskLoc* dlOut);
+
+        virtual bool isEOF();
+
+        virtual void saveState();
+
+        virtual bool restoreState(OperationContext* opCtx);
+
+        // Invalidations are delivered straight to the current partition's runner.
+        virtual void invalidate(const DiskLoc& dl, InvalidationType type) { }
+
+        virtual const std::string& ns();
+
+        virtual void kill();
+
+        virtual const Collection* collection() { return _parent; }
+
+        /**
+         * Fills in '*explain' with the totals over the partitions visited so far, or '*planInfo'
+         * with the number of partitions the query visits.
+         */
+        virtual Status getInfo(TypeExplain** explain,
+                               PlanInfo** planInfo) const;
+
+    private:
+        TimePartitionRunner(OperationContext* txn,
+                            Database* db,
+                            Collection* parent,
+                            CanonicalQuery* cq,
+                            const std::vector<std::string>& partitions);
+
+        /**
+         * Opens a runner over the next partition that still exists.  Leaves _child NULL if
+         * there are no partitions left.
+         */
+        Status _openNextPartition();
+
+        /**
+         * Adds the stats of the current partition's runner to the totals and discards it.
+         */
+        void _closePartition();
+
+        // Not owned here.  Both are NULL once we have been killed.
+        Database* _db;
+        Collection* _parent;
+
+        // The operation we are running in.  Updated by restoreState.
+        OperationContext* _txn;
+
+        boost::scoped_ptr<CanonicalQuery> _cq;
+        std::string _ns;
+
+        // The partitions to visit, in order, and the index of the next one to open.
+        std::vector<std::string> _partitions;
+        size_t _nextPartition;
+
+        // The runner over the current partition, and its registration with that partition.
+        boost::scoped_ptr<Runner> _child;
+        boost::scoped_ptr<ScopedRunnerRegistration> _childRegistration;
+        std::string _childNs;
+
+        // Totals over the partitions closed so far, for explain.
+        long long _n;
+        long long _nScanned;
+        long long _nScannedObjects;
+    };
+
+}  // namespace mongo
@@ -404,6 +404,12 @@ namespace repl {
                     bb.appendDate("electionDate", theReplSet->getElectionTime().getSecs() * 1000LL);
                 }
             }
+
+            if (myState == MemberState::RS_STARTUP2 && !_initialSyncProgress.empty()) {
+                BSONObjBuilder initialSyncBuilder(bb.subobjStart("initialSyncStatus"));
+                _initialSyncProgress.append(&initialSyncBuilder);
+                initialSyncBuilder.doneFast();
+            }
             bb.append("self", true);
             v.push_back(bb.obj());
         }
@@ -54,6 +54,7 @@
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/rs.h"
 #include "mongo/db/repl/write_concern.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/db/operation_context_impl.h"
 #include "mongo/db/storage_options.h"
@@ -77,6 +78,10 @@ namespace repl {
     static mongo::mutex newOpMutex("oplogNewOp");
     static boost::condition newOptimeNotifier;
 
+    // Upper bound on how long a read with the afterOpTime option waits for this node to catch
+    // up when the read doesn't carry its own maxTimeMS.
+    MONGO_EXPORT_SERVER_PARAMETER(afterOpTimeDefaultTimeoutMS, int, 30 * 1000);
+
     static void setNewOptime(const OpTime& newTime) {
         mutex::scoped_lock lk(newOpMutex);
         setGlobalOptime(newTime);
@@ -702,9 +707,8 @@ namespace repl {
         else if ( *opType == 'c' ) {
             bool done = false;
             while (!done) {
-                BufBuilder bb;
                 BSONObjBuilder ob;
-                _runCommands(txn, ns, o, bb, ob, true, 0);
+                _runCommands(txn, ns, o, ob, true, 0);
                 // _runCommands takes care of adjusting opcounters for command counting.
                 Status status = Command::getStatusFromCommandResult(ob.done());
                 switch (status.code()) {
@@ -759,6 +763,45 @@ namespace repl {
 
     }
 
+    bool waitForOptime(const OpTime& targetTime, unsigned timeoutMillis) {
+        Timer t;
+        OpTime last = getLastSetOptime();
+        while (last < targetTime) {
+            const unsigned elapsedMillis = static_cast<unsigned>(t.millis());
+            if (elapsedMillis >= timeoutMillis)
+                return false;
+
+            // Any new OpTime wakes us up, so re-check against the target after each change.
+            waitForOptimeChange(last, timeoutMillis - elapsedMillis);
+            last = getLastSetOptime();
+        }
+
+        return true;
+    }
+
+    Status waitForReadAfterOptime(OperationContext* txn,
+                                  const OpTime& targetTime,
+                                  int maxTimeMS) {
+        if (targetTime.isNull())
+            return Status::OK();
+
+        if (txn->lockState()->isLocked()) {
+            return Status(ErrorCodes::IllegalOperation,
+                          "cannot wait for afterOpTime while holding a lock");
+        }
+
+        const int timeoutMillis = maxTimeMS > 0 ? maxTimeMS : afterOpTimeDefaultTimeoutMS;
+        if (!waitForOptime(targetTime, std::max(timeoutMillis, 0))) {
+            return Status(ErrorCodes::ExceededTimeLimit,
+                          str::stream() << "timed out waiting for optime "
+                                        << targetTime.toStringPretty()
+                                        << " to be applied; last applied optime is "
+                                        << getLastSetOptime().toStringPretty());
+        }
+
+        return Status::OK();
+    }
+
     void initOpTimeFromOplog(OperationContext* txn, const std::string& oplogNS) {
         DBDirectClient c(txn);
         BSONObj lastOp = c.findOne(oplogNS,
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include "mongo/base/status.h"
+
 namespace mongo {
     class BSONObj;
     class Database;
@@ -109,6 +111,25 @@ namespace repl {
      */
     bool waitForOptimeChange(const OpTime& referenceTime, unsigned timeoutMillis);
 
+    /**
+     * Waits until the given timeout for the OpTime from the oplog to reach 'targetTime'.
+     * Returns true if an OpTime at or after 'targetTime' was set before the timeout.
+     */
+    bool waitForOptime(const OpTime& targetTime, unsigned timeoutMillis);
+
+    /**
+     * Blocks a read that asked to observe the writes up to 'targetTime' (the afterOpTime read
+     * option) until this node has applied them.  Waits at most 'maxTimeMS' milliseconds, or
+     * the afterOpTimeDefaultTimeoutMS server parameter if 'maxTimeMS' is 0.  A null
+     * 'targetTime' returns immediately.
+     *
+     * Returns IllegalOperation if 'txn' holds any locks, since applying the awaited ops
+     * requires them, and ExceededTimeLimit if the target OpTime was not reached in time.
+     */
+    Status waitForReadAfterOptime(OperationContext* txn,
+                                  const OpTime& targetTime,
+                                  int maxTimeMS);
+
     /**
      * Initializes the global OpTime with the value from the timestamp of the last oplog entry.
      */
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include "mongo/db/clone_progress.h"
 #include "mongo/db/repl/consensus.h"
 #include "mongo/db/repl/heartbeat_info.h"
 #include "mongo/db/repl/manager.h"
@@ -295,6 +296,8 @@ namespace repl {
 
         // keep a list of hosts that we've tried recently that didn't work
         map<string,time_t> _veto;
+        // per-collection progress of the current initial sync's data clone, for replSetGetStatus
+        CloneProgress _initialSyncProgress;
         // persistent pool of worker threads for writing ops to the databases
         threadpool::ThreadPool _writerPool;
         // persistent pool of worker threads for prefetching
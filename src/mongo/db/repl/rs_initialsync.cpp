@@ -46,6 +46,7 @@
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplogreader.h"
 #include "mongo/db/repl/repl_settings.h"  // replSettings
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/structure/catalog/namespace_details.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -55,6 +56,9 @@ namespace repl {
     using namespace mongoutils;
     using namespace bson;
 
+    // Number of collections initial sync clones at once, each over its own connection.
+    MONGO_EXPORT_SERVER_PARAMETER(initialSyncCollectionCloners, int, 4);
+
     // add try/catch with sleep
 
     void isyncassert(const string& msg, bool expr) {
@@ -114,6 +118,9 @@ namespace repl {
             options.mayBeInterrupted = false;
             options.syncData = dataPass;
             options.syncIndexes = ! dataPass;
+            options.parallelCollectionClones = initialSyncCollectionCloners;
+            if ( dataPass )
+                options.progress = &_initialSyncProgress;
 
             if (!cloner.go(&txn, ctx.ctx(), master, options, NULL, err, &errCode)) {
                 sethbmsg(str::stream() << "initial sync: error while "
@@ -413,6 +420,7 @@ namespace repl {
             dropAllDatabasesExceptLocal(&txn);
 
             sethbmsg("initial sync clone all databases", 0);
+            _initialSyncProgress.clear();
 
             list<string> dbs = r.conn()->getDatabaseNames();
 
@@ -495,6 +503,7 @@ namespace repl {
         // we're up to
         BackgroundSync::notify();
 
+        _initialSyncProgress.clear();
         changeState(MemberState::RS_RECOVERING);
         sethbmsg("initial sync done",0);
     }
@@ -36,6 +36,7 @@
 #include "mongo/db/commands/fsync.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/instance.h"
+#include "mongo/db/operation_context.h"
 #include "mongo/db/repl/is_master.h"
 #include "mongo/util/background.h"
 #include "mongo/util/mongoutils/str.h"
@@ -48,6 +49,10 @@ namespace repl {
 
     using namespace mongoutils;
 
+    // How often a thread waiting for replication wakes to check for interruption when no slave
+    // has reported progress.
+    static const int kReplWaitInterruptCheckMillis = 100;
+
     class SlaveTracking : public BackgroundJob { // SERVER-4328 todo review
     public:
         string name() const { return "SlaveTracking"; }
@@ -143,12 +148,15 @@ namespace repl {
                 if (theReplSet && theReplSet->isPrimary()) {
                     const Member* mem = theReplSet->findById(ident.obj["config"]["_id"].Int());
                     if (!mem) {
+                        _wakeWaiters_locked(last);
                         return false;
                     }
                     ReplSetConfig::MemberCfg cfg = mem->config();
                     cfg.updateGroups(last);
                 }
 
+                _wakeWaiters_locked(last);
+
                 if ( ! _started ) {
                     // start background thread here since we definitely need it
                     _started = true;
@@ -232,7 +240,64 @@ namespace repl {
             return true;
         }
 
-        bool _replicatedToNum_slaves_locked(OpTime& op, int numSlaves ) {
+        bool awaitReplication(OperationContext* txn,
+                              const OpTime& op,
+                              int w,
+                              const string& wMode,
+                              int timeoutMillis) {
+            Timer timer;
+            ReplicationWaiter waiter;
+
+            scoped_lock mylk(_mutex);
+            WaiterRegistration registration(&_waiters, op, &waiter);
+            while (!_opReplicatedEnough_locked(op, w, wMode)) {
+                int waitMillis = kReplWaitInterruptCheckMillis;
+                if (timeoutMillis > 0) {
+                    const int remaining = timeoutMillis - timer.millis();
+                    if (remaining <= 0) {
+                        return false;
+                    }
+                    waitMillis = std::min(waitMillis, remaining);
+                }
+                waiter.condition.timed_wait(mylk.boost(),
+                                            boost::posix_time::milliseconds(waitMillis));
+                txn->checkForInterrupt();
+            }
+            return true;
+        }
+
+        bool _opReplicatedEnough_locked(const OpTime& op, int w, const string& wMode) {
+            if (wMode.empty() || wMode == "majority") {
+                massert(ErrorCodes::NotMaster,
+                        "awaitReplication called but not master anymore", _isMaster());
+                if (!wMode.empty()) {
+                    // use the entire set, including arbiters, as opReplicatedEnough does
+                    w = theReplSet->config().getMajority();
+                }
+                return w <= 1 || _replicatedToNum_slaves_locked(op, w - 1);
+            }
+
+            map<string,ReplSetConfig::TagRule*>::const_iterator it =
+                theReplSet->config().rules.find(wMode);
+            uassert(ErrorCodes::UnknownReplWriteConcern,
+                    str::stream() << "unrecognized getLastError mode: " << wMode,
+                    it != theReplSet->config().rules.end());
+
+            return op <= (*it).second->last;
+        }
+
+        /**
+         * Wakes the threads in awaitReplication() whose op a slave has now reached, since only
+         * they can have had their write concern satisfied.
+         */
+        void _wakeWaiters_locked(const OpTime& last) {
+            for (WaiterMap::const_iterator it = _waiters.begin();
+                 it != _waiters.end() && it->first <= last; ++it) {
+                it->second->condition.notify_one();
+            }
+        }
+
+        bool _replicatedToNum_slaves_locked(const OpTime& op, int numSlaves ) {
             for ( map<Ident,OpTime>::iterator i=_slaves.begin(); i!=_slaves.end(); i++) {
                 OpTime s = i->second;
                 if ( s < op ) {
@@ -267,9 +332,32 @@ namespace repl {
             return _slaves.size();
         }
 
+        struct ReplicationWaiter {
+            boost::condition condition;
+        };
+
+        // Threads in awaitReplication(), by the op they wait for.
+        typedef multimap<OpTime, ReplicationWaiter*> WaiterMap;
+
+        /**
+         * Keeps a waiter in the WaiterMap for its lifetime.  Must only be constructed and
+         * destroyed with _mutex held.
+         */
+        class WaiterRegistration {
+            MONGO_DISALLOW_COPYING(WaiterRegistration);
+        public:
+            WaiterRegistration(WaiterMap* waiters, const OpTime& op, ReplicationWaiter* waiter)
+                : _waiters(waiters), _it(waiters->insert(make_pair(op, waiter))) {}
+            ~WaiterRegistration() { _waiters->erase(_it); }
+        private:
+            WaiterMap* _waiters;
+            WaiterMap::iterator _it;
+        };
+
         // need to be careful not to deadlock with this
         mutable mongo::mutex _mutex;
         boost::condition _threadsWaitingForReplication;
+        WaiterMap _waiters;
 
         map<Ident,OpTime> _slaves;
         bool _dirty;
@@ -354,6 +442,14 @@ namespace repl {
         return slaveTracking.waitForReplication( op, w, maxSecondsToWait );
     }
 
+    bool awaitReplication( OperationContext* txn,
+                           const OpTime& op,
+                           int w,
+                           const string& wMode,
+                           int timeoutMillis ) {
+        return slaveTracking.awaitReplication( txn, op, w, wMode, timeoutMillis );
+    }
+
     vector<BSONObj> getHostsWrittenTo( const OpTime& op ) {
         return slaveTracking.getHostsAtOp(op);
     }
@@ -39,6 +39,7 @@
  */
 namespace mongo {
     class CurOp;
+    class OperationContext;
 
 namespace repl {
 
@@ -53,6 +54,18 @@ namespace repl {
 
     bool waitForReplication( OpTime op , int w , int maxSecondsToWait );
 
+    /**
+     * Blocks until "op" has made it to "w" servers, or to the servers named by "wMode" if it is
+     * not empty.  Waiters sleep until a slave reports progress past "op" rather than polling.
+     * Throws if "txn" is interrupted or this node stops being master.
+     * @return false if "timeoutMillis" pass first; 0 waits forever
+     */
+    bool awaitReplication( OperationContext* txn,
+                           const OpTime& op,
+                           int w,
+                           const std::string& wMode,
+                           int timeoutMillis );
+
     std::vector<BSONObj> getHostsWrittenTo( const OpTime& op );
 
     void resetSlaveCache();
@@ -42,7 +42,8 @@ namespace mongo {
             configsvr(false), cpu(false), objcheck(true), defaultProfile(0),
             slowMS(100), defaultLocalThresholdMillis(15), moveParanoia(true),
             noUnixSocket(false), doFork(0), socket("/tmp"), maxConns(DEFAULT_MAX_CONN), 
-            unixSocketPermissions(DEFAULT_UNIX_PERMS), logAppend(false), logWithSyslog(false), 
+            unixSocketPermissions(DEFAULT_UNIX_PERMS), logAppend(false), logBufferedWrites(false),
+            logWithSyslog(false), 
             isHttpInterfaceEnabled(false)
         {
             started = time(0);
@@ -91,6 +92,7 @@ namespace mongo {
 
         std::string logpath;   // Path to log file, if logging to a file; otherwise, empty.
         bool logAppend;        // True if logging to a file in append mode.
+        bool logBufferedWrites; // True if log file writes go through a background thread.
         bool logWithSyslog;    // True if logging to syslog; must not be set if logpath is set.
         int syslogFacility;    // Facility used when appending messages to the syslog.
 
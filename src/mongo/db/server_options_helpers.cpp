@@ -198,6 +198,10 @@ namespace {
         options->addOptionChaining("systemLog.logAppend", "logappend", moe::Switch,
                 "append to logpath instead of over-writing");
 
+        options->addOptionChaining("systemLog.bufferedWrites", "logBufferedWrites", moe::Switch,
+                "buffer log messages per thread and write them to logpath from a background "
+                "thread; messages are dropped while a thread's buffer is full");
+
         options->addOptionChaining("systemLog.timeStampFormat", "timeStampFormat", moe::String,
                 "Desired format for timestamps in log messages. One of ctime, "
                 "iso8601-utc or iso8601-local");
@@ -814,6 +818,14 @@ namespace {
             serverGlobalParams.logAppend = true;
         }
 
+        if (params.count("systemLog.bufferedWrites") &&
+            params["systemLog.bufferedWrites"].as<bool>() == true) {
+            if (serverGlobalParams.logpath.empty()) {
+                return Status(ErrorCodes::BadValue, "logBufferedWrites requires a logpath");
+            }
+            serverGlobalParams.logBufferedWrites = true;
+        }
+
         if (!serverGlobalParams.logpath.empty() && serverGlobalParams.logWithSyslog) {
             return Status(ErrorCodes::BadValue, "Cant use both a logpath and syslog ");
         }
@@ -397,6 +397,7 @@ namespace mongo {
                 , _settings(settings)
                 , _opts(opts)
                 , _memUsed(0)
+                , _spilledBytes(0)
             { verify(_opts.limit == 0); }
 
             void add(const Key& key, const Value& val) {
@@ -422,6 +423,7 @@ namespace mongo {
             // TEMP these are here for compatibility. Will be replaced with a general stats API
             int numFiles() const { return _iters.size(); }
             size_t memUsed() const { return _memUsed; }
+            unsigned long long spilledBytes() const { return _spilledBytes; }
 
         private:
             class STLComparator {
@@ -469,6 +471,7 @@ namespace mongo {
 
                 _iters.push_back(boost::shared_ptr<Iterator>(writer.done()));
 
+                _spilledBytes += _memUsed;
                 _memUsed = 0;
             }
 
@@ -476,6 +479,7 @@ namespace mongo {
             const Settings _settings;
             SortOptions _opts;
             size_t _memUsed;
+            unsigned long long _spilledBytes;
             std::deque<Data> _data; // the "current" data
             std::vector<boost::shared_ptr<Iterator> > _iters; // data that has already been spilled
         };
@@ -519,6 +523,7 @@ namespace mongo {
             int numFiles() const { return 0; }
             size_t memUsed() const { return _best.first.memUsageForSorter()
                                           + _best.second.memUsageForSorter(); }
+            unsigned long long spilledBytes() const { return 0; }
 
         private:
             const Comparator _comp;
@@ -542,6 +547,7 @@ namespace mongo {
                 , _settings(settings)
                 , _opts(opts)
                 , _memUsed(0)
+                , _spilledBytes(0)
                 , _haveCutoff(false)
                 , _worstCount(0)
                 , _medianCount(0)
@@ -613,6 +619,7 @@ namespace mongo {
             // TEMP these are here for compatibility. Will be replaced with a general stats API
             int numFiles() const { return _iters.size(); }
             size_t memUsed() const { return _memUsed; }
+            unsigned long long spilledBytes() const { return _spilledBytes; }
 
         private:
             class STLComparator {
@@ -744,6 +751,7 @@ namespace mongo {
 
                 _iters.push_back(boost::shared_ptr<Iterator>(writer.done()));
 
+                _spilledBytes += _memUsed;
                 _memUsed = 0;
             }
 
@@ -751,6 +759,7 @@ namespace mongo {
             const Settings _settings;
             SortOptions _opts;
             size_t _memUsed;
+            unsigned long long _spilledBytes;
             std::vector<Data> _data; // the "current" data. Organized as max-heap if size == limit.
             std::vector<boost::shared_ptr<Iterator> > _iters; // data that has already been spilled
 
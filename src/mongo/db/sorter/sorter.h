@@ -176,6 +176,7 @@ namespace mongo {
         // TEMP these are here for compatibility. Will be replaced with a general stats API
         virtual int numFiles() const =0;
         virtual size_t memUsed() const =0;
+        virtual unsigned long long spilledBytes() const =0; /// memUsed() of all spilled data
 
     protected:
         Sorter() {} // can only be constructed as a base
@@ -38,7 +38,6 @@ namespace mongo {
     OpCounters::OpCounters() {}
 
     void OpCounters::gotOp( int op , bool isCommand ) {
-        RARELY _checkWrap();
         switch ( op ) {
         case dbInsert: /*gotInsert();*/ break; // need to handle multi-insert
         case dbQuery:
@@ -59,35 +58,14 @@ namespace mongo {
         }
     }
 
-    void OpCounters::_checkWrap() {
-        const unsigned MAX = 1 << 30;
-        
-        bool wrap =
-            _insert.get() > MAX ||
-            _query.get() > MAX ||
-            _update.get() > MAX ||
-            _delete.get() > MAX ||
-            _getmore.get() > MAX ||
-            _command.get() > MAX;
-        
-        if ( wrap ) {
-            _insert.zero();
-            _query.zero();
-            _update.zero();
-            _delete.zero();
-            _getmore.zero();
-            _command.zero();
-        }
-    }
-
     BSONObj OpCounters::getObj() const {
         BSONObjBuilder b;
-        b.append( "insert" , _insert.get() );
-        b.append( "query" , _query.get() );
-        b.append( "update" , _update.get() );
-        b.append( "delete" , _delete.get() );
-        b.append( "getmore" , _getmore.get() );
-        b.append( "command" , _command.get() );
+        b.appendNumber( "insert" , _insert.get() );
+        b.appendNumber( "query" , _query.get() );
+        b.appendNumber( "update" , _update.get() );
+        b.appendNumber( "delete" , _delete.get() );
+        b.appendNumber( "getmore" , _getmore.get() );
+        b.appendNumber( "command" , _command.get() );
         return b.obj();
     }
 
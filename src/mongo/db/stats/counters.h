@@ -30,55 +30,54 @@
 #pragma once
 
 #include "mongo/pch.h"
-#include "mongo/bson/util/atomic_int.h"
+#include "mongo/base/disallow_copying.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/util/net/message.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/concurrency/spin_lock.h"
+#include "mongo/util/concurrency/striped_counter.h"
 #include "mongo/db/pdfile.h"
 
 namespace mongo {
 
     /**
      * for storing operation counters
-     * note: not thread safe.  ok with that for speed
+     * each counter is striped across cache lines, so counting an op doesn't contend with other
+     * cores; getObj() sums the stripes.
      */
     class OpCounters {
+        MONGO_DISALLOW_COPYING(OpCounters);
     public:
 
         OpCounters();
-        void incInsertInWriteLock(int n) { _insert.x += n; }
-        void gotInsert() { _insert++; }
-        void gotQuery() { _query++; }
-        void gotUpdate() { _update++; }
-        void gotDelete() { _delete++; }
-        void gotGetMore() { _getmore++; }
-        void gotCommand() { _command++; }
+        void incInsertInWriteLock(int n) { _insert.add(n); }
+        void gotInsert() { _insert.increment(); }
+        void gotQuery() { _query.increment(); }
+        void gotUpdate() { _update.increment(); }
+        void gotDelete() { _delete.increment(); }
+        void gotGetMore() { _getmore.increment(); }
+        void gotCommand() { _command.increment(); }
 
         void gotOp( int op , bool isCommand );
 
         BSONObj getObj() const;
         
         // thse are used by snmp, and other things, do not remove
-        const AtomicUInt * getInsert() const { return &_insert; }
-        const AtomicUInt * getQuery() const { return &_query; }
-        const AtomicUInt * getUpdate() const { return &_update; }
-        const AtomicUInt * getDelete() const { return &_delete; }
-        const AtomicUInt * getGetMore() const { return &_getmore; }
-        const AtomicUInt * getCommand() const { return &_command; }
+        const StripedCounter * getInsert() const { return &_insert; }
+        const StripedCounter * getQuery() const { return &_query; }
+        const StripedCounter * getUpdate() const { return &_update; }
+        const StripedCounter * getDelete() const { return &_delete; }
+        const StripedCounter * getGetMore() const { return &_getmore; }
+        const StripedCounter * getCommand() const { return &_command; }
 
 
     private:
-        void _checkWrap();
-        
-        // todo: there will be a lot of cache line contention on these.  need to do something 
-        //       else eventually.
-        AtomicUInt _insert;
-        AtomicUInt _query;
-        AtomicUInt _update;
-        AtomicUInt _delete;
-        AtomicUInt _getmore;
-        AtomicUInt _command;
+        StripedCounter _insert;
+        StripedCounter _query;
+        StripedCounter _update;
+        StripedCounter _delete;
+        StripedCounter _getmore;
+        StripedCounter _command;
     };
 
     extern OpCounters globalOpCounters;
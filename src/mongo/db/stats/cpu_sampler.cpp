@@ -0,0 +1,444 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/pch.h"
+
+#include "mongo/db/stats/cpu_sampler.h"
+
+#include <algorithm>
+#include <boost/scoped_array.hpp>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <signal.h>
+#include <sys/time.h>
+#endif
+
+#include "mongo/db/jsobj.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/concurrency/threadlocal.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/stacktrace.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+namespace {
+
+    /// Deepest stack recorded for a sample.
+    const int kMaxFrames = 32;
+
+    /// Frames at the top of every sampled stack that belong to the sampler itself:
+    /// getStackAddresses(), the signal handler, and the signal return trampoline.
+    const int kHandlerFrames = 3;
+
+    /// Largest "collapsed" report returned; the least frequent stacks are left out past this.
+    const size_t kMaxCollapsedBytes = 8 * 1024 * 1024;
+
+    struct Sample {
+        void* frames[kMaxFrames];
+        int depth;
+        int label;
+        AtomicUInt32 complete;
+    };
+
+    /// Label of samples taken on threads that are not running an operation.
+    const int kNoOperationLabel = 0;
+
+    struct ThreadLabel {
+        ThreadLabel() : id(kNoOperationLabel) {}
+        int id;
+    };
+
+    //
+    // State shared with the signal handler.  sampleBuffer and sampleCapacity only change while
+    // "sampling" is false and no handler is running.
+    //
+
+    Sample* sampleBuffer = NULL;
+    unsigned sampleCapacity = 0;
+    AtomicUInt32 sampling;
+    AtomicUInt32 nextSample;
+    AtomicUInt32 droppedSamples;
+    AtomicUInt32 handlersRunning;
+
+    /// Guards "profileRunning" and "externalProfilerRunning", so that one profile is taken at a
+    /// time, by either this sampler or another profiler using SIGPROF.
+    SimpleMutex profileMutex("CpuSampler");
+    bool profileRunning = false;
+    bool externalProfilerRunning = false;
+
+    /// Interned operation labels, indexed by label id.
+    SimpleMutex labelsMutex("CpuSamplerLabels");
+    std::vector<std::string> labelNames(1, "(no operation)");
+    std::map<std::string, int> labelIds;
+
+    int internLabel(const std::string& label) {
+        SimpleMutex::scoped_lock lk(labelsMutex);
+        std::map<std::string, int>::const_iterator it = labelIds.find(label);
+        if (it != labelIds.end()) {
+            return it->second;
+        }
+        const int id = labelNames.size();
+        labelNames.push_back(label);
+        labelIds[label] = id;
+        return id;
+    }
+
+    std::string labelName(int id) {
+        SimpleMutex::scoped_lock lk(labelsMutex);
+        return labelNames[id];
+    }
+
+}  // namespace
+
+    TSP_DECLARE(ThreadLabel, cpuSamplerThreadLabel);
+    TSP_DEFINE(ThreadLabel, cpuSamplerThreadLabel);
+
+namespace {
+
+#if !defined(_WIN32)
+    /**
+     * SIGPROF handler.  Records the interrupted thread's stack into the next free sample.
+     */
+    void recordSample(int) {
+        const int savedErrno = errno;
+        handlersRunning.addAndFetch(1);
+        if (sampling.load()) {
+            const unsigned index = nextSample.fetchAndAdd(1);
+            if (index < sampleCapacity) {
+                Sample& sample = sampleBuffer[index];
+                sample.depth = getStackAddresses(sample.frames, kMaxFrames);
+                sample.label = kNoOperationLabel;
+#if defined(MONGO_HAVE___THREAD)
+                // Only a plain thread local read is safe here.
+                ThreadLabel* label = cpuSamplerThreadLabel.get();
+                if (label) {
+                    sample.label = label->id;
+                }
+#endif
+                sample.complete.store(1);
+            }
+            else {
+                droppedSamples.addAndFetch(1);
+            }
+        }
+        handlersRunning.subtractAndFetch(1);
+        errno = savedErrno;
+    }
+
+    Status setProfileTimer(const struct itimerval& timer) {
+        if (setitimer(ITIMER_PROF, &timer, NULL) != 0) {
+            return Status(ErrorCodes::InternalError,
+                          mongoutils::str::stream() << "setitimer failed: "
+                                                    << errnoWithDescription());
+        }
+        return Status::OK();
+    }
+
+    Status setProfileTimer(int frequency) {
+        struct itimerval timer;
+        timer.it_interval.tv_sec = 0;
+        timer.it_interval.tv_usec = frequency ? 1000000 / frequency : 0;
+        timer.it_value = timer.it_interval;
+        return setProfileTimer(timer);
+    }
+
+    /**
+     * Fails if ITIMER_PROF is already armed, which means another profiler owns SIGPROF.
+     */
+    Status checkProfileTimerUnused(struct itimerval* previous) {
+        if (getitimer(ITIMER_PROF, previous) != 0) {
+            return Status(ErrorCodes::InternalError,
+                          mongoutils::str::stream() << "getitimer failed: "
+                                                    << errnoWithDescription());
+        }
+        if (previous->it_value.tv_sec || previous->it_value.tv_usec) {
+            return Status(ErrorCodes::IllegalOperation,
+                          "ITIMER_PROF is in use by another CPU profiler");
+        }
+        return Status::OK();
+    }
+
+    Status installHandler(struct sigaction* previous) {
+        // The unwinder may allocate the first time it runs, which must not happen in a handler.
+        void* frames[kMaxFrames];
+        getStackAddresses(frames, kMaxFrames);
+
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = &recordSample;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        if (sigaction(SIGPROF, &action, previous) != 0) {
+            return Status(ErrorCodes::InternalError,
+                          mongoutils::str::stream() << "sigaction failed: "
+                                                    << errnoWithDescription());
+        }
+        return Status::OK();
+    }
+
+    /**
+     * Puts back the SIGPROF action replaced by installHandler().  Must be called with the timer
+     * stopped.
+     */
+    void restoreHandler(const struct sigaction& previous) {
+        // A SIGPROF generated just before the timer stopped may still be pending, and if the
+        // previous action is the default one it would kill the process.  Ignoring the signal
+        // discards anything pending first.
+        if (previous.sa_handler == SIG_DFL && !(previous.sa_flags & SA_SIGINFO)) {
+            struct sigaction ignore;
+            memset(&ignore, 0, sizeof(ignore));
+            ignore.sa_handler = SIG_IGN;
+            sigemptyset(&ignore.sa_mask);
+            sigaction(SIGPROF, &ignore, NULL);
+        }
+        sigaction(SIGPROF, &previous, NULL);
+    }
+#endif
+
+    /**
+     * Makes "name" safe to use as a frame in the collapsed format.
+     */
+    std::string collapsedFrameName(std::string name) {
+        std::replace(name.begin(), name.end(), ';', ':');
+        std::replace(name.begin(), name.end(), '\n', ' ');
+        return name;
+    }
+
+    struct MoreSamples {
+        bool operator()(const std::pair<unsigned, const std::string*>& a,
+                        const std::pair<unsigned, const std::string*>& b) const {
+            return a.first > b.first;
+        }
+    };
+
+    typedef std::pair<int, std::vector<void*> > LabeledStack;
+
+    /**
+     * Counts identical stacks among the recorded samples and appends the report to "result".
+     */
+    void appendReport(unsigned recorded, BSONObjBuilder* result) {
+        std::map<LabeledStack, unsigned> stackCounts;
+        std::map<int, unsigned> labelCounts;
+        long long samples = 0;
+        for (unsigned i = 0; i < recorded; ++i) {
+            const Sample& sample = sampleBuffer[i];
+            if (!sample.complete.load() || sample.depth <= kHandlerFrames) {
+                continue;
+            }
+            LabeledStack stack;
+            stack.first = sample.label;
+            // Outermost frame first.
+            stack.second.assign(std::reverse_iterator<void* const*>(sample.frames + sample.depth),
+                                std::reverse_iterator<void* const*>(sample.frames +
+                                                                    kHandlerFrames));
+            ++stackCounts[stack];
+            ++labelCounts[sample.label];
+            ++samples;
+        }
+
+        result->append("samples", samples);
+        result->append("dropped", static_cast<long long>(droppedSamples.load()));
+
+        {
+            std::vector<std::pair<unsigned, int> > sorted;
+            for (std::map<int, unsigned>::const_iterator it = labelCounts.begin();
+                 it != labelCounts.end(); ++it) {
+                sorted.push_back(std::make_pair(it->second, it->first));
+            }
+            std::sort(sorted.rbegin(), sorted.rend());
+            BSONArrayBuilder operations(result->subarrayStart("operations"));
+            for (size_t i = 0; i < sorted.size(); ++i) {
+                operations.append(BSON("op" << labelName(sorted[i].second) <<
+                                       "samples" << static_cast<int>(sorted[i].first)));
+            }
+        }
+
+        // Stacks sampled at different addresses within the same functions print the same, so
+        // they are counted together by name.
+        std::map<void*, std::string> frameNames;
+        std::map<std::string, unsigned> namedCounts;
+        for (std::map<LabeledStack, unsigned>::const_iterator it = stackCounts.begin();
+             it != stackCounts.end(); ++it) {
+            std::string line = collapsedFrameName(labelName(it->first.first));
+            const std::vector<void*>& frames = it->first.second;
+            for (size_t f = 0; f < frames.size(); ++f) {
+                std::string& name = frameNames[frames[f]];
+                if (name.empty()) {
+                    std::ostringstream os;
+                    printFrameName(frames[f], os);
+                    name = collapsedFrameName(os.str());
+                }
+                line += ';';
+                line += name;
+            }
+            namedCounts[line] += it->second;
+        }
+
+        std::vector<std::pair<unsigned, const std::string*> > sorted;
+        for (std::map<std::string, unsigned>::const_iterator it = namedCounts.begin();
+             it != namedCounts.end(); ++it) {
+            sorted.push_back(std::make_pair(it->second, &it->first));
+        }
+        std::stable_sort(sorted.begin(), sorted.end(), MoreSamples());
+
+        std::ostringstream collapsed;
+        bool truncated = false;
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            std::ostringstream line;
+            line << *sorted[i].second << ' ' << sorted[i].first << '\n';
+            const std::string text = line.str();
+            if (static_cast<size_t>(collapsed.tellp()) + text.size() > kMaxCollapsedBytes) {
+                truncated = true;
+                break;
+            }
+            collapsed << text;
+        }
+        result->append("collapsed", collapsed.str());
+        result->append("truncated", truncated);
+    }
+
+}  // namespace
+
+    CpuSampler::OperationScope::OperationScope() : _previousLabel(-1) {}
+
+    CpuSampler::OperationScope::~OperationScope() {
+        if (_previousLabel >= 0) {
+            cpuSamplerThreadLabel.getMake()->id = _previousLabel;
+        }
+    }
+
+    void CpuSampler::OperationScope::setLabel(const std::string& label) {
+        ThreadLabel* threadLabel = cpuSamplerThreadLabel.getMake();
+        if (_previousLabel < 0) {
+            _previousLabel = threadLabel->id;
+        }
+        threadLabel->id = internLabel(label);
+    }
+
+    bool CpuSampler::isSampling() {
+        return sampling.loadRelaxed();
+    }
+
+    Status CpuSampler::profile(int frequency, int seconds, int maxSamples,
+                               BSONObjBuilder* result) {
+#if defined(_WIN32)
+        return Status(ErrorCodes::IllegalOperation, "CPU sampling is not supported on Windows");
+#else
+        if (frequency < 1 || frequency > 1000) {
+            return Status(ErrorCodes::BadValue, "frequency must be between 1 and 1000");
+        }
+        if (seconds < 1 || seconds > 600) {
+            return Status(ErrorCodes::BadValue, "seconds must be between 1 and 600");
+        }
+        if (maxSamples < 1 || maxSamples > 1000000) {
+            return Status(ErrorCodes::BadValue, "maxSamples must be between 1 and 1000000");
+        }
+
+        struct itimerval previousTimer;
+        struct sigaction previousAction;
+        {
+            SimpleMutex::scoped_lock lk(profileMutex);
+            if (profileRunning) {
+                return Status(ErrorCodes::IllegalOperation,
+                              "a CPU profile is already being taken");
+            }
+            if (externalProfilerRunning) {
+                return Status(ErrorCodes::IllegalOperation,
+                              "the gperftools CPU profiler is running; stop it with "
+                              "_cpuProfilerStop first");
+            }
+            Status status = checkProfileTimerUnused(&previousTimer);
+            if (!status.isOK()) {
+                return status;
+            }
+            status = installHandler(&previousAction);
+            if (!status.isOK()) {
+                return status;
+            }
+            profileRunning = true;
+        }
+
+        boost::scoped_array<Sample> buffer(new Sample[maxSamples]);
+        sampleBuffer = buffer.get();
+        sampleCapacity = maxSamples;
+        nextSample.store(0);
+        droppedSamples.store(0);
+        sampling.store(1);
+
+        Status status = setProfileTimer(frequency);
+        if (status.isOK()) {
+            for (long long deadline = curTimeMillis64() + seconds * 1000LL;
+                 curTimeMillis64() < deadline && !inShutdown(); ) {
+                sleepmillis(100);
+            }
+            setProfileTimer(0);
+        }
+
+        // Once no handler is left running, nothing else touches the samples.
+        sampling.store(0);
+        while (handlersRunning.load()) {
+            sleepmillis(1);
+        }
+
+        if (status.isOK()) {
+            result->append("frequency", frequency);
+            result->append("seconds", seconds);
+            appendReport(std::min(nextSample.load(), sampleCapacity), result);
+        }
+
+        sampleBuffer = NULL;
+        sampleCapacity = 0;
+        SimpleMutex::scoped_lock lk(profileMutex);
+        restoreHandler(previousAction);
+        setProfileTimer(previousTimer);
+        profileRunning = false;
+        return status;
+#endif
+    }
+
+    Status CpuSampler::claimExternalProfiler() {
+        SimpleMutex::scoped_lock lk(profileMutex);
+        if (profileRunning) {
+            return Status(ErrorCodes::IllegalOperation,
+                          "a profileCPU profile is being taken; wait for it to finish");
+        }
+        externalProfilerRunning = true;
+        return Status::OK();
+    }
+
+    void CpuSampler::releaseExternalProfiler() {
+        SimpleMutex::scoped_lock lk(profileMutex);
+        externalProfilerRunning = false;
+    }
+
+}  // namespace mongo
@@ -0,0 +1,104 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+
+namespace mongo {
+
+    class BSONObjBuilder;
+
+    /**
+     * Statistical CPU profiler built into the server.
+     *
+     * While a profile is being taken, an ITIMER_PROF timer delivers SIGPROF to whichever thread
+     * is using CPU, and the signal handler records that thread's stack along with the label of
+     * the operation it is running.  Recording takes no locks and allocates nothing; samples go
+     * into a buffer sized when the profile starts, and samples that don't fit are counted and
+     * dropped.  When the profile ends, identical stacks are counted together and reported in
+     * the "collapsed" format consumed by flame graph tools: one line per distinct stack, frames
+     * from outermost to innermost separated by ';', followed by the number of samples.
+     *
+     * The SIGPROF handler and ITIMER_PROF timer are only taken over while a profile is being
+     * taken, and whatever was there before is restored afterwards.  Since gperftools' profiler
+     * uses the same signal and timer, the two cannot run at once: a profile is refused while
+     * ITIMER_PROF is armed or while another profiler holds claimExternalProfiler().
+     *
+     * Only one profile may be taken at a time.  Only supported on POSIX systems.
+     */
+    class CpuSampler {
+        MONGO_DISALLOW_COPYING(CpuSampler);
+    public:
+        /**
+         * Labels the CPU samples taken on the constructing thread while the scope is live.
+         * Scopes nest; the label of the enclosing scope is restored on destruction.
+         */
+        class OperationScope {
+            MONGO_DISALLOW_COPYING(OperationScope);
+        public:
+            OperationScope();
+            ~OperationScope();
+
+            /**
+             * Sets the label, e.g. "query test.foo".  Only worth calling while isSampling().
+             */
+            void setLabel(const std::string& label);
+
+        private:
+            int _previousLabel;
+        };
+
+        /**
+         * Samples every thread's CPU use "frequency" times per second for "seconds" seconds,
+         * keeping at most "maxSamples" samples, and appends the result to "result".  Blocks the
+         * calling thread for the length of the profile.
+         */
+        static Status profile(int frequency, int seconds, int maxSamples, BSONObjBuilder* result);
+
+        /**
+         * Returns true if a profile is being taken.  Cheap enough to call on every operation.
+         */
+        static bool isSampling();
+
+        /**
+         * Marks SIGPROF and ITIMER_PROF as in use by another profiler, e.g. gperftools', until
+         * releaseExternalProfiler() is called.  Fails if a profile is being taken.
+         */
+        static Status claimExternalProfiler();
+
+        static void releaseExternalProfiler();
+
+    private:
+        CpuSampler();
+    };
+
+}  // namespace mongo
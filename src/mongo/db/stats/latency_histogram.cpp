@@ -0,0 +1,150 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/util/concurrency/striped_counter.h"
+
+namespace mongo {
+
+    const int LatencyHistogram::kNumBuckets;
+    const int LatencyHistogram::kNumThreadShards;
+
+    LatencyHistogram::LatencyHistogram(Sharding sharding)
+        : _numShards(sharding == kPerThreadShards ? kNumThreadShards : 1),
+          _shards(new Shard[_numShards]) {
+    }
+
+    int LatencyHistogram::bucketFor(long long micros) {
+        int bucket = 0;
+        while (micros > 0 && bucket < kNumBuckets - 1) {
+            micros >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+
+    void LatencyHistogram::record(long long micros) {
+        if (micros < 0) {
+            micros = 0;
+        }
+        Shard& shard = _numShards == 1 ?
+            _shards[0] : _shards[StripedCounter::threadStripe() % _numShards];
+        shard.buckets[bucketFor(micros)].fetchAndAdd(1);
+        shard.totalMicros.fetchAndAdd(micros);
+        shard.count.fetchAndAdd(1);
+    }
+
+    long long LatencyHistogram::getCount() const {
+        long long total = 0;
+        for (int i = 0; i < _numShards; ++i) {
+            total += _shards[i].count.loadRelaxed();
+        }
+        return total;
+    }
+
+    long long LatencyHistogram::getTotalMicros() const {
+        long long total = 0;
+        for (int i = 0; i < _numShards; ++i) {
+            total += _shards[i].totalMicros.loadRelaxed();
+        }
+        return total;
+    }
+
+    long long LatencyHistogram::getBucketCount(int bucket) const {
+        long long total = 0;
+        for (int i = 0; i < _numShards; ++i) {
+            total += _shards[i].buckets[bucket].loadRelaxed();
+        }
+        return total;
+    }
+
+    int LatencyHistogram::getPercentileBucket(double fraction) const {
+        long long counts[kNumBuckets];
+        long long total = 0;
+        for (int i = 0; i < kNumBuckets; ++i) {
+            counts[i] = getBucketCount(i);
+            total += counts[i];
+        }
+        if (!total) {
+            return -1;
+        }
+
+        // The rank of the sample we want, counting from 1.
+        const long long rank = std::max(1LL, static_cast<long long>(ceil(fraction * total)));
+        long long seen = 0;
+        for (int i = 0; i < kNumBuckets; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return i;
+            }
+        }
+        return kNumBuckets - 1;
+    }
+
+    BSONObj LatencyHistogram::getReport() const {
+        BSONObjBuilder b;
+        b.appendNumber("count", getCount());
+        b.appendNumber("totalMicros", getTotalMicros());
+
+        static const struct {
+            const char* name;
+            double fraction;
+        } kPercentiles[] = { { "p50", 0.5 }, { "p99", 0.99 }, { "p999", 0.999 } };
+        BSONObjBuilder percentiles(b.subobjStart("percentiles"));
+        for (size_t i = 0; i < sizeof(kPercentiles) / sizeof(kPercentiles[0]); ++i) {
+            const int bucket = getPercentileBucket(kPercentiles[i].fraction);
+            if (bucket >= 0 && bucket < kNumBuckets - 1) {
+                percentiles.appendNumber(kPercentiles[i].name, 1LL << bucket);
+            }
+        }
+        percentiles.doneFast();
+
+        BSONArrayBuilder buckets(b.subarrayStart("buckets"));
+        for (int i = 0; i < kNumBuckets; ++i) {
+            const long long count = getBucketCount(i);
+            if (!count) {
+                continue;
+            }
+            BSONObjBuilder bucket(buckets.subobjStart());
+            if (i < kNumBuckets - 1) {
+                bucket.appendNumber("lessThanMicros", 1LL << i);
+            }
+            bucket.appendNumber("count", count);
+            bucket.doneFast();
+        }
+        buckets.doneFast();
+        return b.obj();
+    }
+
+}  // namespace mongo
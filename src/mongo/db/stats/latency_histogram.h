@@ -0,0 +1,115 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/scoped_array.hpp>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+    /**
+     * Counts latencies in power of two buckets of microseconds.  Recording is a few atomic
+     * increments, so one histogram may be shared by any number of threads.  A histogram that
+     * every thread records into on a hot path, such as lock acquisition, should be built with
+     * kPerThreadShards: each thread then increments counters on cache lines of its own, picked
+     * by StripedCounter::threadStripe(), and reads sum the shards.
+     *
+     * Reported as
+     *     { count: <n>, totalMicros: <sum>,
+     *       percentiles: { p50: <bound>, p99: <bound>, p999: <bound> },
+     *       buckets: [ { lessThanMicros: <bound>, count: <n> }, ... ] }
+     * where only the non empty buckets are listed, in increasing order.  The last bucket counts
+     * everything too large for the others and has no "lessThanMicros".  Each percentile is the
+     * "lessThanMicros" of the bucket it falls in, and is left out if that is the last bucket.
+     */
+    class LatencyHistogram {
+        MONGO_DISALLOW_COPYING(LatencyHistogram);
+    public:
+        /// Bucket i < kNumBuckets - 1 counts latencies in [2^(i-1), 2^i) microseconds.
+        static const int kNumBuckets = 32;
+
+        enum Sharding {
+            kSingleShard,
+            kPerThreadShards
+        };
+
+        /// Shards used by a kPerThreadShards histogram.
+        static const int kNumThreadShards = 16;
+
+        explicit LatencyHistogram(Sharding sharding = kSingleShard);
+
+        void record(long long micros);
+
+        /**
+         * Returns the index of the bucket "micros" is counted in.
+         */
+        static int bucketFor(long long micros);
+
+        long long getCount() const;
+        long long getTotalMicros() const;
+        long long getBucketCount(int bucket) const;
+
+        /**
+         * Returns the index of the bucket holding the latency that "fraction" of the recorded
+         * latencies are at or below, or -1 if nothing was recorded.
+         */
+        int getPercentileBucket(double fraction) const;
+
+        BSONObj getReport() const;
+        operator BSONObj() const { return getReport(); }
+
+    private:
+        struct Counters {
+            AtomicInt64 count;
+            AtomicInt64 totalMicros;
+            AtomicInt64 buckets[kNumBuckets];
+        };
+
+        // Padded so that no two shards share a cache line.
+        struct Shard : Counters {
+            char pad[64 - sizeof(Counters) % 64];
+        };
+
+        const int _numShards;
+        boost::scoped_array<Shard> _shards;
+    };
+
+    /**
+     * A kPerThreadShards LatencyHistogram that can be default constructed, as array elements
+     * must be.
+     */
+    class ThreadShardedLatencyHistogram : public LatencyHistogram {
+    public:
+        ThreadShardedLatencyHistogram() : LatencyHistogram(kPerThreadShards) {}
+    };
+
+}  // namespace mongo
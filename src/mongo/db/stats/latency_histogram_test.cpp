@@ -0,0 +1,146 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <boost/thread/thread.hpp>
+#include <vector>
+
+#include "mongo/db/stats/latency_histogram.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+    using mongo::BSONObj;
+    using mongo::LatencyHistogram;
+    using mongo::ThreadShardedLatencyHistogram;
+
+    void recordMany(LatencyHistogram* histogram, long long micros, int n) {
+        for (int i = 0; i < n; ++i) {
+            histogram->record(micros);
+        }
+    }
+
+    TEST(LatencyHistogram, BucketBoundaries) {
+        ASSERT_EQUALS(0, LatencyHistogram::bucketFor(0));
+        ASSERT_EQUALS(1, LatencyHistogram::bucketFor(1));
+        ASSERT_EQUALS(2, LatencyHistogram::bucketFor(2));
+        ASSERT_EQUALS(2, LatencyHistogram::bucketFor(3));
+        ASSERT_EQUALS(3, LatencyHistogram::bucketFor(4));
+        ASSERT_EQUALS(10, LatencyHistogram::bucketFor(1023));
+        ASSERT_EQUALS(11, LatencyHistogram::bucketFor(1024));
+        ASSERT_EQUALS(LatencyHistogram::kNumBuckets - 1,
+                      LatencyHistogram::bucketFor(1LL << 40));
+    }
+
+    TEST(LatencyHistogram, RecordCountsEachBucket) {
+        LatencyHistogram histogram;
+        histogram.record(3);
+        histogram.record(2);
+        histogram.record(1000);
+        histogram.record(-5);
+
+        ASSERT_EQUALS(4, histogram.getCount());
+        ASSERT_EQUALS(1, histogram.getBucketCount(0));
+        ASSERT_EQUALS(2, histogram.getBucketCount(2));
+        ASSERT_EQUALS(1, histogram.getBucketCount(10));
+    }
+
+    TEST(LatencyHistogram, ReportListsNonEmptyBuckets) {
+        LatencyHistogram histogram;
+        histogram.record(3);
+        histogram.record(1000);
+        histogram.record(1LL << 40);
+
+        BSONObj report = histogram.getReport();
+        ASSERT_EQUALS(3, report["count"].numberLong());
+        ASSERT_EQUALS(1003 + (1LL << 40), report["totalMicros"].numberLong());
+
+        BSONObj percentiles = report["percentiles"].Obj();
+        ASSERT_EQUALS(1024, percentiles["p50"].numberLong());
+        ASSERT_TRUE(percentiles["p99"].eoo());
+
+        std::vector<mongo::BSONElement> buckets = report["buckets"].Array();
+        ASSERT_EQUALS(3U, buckets.size());
+        ASSERT_EQUALS(4, buckets[0]["lessThanMicros"].numberLong());
+        ASSERT_EQUALS(1, buckets[0]["count"].numberLong());
+        ASSERT_EQUALS(1024, buckets[1]["lessThanMicros"].numberLong());
+        ASSERT_TRUE(buckets[2]["lessThanMicros"].eoo());
+        ASSERT_EQUALS(1, buckets[2]["count"].numberLong());
+    }
+
+    TEST(LatencyHistogram, PercentileBuckets) {
+        LatencyHistogram histogram;
+        ASSERT_EQUALS(-1, histogram.getPercentileBucket(0.5));
+
+        for (int i = 0; i < 990; ++i) {
+            histogram.record(3);
+        }
+        for (int i = 0; i < 9; ++i) {
+            histogram.record(100);
+        }
+        histogram.record(5000);
+
+        ASSERT_EQUALS(2, histogram.getPercentileBucket(0.5));
+        ASSERT_EQUALS(2, histogram.getPercentileBucket(0.99));
+        ASSERT_EQUALS(7, histogram.getPercentileBucket(0.995));
+        ASSERT_EQUALS(7, histogram.getPercentileBucket(0.999));
+        ASSERT_EQUALS(13, histogram.getPercentileBucket(1.0));
+
+        BSONObj percentiles = histogram.getReport()["percentiles"].Obj();
+        ASSERT_EQUALS(4, percentiles["p50"].numberLong());
+        ASSERT_EQUALS(4, percentiles["p99"].numberLong());
+        ASSERT_EQUALS(128, percentiles["p999"].numberLong());
+    }
+
+    TEST(LatencyHistogram, ThreadShardsAreSummed) {
+        const int kThreads = 8;
+        const int kRecords = 10000;
+
+        ThreadShardedLatencyHistogram histogram;
+        std::vector<boost::thread*> threads;
+        for (int i = 0; i < kThreads; ++i) {
+            threads.push_back(new boost::thread(
+                mongo::stdx::bind(recordMany, &histogram, 1LL << i, kRecords)));
+        }
+        for (int i = 0; i < kThreads; ++i) {
+            threads[i]->join();
+            delete threads[i];
+        }
+
+        ASSERT_EQUALS(static_cast<long long>(kThreads) * kRecords, histogram.getCount());
+        ASSERT_EQUALS(static_cast<long long>(kRecords) * ((1LL << kThreads) - 1),
+                      histogram.getTotalMicros());
+        for (int i = 0; i < kThreads; ++i) {
+            ASSERT_EQUALS(kRecords, histogram.getBucketCount(i + 1));
+        }
+        ASSERT_EQUALS(kThreads, histogram.getPercentileBucket(1.0));
+    }
+
+}  // namespace
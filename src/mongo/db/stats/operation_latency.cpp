@@ -0,0 +1,173 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/operation_latency.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "mongo/util/net/message.h"
+
+namespace mongo {
+
+    const size_t OperationLatencyStats::kMaxNamespaces;
+
+    OperationLatencyStats globalLatencyStats;
+
+    OperationLatencyStats::OperationLatencyStats() : _namespacesLock("latencyStats") {}
+
+    OperationLatencyStats::~OperationLatencyStats() {
+        for (NamespaceMap::const_iterator it = _namespaces.begin();
+             it != _namespaces.end(); ++it) {
+            delete it->second;
+        }
+    }
+
+    OperationLatencyStats::OpType OperationLatencyStats::opTypeFor(int op, bool isCommand) {
+        switch (op) {
+        case dbQuery: return isCommand ? kCommand : kQuery;
+        case dbGetMore: return kGetMore;
+        case dbInsert: return kInsert;
+        case dbUpdate: return kUpdate;
+        case dbDelete: return kRemove;
+        default: return kNumOpTypes;
+        }
+    }
+
+    OperationLatencyStats::OpType OperationLatencyStats::opTypeForCommand(
+            const StringData& commandName) {
+        if (commandName == "insert") {
+            return kInsert;
+        }
+        if (commandName == "update") {
+            return kUpdate;
+        }
+        if (commandName == "delete") {
+            return kRemove;
+        }
+        return kCommand;
+    }
+
+    const char* OperationLatencyStats::opTypeName(OpType opType) {
+        switch (opType) {
+        case kQuery: return "query";
+        case kGetMore: return "getmore";
+        case kInsert: return "insert";
+        case kUpdate: return "update";
+        case kRemove: return "remove";
+        case kCommand: return "command";
+        case kNumOpTypes: break;
+        }
+        return "unknown";
+    }
+
+    void OperationLatencyStats::recordOperation(OpType opType,
+                                                const StringData& ns,
+                                                long long micros) {
+        if (opType == kNumOpTypes) {
+            return;
+        }
+        _ops[opType].record(micros);
+
+        if (ns.empty()) {
+            return;
+        }
+        OpHistograms* nsHistograms = _getNamespace(ns);
+        if (nsHistograms) {
+            nsHistograms->ops[opType].record(micros);
+        }
+    }
+
+    OperationLatencyStats::OpHistograms* OperationLatencyStats::_getNamespace(
+            const StringData& ns) {
+        {
+            SimpleRWLock::Shared lk(_namespacesLock);
+            NamespaceMap::const_iterator it = _namespaces.find(ns);
+            if (it != _namespaces.end()) {
+                return it->second;
+            }
+            if (_namespaces.size() >= kMaxNamespaces) {
+                return NULL;
+            }
+        }
+
+        SimpleRWLock::Exclusive lk(_namespacesLock);
+        NamespaceMap::const_iterator it = _namespaces.find(ns);
+        if (it != _namespaces.end()) {
+            return it->second;
+        }
+        if (_namespaces.size() >= kMaxNamespaces) {
+            return NULL;
+        }
+        OpHistograms* nsHistograms = new OpHistograms();
+        _namespaces[ns] = nsHistograms;
+        return nsHistograms;
+    }
+
+    template <typename Histogram>
+    void OperationLatencyStats::_appendOps(BSONObjBuilder* b, const Histogram* ops) {
+        for (int i = 0; i < kNumOpTypes; ++i) {
+            b->append(opTypeName(static_cast<OpType>(i)), ops[i].getReport());
+        }
+    }
+
+    BSONObj OperationLatencyStats::getReport(bool includeNamespaces) const {
+        BSONObjBuilder b;
+        {
+            BSONObjBuilder ops(b.subobjStart("ops"));
+            _appendOps(&ops, _ops);
+            ops.doneFast();
+        }
+        b.append("lockAcquire", _lockAcquire.getReport());
+        b.append("storageFetch", _storageFetch.getReport());
+
+        if (includeNamespaces) {
+            SimpleRWLock::Shared lk(_namespacesLock);
+
+            std::vector<std::string> names;
+            for (NamespaceMap::const_iterator it = _namespaces.begin();
+                 it != _namespaces.end(); ++it) {
+                names.push_back(it->first);
+            }
+            std::sort(names.begin(), names.end());
+
+            BSONObjBuilder namespaces(b.subobjStart("namespaces"));
+            for (size_t i = 0; i < names.size(); ++i) {
+                BSONObjBuilder ns(namespaces.subobjStart(names[i]));
+                _appendOps(&ns, _namespaces.find(names[i])->second->ops);
+                ns.doneFast();
+            }
+            namespaces.doneFast();
+        }
+        return b.obj();
+    }
+
+}  // namespace mongo
@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/stats/latency_histogram.h"
+#include "mongo/util/concurrency/rwlock.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+    /**
+     * Always on latency histograms of this server's operations, by type and optionally by
+     * namespace, and of two things operations commonly wait for: acquiring locks and fetching
+     * documents from the data files, where a page fault shows up as a slow fetch.
+     *
+     * Reported as
+     *     { ops: { query: <histogram>, getmore: ..., insert: ..., update: ..., remove: ...,
+     *              command: ... },
+     *       lockAcquire: <histogram>, storageFetch: <histogram> }
+     * with "namespaces: { <ns>: { <op type>: <histogram>, ... }, ... }" added on request.  Each
+     * histogram is a LatencyHistogram report.
+     */
+    class OperationLatencyStats {
+        MONGO_DISALLOW_COPYING(OperationLatencyStats);
+    public:
+        enum OpType {
+            kQuery,
+            kGetMore,
+            kInsert,
+            kUpdate,
+            kRemove,
+            kCommand,
+            kNumOpTypes
+        };
+
+        /// At most this many namespaces are tracked; operations on others count only by type.
+        static const size_t kMaxNamespaces = 1000;
+
+        OperationLatencyStats();
+        ~OperationLatencyStats();
+
+        /**
+         * Returns the type of the wire protocol operation "op", or kNumOpTypes if its latency
+         * isn't tracked.
+         */
+        static OpType opTypeFor(int op, bool isCommand);
+
+        /**
+         * Returns the type of the command "commandName".  The insert, update and delete write
+         * commands count as the writes they carry out.
+         */
+        static OpType opTypeForCommand(const StringData& commandName);
+
+        static const char* opTypeName(OpType opType);
+
+        /**
+         * Records an operation of "opType" that took "micros".  It is also counted under "ns"
+         * unless that is empty.  kNumOpTypes is ignored.
+         */
+        void recordOperation(OpType opType, const StringData& ns, long long micros);
+
+        void recordLockAcquire(long long micros) { _lockAcquire.record(micros); }
+        void recordStorageFetch(long long micros) { _storageFetch.record(micros); }
+
+        const LatencyHistogram& getOpHistogram(OpType opType) const { return _ops[opType]; }
+
+        BSONObj getReport(bool includeNamespaces) const;
+
+    private:
+        struct OpHistograms {
+            LatencyHistogram ops[kNumOpTypes];
+        };
+
+        typedef StringMap<OpHistograms*> NamespaceMap;
+
+        /**
+         * Returns the histograms of "ns", creating them if there's room, or NULL.
+         */
+        OpHistograms* _getNamespace(const StringData& ns);
+
+        template <typename Histogram>
+        static void _appendOps(BSONObjBuilder* b, const Histogram* ops);
+
+        // Every operation records into these, so each thread gets its own shard of them.
+        ThreadShardedLatencyHistogram _ops[kNumOpTypes];
+        ThreadShardedLatencyHistogram _lockAcquire;
+        ThreadShardedLatencyHistogram _storageFetch;
+
+        // Entries are never removed, so a histogram found under the shared lock stays valid.
+        mutable SimpleRWLock _namespacesLock;
+        NamespaceMap _namespaces;
+    };
+
+    extern OperationLatencyStats globalLatencyStats;
+
+}  // namespace mongo
@@ -36,11 +36,16 @@
 #include "mongo/db/auth/action_type.h"
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/privilege.h"
+#include "mongo/util/concurrency/striped_counter.h"
 #include "mongo/util/net/message.h"
 #include "mongo/db/commands.h"
 
 namespace mongo {
 
+    const int Top::kNumShards;
+
+    Top::Top() {}
+
     Top::UsageData::UsageData( const UsageData& older , const UsageData& newer ) {
         // this won't be 100% accurate on rollovers and drop(), but at least it won't be negative
         time  = (newer.time  >= older.time)  ? (newer.time  - older.time)  : newer.time;
@@ -60,21 +65,35 @@ namespace mongo {
 
     }
 
+    void Top::CollectionData::add( const CollectionData& other ) {
+        total.add( other.total );
+        readLock.add( other.readLock );
+        writeLock.add( other.writeLock );
+        queries.add( other.queries );
+        getmore.add( other.getmore );
+        insert.add( other.insert );
+        update.add( other.update );
+        remove.add( other.remove );
+        commands.add( other.commands );
+    }
+
     void Top::record( const StringData& ns , int op , int lockType , long long micros , bool command ) {
         if ( ns[0] == '?' )
             return;
 
         //cout << "record: " << ns << "\t" << op << "\t" << command << endl;
-        SimpleMutex::scoped_lock lk(_lock);
+        Shard& shard = _shards[StripedCounter::threadStripe() % kNumShards];
+        SimpleMutex::scoped_lock lk(shard.lock);
 
-        if ( ( command || op == dbQuery ) && ns == _lastDropped ) {
-            _lastDropped = "";
+        if ( ( command || op == dbQuery ) && !shard.lastDropped.empty() &&
+             ns == shard.lastDropped ) {
+            shard.lastDropped.clear();
             return;
         }
 
-        CollectionData& coll = _usage[ns];
+        CollectionData& coll = shard.usage[ns];
         _record( coll , op , lockType , micros , command );
-        _record( _global , op , lockType , micros , command );
+        _record( shard.global , op , lockType , micros , command );
     }
 
     void Top::_record( CollectionData& c , int op , int lockType , long long micros , bool command ) {
@@ -120,19 +139,41 @@ namespace mongo {
     }
 
     void Top::collectionDropped( const StringData& ns ) {
-        SimpleMutex::scoped_lock lk(_lock);
-        _usage.erase(ns);
-        _lastDropped = ns.toString();
+        for ( int i = 0; i < kNumShards; i++ ) {
+            SimpleMutex::scoped_lock lk(_shards[i].lock);
+            _shards[i].usage.erase(ns);
+        }
+
+        // The drop command is recorded later by this same thread, so only its shard skips it.
+        Shard& shard = _shards[StripedCounter::threadStripe() % kNumShards];
+        SimpleMutex::scoped_lock lk(shard.lock);
+        shard.lastDropped = ns.toString();
     }
 
     void Top::cloneMap(Top::UsageMap& out) const {
-        SimpleMutex::scoped_lock lk(_lock);
-        out = _usage;
+        out = UsageMap();
+        for ( int i = 0; i < kNumShards; i++ ) {
+            SimpleMutex::scoped_lock lk(_shards[i].lock);
+            const UsageMap& usage = _shards[i].usage;
+            for ( UsageMap::const_iterator it = usage.begin(); it != usage.end(); ++it ) {
+                out[it->first].add( it->second );
+            }
+        }
+    }
+
+    Top::CollectionData Top::getGlobalData() const {
+        CollectionData global;
+        for ( int i = 0; i < kNumShards; i++ ) {
+            SimpleMutex::scoped_lock lk(_shards[i].lock);
+            global.add( _shards[i].global );
+        }
+        return global;
     }
 
     void Top::append( BSONObjBuilder& b ) {
-        SimpleMutex::scoped_lock lk( _lock );
-        _appendToUsageMap( b , _usage );
+        UsageMap usage;
+        cloneMap( usage );
+        _appendToUsageMap( b , usage );
     }
 
     void Top::_appendToUsageMap( BSONObjBuilder& b , const UsageMap& map ) const {
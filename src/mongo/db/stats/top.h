@@ -30,7 +30,6 @@
 #pragma once
 
 #include <boost/date_time/posix_time/posix_time.hpp>
-
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/string_map.h"
 
@@ -38,11 +37,15 @@ namespace mongo {
 
     /**
      * tracks usage by collection
+     *
+     * Usage is recorded in one of kNumShards tables, picked by the recording thread, each with
+     * its own lock, so operations running on different cores rarely contend.  Readers merge the
+     * tables.
      */
     class Top {
 
     public:
-        Top() : _lock("Top") { }
+        Top();
 
         struct UsageData {
             UsageData() : time(0) , count(0) {}
@@ -54,6 +57,11 @@ namespace mongo {
                 count++;
                 time += micros;
             }
+
+            void add( const UsageData& other ) {
+                count += other.count;
+                time += other.time;
+            }
         };
 
         struct CollectionData {
@@ -63,6 +71,8 @@ namespace mongo {
             CollectionData() {}
             CollectionData( const CollectionData& older , const CollectionData& newer );
 
+            void add( const CollectionData& other );
+
             UsageData total;
 
             UsageData readLock;
@@ -82,21 +92,32 @@ namespace mongo {
         void record( const StringData& ns , int op , int lockType , long long micros , bool command );
         void append( BSONObjBuilder& b );
         void cloneMap(UsageMap& out) const;
-        CollectionData getGlobalData() const { return _global; }
+        CollectionData getGlobalData() const;
         void collectionDropped( const StringData& ns );
 
     public: // static stuff
         static Top global;
 
     private:
+        static const int kNumShards = 16;
+
+        struct Shard {
+            Shard() : lock("Top") {}
+            mutable SimpleMutex lock;
+            CollectionData global;
+            UsageMap usage;
+
+            // Set by collectionDropped() on the dropping thread's shard, so the drop's own
+            // command, recorded later by that thread, doesn't recreate the entry.  Cleared by
+            // the first matching record.
+            std::string lastDropped;
+        };
+
         void _appendToUsageMap( BSONObjBuilder& b , const UsageMap& map ) const;
         void _appendStatsEntry( BSONObjBuilder& b , const char * statsName , const UsageData& map ) const;
         void _record( CollectionData& c , int op , int lockType , long long micros , bool command );
 
-        mutable SimpleMutex _lock;
-        CollectionData _global;
-        UsageMap _usage;
-        std::string _lastDropped;
+        Shard _shards[kNumShards];
     };
 
 } // namespace mongo
@@ -39,6 +39,7 @@
 #include "mongo/db/commands/fsync.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/catalog/time_partition.h"
 #include "mongo/db/instance.h"
 #include "mongo/db/ops/delete.h"
 #include "mongo/db/repl/is_master.h"
@@ -51,9 +52,12 @@ namespace mongo {
 
     Counter64 ttlPasses;
     Counter64 ttlDeletedDocuments;
+    Counter64 ttlDroppedPartitions;
 
     ServerStatusMetricField<Counter64> ttlPassesDisplay("ttl.passes", &ttlPasses);
     ServerStatusMetricField<Counter64> ttlDeletedDocumentsDisplay("ttl.deletedDocuments", &ttlDeletedDocuments);
+    ServerStatusMetricField<Counter64> ttlDroppedPartitionsDisplay("ttl.droppedPartitions",
+                                                                   &ttlDroppedPartitions);
 
     MONGO_EXPORT_SERVER_PARAMETER( ttlMonitorEnabled, bool, true );
     
@@ -142,8 +146,57 @@ namespace mongo {
 
                 LOG(1) << "\tTTL deleted: " << n << endl;
             }
-            
-            
+
+            doTimePartitionsForDB( dbName );
+        }
+
+        /**
+         * Expires time partitioned collections by dropping their old partitions, rather than
+         * deleting documents one at a time.
+         */
+        void doTimePartitionsForDB( const string& dbName ) {
+            vector<string> parents;
+            {
+                auto_ptr<DBClientCursor> cursor =
+                                db.query( dbName + ".system.namespaces" ,
+                                          BSON( "options.timePartition.expireAfterSeconds" <<
+                                                BSON( "$gt" << 0 ) ) ,
+                                          0 , /* default nToReturn */
+                                          0 , /* default nToSkip */
+                                          0 , /* default fieldsToReturn */
+                                          QueryOption_SlaveOk );
+                if ( cursor.get() ) {
+                    while ( cursor->more() ) {
+                        parents.push_back( cursor->next()["name"].String() );
+                    }
+                }
+            }
+
+            for ( unsigned i=0; i<parents.size(); i++ ) {
+                const string& ns = parents[i];
+
+                OperationContextImpl txn;
+                Client::WriteContext ctx(&txn, ns);
+                Collection* collection = ctx.ctx().db()->getCollection( &txn, ns );
+                if ( !collection ) {
+                    // collection was dropped
+                    continue;
+                }
+
+                if (!repl::isMasterNs(dbName.c_str())) {
+                    // we've stepped down since we started this function
+                    break;
+                }
+
+                int n = dropExpiredTimePartitions( &txn,
+                                                   ctx.ctx().db(),
+                                                   collection,
+                                                   collection->getTimePartitionOptions( &txn ),
+                                                   curTimeMillis64() );
+                ttlDroppedPartitions.increment( n );
+
+                LOG(1) << "\tTTL dropped " << n << " partitions of " << ns << endl;
+            }
         }
 
         virtual void run() {
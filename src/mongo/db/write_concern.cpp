@@ -33,6 +33,7 @@
 #include "mongo/db/repl/repl_coordinator_global.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/write_concern.h"
+#include "mongo/db/stats/latency_histogram.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/db/write_concern.h"
 
@@ -44,6 +45,17 @@ namespace mongo {
     static Counter64 gleWtimeouts;
     static ServerStatusMetricField<Counter64> gleWtimeoutsDisplay( "getLastError.wtimeouts", &gleWtimeouts );
 
+    // Time spent waiting for replication, by the kind of "w" waited for.
+    static LatencyHistogram gleWtimeNumberHistogram;
+    static ServerStatusMetricField<LatencyHistogram> displayGleWtimeNumberHistogram(
+            "getLastError.wtimeHistograms.number", &gleWtimeNumberHistogram );
+    static LatencyHistogram gleWtimeMajorityHistogram;
+    static ServerStatusMetricField<LatencyHistogram> displayGleWtimeMajorityHistogram(
+            "getLastError.wtimeHistograms.majority", &gleWtimeMajorityHistogram );
+    static LatencyHistogram gleWtimeTagHistogram;
+    static ServerStatusMetricField<LatencyHistogram> displayGleWtimeTagHistogram(
+            "getLastError.wtimeHistograms.tag", &gleWtimeTagHistogram );
+
     Status validateWriteConcern( const WriteConcernOptions& writeConcern ) {
 
         const bool isJournalEnabled = getDur().isDurable();
@@ -185,35 +197,31 @@ namespace mongo {
 
         // We're sure that replication is enabled and that we have more than one node or a wMode
         TimerHolder gleTimerHolder( &gleWtimeStats );
+        Timer replTimer;
+
+        LatencyHistogram* histogram = &gleWtimeNumberHistogram;
+        if ( writeConcern.wNumNodes <= 0 ) {
+            histogram = writeConcern.wMode == "majority" ? &gleWtimeMajorityHistogram :
+                                                           &gleWtimeTagHistogram;
+        }
 
         // Now we wait for replication
         // Note that replica set stepdowns and gle mode changes are thrown as errors
         // TODO: Make this cleaner
         Status replStatus = Status::OK();
         try {
-            while ( 1 ) {
-
-                if ( writeConcern.wNumNodes > 0 ) {
-                    if (repl::opReplicatedEnough(replOpTime, writeConcern.wNumNodes)) {
-                        break;
-                    }
-                }
-                else if (repl::opReplicatedEnough(replOpTime, writeConcern.wMode)) {
-                    break;
-                }
-
-                if ( writeConcern.wTimeout > 0 &&
-                     gleTimerHolder.millis() >= writeConcern.wTimeout ) {
-                    gleWtimeouts.increment();
-                    result->err = "timeout";
-                    result->wTimedOut = true;
-                    replStatus = Status( ErrorCodes::WriteConcernFailed,
-                                         "waiting for replication timed out" );
-                    break;
-                }
-
-                sleepmillis(1);
-                txn->checkForInterrupt();
+            const bool replicated =
+                    writeConcern.wNumNodes > 0 ?
+                    repl::awaitReplication( txn, replOpTime, writeConcern.wNumNodes, "",
+                                            writeConcern.wTimeout ) :
+                    repl::awaitReplication( txn, replOpTime, 0, writeConcern.wMode,
+                                            writeConcern.wTimeout );
+            if ( !replicated ) {
+                gleWtimeouts.increment();
+                result->err = "timeout";
+                result->wTimedOut = true;
+                replStatus = Status( ErrorCodes::WriteConcernFailed,
+                                     "waiting for replication timed out" );
             }
         }
         catch( const AssertionException& ex ) {
@@ -222,6 +230,7 @@ namespace mongo {
         }
 
         // Add stats
+        histogram->record( replTimer.micros() );
         result->writtenTo = repl::getHostsWrittenTo(replOpTime);
         result->wTime = gleTimerHolder.recordMillis();
 
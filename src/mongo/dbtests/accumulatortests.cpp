@@ -159,6 +159,23 @@ namespace AccumulatorTests {
             }
         };
 
+        /** A batch is averaged exactly as its values are one at a time. */
+        class Batch : public Base {
+        public:
+            void run() {
+                const Value values[] = { Value(10), Value("x"), Value(11LL), Value(BSONNULL),
+                                         Value(2.5) };
+                const size_t numValues = sizeof(values) / sizeof(values[0]);
+
+                createAccumulator();
+                accumulator()->processBatch(values, 2, false);
+                accumulator()->processBatch(values + 2, numValues - 2, false);
+                ASSERT_EQUALS( 23.5 / 3, accumulator()->getValue(false).getDouble() );
+                ASSERT_EQUALS( Value(DOC("subTotal" << 23.5 << "count" << 3LL)),
+                               accumulator()->getValue(true) );
+            }
+        };
+
         namespace Shard {
             class SingleOperandBase : public Base {
             public:
@@ -834,7 +851,31 @@ namespace AccumulatorTests {
                            + (double)numeric_limits<long long>::max());
             }
         };
-        
+
+        /** A batch is summed exactly as its values are one at a time. */
+        class Batch : public Base {
+        public:
+            void run() {
+                const Value values[] = { Value(5), Value(BSONNULL), Value(6LL), Value("x"),
+                                         Value(numeric_limits<int>::max()), Value(0.5),
+                                         Value(7) };
+                const size_t numValues = sizeof(values) / sizeof(values[0]);
+
+                for (size_t split = 0; split <= numValues; ++split) {
+                    createAccumulator();
+                    for (size_t i = 0; i < numValues; ++i) {
+                        accumulator()->process(values[i], false);
+                    }
+                    const BSONObj expected = fromValue(accumulator()->getValue(false));
+
+                    createAccumulator();
+                    accumulator()->processBatch(values, split, false);
+                    accumulator()->processBatch(values + split, numValues - split, false);
+                    assertBinaryEqual(expected, fromValue(accumulator()->getValue(false)));
+                }
+            }
+        };
+
     } // namespace Sum
 
     class All : public Suite {
@@ -850,6 +891,7 @@ namespace AccumulatorTests {
             add<Avg::IntDouble>();
             add<Avg::IntIntNoOverflow>();
             add<Avg::LongLongOverflow>();
+            add<Avg::Batch>();
             add<Avg::Shard::Int>();
             add<Avg::Shard::Long>();
             add<Avg::Shard::Double>();
@@ -913,6 +955,7 @@ namespace AccumulatorTests {
             add<Sum::IntNull>();
             add<Sum::IntUndefined>();
             add<Sum::NoOverflowBeforeDouble>();
+            add<Sum::Batch>();
         }
     } myall;
 
@@ -31,6 +31,7 @@
 #include "mongo/pch.h"
 
 #include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_buffer_pool.h"
 #include "mongo/db/pipeline/field_path.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/dbtests/dbtests.h"
@@ -427,6 +428,42 @@ namespace DocumentTests {
             BSONObjBuilder objBuilder;
             BSONArrayBuilder arrBuilder;
         };
+
+        /** Documents freed in a DocumentBufferPool::Scope recycle their memory within it. */
+        class BufferPoolScope {
+        public:
+            void run() {
+                const BSONObj obj = BSON("a" << 1 << "b" << "two" << "c" << BSON("d" << 3));
+                ASSERT_EQUALS(0U, DocumentBufferPool::pooledBlocks());
+                Document survivor;
+                {
+                    DocumentBufferPool::Scope scope;
+                    fromBson(obj);
+                    const size_t pooled = DocumentBufferPool::pooledBlocks();
+                    ASSERT_NOT_EQUALS(0U, pooled);
+
+                    // A nested scope doesn't release anything, and building the same shape of
+                    // Document again takes its memory from the pool.
+                    {
+                        DocumentBufferPool::Scope nested;
+                        const Document doc = fromBson(obj);
+                        ASSERT_LESS_THAN(DocumentBufferPool::pooledBlocks(), pooled);
+                        ASSERT_EQUALS(obj, toBson(doc));
+                    }
+                    ASSERT_GREATER_THAN_OR_EQUALS(DocumentBufferPool::pooledBlocks(), pooled);
+
+                    survivor = fromBson(obj);
+                }
+                ASSERT_EQUALS(0U, DocumentBufferPool::pooledBlocks());
+
+                // A Document that outlives the scope is still usable.
+                ASSERT_EQUALS(obj, toBson(survivor));
+
+                // Without a scope nothing is pooled.
+                fromBson(obj);
+                ASSERT_EQUALS(0U, DocumentBufferPool::pooledBlocks());
+            }
+        };
     } // namespace Document
 
     namespace Value {
@@ -1428,6 +1465,7 @@ namespace DocumentTests {
             add<Document::FieldIteratorSingle>();
             add<Document::FieldIteratorMultiple>();
             add<Document::AllTypesDoc>();
+            add<Document::BufferPoolScope>();
 
             add<Value::BSONArrayTest>();
             add<Value::Int>();
@@ -92,7 +92,31 @@ namespace ExpressionTests {
         BSONElement element = obj.firstElement();
         return Value( element );
     }
-    
+
+    /**
+     * Check that evaluating the expression parsed from 'spec' over a batch of 'docs' gives the
+     * same results as evaluating it over each of them in turn.
+     */
+    static void assertBatchMatchesSingle( const BSONObj& spec, const BSONArray& docs ) {
+        VariablesIdGenerator idGenerator;
+        VariablesParseState vps(&idGenerator);
+        intrusive_ptr<Expression> expression = Expression::parseOperand(spec.firstElement(), vps);
+
+        vector<Document> batch;
+        for (BSONObjIterator itr(docs); itr.more(); itr.next()) {
+            batch.push_back(Document((*itr).Obj()));
+        }
+
+        Variables vars(idGenerator.getIdCount());
+        vector<Value> results;
+        expression->evaluateBatch(batch, &vars, &results);
+        ASSERT_EQUALS( batch.size(), results.size() );
+        for (size_t i = 0; i < batch.size(); ++i) {
+            vars.setRoot(batch[i]);
+            assertBinaryEqual( toBson( expression->evaluate(&vars) ), toBson( results[i] ) );
+        }
+    }
+
     namespace Add {
 
         class ExpectedResultBase {
@@ -287,6 +311,36 @@ namespace ExpressionTests {
             BSONObj expectedResult() { return BSON( "" << BSONNULL ); }
         };
         
+        /** $add evaluated over a batch gives the same results as one document at a time. */
+        class EvaluateBatch {
+        public:
+            void run() {
+                const BSONArray docs = BSON_ARRAY( BSON( "a" << 1 << "b" << 2 ) <<
+                                                   BSON( "a" << 1 << "b" << 2.5 ) <<
+                                                   BSON( "a" << 1LL << "b" << 2 ) <<
+                                                   BSON( "a" << Date_t(1000) << "b" << 2 ) <<
+                                                   BSON( "a" << BSONNULL << "b" << 2 ) <<
+                                                   BSON( "b" << 2 ) <<
+                                                   BSON( "a" << numeric_limits<int>::max()
+                                                         << "b" << 1 ) );
+                assertBatchMatchesSingle( fromjson( "{'':{$add:['$a', '$b', 1]}}" ), docs );
+                assertBatchMatchesSingle( fromjson( "{'':{$add:['$a', {$add:['$b', 2]}]}}" ),
+                                          docs );
+            }
+        };
+
+        /** A null operand hides errors in later operands in a batch too. */
+        class EvaluateBatchNullFirst {
+        public:
+            void run() {
+                const BSONArray docs = BSON_ARRAY( BSON( "a" << BSONNULL << "b" << "x" ) <<
+                                                   BSON( "a" << 1 << "b" << 2 ) );
+                assertBatchMatchesSingle( fromjson( "{'':{$add:['$a', '$b']}}" ), docs );
+                assertBatchMatchesSingle( fromjson( "{'':{$add:['$a', {$add:['$b']}]}}" ),
+                                          docs );
+            }
+        };
+
     } // namespace Add
 
     namespace And {
@@ -571,6 +625,24 @@ namespace ExpressionTests {
 
     namespace Compare {
 
+        /** Comparisons evaluated over a batch give the same results as one at a time. */
+        class EvaluateBatch {
+        public:
+            void run() {
+                const BSONArray docs = BSON_ARRAY( BSON( "a" << 1 << "b" << 0 ) <<
+                                                   BSON( "a" << 1 << "b" << 1.5 ) <<
+                                                   BSON( "a" << "x" << "b" << 2 ) <<
+                                                   BSON( "b" << 3 ) <<
+                                                   BSONObj() );
+                assertBatchMatchesSingle( BSON( "" << BSON( "$gt" << BSON_ARRAY( "$a" << "$b" ) ) ),
+                                          docs );
+                assertBatchMatchesSingle( BSON( "" << BSON( "$cmp" << BSON_ARRAY( "$a" << 1 ) ) ),
+                                          docs );
+                assertBatchMatchesSingle( fromjson( "{'':{$lte:[{$add:['$b', 1]}, '$a']}}" ),
+                                          docs );
+            }
+        };
+
         class OptimizeBase {
         public:
             virtual ~OptimizeBase() {
@@ -3461,6 +3533,8 @@ namespace ExpressionTests {
             add<Add::LongDoubleNoOverflow>();
             add<Add::IntNull>();
             add<Add::LongUndefined>();
+            add<Add::EvaluateBatch>();
+            add<Add::EvaluateBatchNullFirst>();
 
             add<And::NoOperands>();
             add<And::True>();
@@ -3536,6 +3610,7 @@ namespace ExpressionTests {
             add<Compare::OptimizeGtReverse>();
             add<Compare::OptimizeGte>();
             add<Compare::OptimizeGteReverse>();
+            add<Compare::EvaluateBatch>();
 
             add<Constant::Create>();
             add<Constant::CreateFromBsonElement>();
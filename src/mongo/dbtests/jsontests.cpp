@@ -582,6 +582,9 @@ namespace JsonTests {
                 assertEquals( bson(), fromjson( bson().jsonString( Strict ) ), "mode: strict" );
                 assertEquals( bson(), fromjson( bson().jsonString( TenGen ) ), "mode: tengen" );
                 assertEquals( bson(), fromjson( bson().jsonString( JS ) ), "mode: js" );
+                assertEquals( bson(), fromjsonFast( json().c_str() ), "mode: fast" );
+                assertEquals( bson(), fromjsonFast( bson().jsonString( Strict ).c_str() ),
+                              "mode: fast strict" );
             }
         protected:
             virtual BSONObj bson() const = 0;
@@ -610,6 +613,7 @@ namespace JsonTests {
             virtual ~Bad() {}
             void run() {
                 ASSERT_THROWS( fromjson( json() ), MsgAssertionException );
+                ASSERT_THROWS( fromjsonFast( json().c_str() ), MsgAssertionException );
             }
         protected:
             virtual string json() const = 0;
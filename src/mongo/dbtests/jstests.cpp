@@ -1931,6 +1931,98 @@ namespace JSTests {
         }
     };
 
+    /**
+     * Documents are handed to JS as lazy BSON-backed objects, so a function reading one field
+     * of a wide document shouldn't pay for the rest.  Times that against reading every field.
+     */
+    class LazyObjectSpeed {
+    public:
+        void run() {
+            BSONObjBuilder b;
+            for ( int i = 0; i < 200; i++ ) {
+                const string field = str::stream() << "f" << i;
+                b.append( field , i );
+            }
+            b.append( "arr" , BSON_ARRAY( 1 << 2 << 3 << BSON( "x" << 1 ) ) );
+            BSONObj wide = b.obj();
+
+            auto_ptr<Scope> s;
+            s.reset( globalScriptEngine->newScope() );
+
+            ScriptingFunction one = s->createFunction( "return this.f199;" );
+            ScriptingFunction all = s->createFunction(
+                    "var n = 0; for ( var k in this ) { n++; } return n;" );
+
+            const int iterations = 5000;
+
+            Timer t;
+            for ( int i = 0; i < iterations; i++ ) {
+                s->invoke( one , 0 , &wide );
+                ASSERT_EQUALS( 199 , s->getNumber( "__returnValue" ) );
+            }
+            const long long oneMicros = t.micros();
+
+            t.reset();
+            for ( int i = 0; i < iterations; i++ ) {
+                s->invoke( all , 0 , &wide );
+                ASSERT_EQUALS( 201 , s->getNumber( "__returnValue" ) );
+            }
+            const long long allMicros = t.micros();
+
+            LOG(1) << "lazy object: one field " << iterations * 1000.0 / ( oneMicros + 1 )
+                   << " ops/ms, all fields " << iterations * 1000.0 / ( allMicros + 1 )
+                   << " ops/ms" << endl;
+        }
+    };
+
+    /**
+     * getPooledScope() hands out scopes created ahead of time when it has nothing to reuse,
+     * and they get replaced in the background.
+     */
+    class PrewarmedScopes {
+    public:
+        void run() {
+            globalScriptEngine->setNumPrewarmedScopes( 2 );
+            waitForPrewarmed( 2 );
+
+            Timer t;
+            {
+                // nothing was ever pooled under this name, so it has to be a prewarmed scope
+                auto_ptr<Scope> s = globalScriptEngine->getPooledScope( "unittest" ,
+                                                                        "prewarmedTest" );
+                s->invokeSafe( "x = 7;" , 0 , 0 );
+                ASSERT_EQUALS( 7 , s->getNumber( "x" ) );
+            }
+            const long long prewarmedMicros = t.micros();
+
+            // the scope handed out is replaced
+            waitForPrewarmed( 2 );
+
+            globalScriptEngine->setNumPrewarmedScopes( 0 );
+            ASSERT_EQUALS( 0 , globalScriptEngine->numPrewarmedScopes() );
+
+            t.reset();
+            {
+                auto_ptr<Scope> s( globalScriptEngine->newScope() );
+                s->invokeSafe( "x = 7;" , 0 , 0 );
+            }
+            const long long coldMicros = t.micros();
+
+            LOG(1) << "prewarmed scope: " << prewarmedMicros << "us, new scope: "
+                   << coldMicros << "us" << endl;
+        }
+
+    private:
+        static void waitForPrewarmed( int numScopes ) {
+            for ( int i = 0; i < 3000; i++ ) {
+                if ( globalScriptEngine->numPrewarmedScopes() == numScopes )
+                    return;
+                sleepmillis( 10 );
+            }
+            FAIL( "scopes weren't created ahead of time" );
+        }
+    };
+
     class ScopeOut {
     public:
         void run() {
@@ -2093,6 +2185,8 @@ namespace JSTests {
             add< VarTests >();
 
             add< Speed1 >();
+            add< LazyObjectSpeed >();
+            add< PrewarmedScopes >();
 
             add< InvalidUTF8Check >();
             add< Utf8Check >();
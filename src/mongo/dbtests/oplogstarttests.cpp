@@ -23,6 +23,7 @@
 
 #include "mongo/dbtests/dbtests.h"
 
+#include "mongo/db/catalog/oplog_ts_index.h"
 #include "mongo/db/db.h"
 #include "mongo/db/exec/oplogstart.h"
 #include "mongo/db/exec/working_set.h"
@@ -68,6 +69,8 @@ namespace OplogStartTests {
 
         DBDirectClient* client() { return &_client; }
 
+        OperationContext* txn() { return &_txn; }
+
         void setupFromQuery(const BSONObj& query) {
             CanonicalQuery* cq;
             Status s = CanonicalQuery::canonicalize(ns(), query, &cq);
@@ -341,6 +344,130 @@ namespace OplogStartTests {
         virtual int tsGte() const { return 0; }
      };
 
+    /**
+     * Base class for tests of the sparse 'ts' index kept for oplogs.
+     */
+    class OplogTsIndexBase : public Base {
+    public:
+        OplogTsIndexBase() {
+            client()->dropCollection(ns());
+        }
+
+    protected:
+        static BSONObj tsDoc(int id) {
+            BSONObjBuilder b;
+            b.append("_id", id);
+            b.appendTimestamp("ts", OpTime(id + 1, 0).asDate());
+            b.append("payload", string(8*1024, 'a'));
+            return b.obj();
+        }
+
+        DiskLoc findStart(OplogTsIndex* index, const char* op, int id) {
+            BSONObjBuilder bound;
+            bound.appendTimestamp(op, OpTime(id + 1, 0).asDate());
+            CanonicalQuery* cq;
+            ASSERT_OK(CanonicalQuery::canonicalize(ns(), BSON("ts" << bound.obj()), &cq));
+            _cq.reset(cq);
+
+            DiskLoc start;
+            ASSERT(index->findStart(_cq->root(), &start));
+            return start;
+        }
+
+        int idAt(const DiskLoc& loc) {
+            return collection()->docFor(loc)["_id"].numberInt();
+        }
+    };
+
+    /**
+     * An index built over an existing collection has one sample per non empty extent.
+     */
+    class OplogTsIndexBuildsFromExtents : public OplogTsIndexBase {
+    public:
+        void run() {
+            BSONObj info;
+            BSONObj command = BSON( "create" << collname() << "capped" << true <<
+                                    "$nExtents" << BSON_ARRAY( 50*1024 << 1024 << 50*1024 <<
+                                                               50*1024 ) <<
+                                    "autoIndexId" << false );
+            ASSERT(client()->runCommand(dbname(), command, info));
+            for (int i = 0; i < 15; ++i) {
+                client()->insert(ns(), tsDoc(i));
+            }
+
+            // The documents that start each non empty extent.
+            std::vector<int> firsts;
+            OwnedPointerVector<RecordIterator> iterators;
+            iterators.mutableVector() = collection()->getManyIterators();
+            for (size_t i = 0; i < iterators.size(); i++) {
+                if (!iterators[i]->isEOF()) {
+                    firsts.push_back(idAt(iterators[i]->curr()));
+                }
+            }
+            ASSERT_EQUALS(firsts.size(), 3U);
+            ASSERT_EQUALS(firsts[0], 0);
+
+            OplogTsIndex index(collection());
+            ASSERT_EQUALS(findStart(&index, "$gte", 0), DiskLoc());
+            ASSERT_EQUALS(index.numSamples(), 3U);
+
+            // Start from the first document of the extent before the one holding a match.
+            ASSERT_EQUALS(idAt(findStart(&index, "$gte", firsts[1] + 1)), firsts[1]);
+            ASSERT_EQUALS(idAt(findStart(&index, "$gt", firsts[1] - 1)), firsts[0]);
+            ASSERT_EQUALS(idAt(findStart(&index, "$gt", firsts[1])), firsts[1]);
+            ASSERT_EQUALS(idAt(findStart(&index, "$gte", 100)), firsts[2]);
+
+            // Only Timestamp bounds can use the index.
+            CanonicalQuery* cq;
+            ASSERT_OK(CanonicalQuery::canonicalize(ns(), BSON("ts" << BSON("$gte" << 5)), &cq));
+            _cq.reset(cq);
+            DiskLoc start;
+            ASSERT(!index.findStart(_cq->root(), &start));
+        }
+    };
+
+    /**
+     * Inserted documents are sampled, and samples are dropped with their documents.
+     */
+    class OplogTsIndexSamplesInserts : public OplogTsIndexBase {
+    public:
+        void run() {
+            BSONObj info;
+            BSONObj command = BSON( "create" << collname() << "capped" << true <<
+                                    "size" << 1024*1024 << "autoIndexId" << false );
+            ASSERT(client()->runCommand(dbname(), command, info));
+
+            OplogTsIndex index(collection(), 4);
+            std::vector<DiskLoc> locs;
+            for (int i = 0; i < 10; ++i) {
+                BSONObj doc = tsDoc(i);
+                StatusWith<DiskLoc> loc = collection()->insertDocument(txn(), doc, false);
+                ASSERT_OK(loc.getStatus());
+                locs.push_back(loc.getValue());
+                index.noteInsert(doc, loc.getValue());
+            }
+
+            // The first insert builds the index from the extents, and then every fourth
+            // insert is sampled.
+            ASSERT_EQUALS(index.numSamples(), 3U);
+            ASSERT_EQUALS(idAt(findStart(&index, "$gte", 4)), 0);
+            ASSERT_EQUALS(idAt(findStart(&index, "$gte", 5)), 4);
+            ASSERT_EQUALS(idAt(findStart(&index, "$gte", 9)), 8);
+
+            index.noteDelete(locs[1]);
+            ASSERT_EQUALS(index.numSamples(), 3U);
+            index.noteDelete(locs[0]);
+            ASSERT_EQUALS(index.numSamples(), 2U);
+            ASSERT_EQUALS(findStart(&index, "$gte", 4), DiskLoc());
+            index.noteDelete(locs[8]);
+            ASSERT_EQUALS(index.numSamples(), 1U);
+            ASSERT_EQUALS(idAt(findStart(&index, "$gte", 9)), 4);
+
+            index.reset();
+            ASSERT_EQUALS(index.numSamples(), 0U);
+        }
+    };
+
     class All : public Suite {
     public:
         All() : Suite("oplogstart") { }
@@ -356,6 +483,8 @@ namespace OplogStartTests {
             add< OplogStartOneFullExtent >();
             add< OplogStartFirstExtentEmpty >();
             add< OplogStartEOF >();
+            add< OplogTsIndexBuildsFromExtents >();
+            add< OplogTsIndexSamplesInserts >();
         }
     } oplogStart;
 
@@ -37,8 +37,12 @@
 #include "mongo/client/dbclientcursor.h"
 #include "mongo/db/instance.h"
 #include "mongo/db/json.h"
+#include "mongo/db/matcher/compiled_matcher.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/dbtests/framework.h"
+#include "mongo/platform/random.h"
 #include "mongo/util/file_allocator.h"
 #include "mongo/unittest/unittest.h"
 
@@ -662,6 +666,144 @@ namespace Count {
 
 } // namespace Count
 
+namespace Matcher {
+
+    /**
+     * Evaluates a typical collection scan filter over in-memory documents, either through
+     * the MatchExpression interpreter or through a CompiledMatcher.
+     */
+    class Base {
+    public:
+        Base() {
+            for( int i = 0; i < 100000; ++i ) {
+                docs_.push_back( BSON( "_id" << i <<
+                                       "a" << i % 1000 <<
+                                       "b" << ( i % 2 ? "x" : "y" ) <<
+                                       "c" << BSON( "d" << i % 7 << "e" << "filler" ) ) );
+            }
+            query_ = fromjson( "{a: {$gt: 100, $lt: 900}, b: 'x', 'c.d': {$gte: 3}, "
+                               "'c.e': {$exists: true}}" );
+            StatusWithMatchExpression result = MatchExpressionParser::parse( query_ );
+            verify( result.isOK() );
+            expr_.reset( result.getValue() );
+        }
+        vector<BSONObj> docs_;
+        BSONObj query_;
+        scoped_ptr<MatchExpression> expr_;
+    };
+
+    class Interpreted : public Base {
+    public:
+        void run() {
+            int n = 0;
+            for( int pass = 0; pass < 10; ++pass )
+                for( vector<BSONObj>::const_iterator i = docs_.begin(); i != docs_.end(); ++i )
+                    n += expr_->matchesBSON( *i ) ? 1 : 0;
+            ASSERT( n > 0 );
+        }
+    };
+
+    class Compiled : public Base {
+    public:
+        void run() {
+            CompiledMatcher compiled( expr_.get() );
+            int n = 0;
+            for( int pass = 0; pass < 10; ++pass )
+                for( vector<BSONObj>::const_iterator i = docs_.begin(); i != docs_.end(); ++i )
+                    n += compiled.matchesBSON( *i ) ? 1 : 0;
+            ASSERT( n > 0 );
+        }
+    };
+
+    class All : public RunnerSuite {
+    public:
+        All() : RunnerSuite( "matcher" ) {}
+        void setupTests() {
+            add< Interpreted >();
+            add< Compiled >();
+        }
+    } all;
+
+} // namespace Matcher
+
+namespace Text {
+
+    /**
+     * Builds a synthetic corpus whose word frequencies fall off roughly as 1/rank, so the
+     * most common words appear in most documents and the rarest in only a handful, then asks
+     * for the ten best matches of a query that mixes common and uncommon words.
+     */
+    class Base {
+    public:
+        Base() : ns_( testNs( this ) ) {
+            client_->ensureIndex( ns_, BSON( "body" << "text" ) );
+            PseudoRandom random( 17 );
+            for( int i = 0; i < 100000; ++i ) {
+                string body;
+                int length = 10 + static_cast<unsigned>( random.nextInt32() ) % 40;
+                for( int j = 0; j < length; ++j ) {
+                    double u = ( static_cast<unsigned>( random.nextInt32() ) % 10000 ) / 10000.0;
+                    body += word( static_cast<int>( pow( vocabulary, u ) ) - 1 );
+                    body += ' ';
+                }
+                client_->insert( ns_.c_str(), BSON( "_id" << i << "body" << body ) );
+            }
+        }
+        void search() {
+            string query = word( 0 ) + " " + word( 3 ) + " " + word( 40 ) + " " + word( 900 );
+            BSONObj score = BSON( "score" << BSON( "$meta" << "textScore" ) );
+            auto_ptr< DBClientCursor > c =
+                client_->query( ns_.c_str(),
+                                Query( BSON( "$text" << BSON( "$search" << query ) ) )
+                                    .sort( score ),
+                                -10, 0, &score );
+            int n = 0;
+            for( ; c->more(); c->nextSafe(), ++n );
+            ASSERT_EQUALS( 10, n );
+        }
+        static const int vocabulary = 5000;
+        // Distinct, unstemmable words: "qa", "qb", ..., "qba", ...
+        static string word( int rank ) {
+            string w = "q";
+            do {
+                w += static_cast<char>( 'a' + rank % 26 );
+                rank /= 26;
+            } while( rank > 0 );
+            return w;
+        }
+        string ns_;
+    };
+
+    class TopK : public Base {
+    public:
+        void run() {
+            for( int i = 0; i < 20; ++i )
+                search();
+        }
+    };
+
+    class FullScan : public Base {
+    public:
+        void run() {
+            bool old = internalQueryTextTopK;
+            internalQueryTextTopK = false;
+            for( int i = 0; i < 20; ++i )
+                search();
+            internalQueryTextTopK = old;
+        }
+    };
+
+    class All : public RunnerSuite {
+    public:
+        All() : RunnerSuite( "text" ) {}
+        void setupTests() {
+            add< TopK >();
+            add< FullScan >();
+        }
+    } all;
+
+} // namespace Text
+
 namespace Plan {
 
     // QUERY_MIGRATION: what is this really testing?
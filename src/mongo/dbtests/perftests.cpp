@@ -49,6 +49,9 @@
 #include "mongo/db/lasterror.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/dbtests/framework_options.h"
+#include "mongo/logger/buffered_log_writer.h"
+#include "mongo/logger/message_event_utf8_encoder.h"
+#include "mongo/logger/rotatable_file_appender.h"
 #include "mongo/util/checksum.h"
 #include "mongo/util/compress.h"
 #include "mongo/util/concurrency/qlock.h"
@@ -1194,6 +1197,66 @@ namespace PerfTests {
         const volatile int _value;
     };
 
+    // Measures the cost to the logging thread of one log message written to a file, either
+    // directly through RotatableFileAppender or handed off through BufferedLogWriter.  The
+    // threaded variant shows how each holds up when several threads log at once.
+    template <bool buffered>
+    class LogToFile : public B {
+    public:
+        LogToFile() : _count(0) {
+            verify(logger::RotatableFileWriter::Use(&_file).setFileName(fileName(), false)
+                   .isOK());
+            if (buffered) {
+                _bufferedWriter.reset(new logger::BufferedLogWriter(&_file));
+                _domain.attachAppender(logger::MessageLogDomain::AppenderAutoPtr(
+                        new logger::BufferedLogAppender(new logger::MessageEventDetailsEncoder,
+                                                        _bufferedWriter.get())));
+            }
+            else {
+                _domain.attachAppender(logger::MessageLogDomain::AppenderAutoPtr(
+                        new logger::RotatableFileAppender<logger::MessageEventEphemeral>(
+                                new logger::MessageEventDetailsEncoder, &_file)));
+            }
+        }
+
+        virtual ~LogToFile() {
+            _domain.clearAppenders();
+            _bufferedWriter.reset();
+            boost::filesystem::remove(fileName());
+        }
+
+        virtual string name() { return buffered ? "log-buffered" : "log-file"; }
+        virtual int howLongMillis() { return 2000; }
+        virtual bool showDurStats() { return false; }
+
+        virtual void timed() {
+            logger::LogstreamBuilder(&_domain, "perftest", logger::LogSeverity::Log())
+                << "perf test message " << _count++ << ' ' << 1.5;
+        }
+
+        virtual void timed2(DBClientBase&) {
+            logger::LogstreamBuilder(&_domain, "perftest", logger::LogSeverity::Log())
+                << "perf test message " << 7 << ' ' << 1.5;
+        }
+
+        virtual bool testThreaded() { return true; }
+
+        virtual void post() {
+            if (buffered) {
+                cout << "stats " << setw(42) << left << (name() + " dropped") << ' ' << right
+                     << setw(9) << _bufferedWriter->getDroppedCount() << endl;
+            }
+        }
+
+    private:
+        string fileName() { return name() + ".perftest.log"; }
+
+        logger::RotatableFileWriter _file;
+        scoped_ptr<logger::BufferedLogWriter> _bufferedWriter;
+        logger::MessageLogDomain _domain;
+        unsigned long long _count;
+    };
+
     void t() {
         for( int i = 0; i < 20; i++ ) {
             sleepmillis(21);
@@ -1408,6 +1471,8 @@ namespace PerfTests {
                 add< FailPointTest<false, false> >();
                 add< FailPointTest<true, false> >();
                 add< FailPointTest<true, true> >();
+                add< LogToFile<false> >();
+                add< LogToFile<true> >();
 
                 add< ReturnOKStatus >();
                 add< ReturnNotOKStatus >();
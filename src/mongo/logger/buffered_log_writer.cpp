@@ -0,0 +1,253 @@
+/*    Copyright 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/logger/buffered_log_writer.h"
+
+#include <algorithm>
+#include <boost/thread/thread.hpp>
+#include <sstream>
+
+#include "mongo/logger/message_event_utf8_encoder.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace logger {
+
+namespace {
+
+    // How long the writer thread sleeps when it finds nothing to write.
+    const int kWriterIdleMillis = 5;
+
+    // Lines longer than this don't keep their storage in the ring after being written, so that
+    // one huge message doesn't pin memory for the life of the thread.
+    const size_t kMaxRetainedLineCapacity = 1024;
+
+    boost::mutex liveWritersMutex;
+    std::vector<BufferedLogWriter*> liveWriters;
+
+}  // namespace
+
+    /**
+     * Single producer, single consumer ring of encoded log lines.  The producer is the thread
+     * the ring belongs to; the consumer is whoever holds the writer's _drainMutex.
+     */
+    class BufferedLogWriter::ThreadBuffer {
+        MONGO_DISALLOW_COPYING(ThreadBuffer);
+    public:
+        ThreadBuffer() : _slots(kRingSlots) {}
+
+        /**
+         * Queues "line", swapping it into a free slot.  Returns false if the ring is full.
+         */
+        bool push(std::string* line) {
+            const uint64_t head = _head.loadRelaxed();
+            if (head - _tail.load() >= kRingSlots ||
+                _bytes.load() + line->size() > kMaxBufferedBytes) {
+                return false;
+            }
+
+            std::string& slot = _slots[head % kRingSlots];
+            slot.swap(*line);
+            _bytes.addAndFetch(slot.size());
+            _head.store(head + 1);
+            return true;
+        }
+
+        /**
+         * Writes every queued line to "os", oldest first.  Returns the number of lines written.
+         */
+        size_t drain(std::ostream& os) {
+            const uint64_t head = _head.load();
+            const uint64_t first = _tail.loadRelaxed();
+            for (uint64_t tail = first; tail != head; ++tail) {
+                std::string& slot = _slots[tail % kRingSlots];
+                os << slot;
+                _bytes.subtractAndFetch(slot.size());
+                if (slot.capacity() > kMaxRetainedLineCapacity) {
+                    std::string().swap(slot);
+                }
+                else {
+                    slot.clear();
+                }
+            }
+            _tail.store(head);
+            return head - first;
+        }
+
+        /**
+         * Stream the owning thread encodes its messages into.
+         */
+        std::ostringstream& stream() { return _stream; }
+
+    private:
+        std::vector<std::string> _slots;
+        AtomicUInt64 _head;   // Next slot to fill; only stored by the producer.
+        AtomicUInt64 _tail;   // Next slot to drain; only stored by the consumer.
+        AtomicUInt64 _bytes;
+        std::ostringstream _stream;
+    };
+
+    BufferedLogWriter::BufferedLogWriter(RotatableFileWriter* writer) :
+        _writer(writer),
+        _noticeEncoder(new MessageEventDetailsEncoder),
+        _droppedReported(0),
+        _inShutdown(false) {
+
+        _thread.reset(new boost::thread(stdx::bind(&BufferedLogWriter::_writerThread, this)));
+
+        boost::mutex::scoped_lock lk(liveWritersMutex);
+        liveWriters.push_back(this);
+    }
+
+    BufferedLogWriter::~BufferedLogWriter() {
+        {
+            boost::mutex::scoped_lock lk(liveWritersMutex);
+            liveWriters.erase(std::find(liveWriters.begin(), liveWriters.end(), this));
+        }
+        {
+            boost::mutex::scoped_lock lk(_shutdownMutex);
+            _inShutdown = true;
+            _shutdownCondition.notify_one();
+        }
+        _thread->join();
+        flush();
+    }
+
+    BufferedLogWriter::ThreadBuffer* BufferedLogWriter::getThreadBuffer() {
+        ThreadBufferPtr* buffer = _threadBuffer.get();
+        if (!buffer) {
+            buffer = new ThreadBufferPtr(new ThreadBuffer);
+            _threadBuffer.reset(buffer);
+
+            boost::mutex::scoped_lock lk(_drainMutex);
+            _buffers.push_back(*buffer);
+        }
+        return buffer->get();
+    }
+
+    Status BufferedLogWriter::append(const MessageEventEphemeral& event,
+                                     Encoder<MessageEventEphemeral>* encoder) {
+        if (event.getSeverity() >= LogSeverity::Severe()) {
+            boost::mutex::scoped_lock lk(_drainMutex);
+            _drainAll();
+            RotatableFileWriter::Use useWriter(_writer);
+            Status status = useWriter.status();
+            if (!status.isOK())
+                return status;
+            encoder->encode(event, useWriter.stream()).flush();
+            return useWriter.status();
+        }
+
+        ThreadBuffer* buffer = getThreadBuffer();
+        std::ostringstream& os = buffer->stream();
+        os.str("");
+        encoder->encode(event, os);
+        std::string line = os.str();
+        if (!buffer->push(&line)) {
+            _dropped.addAndFetch(1);
+        }
+        return Status::OK();
+    }
+
+    void BufferedLogWriter::flush() {
+        boost::mutex::scoped_lock lk(_drainMutex);
+        _drainAll();
+    }
+
+    void BufferedLogWriter::flushAll() {
+        boost::mutex::scoped_lock lk(liveWritersMutex);
+        for (size_t i = 0; i < liveWriters.size(); ++i) {
+            liveWriters[i]->flush();
+        }
+    }
+
+    size_t BufferedLogWriter::_drainAll() {
+        RotatableFileWriter::Use useWriter(_writer);
+        if (!useWriter.status().isOK()) {
+            return 0;
+        }
+
+        size_t written = 0;
+        for (size_t i = 0; i < _buffers.size(); ) {
+            // Check for an exited owner before draining, so nothing it queued is left behind.
+            const bool orphaned = _buffers[i].unique();
+            written += _buffers[i]->drain(useWriter.stream());
+            if (orphaned) {
+                _buffers[i] = _buffers.back();
+                _buffers.pop_back();
+            }
+            else {
+                ++i;
+            }
+        }
+
+        const uint64_t dropped = _dropped.load();
+        if (dropped != _droppedReported) {
+            std::string notice = mongoutils::str::stream() << (dropped - _droppedReported) <<
+                " log messages dropped because their thread's log buffer was full";
+            _noticeEncoder->encode(MessageEventEphemeral(curTimeMillis64(),
+                                                         LogSeverity::Warning(),
+                                                         "logWriter",
+                                                         notice),
+                                   useWriter.stream());
+            _droppedReported = dropped;
+            ++written;
+        }
+
+        if (written) {
+            useWriter.stream().flush();
+        }
+        return written;
+    }
+
+    void BufferedLogWriter::_writerThread() {
+        setThreadName("logWriter");
+        while (true) {
+            size_t written;
+            {
+                boost::mutex::scoped_lock lk(_drainMutex);
+                written = _drainAll();
+            }
+
+            boost::mutex::scoped_lock lk(_shutdownMutex);
+            if (_inShutdown) {
+                return;
+            }
+            if (!written) {
+                _shutdownCondition.timed_wait(lk,
+                                              boost::posix_time::milliseconds(kWriterIdleMillis));
+            }
+        }
+    }
+
+}  // namespace logger
+}  // namespace mongo
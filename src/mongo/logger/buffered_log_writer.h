@@ -0,0 +1,170 @@
+/*    Copyright 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/logger/appender.h"
+#include "mongo/logger/encoder.h"
+#include "mongo/logger/message_event.h"
+#include "mongo/logger/rotatable_file_writer.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace boost {
+    class thread;
+}  // namespace boost
+
+namespace mongo {
+namespace logger {
+
+    /**
+     * Writes log messages to a RotatableFileWriter from a background thread.
+     *
+     * Each thread that logs through a BufferedLogWriter gets a fixed-size ring buffer of its own,
+     * so appending a message takes no lock: the calling thread encodes the message into its ring
+     * and the writer thread drains all the rings into the file every few milliseconds.  When a
+     * thread's ring is full, messages from that thread are dropped and counted, and the writer
+     * notes the number of dropped messages in the log.
+     *
+     * Messages of severity Severe or worse are written synchronously, after everything buffered
+     * ahead of them, so that they reach the file even if the process is about to die.
+     */
+    class BufferedLogWriter {
+        MONGO_DISALLOW_COPYING(BufferedLogWriter);
+    public:
+        /** Maximum number of messages buffered for one thread. */
+        static const size_t kRingSlots = 1024;
+
+        /** Maximum number of bytes buffered for one thread. */
+        static const size_t kMaxBufferedBytes = 256 * 1024;
+
+        /**
+         * Starts the writer thread.  Caller must keep "writer" in scope at least as long as the
+         * constructed BufferedLogWriter.
+         */
+        explicit BufferedLogWriter(RotatableFileWriter* writer);
+
+        /**
+         * Writes out everything still buffered and stops the writer thread.
+         */
+        ~BufferedLogWriter();
+
+        /**
+         * Encodes "event" with "encoder" and queues it for the writer thread.
+         *
+         * Returns Status::OK() even if the message had to be dropped; returns the status of the
+         * file only for messages written synchronously.
+         */
+        Status append(const MessageEventEphemeral& event, Encoder<MessageEventEphemeral>* encoder);
+
+        /**
+         * Writes out, from the calling thread, every message queued before the call.
+         */
+        void flush();
+
+        /**
+         * Number of messages dropped because their thread's ring buffer was full.
+         */
+        uint64_t getDroppedCount() const { return _dropped.load(); }
+
+        /**
+         * Calls flush() on every live BufferedLogWriter.  Used on the way out of the process.
+         */
+        static void flushAll();
+
+    private:
+        class ThreadBuffer;
+        typedef boost::shared_ptr<ThreadBuffer> ThreadBufferPtr;
+
+        ThreadBuffer* getThreadBuffer();
+
+        /**
+         * Writes all buffered messages to the file.  Caller must hold _drainMutex.
+         * Returns the number of messages written.
+         */
+        size_t _drainAll();
+
+        void _writerThread();
+
+        RotatableFileWriter* _writer;
+        boost::scoped_ptr< Encoder<MessageEventEphemeral> > _noticeEncoder;
+
+        // The calling thread's ring buffer.  The writer shares ownership so that a ring outlives
+        // its thread until it has been drained.
+        boost::thread_specific_ptr<ThreadBufferPtr> _threadBuffer;
+
+        // Protects _buffers and serializes draining, which makes the writer thread and flush()
+        // callers take turns being the single consumer of every ring.
+        boost::mutex _drainMutex;
+        std::vector<ThreadBufferPtr> _buffers;
+        uint64_t _droppedReported;
+
+        boost::mutex _shutdownMutex;
+        boost::condition_variable _shutdownCondition;
+        bool _inShutdown;
+
+        AtomicUInt64 _dropped;
+        boost::scoped_ptr<boost::thread> _thread;
+    };
+
+    /**
+     * Appender for writing to a BufferedLogWriter.
+     */
+    class BufferedLogAppender : public Appender<MessageEventEphemeral> {
+        MONGO_DISALLOW_COPYING(BufferedLogAppender);
+    public:
+        typedef Encoder<MessageEventEphemeral> EventEncoder;
+
+        /**
+         * Constructs an appender, that owns "encoder", but not "writer."  Caller must
+         * keep "writer" in scope at least as long as the constructed appender.
+         */
+        BufferedLogAppender(EventEncoder* encoder, BufferedLogWriter* writer) :
+            _encoder(encoder),
+            _writer(writer) {
+        }
+
+        virtual Status append(const MessageEventEphemeral& event) {
+            return _writer->append(event, _encoder.get());
+        }
+
+    private:
+        boost::scoped_ptr<EventEncoder> _encoder;
+        BufferedLogWriter* _writer;
+    };
+
+}  // namespace logger
+}  // namespace mongo
@@ -0,0 +1,145 @@
+/*    Copyright 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <boost/thread/thread.hpp>
+#include <fstream>
+#include <sstream>
+
+#include "mongo/logger/buffered_log_writer.h"
+#include "mongo/logger/message_event_utf8_encoder.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+    using namespace mongo;
+    using namespace mongo::logger;
+
+    const std::string logFileName("LogTest_BufferedLogWriter.txt");
+
+    // TODO(schwerin): Create a safe, uniform mechanism by which unit tests may read and write
+    // temporary files.
+    class BufferedLogWriterTest : public mongo::unittest::Test {
+    public:
+        BufferedLogWriterTest() {
+            unlink(logFileName.c_str());
+            ASSERT_OK(RotatableFileWriter::Use(&_file).setFileName(logFileName, false));
+        }
+
+        virtual ~BufferedLogWriterTest() {
+            unlink(logFileName.c_str());
+        }
+
+    protected:
+        std::vector<std::string> readLines() {
+            std::vector<std::string> lines;
+            std::ifstream ifs(logFileName.c_str());
+            std::string line;
+            while (std::getline(ifs, line)) {
+                lines.push_back(line);
+            }
+            return lines;
+        }
+
+        static void logMessages(BufferedLogAppender* appender, int thread, int count) {
+            for (int i = 0; i < count; ++i) {
+                std::ostringstream msg;
+                msg << thread << ":" << i;
+                std::string text = msg.str();
+                ASSERT_OK(appender->append(MessageEventEphemeral(0, LogSeverity::Log(), "test",
+                                                                 text)));
+            }
+        }
+
+        RotatableFileWriter _file;
+    };
+
+    TEST_F(BufferedLogWriterTest, MessagesFromEachThreadArriveInOrder) {
+        const int kThreads = 4;
+        const int kMessages = 500;
+        {
+            BufferedLogWriter writer(&_file);
+            BufferedLogAppender appender(new MessageEventUnadornedEncoder, &writer);
+            std::vector<boost::thread*> threads;
+            for (int t = 0; t < kThreads; ++t) {
+                threads.push_back(new boost::thread(
+                        stdx::bind(&BufferedLogWriterTest::logMessages, &appender, t, kMessages)));
+            }
+            for (int t = 0; t < kThreads; ++t) {
+                threads[t]->join();
+                delete threads[t];
+            }
+            writer.flush();
+            ASSERT_EQUALS(0U, writer.getDroppedCount());
+        }
+
+        std::vector<int> next(kThreads, 0);
+        std::vector<std::string> lines = readLines();
+        ASSERT_EQUALS(static_cast<size_t>(kThreads * kMessages), lines.size());
+        for (size_t i = 0; i < lines.size(); ++i) {
+            int thread, n;
+            char colon;
+            std::istringstream(lines[i]) >> thread >> colon >> n;
+            ASSERT_EQUALS(next[thread], n);
+            next[thread]++;
+        }
+    }
+
+    TEST_F(BufferedLogWriterTest, OversizedMessageIsDroppedAndReported) {
+        BufferedLogWriter writer(&_file);
+        BufferedLogAppender appender(new MessageEventUnadornedEncoder, &writer);
+
+        std::string huge(BufferedLogWriter::kMaxBufferedBytes + 1, 'x');
+        ASSERT_OK(appender.append(MessageEventEphemeral(0, LogSeverity::Log(), "test", huge)));
+        logMessages(&appender, 0, 1);
+        writer.flush();
+
+        ASSERT_EQUALS(1U, writer.getDroppedCount());
+        std::vector<std::string> lines = readLines();
+        ASSERT_EQUALS(2U, lines.size());
+        ASSERT_EQUALS("0:0", lines[0]);
+        ASSERT_NOT_EQUALS(std::string::npos, lines[1].find("1 log messages dropped"));
+    }
+
+    TEST_F(BufferedLogWriterTest, SevereMessagesAreWrittenImmediately) {
+        BufferedLogWriter writer(&_file);
+        BufferedLogAppender appender(new MessageEventUnadornedEncoder, &writer);
+
+        logMessages(&appender, 0, 2);
+        ASSERT_OK(appender.append(MessageEventEphemeral(0, LogSeverity::Severe(), "test",
+                                                        "fatal")));
+
+        // No flush: the severe message, and everything queued before it, is already written.
+        std::vector<std::string> lines = readLines();
+        ASSERT_EQUALS(3U, lines.size());
+        ASSERT_EQUALS("0:0", lines[0]);
+        ASSERT_EQUALS("0:1", lines[1]);
+        ASSERT_EQUALS("fatal", lines[2]);
+    }
+
+}  // namespace
@@ -52,6 +52,7 @@
 #include "mongo/db/instance.h"
 #include "mongo/db/lasterror.h"
 #include "mongo/db/log_process_details.h"
+#include "mongo/logger/buffered_log_writer.h"
 #include "mongo/platform/process_id.h"
 #include "mongo/s/balance.h"
 #include "mongo/s/chunk.h"
@@ -466,5 +467,6 @@ void mongo::dbexit( ExitCode rc, const char *why ) {
           << " " << ( why ? why : "" )
           << endl;
     flushForGcov();
+    logger::BufferedLogWriter::flushAll();
     ::_exit(rc);
 }
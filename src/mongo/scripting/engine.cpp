@@ -33,11 +33,15 @@
 
 #include <cctype>
 #include <boost/filesystem/operations.hpp>
+#include <boost/thread.hpp>
+#include <boost/thread/condition.hpp>
 
 #include "mongo/client/dbclientcursor.h"
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/platform/unordered_set.h"
 #include "mongo/scripting/bench.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/util/concurrency/thread_name.h"
 #include "mongo/util/file.h"
 #include "mongo/util/text.h"
 
@@ -290,7 +294,7 @@ namespace mongo {
 namespace {
     class ScopeCache {
     public:
-        ScopeCache() : _mutex("ScopeCache") {}
+        ScopeCache() : _numSpares(0), _refillStarted(false), _mutex("ScopeCache") {}
 
         void release(const string& poolName, const boost::shared_ptr<Scope>& scope) {
             scoped_lock lk(_mutex);
@@ -333,7 +337,76 @@ namespace {
             return boost::shared_ptr<Scope>();
         }
 
+        /**
+         * Returns one of the scopes created ahead of time, or an empty pointer if there are
+         * none.  Wakes up the thread creating them so it makes a replacement.
+         */
+        boost::shared_ptr<Scope> tryAcquireSpare() {
+            scoped_lock lk(_mutex);
+
+            if (_spares.empty())
+                return boost::shared_ptr<Scope>();
+
+            boost::shared_ptr<Scope> scope = _spares.front();
+            _spares.pop_front();
+            _spareTaken.notify_one();
+
+            scope->reset();
+            return scope;
+        }
+
+        void setNumSpares(ScriptEngine* engine, size_t numSpares) {
+            scoped_lock lk(_mutex);
+
+            _numSpares = numSpares;
+            while (_spares.size() > _numSpares)
+                _spares.pop_back();
+
+            if (_numSpares > 0 && !_refillStarted) {
+                _refillStarted = true;
+                boost::thread t(stdx::bind(&ScopeCache::_refillSpares, this, engine));
+            }
+            _spareTaken.notify_one();
+        }
+
+        size_t numSpares() {
+            scoped_lock lk(_mutex);
+            return _spares.size();
+        }
+
     private:
+        /**
+         * Runs on its own thread for the life of the process, keeping _numSpares scopes ready.
+         * Scopes are created without holding _mutex since that takes a while.
+         */
+        void _refillSpares(ScriptEngine* engine) {
+            setThreadName("jsScopePrewarmer");
+
+            while (true) {
+                {
+                    scoped_lock lk(_mutex);
+                    while (_spares.size() >= _numSpares)
+                        _spareTaken.wait(lk.boost());
+                }
+
+                boost::shared_ptr<Scope> scope;
+                try {
+                    scope.reset(engine->newScope());
+                }
+                catch (const std::exception& e) {
+                    warning() << "couldn't create JS scope ahead of time, giving up: "
+                              << e.what() << endl;
+                    scoped_lock lk(_mutex);
+                    _numSpares = 0;
+                    continue;
+                }
+
+                scoped_lock lk(_mutex);
+                if (_spares.size() < _numSpares)
+                    _spares.push_back(scope);
+            }
+        }
+
         struct ScopeAndPool {
             boost::shared_ptr<Scope> scope;
             string poolName;
@@ -345,6 +418,13 @@ namespace {
 
         typedef deque<ScopeAndPool> Pools; // More-recently used Scopes are kept at the front.
         Pools _pools;    // protected by _mutex
+
+        // Scopes created ahead of time and not handed out to any pool yet.
+        deque<boost::shared_ptr<Scope> > _spares;  // protected by _mutex
+        size_t _numSpares;                          // protected by _mutex
+        bool _refillStarted;                        // protected by _mutex
+        boost::condition _spareTaken;
+
         mongo::mutex _mutex;
     };
 
@@ -429,6 +509,9 @@ namespace {
     auto_ptr<Scope> ScriptEngine::getPooledScope(const string& db, const string& scopeType) {
         const string fullPoolName = db + scopeType;
         boost::shared_ptr<Scope> s = scopeCache.tryAcquire(fullPoolName);
+        if (!s) {
+            s = scopeCache.tryAcquireSpare();
+        }
         if (!s) {
             s.reset(newScope());
         }
@@ -440,6 +523,14 @@ namespace {
         return p;
     }
 
+    void ScriptEngine::setNumPrewarmedScopes(int numScopes) {
+        scopeCache.setNumSpares(this, std::max(numScopes, 0));
+    }
+
+    int ScriptEngine::numPrewarmedScopes() {
+        return scopeCache.numSpares();
+    }
+
     void (*ScriptEngine::_connectCallback)(DBClientWithCommands&) = 0;
     const char* (*ScriptEngine::_checkInterruptCallback)() = 0;
     unsigned (*ScriptEngine::_getCurrentOpIdCallback)() = 0;
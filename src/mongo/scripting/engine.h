@@ -208,6 +208,16 @@ namespace mongo {
          */
         std::auto_ptr<Scope> getPooledScope(const std::string& db, const std::string& scopeType);
 
+        /**
+         * Keeps 'numScopes' scopes created ahead of time, which getPooledScope() hands out when
+         * it has no pooled scope to reuse.  They are created on a background thread, started by
+         * the first call asking for any.
+         */
+        void setNumPrewarmedScopes(int numScopes);
+
+        /** @return the number of scopes created ahead of time that are ready to be handed out */
+        int numPrewarmedScopes();
+
         void setScopeInitCallback(void (*func)(Scope&)) { _scopeInitCallback = func; }
         static void setConnectCallback(void (*func)(DBClientWithCommands&)) {
             _connectCallback = func;
@@ -36,6 +36,7 @@
 
 #include "mongo/base/status.h"
 #include "mongo/client/auth_helpers.h"
+#include "mongo/client/dbclient_rs.h"
 #include "mongo/client/dbclientcursor.h"
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/catalog/database_catalog_entry.h"
@@ -43,13 +44,23 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context_impl.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/tools/mongodump_options.h"
 #include "mongo/tools/tool.h"
+#include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/options_parser/option_section.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
 
 using namespace mongo;
 
+namespace {
+    // Collections with at least this many documents are read through several cursors at once,
+    // when the server allows it (see Dump::splitCollection).
+    const long long kMinDocsToSplit = 100 * 1000;
+}
+
 class Dump : public Tool {
     class FilePtr : boost::noncopyable {
     public:
@@ -60,17 +71,40 @@ class Dump : public Tool {
         FILE* _f;
     };
 public:
-    Dump() : Tool() { }
+    Dump() : Tool(), _failureMutex("dumpFailure"), _failureCode(0) { }
 
     virtual void printHelp(ostream& out) {
         printMongoDumpHelp(&out);
     }
 
-    // This is a functor that writes a BSONObj to a file
+    // Running totals for the throughput summary, shared by all threads
+    struct Totals {
+        AtomicInt64 docs;
+        AtomicInt64 bytes;
+    };
+
+    // This is a functor that writes a BSONObj to a file.  If several threads write to the same
+    // file, they must share one Writer with a mutex.
     struct Writer {
-        Writer(FILE* out, ProgressMeter* m) :_out(out), _m(m) {}
+        Writer(FILE* out, ProgressMeter* m, Totals* totals = NULL, mongo::mutex* mutex = NULL)
+            : _out(out), _m(m), _totals(totals), _mutex(mutex) {}
 
         void operator () (const BSONObj& obj) {
+            if (_mutex) {
+                scoped_lock lk(*_mutex);
+                write(obj);
+            }
+            else {
+                write(obj);
+            }
+
+            if (_totals) {
+                _totals->docs.addAndFetch(1);
+                _totals->bytes.addAndFetch(obj.objsize());
+            }
+        }
+
+        void write(const BSONObj& obj) {
             size_t toWrite = obj.objsize();
             size_t written = 0;
 
@@ -89,18 +123,38 @@ public:
 
         FILE* _out;
         ProgressMeter* _m;
+        Totals* _totals;
+        mongo::mutex* _mutex;
     };
 
-    void doCollection( const string coll , Query q, FILE* out , ProgressMeter *m ) {
+    // Everything needed to dump one collection on a worker thread
+    struct CollectionJob {
+        string ns;
+        Query query;
+        boost::filesystem::path dataFile;
+        boost::filesystem::path metadataFile;
+        const map<string, BSONObj>* options;
+        const multimap<string, BSONObj>* indexes;
+    };
+
+    // The connection to read from on 'c', following the same rules as conn(true)
+    static DBClientBase& readerFor(DBClientBase* c) {
+        if (c->type() == ConnectionString::SET) {
+            return static_cast<DBClientReplicaSet*>(c)->slaveConn();
+        }
+        return *c;
+    }
+
+    void doCollection( DBClientBase& connBase, const string coll , Query q, FILE* out ,
+                       ProgressMeter *m ) {
         int queryOptions = QueryOption_SlaveOk | QueryOption_NoCursorTimeout;
         if (startsWith(coll.c_str(), "local.oplog.") && q.obj.hasField("ts"))
             queryOptions |= QueryOption_OplogReplay;
         else if (mongoDumpGlobalParams.snapShotQuery) {
             q.snapshot();
         }
-        
-        DBClientBase& connBase = conn(true);
-        Writer writer(out, m);
+
+        Writer writer(out, m, &_totals);
 
         // use low-latency "exhaust" mode if going over the network
         if (!_usingMongos && typeid(connBase) == typeid(DBClientConnection&)) {
@@ -117,25 +171,110 @@ public:
         }
     }
 
-    void writeCollectionFile( const string coll , Query q, boost::filesystem::path outputFile ) {
+    /**
+     * Returns whether the documents of 'coll' may be read through several cursors at once and
+     * written in any order.  That needs parallelCollectionScan on the server we're connected
+     * to directly, so not through mongos or a replica set connection, and no snapshot or query.
+     */
+    bool canSplit(const string& coll, const Query& q) {
+        return mongoDumpGlobalParams.numParallelCollections > 1 &&
+               !toolGlobalParams.useDirectClient &&
+               !_usingMongos &&
+               !mongoDumpGlobalParams.snapShotQuery &&
+               q.obj.isEmpty() &&
+               !startsWith(coll.c_str(), "local.oplog.") &&
+               conn(true).type() == ConnectionString::MASTER;
+    }
+
+    /**
+     * Asks the server for up to 'numCursors' cursors over 'coll' and reads them all at once, on
+     * separate connections, into 'out'.  Returns false without writing anything if the server
+     * can't split the collection.
+     */
+    bool splitCollection(const string& coll, int numCursors, FILE* out, ProgressMeter* m) {
+        NamespaceString nss(coll);
+        BSONObj res;
+        if (!conn(true).runCommand(nss.db().toString(),
+                                   BSON("parallelCollectionScan" << nss.coll() <<
+                                        "numCursors" << numCursors),
+                                   res)) {
+            if (logger::globalLogDomain()->shouldLog(logger::LogSeverity::Debug(1))) {
+                toolInfoLog() << "\tnot splitting " << coll << ": " << res << std::endl;
+            }
+            return false;
+        }
+
+        mongo::mutex writeMutex("dumpSplitCollection");
+        Writer writer(out, m, &_totals, &writeMutex);
+
+        vector<long long> cursorIds;
+        BSONObjIterator i(res["cursors"].Obj());
+        while (i.more()) {
+            BSONObj cursor = i.next().Obj()["cursor"].Obj();
+            BSONObjIterator batch(cursor["firstBatch"].Obj());
+            while (batch.more()) {
+                writer(batch.next().Obj());
+            }
+            if (cursor["id"].numberLong() != 0) {
+                cursorIds.push_back(cursor["id"].numberLong());
+            }
+        }
+
+        toolInfoLog() << "\t\treading with " << cursorIds.size() << " cursors" << std::endl;
+
+        if (!cursorIds.empty()) {
+            ThreadPool pool(cursorIds.size());
+            for (size_t j = 0; j < cursorIds.size(); j++) {
+                pool.schedule(&Dump::readCursor, this, coll, cursorIds[j], &writer);
+            }
+            pool.join();
+        }
+
+        rethrowFailure();
+        return true;
+    }
+
+    void readCursor(const string& coll, long long cursorId, Writer* writer) {
+        try {
+            scoped_ptr<DBClientBase> c(newConnection());
+            DBClientCursor cursor(c.get(), coll, cursorId, 0, 0);
+            while (cursor.more()) {
+                (*writer)(cursor.nextSafe());
+            }
+        }
+        catch (const DBException& e) {
+            recordFailure(e.getCode(), e.what());
+        }
+        catch (const std::exception& e) {
+            recordFailure(17516, e.what());
+        }
+    }
+
+    void writeCollectionFile( DBClientBase& c, const string coll , Query q,
+                              boost::filesystem::path outputFile, bool split = false ) {
         toolInfoLog() << "\t" << coll << " to " << outputFile.string() << std::endl;
 
         FilePtr f (fopen(outputFile.string().c_str(), "wb"));
         uassert(10262, errnoWithPrefix("couldn't open file"), f);
 
-        ProgressMeter m(conn(true).count(coll.c_str(), BSONObj(), QueryOption_SlaveOk));
+        const long long count = c.count(coll.c_str(), BSONObj(), QueryOption_SlaveOk);
+        ProgressMeter m(count);
         m.setName("Collection File Writing Progress");
         m.setUnits("documents");
 
-        doCollection(coll, q, f, &m);
+        if (!split || count < kMinDocsToSplit ||
+                !splitCollection(coll, mongoDumpGlobalParams.numParallelCollections, f, &m)) {
+            doCollection(c, coll, q, f, &m);
+        }
 
         toolInfoLog() << "\t\t " << m.done()
                       << ((m.done() == 1) ? " document" : " documents")
                       << std::endl;
     }
 
-    void writeMetadataFile( const string coll, boost::filesystem::path outputFile, 
-                            map<string, BSONObj> options, multimap<string, BSONObj> indexes ) {
+    void writeMetadataFile( const string coll, boost::filesystem::path outputFile,
+                            const map<string, BSONObj>& options,
+                            const multimap<string, BSONObj>& indexes ) {
         toolInfoLog() << "\tMetadata for " << coll << " to " << outputFile.string() << std::endl;
 
         bool hasOptions = options.count(coll) > 0;
@@ -151,10 +290,10 @@ public:
             BSONArrayBuilder indexesOutput (metadata.subarrayStart("indexes"));
 
             // I'd kill for C++11 auto here...
-            const pair<multimap<string, BSONObj>::iterator, multimap<string, BSONObj>::iterator>
-                range = indexes.equal_range(coll);
+            typedef multimap<string, BSONObj>::const_iterator IndexIterator;
+            const pair<IndexIterator, IndexIterator> range = indexes.equal_range(coll);
 
-            for (multimap<string, BSONObj>::iterator it=range.first; it!=range.second; ++it) {
+            for (IndexIterator it=range.first; it!=range.second; ++it) {
                  indexesOutput << it->second;
             }
 
@@ -169,7 +308,42 @@ public:
 
 
     void writeCollectionStdout( const string coll ) {
-        doCollection(coll, _query, stdout, NULL);
+        doCollection(conn(true), coll, _query, stdout, NULL);
+    }
+
+    void dumpCollection(DBClientBase& c, const CollectionJob& job, bool split) {
+        writeCollectionFile(c, job.ns, job.query, job.dataFile, split);
+        writeMetadataFile(job.ns, job.metadataFile, *job.options, *job.indexes);
+    }
+
+    // Runs on a worker thread, with a connection of its own
+    void dumpCollectionInPool(const CollectionJob* job) {
+        try {
+            scoped_ptr<DBClientBase> c(newConnection());
+            dumpCollection(readerFor(c.get()), *job, false);
+        }
+        catch (const DBException& e) {
+            recordFailure(e.getCode(), e.what());
+        }
+        catch (const std::exception& e) {
+            recordFailure(17517, e.what());
+        }
+    }
+
+    // Worker threads report the first error they hit here, to be rethrown on the main thread
+    void recordFailure(int code, const string& msg) {
+        scoped_lock lk(_failureMutex);
+        if (_failureCode == 0) {
+            _failureCode = code;
+            _failureMsg = msg;
+        }
+    }
+
+    void rethrowFailure() {
+        scoped_lock lk(_failureMutex);
+        if (_failureCode != 0) {
+            uasserted(_failureCode, _failureMsg);
+        }
     }
 
     void go(const string& db,
@@ -229,7 +403,8 @@ public:
             if (nsToCollectionSubstring(name) == "system.indexes") {
               // Create system.indexes.bson for compatibility with pre 2.2 mongorestore
               const string filename = name.substr( db.size() + 1 );
-              writeCollectionFile( name.c_str() , query, outdir / ( filename + ".bson" ) );
+              writeCollectionFile( conn(true), name.c_str() , query,
+                                   outdir / ( filename + ".bson" ) );
               // Don't dump indexes as *.metadata.json
               continue;
             }
@@ -241,14 +416,52 @@ public:
 
             collections.push_back(name);
         }
-        
-        for (vector<string>::iterator it = collections.begin(); it != collections.end(); ++it) {
-            string name = *it;
+
+        vector<CollectionJob> jobs(collections.size());
+        for (size_t i = 0; i < collections.size(); i++) {
+            const string& name = collections[i];
             const string filename = outFilename != "" ? outFilename : name.substr( db.size() + 1 );
-            writeCollectionFile( name , query, outdir / ( filename + ".bson" ) );
-            writeMetadataFile( name, outdir / (filename + ".metadata.json"), collectionOptions, indexes);
+            CollectionJob& job = jobs[i];
+            job.ns = name;
+            job.query = query;
+            job.dataFile = outdir / ( filename + ".bson" );
+            job.metadataFile = outdir / ( filename + ".metadata.json" );
+            job.options = &collectionOptions;
+            job.indexes = &indexes;
+        }
+
+        const int numParallel = mongoDumpGlobalParams.numParallelCollections;
+        if (numParallel <= 1 || jobs.size() <= 1 || toolGlobalParams.useDirectClient) {
+            for (size_t i = 0; i < jobs.size(); i++) {
+                dumpCollection(conn(true), jobs[i],
+                               canSplit(jobs[i].ns, jobs[i].query));
+            }
+            return;
+        }
+
+        // Large collections are split across all the threads one at a time, the rest are
+        // dumped 'numParallel' at a time.
+        vector<const CollectionJob*> small;
+        for (size_t i = 0; i < jobs.size(); i++) {
+            if (canSplit(jobs[i].ns, jobs[i].query) &&
+                    conn(true).count(jobs[i].ns, BSONObj(), QueryOption_SlaveOk) >=
+                            kMinDocsToSplit) {
+                dumpCollection(conn(true), jobs[i], true);
+            }
+            else {
+                small.push_back(&jobs[i]);
+            }
         }
 
+        {
+            ThreadPool pool(numParallel);
+            for (size_t i = 0; i < small.size(); i++) {
+                pool.schedule(&Dump::dumpCollectionInPool, this, small[i]);
+            }
+            pool.join();
+        }
+
+        rethrowFailure();
     }
 
     int repair() {
@@ -381,6 +594,8 @@ public:
             return repair();
         }
 
+        Timer elapsed;
+
         {
             if (mongoDumpGlobalParams.query.size()) {
                 _query = fromjson(mongoDumpGlobalParams.query);
@@ -505,15 +720,28 @@ public:
 
             _query = BSON("ts" << b.obj());
 
-            writeCollectionFile( opLogName , _query, root / "oplog.bson" );
+            writeCollectionFile( conn(true), opLogName , _query, root / "oplog.bson" );
         }
 
+        const double seconds = std::max(elapsed.micros(), 1LL) / 1000000.0;
+        const long long docs = _totals.docs.load();
+        const long long bytes = _totals.bytes.load();
+        toolInfoLog() << "dumped " << docs << ((docs == 1) ? " document" : " documents")
+                      << " (" << bytes / (1024 * 1024) << " MB) in " << seconds << " seconds, "
+                      << docs / seconds << " documents/s, "
+                      << bytes / seconds / (1024 * 1024) << " MB/s" << std::endl;
+
         return 0;
     }
 
     bool _usingMongos;
     int _serverAuthzVersion;
     BSONObj _query;
+    Totals _totals;
+
+    mongo::mutex _failureMutex;
+    int _failureCode;
+    string _failureMsg;
 };
 
 REGISTER_MONGO_TOOL(Dump);
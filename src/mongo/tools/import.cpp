@@ -30,14 +30,19 @@
 
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem/operations.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/thread.hpp>
 #include <fstream>
 #include <iostream>
 
 #include "mongo/base/initializer.h"
 #include "mongo/db/json.h"
 #include "mongo/tools/mongoimport_options.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/functional.h"
 #include "mongo/tools/tool.h"
 #include "mongo/util/options_parser/option_section.h"
+#include "mongo/util/queue.h"
 #include "mongo/util/text.h"
 
 using namespace mongo;
@@ -173,7 +178,7 @@ class Import : public Tool {
 
         try {
             int len = 0;
-            *o = fromjson(buf, &len);
+            *o = fromjsonFast(buf, &len);
             (*numBytesRead) += len;
         } catch ( MsgAssertionException& e ) {
             uasserted(13293, string("Invalid JSON passed to mongoimport: ") + e.what());
@@ -183,13 +188,12 @@ class Import : public Tool {
     }
 
     /*
-     * Parses one object from the input file.  This usually corresponds to one line in the input
-     * file, unless the file is a CSV and contains a newline within a quoted string entry.
-     * Returns a true if a BSONObj was successfully created and false if not.
+     * Reads one record from the input file into 'record'.  This usually corresponds to one line
+     * in the input file, unless the file is a CSV and contains a newline within a quoted string
+     * entry.  Returns false if the line was blank and there is nothing to parse.
      */
-    bool parseRow(istream* in, BSONObj& o, int& numBytesRead) {
-        boost::scoped_array<char> buffer(new char[BUF_SIZE+2]);
-        char* line = buffer.get();
+    bool readRecord(istream* in, string* record, int& numBytesRead) {
+        char* line = _lineBuffer.get();
 
         numBytesRead = getLine(in, line);
         line += numBytesRead;
@@ -199,54 +203,67 @@ class Import : public Tool {
         }
         numBytesRead += strlen( line );
 
+        if (_type != CSV) {
+            record->assign(line);
+            return true;
+        }
+
+        bool inside_quotes = false;
+        size_t last_quote = 0;
+        record->clear();
+        while (true) {
+            string lineStr(line);
+            // Deal with line breaks in quoted strings
+            last_quote = lineStr.find_first_of('"');
+            while (last_quote != string::npos) {
+                inside_quotes = !inside_quotes;
+                last_quote = lineStr.find_first_of('"', last_quote+1);
+            }
+
+            record->append(lineStr);
+
+            if (inside_quotes) {
+                record->append("\n");
+                line = _lineBuffer.get();
+                int num = getLine(in, line);
+                line += num;
+                numBytesRead += num;
+
+                uassert(15854, "CSV file ends while inside quoted field", line[0] != '\0');
+                numBytesRead += strlen( line );
+            } else {
+                break;
+            }
+        }
+        // now 'record' is string corresponding to one row of the CSV file
+        // (which may span multiple lines) and represents one BSONObj
+        return true;
+    }
+
+    /*
+     * Turns one record read by readRecord into a BSONObj.  While the header line is being
+     * parsed its tokens become the field names and 'o' is left empty.  Safe to call from
+     * several insertion workers at once once the header line has been handled.
+     */
+    void parseRecord(const string& record, BSONObj& o) {
         if (_type == JSON) {
             // Strip out trailing whitespace
-            char * end = ( line + strlen( line ) ) - 1;
-            while ( end >= line && isspace(*end) ) {
-                *end = 0;
-                end--;
-            }
+            size_t end = record.find_last_not_of(" \t\n\v\f\r");
+            string line(record, 0, end == string::npos ? 0 : end + 1);
             try {
-                o = fromjson( line );
+                o = fromjsonFast( line.c_str() );
             } catch ( MsgAssertionException& e ) {
                 uasserted(13504, string("BSON representation of supplied JSON is too large: ") + e.what());
             }
-            return true;
+            return;
         }
 
         vector<string> tokens;
         if (_type == CSV) {
-            string row;
-            bool inside_quotes = false;
-            size_t last_quote = 0;
-            while (true) {
-                string lineStr(line);
-                // Deal with line breaks in quoted strings
-                last_quote = lineStr.find_first_of('"');
-                while (last_quote != string::npos) {
-                    inside_quotes = !inside_quotes;
-                    last_quote = lineStr.find_first_of('"', last_quote+1);
-                }
-
-                row.append(lineStr);
-
-                if (inside_quotes) {
-                    row.append("\n");
-                    int num = getLine(in, line);
-                    line += num;
-                    numBytesRead += num;
-
-                    uassert(15854, "CSV file ends while inside quoted field", line[0] != '\0');
-                    numBytesRead += strlen( line );
-                } else {
-                    break;
-                }
-            }
-            // now 'row' is string corresponding to one row of the CSV file
-            // (which may span multiple lines) and represents one BSONObj
-            csvTokenizeRow(row, tokens);
+            csvTokenizeRow(record, tokens);
         }
         else {  // _type == TSV
+            const char* line = record.c_str();
             while (line[0] != '\t' && isspace(line[0])) { // Strip leading whitespace, but not tabs
                 line++;
             }
@@ -278,7 +295,45 @@ class Import : public Tool {
             }
         }
         o = b.obj();
-        return true;
+    }
+
+    /*
+     * A run of consecutive input records handed to one insertion worker.  Line oriented input
+     * is carried unparsed so that parsing happens on the workers; documents from a JSON array
+     * are parsed by the reader and carried in 'docs'.
+     */
+    struct Batch {
+        Batch() : bytes(0) {}
+        vector<string> records;
+        vector<BSONObj> docs;
+        size_t bytes;
+    };
+
+    static const size_t kMaxBatchRecords;
+    static const size_t kMaxBatchBytes;
+
+    bool batchFull(const Batch& batch) const {
+        return batch.records.size() + batch.docs.size() >= kMaxBatchRecords ||
+               batch.bytes >= kMaxBatchBytes;
+    }
+
+    string _ns;
+    boost::scoped_array<char> _lineBuffer;
+
+    // Batches waiting for an insertion worker; a NULL batch tells a worker to exit
+    scoped_ptr< BlockingQueue<Batch*> > _batches;
+    vector<boost::thread*> _workers;
+
+    AtomicUInt32 _stop;
+    AtomicInt64 _errors;
+    AtomicInt64 _imported;
+    AtomicInt64 _lastErrorFailures;
+
+    void recordError() {
+        _errors.addAndFetch(1);
+        if (mongoImportGlobalParams.stopOnError) {
+            _stop.store(1);
+        }
     }
 
 public:
@@ -290,11 +345,9 @@ public:
         printMongoImportHelp(&out);
     }
 
-    unsigned long long lastErrorFailures;
-
     /** @return true if ok */
-    bool checkLastError() { 
-        string s = conn().getLastError();
+    bool checkLastError(DBClientBase& c) {
+        string s = c.getLastError();
         if( !s.empty() ) { 
             if( str::contains(s,"uplicate") ) {
                 // we don't want to return an error from the mongoimport process for
@@ -302,7 +355,7 @@ public:
                 toolInfoLog() << s << endl;
             }
             else {
-                lastErrorFailures++;
+                _lastErrorFailures.addAndFetch(1);
                 toolInfoLog() << "error: " << s << endl;
                 return false;
             }
@@ -310,32 +363,147 @@ public:
         return true;
     }
 
-    void importDocument (const std::string &ns, const BSONObj& o) {
-        bool doUpsert = mongoImportGlobalParams.upsert;
+    /** @return true if the document was upserted, false if it still needs to be inserted */
+    bool upsertDocument(DBClientBase& c, const BSONObj& o) {
         BSONObjBuilder b;
-        if (mongoImportGlobalParams.upsert) {
-            for (vector<string>::const_iterator it = mongoImportGlobalParams.upsertFields.begin(),
-                 end = mongoImportGlobalParams.upsertFields.end(); it != end; ++it) {
-                BSONElement e = o.getFieldDotted(it->c_str());
-                if (e.eoo()) {
-                    doUpsert = false;
+        for (vector<string>::const_iterator it = mongoImportGlobalParams.upsertFields.begin(),
+             end = mongoImportGlobalParams.upsertFields.end(); it != end; ++it) {
+            BSONElement e = o.getFieldDotted(it->c_str());
+            if (e.eoo()) {
+                return false;
+            }
+            b.appendAs(e, *it);
+        }
+
+        c.update(_ns, Query(b.obj()), o, true);
+        return true;
+    }
+
+    /*
+     * Parses the records of 'batch' and sends the documents over 'c', as few multi-document
+     * inserts as the message size allows.  Inserts continue past a failed document unless
+     * --stopOnError was given.  Checks getLastError once the whole batch has been sent.
+     */
+    void importBatch(DBClientBase& c, Batch& batch) {
+        vector<BSONObj>& docs = batch.docs;
+        for (vector<string>::const_iterator it = batch.records.begin();
+             it != batch.records.end(); ++it) {
+            try {
+                BSONObj o;
+                parseRecord(*it, o);
+                docs.push_back(o);
+            }
+            catch ( const std::exception& e ) {
+                toolError() << "exception:" << e.what() << std::endl;
+                recordError();
+                if (mongoImportGlobalParams.stopOnError) {
+                    // Still import the documents that came before the bad one
                     break;
                 }
-                b.appendAs(e, *it);
             }
         }
 
-        if (doUpsert) {
-            conn().update(ns, Query(b.obj()), o, true);
+        if (!mongoImportGlobalParams.doimport || docs.empty()) {
+            _imported.addAndFetch(docs.size());
+            return;
+        }
+
+        const int flags = mongoImportGlobalParams.stopOnError ? 0 : InsertOption_ContinueOnError;
+        vector<BSONObj> toInsert;
+        int toInsertBytes = 0;
+        for (vector<BSONObj>::const_iterator it = docs.begin(); it != docs.end(); ++it) {
+            if (mongoImportGlobalParams.upsert && upsertDocument(c, *it)) {
+                continue;
+            }
+            if (!toInsert.empty() && toInsertBytes + it->objsize() > BSONObjMaxUserSize) {
+                c.insert(_ns, toInsert, flags);
+                toInsert.clear();
+                toInsertBytes = 0;
+            }
+            toInsert.push_back(*it);
+            toInsertBytes += it->objsize();
+        }
+        if (!toInsert.empty()) {
+            c.insert(_ns, toInsert, flags);
+        }
+        _imported.addAndFetch(docs.size());
+
+        // Waits for the batch to reach the server and be processed, and reports an error on
+        // its last write
+        if (!checkLastError(c) && mongoImportGlobalParams.stopOnError) {
+            _stop.store(1);
+        }
+    }
+
+    void importBatchAndReport(DBClientBase& c, Batch* batch) {
+        scoped_ptr<Batch> owned(batch);
+        try {
+            importBatch(c, *batch);
+        }
+        catch ( const std::exception& e ) {
+            toolError() << "exception:" << e.what() << std::endl;
+            recordError();
+        }
+    }
+
+    // Body of an insertion worker thread, with a connection of its own
+    void insertionWorker() {
+        scoped_ptr<DBClientBase> c;
+        try {
+            c.reset(newConnection());
+        }
+        catch ( const std::exception& e ) {
+            toolError() << "insertion worker couldn't connect: " << e.what() << std::endl;
+            _errors.addAndFetch(1);
+            _stop.store(1);
+        }
+
+        while (Batch* batch = _batches->blockingPop()) {
+            if (!c || _stop.load()) {
+                // Keep draining so the reader never blocks on a full queue
+                delete batch;
+                continue;
+            }
+            importBatchAndReport(*c, batch);
+        }
+    }
+
+    void startWorkers() {
+        // The direct client can only be used from the thread that opened the database
+        if (mongoImportGlobalParams.numInsertionWorkers <= 1 || toolGlobalParams.useDirectClient) {
+            return;
+        }
+        _batches.reset(new BlockingQueue<Batch*>(2 * mongoImportGlobalParams.numInsertionWorkers));
+        for (int i = 0; i < mongoImportGlobalParams.numInsertionWorkers; i++) {
+            _workers.push_back(new boost::thread(stdx::bind(&Import::insertionWorker, this)));
+        }
+    }
+
+    void dispatch(Batch* batch) {
+        if (_stop.load()) {
+            delete batch;
+        }
+        else if (_workers.empty()) {
+            importBatchAndReport(conn(), batch);
         }
         else {
-            conn().insert(ns.c_str(), o);
+            _batches->push(batch);
+        }
+    }
+
+    void stopWorkers() {
+        for (size_t i = 0; i < _workers.size(); i++) {
+            _batches->push(NULL);
+        }
+        for (size_t i = 0; i < _workers.size(); i++) {
+            _workers[i]->join();
+            delete _workers[i];
         }
+        _workers.clear();
     }
 
     int run() {
         long long fileSize = 0;
-        int headerRows = 0;
 
         istream * in = &cin;
 
@@ -404,29 +572,25 @@ public:
         }
 
         if (_type == CSV || _type == TSV) {
-            if (mongoImportGlobalParams.headerLine) {
-                headerRows = 1;
-            }
-            else {
-                if (!toolGlobalParams.fieldsSpecified) {
-                    throw UserException(9998, "You need to specify fields or have a headerline to "
-                                              "import this file type");
-                }
+            if (!mongoImportGlobalParams.headerLine && !toolGlobalParams.fieldsSpecified) {
+                throw UserException(9998, "You need to specify fields or have a headerline to "
+                                          "import this file type");
             }
         }
 
 
+        _ns = ns;
         time_t start = time(0);
         if (logger::globalLogDomain()->shouldLog(logger::LogSeverity::Debug(1))) {
             toolInfoLog() << "filesize: " << fileSize << endl;
         }
         ProgressMeter pm( fileSize );
         int num = 0;
-        int lastNumChecked = num;
-        int errors = 0;
-        lastErrorFailures = 0;
         int len = 0;
 
+        startWorkers();
+        Batch* batch = new Batch();
+
         // We have to handle jsonArrays differently since we can't read line by line
         if (_type == JSON && mongoImportGlobalParams.jsonArray) {
 
@@ -450,7 +614,7 @@ public:
             // Record how far we read into the stream.
             input_stream_offset += in->gcount();
 
-            while (true) {
+            while (!_stop.load()) {
                 try {
 
                     BSONObj o;
@@ -460,16 +624,11 @@ public:
                         break;
                     }
 
-                    // Import documents
-                    if (mongoImportGlobalParams.doimport) {
-                        importDocument(ns, o);
-
-                        if (num < 10) {
-                            // we absolutely want to check the first and last op of the batch. we do
-                            // a few more as that won't be too time expensive.
-                            checkLastError();
-                            lastNumChecked = num;
-                        }
+                    batch->docs.push_back(o);
+                    batch->bytes += len;
+                    if (batchFull(*batch)) {
+                        dispatch(batch);
+                        batch = new Batch();
                     }
 
                     // Copy over the part of buffer that was not parsed
@@ -500,7 +659,7 @@ public:
                 catch ( const std::exception& e ) {
                     toolError() << "exception: " << e.what()
                               << ", current buffer: " << current_buffer << std::endl;
-                    errors++;
+                    _errors.addAndFetch(1);
 
                     // Since we only support JSON arrays all on one line, we might as well stop now
                     // because we can't read any more documents
@@ -516,25 +675,28 @@ public:
             }
         }
         else {
-            while (in->rdstate() == 0) {
+            _lineBuffer.reset(new char[BUF_SIZE+2]);
+            while (in->rdstate() == 0 && !_stop.load()) {
                 try {
-                    BSONObj o;
+                    string record;
 
-                    if (!parseRow(in, o, len)) {
+                    if (!readRecord(in, &record, len)) {
                         continue;
                     }
 
                     if (mongoImportGlobalParams.headerLine) {
+                        // The field names have to be known before any worker parses a row
+                        BSONObj header;
+                        parseRecord(record, header);
                         mongoImportGlobalParams.headerLine = false;
                     }
-                    else if (mongoImportGlobalParams.doimport) {
-                        importDocument(ns, o);
-
-                        if (num < 10) {
-                            // we absolutely want to check the first and last op of the batch. we do
-                            // a few more as that won't be too time expensive.
-                            checkLastError();
-                            lastNumChecked = num;
+                    else {
+                        batch->bytes += record.size();
+                        batch->records.push_back(string());
+                        batch->records.back().swap(record);
+                        if (batchFull(*batch)) {
+                            dispatch(batch);
+                            batch = new Batch();
                         }
                     }
 
@@ -542,10 +704,7 @@ public:
                 }
                 catch ( const std::exception& e ) {
                     toolError() << "exception:" << e.what() << std::endl;
-                    errors++;
-
-                    if (mongoImportGlobalParams.stopOnError)
-                        break;
+                    recordError();
                 }
 
                 if (!toolGlobalParams.quiet) {
@@ -557,20 +716,21 @@ public:
             }
         }
 
-        // this is for two reasons: to wait for all operations to reach the server and be processed, and this will wait until all data reaches the server,
-        // and secondly to check if there were an error (on the last op)
-        if( lastNumChecked+1 != num ) { // avoid redundant log message if already reported above
-            toolInfoLog() << "check " << lastNumChecked << " " << num << endl;
-            checkLastError();
-        }
+        // Every batch checks getLastError once it has been sent, so once the workers are done
+        // all the documents have reached the server and been processed
+        dispatch(batch);
+        stopWorkers();
 
+        long long imported = _imported.load();
+        long long errors = _errors.load();
+        long long lastErrorFailures = _lastErrorFailures.load();
         bool hadErrors = lastErrorFailures || errors;
 
         // the message is vague on lastErrorFailures as we don't call it on every single operation. 
         // so if we have a lastErrorFailure there might be more than just what has been counted.
         toolInfoLog() << (lastErrorFailures ? "tried to import " : "imported ")
-                      << (num - headerRows)
-                      << (((num - headerRows) == 1) ? " document" : " documents")
+                      << imported
+                      << ((imported == 1) ? " document" : " documents")
                       << std::endl;
 
         if ( !hadErrors )
@@ -584,5 +744,7 @@ public:
 };
 
 const int Import::BUF_SIZE(1024 * 1024 * 16);
+const size_t Import::kMaxBatchRecords(1000);
+const size_t Import::kMaxBatchBytes(1024 * 1024 * 4);
 
 REGISTER_MONGO_TOOL(Import);
@@ -76,6 +76,12 @@ namespace mongo {
                 "Dump user and role definitions for the given database")
                         .requires("db").incompatibleWith("collection");
 
+        options->addOptionChaining("numParallelCollections", "numParallelCollections,j", moe::Int,
+                "number of collections to dump in parallel, each over its own connection; "
+                "also the number of cursors a large collection is read with when "
+                "--forceTableScan is used")
+                                  .setDefault(moe::Value(4));
+
         return Status::OK();
     }
 
@@ -122,6 +128,10 @@ namespace mongo {
             }
         }
         mongoDumpGlobalParams.outputDirectory = getParam("out");
+        mongoDumpGlobalParams.numParallelCollections = getParam("numParallelCollections", 4);
+        if (mongoDumpGlobalParams.numParallelCollections < 1) {
+            return Status(ErrorCodes::BadValue, "numParallelCollections must be at least 1");
+        }
         mongoDumpGlobalParams.snapShotQuery = false;
         if (!hasParam("query") && !hasParam("dbpath") && !hasParam("forceTableScan")) {
             mongoDumpGlobalParams.snapShotQuery = true;
@@ -90,6 +90,16 @@ namespace mongo {
         options->addOptionChaining("jsonArray", "jsonArray", moe::Switch,
                 "load a json array, not one item per line. Currently limited to 16MB.");
 
+        options->addOptionChaining("numInsertionWorkers", "numInsertionWorkers,j", moe::Int,
+                "number of threads parsing and inserting documents, each over its own "
+                "connection. ignored with --upsert or --upsertFields, which use one thread so "
+                "that the last line with a given key always wins")
+                                  .setDefault(moe::Value(1));
+
+        options->addOptionChaining("maintainInsertionOrder", "maintainInsertionOrder",
+                moe::Switch,
+                "insert documents in the order they appear in the input; implies "
+                "--numInsertionWorkers 1");
 
         options->addOptionChaining("noimport", "noimport", moe::Switch,
                 "don't actually import. useful for benchmarking parser")
@@ -155,6 +165,16 @@ namespace mongo {
         mongoImportGlobalParams.jsonArray = hasParam("jsonArray");
         mongoImportGlobalParams.headerLine = hasParam("headerline");
         mongoImportGlobalParams.stopOnError = hasParam("stopOnError");
+        mongoImportGlobalParams.maintainInsertionOrder = hasParam("maintainInsertionOrder");
+        mongoImportGlobalParams.numInsertionWorkers = getParam("numInsertionWorkers", 1);
+        if (mongoImportGlobalParams.numInsertionWorkers < 1) {
+            return Status(ErrorCodes::BadValue, "numInsertionWorkers must be at least 1");
+        }
+        // Workers send their batches in any order, so upserts of the same key from different
+        // batches could be applied out of order.
+        if (mongoImportGlobalParams.maintainInsertionOrder || mongoImportGlobalParams.upsert) {
+            mongoImportGlobalParams.numInsertionWorkers = 1;
+        }
 
         return Status::OK();
     }
@@ -48,6 +48,8 @@ namespace mongo {
         bool stopOnError;
         bool jsonArray;
         bool doimport;
+        int numInsertionWorkers;
+        bool maintainInsertionOrder;
     };
 
     extern MongoImportGlobalParams mongoImportGlobalParams;
@@ -103,6 +103,10 @@ namespace mongo {
         options->addOptionChaining("w", "w", moe::Int, "minimum number of replicas per write")
                                   .setDefault(moe::Value(0));
 
+        options->addOptionChaining("numParallelCollections", "numParallelCollections,j", moe::Int,
+                "number of collections to restore in parallel, each over its own connection")
+                                  .setDefault(moe::Value(4));
+
         options->addOptionChaining("dir", "dir", moe::String, "directory to restore from")
                                   .hidden()
                                   .setDefault(moe::Value(std::string("dump")))
@@ -155,6 +159,10 @@ namespace mongo {
         mongoRestoreGlobalParams.restoreOptions = !hasParam("noOptionsRestore");
         mongoRestoreGlobalParams.restoreIndexes = !hasParam("noIndexRestore");
         mongoRestoreGlobalParams.w = getParam( "w" , 0 );
+        mongoRestoreGlobalParams.numParallelCollections = getParam("numParallelCollections", 4);
+        if (mongoRestoreGlobalParams.numParallelCollections < 1) {
+            return Status(ErrorCodes::BadValue, "numParallelCollections must be at least 1");
+        }
         mongoRestoreGlobalParams.oplogReplay = hasParam("oplogReplay");
         mongoRestoreGlobalParams.oplogLimit = getParam("oplogLimit", "");
         mongoRestoreGlobalParams.tempUsersColl = getParam("tempUsersCollection");
@@ -49,6 +49,7 @@ namespace mongo {
         std::string restoreDirectory;
         std::string tempUsersColl;
         std::string tempRolesColl;
+        int numParallelCollections;
     };
 
     extern MongoRestoreGlobalParams mongoRestoreGlobalParams;
@@ -47,16 +47,82 @@
 #include "mongo/db/auth/role_name.h"
 #include "mongo/db/json.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/tools/mongorestore_options.h"
 #include "mongo/tools/tool.h"
+#include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/mmap.h"
 #include "mongo/util/options_parser/option_section.h"
 #include "mongo/util/stringutils.h"
+#include "mongo/util/timer.h"
 
 using namespace mongo;
 
 namespace {
     const char* OPLOG_SENTINEL = "$oplog";  // compare by ptr not strcmp
+
+    // Limits on the documents sent to the server in one insert message
+    const size_t kMaxBatchDocs = 1000;
+    const size_t kMaxBatchBytes = 16 * 1024 * 1024;
+
+    // Running totals for the throughput summary, shared by all threads
+    struct Totals {
+        AtomicInt64 docs;
+        AtomicInt64 bytes;
+    };
+
+    /**
+     * Inserts documents into one collection a batch at a time.  Like the one-at-a-time inserts
+     * it replaces, it keeps going past documents the server refuses.
+     */
+    class BatchInserter {
+        MONGO_DISALLOW_COPYING(BatchInserter);
+    public:
+        BatchInserter(DBClientBase* conn, const string& ns, Totals* totals)
+            : _conn(conn), _ns(ns), _totals(totals), _bytes(0) {
+            _batch.reserve(kMaxBatchDocs);
+        }
+
+        void add(const BSONObj& obj) {
+            // 'obj' points into the file reader's buffer, which gets reused
+            _batch.push_back(obj.getOwned());
+            _bytes += obj.objsize();
+            if (_batch.size() >= kMaxBatchDocs || _bytes >= kMaxBatchBytes) {
+                flush();
+            }
+        }
+
+        void flush() {
+            if (_batch.empty()) {
+                return;
+            }
+
+            _conn->insert(_ns, _batch, InsertOption_ContinueOnError);
+
+            // wait for the batch to propagate to "w" nodes (doesn't warn if w used without
+            // replset)
+            if (mongoRestoreGlobalParams.w > 0) {
+                string err = _conn->getLastError(nsToDatabase(_ns), false, false,
+                                                 mongoRestoreGlobalParams.w);
+                if (!err.empty()) {
+                    toolError() << err << std::endl;
+                }
+            }
+
+            _totals->docs.addAndFetch(_batch.size());
+            _totals->bytes.addAndFetch(_bytes);
+            _batch.clear();
+            _bytes = 0;
+        }
+
+    private:
+        DBClientBase* const _conn;
+        const string _ns;
+        Totals* const _totals;
+        vector<BSONObj> _batch;
+        size_t _bytes;
+    };
 }
 
 MONGO_INITIALIZER_WITH_PREREQUISITES(RestoreAuthExternalState, ("ToolMocks"))(
@@ -86,8 +152,21 @@ public:
     int _serverAuthzVersion; // authSchemaVersion of the cluster being restored into.
     int _dumpFileAuthzVersion; // version extracted from admin.system.version file in dump.
     bool _serverAuthzVersionDocExists; // Whether the remote cluster has an admin.system.version doc
+
+    // Ordinary collections are loaded on these threads, each over its own connection, when
+    // restoring more than one collection at a time.
+    scoped_ptr<ThreadPool> _loaders;
+    Totals _totals;
+
+    // Guards the members below, which the loader threads share with the main thread
+    mongo::mutex _mutex;
+    vector<BSONObj> _deferredIndexes; // built once all the data is loaded
+    int _failureCode; // first error a loader thread hit, rethrown on the main thread
+    string _failureMsg;
+
     Restore() : BSONTool(), _oplogEntrySkips(0), _oplogEntryApplies(0), _serverAuthzVersion(0),
-            _dumpFileAuthzVersion(0), _serverAuthzVersionDocExists(false) { }
+            _dumpFileAuthzVersion(0), _serverAuthzVersionDocExists(false),
+            _mutex("restore"), _failureCode(0) { }
 
     virtual void printHelp(ostream& out) {
         printMongoRestoreHelp(&out);
@@ -114,6 +193,7 @@ public:
     virtual int doRun() {
 
         boost::filesystem::path root = mongoRestoreGlobalParams.restoreDirectory;
+        Timer elapsed;
 
         // check if we're actually talking to a machine that can write
         if (!isMaster()) {
@@ -281,9 +361,30 @@ public:
          * given either a root directory that contains only a single
          * .bson file, or a single .bson file itself (a collection).
          */
+        if (mongoRestoreGlobalParams.numParallelCollections > 1 &&
+                !toolGlobalParams.useDirectClient) {
+            _loaders.reset(new ThreadPool(mongoRestoreGlobalParams.numParallelCollections));
+        }
+
         drillDown(root, toolGlobalParams.db != "", toolGlobalParams.coll != "",
                   !(_oplogLimitTS.get() == NULL), true);
 
+        if (_loaders) {
+            _loaders->join();
+            _loaders.reset();
+        }
+        rethrowFailure();
+
+        buildDeferredIndexes();
+
+        const double seconds = std::max(elapsed.micros(), 1LL) / 1000000.0;
+        const long long docs = _totals.docs.load();
+        const long long bytes = _totals.bytes.load();
+        toolInfoLog() << "restored " << docs << ((docs == 1) ? " document" : " documents")
+                      << " (" << bytes / (1024 * 1024) << " MB) in " << seconds << " seconds, "
+                      << docs / seconds << " documents/s, "
+                      << bytes / seconds / (1024 * 1024) << " MB/s" << std::endl;
+
         // should this happen for oplog replay as well?
         string err = conn().getLastError(toolGlobalParams.db == "" ? "admin" : toolGlobalParams.db);
         if (!err.empty()) {
@@ -427,6 +528,9 @@ public:
     }
 
     /**
+     * Ordinary collections are handed to loadCollection, on a loader thread if there are any.
+     * System collections are restored here, one document at a time:
+     *
      * 1) Drop collection if --drop was specified.  For system.users or system.roles collections,
      * however, you don't want to remove all the users/roles up front as some of them may be needed
      * by the restore.  Instead, keep a set of all the users/roles originally in the server, then
@@ -442,7 +546,7 @@ public:
      * will contain users and roles that were in the collection but not in the dump we are
      * restoring. Iterate these sets and delete any users and roles that are there.
      *
-     * 5) Restore indexes based on index definitions from the metadata file.
+     * 5) Queue the indexes from the metadata file to be built once all the data is loaded.
      */
     void processFileAndMetadata(const boost::filesystem::path& root, const std::string& ns) {
 
@@ -452,6 +556,16 @@ public:
 
         toolInfoLog() << "\tgoing into namespace [" << _curns << "]" << std::endl;
 
+        if (!startsWith(_curcoll, "system.")) {
+            if (_loaders) {
+                _loaders->schedule(&Restore::loadCollectionInPool, this, root, ns);
+            }
+            else {
+                loadCollection(conn(), root, ns);
+            }
+            return;
+        }
+
         // 1) Drop collection if needed.  Save user and role data if this is a system.users or
         // system.roles collection
         if (mongoRestoreGlobalParams.drop) {
@@ -474,42 +588,17 @@ public:
                     }
                 }
             }
-            else if (!startsWith(_curcoll, "system.")) { // Can't drop system collections
-                toolInfoLog() << "\t dropping" << std::endl;
-                conn().dropCollection( ns );
-            }
+            // Can't drop other system collections
         } else {
-            // If drop is not used, warn if the collection exists.
-            scoped_ptr<DBClientCursor> cursor(conn().query(_curdb + ".system.namespaces",
-                                                           Query(BSON("name" << ns))));
-            if (cursor->more()) {
-                // collection already exists show warning
-                toolError() << "Restoring to " << ns << " without dropping. Restored data "
-                        << "will be inserted without raising errors; check your server log"
-                        << std::endl;
-            }
+            warnIfExists(conn(), ns);
         }
 
         // 2) Create collection with options from metadata file if present
-        BSONObj metadataObject;
-        if (mongoRestoreGlobalParams.restoreOptions || mongoRestoreGlobalParams.restoreIndexes) {
-            string oldCollName = root.leaf().string(); // Name of collection that was dumped from
-            oldCollName = oldCollName.substr( 0 , oldCollName.find_last_of( "." ) );
-            boost::filesystem::path metadataFile = (root.branch_path() / (oldCollName + ".metadata.json"));
-            if (!boost::filesystem::exists(metadataFile.string())) {
-                // This is fine because dumps from before 2.1 won't have a metadata file, just print a warning.
-                // System collections shouldn't have metadata so don't warn if that file is missing.
-                if (!startsWith(metadataFile.leaf().string(), "system.")) {
-                    toolInfoLog() << metadataFile.string() << " not found. Skipping." << std::endl;
-                }
-            } else {
-                metadataObject = parseMetadataFile(metadataFile.string());
-            }
-        }
+        BSONObj metadataObject = readMetadata(root);
 
         if (mongoRestoreGlobalParams.restoreOptions && metadataObject.hasField("options")) {
             // Try to create collection with given options
-            createCollectionWithOptions(metadataObject["options"].Obj());
+            createCollectionWithOptions(conn(), _curns, metadataObject["options"].Obj());
         }
 
         // 3) Actually restore the BSONObjs inside the dump file
@@ -576,12 +665,47 @@ public:
             conn().dropCollection(mongoRestoreGlobalParams.tempRolesColl);
         }
 
-        // 5) Restore indexes
-        if (mongoRestoreGlobalParams.restoreIndexes && metadataObject.hasField("indexes")) {
-            vector<BSONElement> indexes = metadataObject["indexes"].Array();
-            for (vector<BSONElement>::iterator it = indexes.begin(); it != indexes.end(); ++it) {
-                createIndex((*it).Obj(), false);
-            }
+        // 5) Queue indexes
+        deferIndexes(_curns, metadataObject);
+    }
+
+    /**
+     * Restores an ordinary collection over 'c': drops it if --drop was specified, creates it
+     * with the options from the metadata file, inserts the documents from the dump file in
+     * batches and queues its indexes to be built once all the data is loaded.
+     */
+    void loadCollection(DBClientBase& c, const boost::filesystem::path& root, const string& ns) {
+        if (mongoRestoreGlobalParams.drop) {
+            toolInfoLog() << "\t dropping " << ns << std::endl;
+            c.dropCollection(ns);
+        }
+        else {
+            warnIfExists(c, ns);
+        }
+
+        BSONObj metadataObject = readMetadata(root);
+        if (mongoRestoreGlobalParams.restoreOptions && metadataObject.hasField("options")) {
+            createCollectionWithOptions(c, ns, metadataObject["options"].Obj());
+        }
+
+        BatchInserter inserter(&c, ns, &_totals);
+        processFile(root, stdx::bind(&BatchInserter::add, &inserter, stdx::placeholders::_1));
+        inserter.flush();
+
+        deferIndexes(ns, metadataObject);
+    }
+
+    // Runs on a loader thread, with a connection of its own
+    void loadCollectionInPool(const boost::filesystem::path& root, const string& ns) {
+        try {
+            scoped_ptr<DBClientBase> c(newConnection());
+            loadCollection(*c, root, ns);
+        }
+        catch (const DBException& e) {
+            recordFailure(e.getCode(), e.what());
+        }
+        catch (const std::exception& e) {
+            recordFailure(17518, e.what());
         }
     }
 
@@ -615,7 +739,7 @@ public:
         }
 
         if (nsToCollectionSubstring(_curns) == "system.indexes") {
-            createIndex(obj, true);
+            deferIndex(indexSpecFor(_curns, obj, true));
         }
         else if (_curns == "admin.system.roles") {
             // To prevent modifying roles when other role modifications may be going on, restore
@@ -718,6 +842,8 @@ public:
                     _serverAuthzVersion == _dumpFileAuthzVersion);
             }
             conn().insert(_curns, obj);
+            _totals.docs.addAndFetch(1);
+            _totals.bytes.addAndFetch(obj.objsize());
         }
 
         // wait for insert (or update) to propagate to "w" nodes (doesn't warn if w used
@@ -732,6 +858,85 @@ public:
 
 private:
 
+    void warnIfExists(DBClientBase& c, const string& ns) {
+        // If drop is not used, warn if the collection exists.
+        scoped_ptr<DBClientCursor> cursor(c.query(nsToDatabase(ns) + ".system.namespaces",
+                                                  Query(BSON("name" << ns))));
+        if (cursor->more()) {
+            // collection already exists show warning
+            toolError() << "Restoring to " << ns << " without dropping. Restored data "
+                    << "will be inserted without raising errors; check your server log"
+                    << std::endl;
+        }
+    }
+
+    // Returns the contents of the metadata file for the dump file 'root', if it's needed and
+    // present, or an empty object.
+    BSONObj readMetadata(const boost::filesystem::path& root) {
+        if (!mongoRestoreGlobalParams.restoreOptions && !mongoRestoreGlobalParams.restoreIndexes) {
+            return BSONObj();
+        }
+
+        string oldCollName = root.leaf().string(); // Name of collection that was dumped from
+        oldCollName = oldCollName.substr( 0 , oldCollName.find_last_of( "." ) );
+        boost::filesystem::path metadataFile = (root.branch_path() / (oldCollName + ".metadata.json"));
+        if (!boost::filesystem::exists(metadataFile.string())) {
+            // This is fine because dumps from before 2.1 won't have a metadata file, just print a warning.
+            // System collections shouldn't have metadata so don't warn if that file is missing.
+            if (!startsWith(metadataFile.leaf().string(), "system.")) {
+                toolInfoLog() << metadataFile.string() << " not found. Skipping." << std::endl;
+            }
+            return BSONObj();
+        }
+        return parseMetadataFile(metadataFile.string());
+    }
+
+    void deferIndexes(const string& ns, const BSONObj& metadataObject) {
+        if (mongoRestoreGlobalParams.restoreIndexes && metadataObject.hasField("indexes")) {
+            vector<BSONElement> indexes = metadataObject["indexes"].Array();
+            for (vector<BSONElement>::iterator it = indexes.begin(); it != indexes.end(); ++it) {
+                deferIndex(indexSpecFor(ns, (*it).Obj(), false));
+            }
+        }
+    }
+
+    void deferIndex(const BSONObj& spec) {
+        scoped_lock lk(_mutex);
+        _deferredIndexes.push_back(spec.getOwned());
+    }
+
+    // Builds the queued indexes, now that no more data is coming
+    void buildDeferredIndexes() {
+        if (_deferredIndexes.empty()) {
+            return;
+        }
+
+        Timer t;
+        toolInfoLog() << "building " << _deferredIndexes.size() << " indexes" << std::endl;
+        for (size_t i = 0; i < _deferredIndexes.size(); i++) {
+            createIndex(_deferredIndexes[i]);
+        }
+        toolInfoLog() << "built " << _deferredIndexes.size() << " indexes in " << t.seconds()
+                      << " seconds" << std::endl;
+        _deferredIndexes.clear();
+    }
+
+    // Loader threads report the first error they hit here, to be rethrown on the main thread
+    void recordFailure(int code, const string& msg) {
+        scoped_lock lk(_mutex);
+        if (_failureCode == 0) {
+            _failureCode = code;
+            _failureMsg = msg;
+        }
+    }
+
+    void rethrowFailure() {
+        scoped_lock lk(_mutex);
+        if (_failureCode != 0) {
+            uasserted(_failureCode, _failureMsg);
+        }
+    }
+
     BSONObj parseMetadataFile(string filePath) {
         long long fileSize = boost::filesystem::file_size(filePath);
         ifstream file(filePath.c_str(), ios_base::in);
@@ -766,14 +971,16 @@ private:
         return nfields == obj2.nFields();
     }
 
-    void createCollectionWithOptions(BSONObj obj) {
+    void createCollectionWithOptions(DBClientBase& c, const string& ns, BSONObj obj) {
+        const string db = nsToDatabase(ns);
+        const string coll = nsToCollectionSubstring(ns).toString();
         BSONObjIterator i(obj);
 
         // Rebuild obj as a command object for the "create" command.
         // - {create: <name>} comes first, where <name> is the new name for the collection
         // - elements with type Undefined get skipped over
         BSONObjBuilder bo;
-        bo.append("create", _curcoll);
+        bo.append("create", coll);
         while (i.more()) {
             BSONElement e = i.next();
 
@@ -782,7 +989,7 @@ private:
             }
 
             if (e.type() == Undefined) {
-                toolInfoLog() << _curns << ": skipping undefined field: " << e.fieldName()
+                toolInfoLog() << ns << ": skipping undefined field: " << e.fieldName()
                               << std::endl;
                 continue;
             }
@@ -792,14 +999,14 @@ private:
         obj = bo.obj();
 
         BSONObj fields = BSON("options" << 1);
-        scoped_ptr<DBClientCursor> cursor(conn().query(_curdb + ".system.namespaces", Query(BSON("name" << _curns)), 0, 0, &fields));
+        scoped_ptr<DBClientCursor> cursor(c.query(db + ".system.namespaces", Query(BSON("name" << ns)), 0, 0, &fields));
 
         bool createColl = true;
         if (cursor->more()) {
             createColl = false;
             BSONObj nsObj = cursor->next();
             if (!nsObj.hasField("options") || !optionsSame(obj, nsObj["options"].Obj())) {
-                toolError() << "WARNING: collection " << _curns
+                toolError() << "WARNING: collection " << ns
                           << " exists with different options than are in the metadata.json file and"
                           << " not using --drop. Options in the metadata file will be ignored."
                           << std::endl;
@@ -811,25 +1018,28 @@ private:
         }
 
         BSONObj info;
-        if (!conn().runCommand(_curdb, obj, info)) {
-            uasserted(15936, "Creating collection " + _curns + " failed. Errmsg: " + info["errmsg"].String());
+        if (!c.runCommand(db, obj, info)) {
+            uasserted(15936, "Creating collection " + ns + " failed. Errmsg: " + info["errmsg"].String());
         } else {
-            toolInfoLog() << "\tCreated collection " << _curns << " with options: "
+            toolInfoLog() << "\tCreated collection " << ns << " with options: "
                           << obj.jsonString() << std::endl;
         }
     }
 
     /* We must handle if the dbname or collection name is different at restore time than what was dumped.
-       If keepCollName is true, however, we keep the same collection name that's in the index object.
+       The index goes on 'ns', or if keepCollName is true, on the collection named in the index
+       object in the database of 'ns'.
      */
-    void createIndex(BSONObj indexObj, bool keepCollName) {
+    BSONObj indexSpecFor(const string& ns, BSONObj indexObj, bool keepCollName) {
+        const string db = nsToDatabase(ns);
         BSONObjBuilder bo;
         BSONObjIterator i(indexObj);
         while ( i.more() ) {
             BSONElement e = i.next();
             if (strcmp(e.fieldName(), "ns") == 0) {
                 NamespaceString n(e.String());
-                string s = _curdb + "." + (keepCollName ? n.coll().toString() : _curcoll);
+                string s = db + "." + (keepCollName ? n.coll().toString()
+                                                    : nsToCollectionSubstring(ns).toString());
                 bo.append("ns", s);
             }
             // Remove index version number
@@ -837,14 +1047,18 @@ private:
                 bo.append(e);
             }
         }
-        BSONObj o = bo.obj();
+        return bo.obj();
+    }
+
+    void createIndex(const BSONObj& o) {
+        const string db = nsToDatabase(o["ns"].String());
         if (logger::globalLogDomain()->shouldLog(logger::LogSeverity::Debug(0))) {
             toolInfoLog() << "\tCreating index: " << o << std::endl;
         }
-        conn().insert( _curdb + ".system.indexes" ,  o );
+        conn().insert( db + ".system.indexes" ,  o );
 
         // We're stricter about errors for indexes than for regular data
-        BSONObj err = conn().getLastErrorDetailed(_curdb, false, false, mongoRestoreGlobalParams.w);
+        BSONObj err = conn().getLastErrorDetailed(db, false, false, mongoRestoreGlobalParams.w);
 
         if (err.hasField("err") && !err["err"].isNull()) {
             if (err["err"].str() == "norepl" && mongoRestoreGlobalParams.w > 1) {
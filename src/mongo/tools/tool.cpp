@@ -147,7 +147,7 @@ namespace mongo {
         int ret = -1;
         try {
             if (!toolGlobalParams.useDirectClient && !toolGlobalParams.noconnection)
-                auth();
+                auth(_conn);
             ret = run();
         }
         catch ( DBException& e ) {
@@ -204,6 +204,26 @@ namespace mongo {
         return *_conn;
     }
 
+    DBClientBase* Tool::newConnection() {
+        if (toolGlobalParams.useDirectClient || toolGlobalParams.noconnection) {
+            return NULL;
+        }
+
+        string errmsg;
+        ConnectionString cs = ConnectionString::parse(toolGlobalParams.connectionString, errmsg);
+        uassert(17514, str::stream() << "invalid hostname [" << toolGlobalParams.connectionString
+                                     << "] " << errmsg,
+                cs.isValid());
+
+        auto_ptr<DBClientBase> c(cs.connect(errmsg));
+        uassert(17515, str::stream() << "couldn't connect to ["
+                                     << toolGlobalParams.connectionString << "] " << errmsg,
+                c.get());
+
+        auth(c.get());
+        return c.release();
+    }
+
     bool Tool::isMaster() {
         if (toolGlobalParams.useDirectClient) {
             return true;
@@ -245,14 +265,14 @@ namespace mongo {
     /**
      * Validate authentication on the server for the given dbname.
      */
-    void Tool::auth() {
+    void Tool::auth( DBClientBase* conn ) {
 
         if (toolGlobalParams.username.empty()) {
             // Make sure that we don't need authentication to connect to this db
             // findOne throws an AssertionException if it's not authenticated.
             if (toolGlobalParams.coll.size() > 0) {
                 // BSONTools don't have a collection
-                conn().findOne(getNS(), Query("{}"), 0, QueryOption_SlaveOk);
+                conn->findOne(getNS(), Query("{}"), 0, QueryOption_SlaveOk);
             }
 
             return;
@@ -274,7 +294,7 @@ namespace mongo {
             authParams << saslCommandServiceHostnameFieldName << toolGlobalParams.gssapiHostName;
         }
 
-        _conn->auth(authParams.obj());
+        conn->auth(authParams.obj());
     }
 
     BSONTool::BSONTool() : Tool() { }
@@ -290,6 +310,11 @@ namespace mongo {
     }
 
     long long BSONTool::processFile( const boost::filesystem::path& root ) {
+        return processFile(root, stdx::bind(&BSONTool::gotObject, this, stdx::placeholders::_1));
+    }
+
+    long long BSONTool::processFile( const boost::filesystem::path& root,
+                                     const stdx::function<void (const BSONObj&)>& sink ) {
         std::string fileName = root.string();
 
         unsigned long long fileLength = file_size( root );
@@ -360,7 +385,7 @@ namespace mongo {
             }
 
             if (!bsonToolGlobalParams.hasFilter || _matcher->matches(o)) {
-                gotObject( o );
+                sink( o );
                 processed++;
             }
 
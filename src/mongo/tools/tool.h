@@ -38,6 +38,7 @@
 
 #include "mongo/db/instance.h"
 #include "mongo/db/matcher/matcher.h"
+#include "mongo/stdx/functional.h"
 #include "mongo/tools/tool_logger.h"
 #include "mongo/tools/tool_options.h"
 #include "mongo/util/options_parser/environment.h"
@@ -76,6 +77,14 @@ namespace mongo {
 
         mongo::DBClientBase &conn( bool slaveIfPaired = false );
 
+        /**
+         * Opens another connection to the same server(s) as conn() and authenticates it the
+         * same way, for tools that work on several collections at once.  The caller owns the
+         * result.  Returns NULL if the tool isn't talking to a remote server (e.g. --dbpath),
+         * in which case callers should stick to conn().
+         */
+        mongo::DBClientBase* newConnection();
+
         bool _autoreconnect;
 
     protected:
@@ -84,7 +93,7 @@ namespace mongo {
         mongo::DBClientBase * _slaveConn;
 
     private:
-        void auth();
+        void auth( mongo::DBClientBase* conn );
     };
 
     class BSONTool : public Tool {
@@ -100,6 +109,13 @@ namespace mongo {
 
         long long processFile( const boost::filesystem::path& file );
 
+        /**
+         * Like processFile, but hands each object to 'sink' instead of gotObject.  The object
+         * is only valid during the call.  Safe to call from several threads at once.
+         */
+        long long processFile( const boost::filesystem::path& file,
+                               const stdx::function<void (const BSONObj&)>& sink );
+
     };
 
 }
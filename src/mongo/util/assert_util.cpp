@@ -40,6 +40,7 @@ using namespace std;
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/lasterror.h"
+#include "mongo/logger/buffered_log_writer.h"
 #include "mongo/util/stacktrace.h"
 
 namespace mongo {
@@ -157,6 +158,8 @@ namespace mongo {
         log() << "Fatal Assertion " << msgid << endl;
         breakpoint();
         log() << "\n\n***aborting after fassert() failure\n\n" << endl;
+        // Nothing else drains buffered log lines on this path, and they explain the exit.
+        logger::BufferedLogWriter::flushAll();
         ::_exit(EXIT_ABRUPT); // bypass our handler for SIGABRT, which prints a stack trace.
     }
 
@@ -0,0 +1,78 @@
+/*    Copyright 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+
+#pragma once
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+    /**
+     * A 64 bit counter spread over kNumStripes cache lines.  Each thread adds to the stripe it
+     * was given the first time it touched any striped counter, so threads running on different
+     * cores rarely write the same line.  Reading sums every stripe, so reads cost far more than
+     * adds and should be left to reporting paths such as serverStatus.
+     */
+    class StripedCounter {
+        MONGO_DISALLOW_COPYING(StripedCounter);
+    public:
+        static const int kNumStripes = 64;
+
+        StripedCounter() {}
+
+        void add(long long n) { _stripes[threadStripe()].value.fetchAndAdd(n); }
+        void increment() { add(1); }
+
+        /**
+         * Returns the sum of all stripes.  Not a snapshot: adds made while summing may or may
+         * not be counted.
+         */
+        long long get() const;
+
+        /**
+         * Zeroes every stripe.  Adds racing with this may survive it.
+         */
+        void reset();
+
+        /**
+         * Returns the stripe, in [0, kNumStripes), of the calling thread.  Stripes are handed
+         * out round robin, so other per-thread sharded structures may use this too.
+         */
+        static int threadStripe();
+
+    private:
+        struct Stripe {
+            AtomicInt64 value;
+            char pad[64 - sizeof(AtomicInt64)];
+        };
+
+        Stripe _stripes[kNumStripes];
+    };
+
+}  // namespace mongo
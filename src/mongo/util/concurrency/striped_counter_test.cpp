@@ -0,0 +1,91 @@
+/*    Copyright 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <boost/thread/thread.hpp>
+#include <vector>
+
+#include "mongo/stdx/functional.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/striped_counter.h"
+
+namespace {
+
+    using mongo::StripedCounter;
+
+    void addMany(StripedCounter* counter, int* stripe, int n) {
+        *stripe = StripedCounter::threadStripe();
+        for (int i = 0; i < n; ++i) {
+            counter->increment();
+        }
+    }
+
+    TEST(StripedCounter, AddsAndResets) {
+        StripedCounter counter;
+        ASSERT_EQUALS(0, counter.get());
+        counter.add(5);
+        counter.increment();
+        counter.add(-2);
+        ASSERT_EQUALS(4, counter.get());
+        counter.reset();
+        ASSERT_EQUALS(0, counter.get());
+    }
+
+    TEST(StripedCounter, ThreadStripeIsStable) {
+        const int stripe = StripedCounter::threadStripe();
+        ASSERT_GREATER_THAN_OR_EQUALS(stripe, 0);
+        ASSERT_LESS_THAN(stripe, StripedCounter::kNumStripes);
+        ASSERT_EQUALS(stripe, StripedCounter::threadStripe());
+    }
+
+    TEST(StripedCounter, SumsAcrossThreads) {
+        const int kThreads = 8;
+        const int kIncrements = 10000;
+
+        StripedCounter counter;
+        std::vector<int> stripes(kThreads);
+        std::vector<boost::thread*> threads;
+        for (int i = 0; i < kThreads; ++i) {
+            threads.push_back(new boost::thread(
+                mongo::stdx::bind(addMany, &counter, &stripes[i], kIncrements)));
+        }
+        for (int i = 0; i < kThreads; ++i) {
+            threads[i]->join();
+            delete threads[i];
+        }
+
+        ASSERT_EQUALS(static_cast<long long>(kThreads) * kIncrements, counter.get());
+
+        // Stripes are handed out round robin, so these threads all got different ones.
+        for (int i = 1; i < kThreads; ++i) {
+            ASSERT_NOT_EQUALS(stripes[0], stripes[i]);
+        }
+    }
+
+}  // namespace
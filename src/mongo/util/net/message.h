@@ -35,6 +35,7 @@
 #include "mongo/platform/cstdint.h"
 #include "mongo/util/goodies.h"
 #include "mongo/util/net/hostandport.h"
+#include "mongo/util/net/message_buffer_pool.h"
 #include "mongo/util/net/sock.h"
 
 namespace mongo {
@@ -166,12 +167,12 @@ namespace mongo {
     class Message {
     public:
         // we assume here that a vector with initial size 0 does no allocation (0 is the default, but wanted to make it explicit).
-        Message() : _buf( 0 ), _data( 0 ), _freeIt( false ) {}
+        Message() : _buf( 0 ), _data( 0 ), _freeIt( false ), _pooled( false ) {}
         Message( void * data , bool freeIt ) :
-            _buf( 0 ), _data( 0 ), _freeIt( false ) {
+            _buf( 0 ), _data( 0 ), _freeIt( false ), _pooled( false ) {
             _setData( reinterpret_cast< MsgData* >( data ), freeIt );
         };
-        Message(Message& r) : _buf( 0 ), _data( 0 ), _freeIt( false ) {
+        Message(Message& r) : _buf( 0 ), _data( 0 ), _freeIt( false ), _pooled( false ) {
             *this = r;
         }
         ~Message() {
@@ -243,22 +244,33 @@ namespace mongo {
             }
             r._freeIt = false;
             _freeIt = true;
+            _pooled = r._pooled;
+            r._pooled = false;
             return *this;
         }
 
         void reset() {
             if ( _freeIt ) {
-                if ( _buf ) {
+                if ( _pooled ) {
+                    MessageBufferPool::release( _buf );
+                }
+                else if ( _buf ) {
                     free( _buf );
                 }
                 for (std::vector< std::pair< char *, int > >::const_iterator i = _data.begin();
                      i != _data.end(); ++i) {
-                    free(i->first);
+                    if ( _pooled ) {
+                        MessageBufferPool::release( i->first );
+                    }
+                    else {
+                        free( i->first );
+                    }
                 }
             }
             _buf = 0;
             _data.clear();
             _freeIt = false;
+            _pooled = false;
         }
 
         // use to add a buffer
@@ -273,13 +285,24 @@ namespace mongo {
                 _setData( md, true );
                 return;
             }
-            verify( _freeIt );
-            if ( _buf ) {
-                _data.push_back(std::make_pair((char*)_buf, _buf->len));
-                _buf = 0;
+            // every buffer is released the same way, so malloc()ed and pooled ones can't mix
+            verify( !_pooled );
+            _append( d, size );
+        }
+
+        // like appendData(), for buffers from MessageBufferPool::allocate()
+        void appendPooledData(char *d, int size) {
+            if ( size <= 0 ) {
+                return;
             }
-            _data.push_back(std::make_pair(d, size));
-            header()->len += size;
+            if ( empty() ) {
+                MsgData *md = (MsgData*)d;
+                md->len = size;
+                setPooledData( md );
+                return;
+            }
+            verify( _pooled );
+            _append( d, size );
         }
 
         // use to set first buffer if empty
@@ -287,6 +310,12 @@ namespace mongo {
             verify( empty() );
             _setData( d, freeIt );
         }
+        // use to set first buffer if empty, where "d" came from MessageBufferPool::allocate()
+        void setPooledData(MsgData *d) {
+            verify( empty() );
+            _setData( d, true );
+            _pooled = true;
+        }
         void setData(int operation, const char *msgtxt) {
             setData(operation, msgtxt, strlen(msgtxt)+1);
         }
@@ -309,8 +338,18 @@ namespace mongo {
         std::string toString() const;
 
     private:
+        void _append(char *d, int size) {
+            verify( _freeIt );
+            if ( _buf ) {
+                _data.push_back(std::make_pair((char*)_buf, _buf->len));
+                _buf = 0;
+            }
+            _data.push_back(std::make_pair(d, size));
+            header()->len += size;
+        }
         void _setData( MsgData *d, bool freeIt ) {
             _freeIt = freeIt;
+            _pooled = false;
             _buf = d;
         }
         // if just one buffer, keep it in _buf, otherwise keep a sequence of buffers in _data
@@ -319,6 +358,8 @@ namespace mongo {
         typedef std::vector< std::pair< char*, int > > MsgVec;
         MsgVec _data;
         bool _freeIt;
+        // _buf or the buffers in _data came from MessageBufferPool
+        bool _pooled;
     };
 
 
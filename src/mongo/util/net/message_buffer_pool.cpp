@@ -0,0 +1,198 @@
+/*    Copyright 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/net/message_buffer_pool.h"
+
+#include <cstdlib>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/threadlocal.h"
+
+namespace mongo {
+
+    const size_t MessageBufferPool::kMinClassBytes;
+    const size_t MessageBufferPool::kMaxClassBytes;
+    const size_t MessageBufferPool::kMaxCachedPerClass;
+    const size_t MessageBufferPool::kMaxCachedBytes;
+    const size_t MessageBufferPool::kOverheadBytes;
+
+namespace {
+
+    /// Every buffer is preceded by a header recording its size class, sized to keep the buffer
+    /// itself as aligned as malloc() made the block.
+    const size_t kHeaderBytes = MessageBufferPool::kOverheadBytes;
+
+    const int kNumClasses = 9;
+    const int kUnpooledClass = -1;
+
+    BOOST_STATIC_ASSERT((MessageBufferPool::kMinClassBytes << (kNumClasses - 1)) ==
+                        MessageBufferPool::kMaxClassBytes);
+
+    AtomicUInt64 allocatedCount;
+    AtomicUInt64 reusedCount;
+    AtomicUInt64 freedCount;
+
+    /**
+     * Returns the size class of a buffer of "size" bytes, or kUnpooledClass if it is too large
+     * to pool.
+     */
+    int classFor(size_t size) {
+        const size_t total = size + kHeaderBytes;
+        for (int sizeClass = 0; sizeClass < kNumClasses; ++sizeClass) {
+            if (total <= (MessageBufferPool::kMinClassBytes << sizeClass)) {
+                return sizeClass;
+            }
+        }
+        return kUnpooledClass;
+    }
+
+    size_t classBytes(int sizeClass) {
+        return MessageBufferPool::kMinClassBytes << sizeClass;
+    }
+
+    void freeBlock(char* block) {
+        freedCount.fetchAndAdd(1);
+        free(block);
+    }
+
+    class ThreadCache {
+        MONGO_DISALLOW_COPYING(ThreadCache);
+    public:
+        ThreadCache() : _cachedBytes(0) {
+            for (int i = 0; i < kNumClasses; ++i) {
+                _counts[i] = 0;
+            }
+        }
+
+        ~ThreadCache() { clear(); }
+
+        /**
+         * Returns a cached block of "sizeClass", or NULL if there is none.
+         */
+        char* pop(int sizeClass) {
+            if (!_counts[sizeClass]) {
+                return NULL;
+            }
+            _cachedBytes -= classBytes(sizeClass);
+            return _blocks[sizeClass][--_counts[sizeClass]];
+        }
+
+        /**
+         * Caches "block" of "sizeClass".  Returns false if the cache is full.
+         */
+        bool push(int sizeClass, char* block) {
+            if (_counts[sizeClass] == MessageBufferPool::kMaxCachedPerClass ||
+                _cachedBytes + classBytes(sizeClass) > MessageBufferPool::kMaxCachedBytes) {
+                return false;
+            }
+            _cachedBytes += classBytes(sizeClass);
+            _blocks[sizeClass][_counts[sizeClass]++] = block;
+            return true;
+        }
+
+        void clear() {
+            for (int i = 0; i < kNumClasses; ++i) {
+                while (_counts[i]) {
+                    freeBlock(_blocks[i][--_counts[i]]);
+                }
+            }
+            _cachedBytes = 0;
+        }
+
+    private:
+        char* _blocks[kNumClasses][MessageBufferPool::kMaxCachedPerClass];
+        size_t _counts[kNumClasses];
+        size_t _cachedBytes;
+    };
+
+}  // namespace
+
+    TSP_DECLARE(ThreadCache, messageBufferCache);
+    TSP_DEFINE(ThreadCache, messageBufferCache);
+
+    void* MessageBufferPool::allocate(size_t size) {
+        const int sizeClass = classFor(size);
+
+        char* block = NULL;
+        if (sizeClass != kUnpooledClass) {
+            block = messageBufferCache.getMake()->pop(sizeClass);
+        }
+        if (block) {
+            reusedCount.fetchAndAdd(1);
+        }
+        else {
+            block = static_cast<char*>(malloc(sizeClass == kUnpooledClass ?
+                                              size + kHeaderBytes : classBytes(sizeClass)));
+            if (!block) {
+                msgasserted(17519, "out of memory allocating a message buffer");
+            }
+            allocatedCount.fetchAndAdd(1);
+        }
+
+        *reinterpret_cast<int*>(block) = sizeClass;
+        return block + kHeaderBytes;
+    }
+
+    void MessageBufferPool::release(void* buffer) {
+        if (!buffer) {
+            return;
+        }
+
+        char* block = static_cast<char*>(buffer) - kHeaderBytes;
+        const int sizeClass = *reinterpret_cast<int*>(block);
+        if (sizeClass != kUnpooledClass) {
+            ThreadCache* cache = messageBufferCache.get();
+            if (cache && cache->push(sizeClass, block)) {
+                return;
+            }
+        }
+        freeBlock(block);
+    }
+
+    void MessageBufferPool::releaseThreadCache() {
+        ThreadCache* cache = messageBufferCache.get();
+        if (cache) {
+            cache->clear();
+        }
+    }
+
+    void MessageBufferPool::appendStats(BSONObjBuilder* b) {
+        b->appendNumber("allocated", static_cast<long long>(getAllocatedCount()));
+        b->appendNumber("reused", static_cast<long long>(getReusedCount()));
+        b->appendNumber("freed", static_cast<long long>(getFreedCount()));
+    }
+
+    uint64_t MessageBufferPool::getAllocatedCount() { return allocatedCount.loadRelaxed(); }
+    uint64_t MessageBufferPool::getReusedCount() { return reusedCount.loadRelaxed(); }
+    uint64_t MessageBufferPool::getFreedCount() { return freedCount.loadRelaxed(); }
+
+}  // namespace mongo
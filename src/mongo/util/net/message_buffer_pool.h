@@ -0,0 +1,89 @@
+/*    Copyright 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "mongo/platform/cstdint.h"
+
+namespace mongo {
+
+    class BSONObjBuilder;
+
+    /**
+     * Buffers for wire protocol messages, recycled through per-thread free lists.
+     *
+     * Requests are received, and most replies sent, on the thread serving the connection, so
+     * that thread's free list usually hands back the buffer its previous message used.
+     * Buffers come in power of two size classes from kMinClassBytes to kMaxClassBytes; larger
+     * ones are malloc()ed and free()d directly.  Each thread keeps at most kMaxCachedPerClass
+     * buffers of a class and kMaxCachedBytes in all.
+     *
+     * Buffers must be returned with release(), never free().
+     */
+    class MessageBufferPool {
+    public:
+        static const size_t kMinClassBytes = 1024;
+        static const size_t kMaxClassBytes = 256 * 1024;
+        static const size_t kMaxCachedPerClass = 4;
+        static const size_t kMaxCachedBytes = 512 * 1024;
+
+        /// A buffer of a size class holds this many bytes less than the class size.
+        static const size_t kOverheadBytes = 16;
+
+        /**
+         * Returns a buffer of at least "size" bytes.  Never returns NULL.
+         */
+        static void* allocate(size_t size);
+
+        /**
+         * Returns "buffer", which must have come from allocate(), to the calling thread's
+         * free list, or to the allocator if that list is full.  NULL is ignored.
+         */
+        static void release(void* buffer);
+
+        /**
+         * Frees the buffers cached by the calling thread.
+         */
+        static void releaseThreadCache();
+
+        /**
+         * Counts of buffers handed out from a free list ("reused"), obtained from the allocator
+         * ("allocated"), and given back to it ("freed").
+         */
+        static void appendStats(BSONObjBuilder* b);
+
+        static uint64_t getAllocatedCount();
+        static uint64_t getReusedCount();
+        static uint64_t getFreedCount();
+
+    private:
+        MessageBufferPool();
+    };
+
+}  // namespace mongo
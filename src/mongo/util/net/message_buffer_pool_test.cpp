@@ -0,0 +1,110 @@
+/*    Copyright 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <cstring>
+#include <vector>
+
+#include "mongo/util/net/message.h"
+#include "mongo/util/net/message_buffer_pool.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+    using mongo::Message;
+    using mongo::MessageBufferPool;
+    using mongo::MsgData;
+
+    class MessageBufferPoolTest : public mongo::unittest::Test {
+    protected:
+        virtual void setUp() { MessageBufferPool::releaseThreadCache(); }
+        virtual void tearDown() { MessageBufferPool::releaseThreadCache(); }
+    };
+
+    TEST_F(MessageBufferPoolTest, ReleasedBufferIsReusedForSameSizeClass) {
+        void* first = MessageBufferPool::allocate(100);
+        memset(first, 'x', 100);
+        MessageBufferPool::release(first);
+
+        const unsigned long long reused = MessageBufferPool::getReusedCount();
+        const unsigned long long allocated = MessageBufferPool::getAllocatedCount();
+        void* second = MessageBufferPool::allocate(500);
+        ASSERT_EQUALS(first, second);
+        ASSERT_EQUALS(reused + 1, MessageBufferPool::getReusedCount());
+        ASSERT_EQUALS(allocated, MessageBufferPool::getAllocatedCount());
+
+        // A larger size class can't use it.
+        void* third = MessageBufferPool::allocate(MessageBufferPool::kMinClassBytes * 2);
+        ASSERT_NOT_EQUALS(second, third);
+        ASSERT_EQUALS(allocated + 1, MessageBufferPool::getAllocatedCount());
+
+        MessageBufferPool::release(second);
+        MessageBufferPool::release(third);
+    }
+
+    TEST_F(MessageBufferPoolTest, OversizedBuffersAreNotCached) {
+        void* big = MessageBufferPool::allocate(MessageBufferPool::kMaxClassBytes + 1);
+        memset(big, 'x', MessageBufferPool::kMaxClassBytes + 1);
+
+        const unsigned long long freed = MessageBufferPool::getFreedCount();
+        MessageBufferPool::release(big);
+        ASSERT_EQUALS(freed + 1, MessageBufferPool::getFreedCount());
+    }
+
+    TEST_F(MessageBufferPoolTest, CacheIsBoundedPerSizeClass) {
+        std::vector<void*> buffers;
+        for (size_t i = 0; i < MessageBufferPool::kMaxCachedPerClass + 2; ++i) {
+            buffers.push_back(MessageBufferPool::allocate(10));
+        }
+
+        const unsigned long long freed = MessageBufferPool::getFreedCount();
+        for (size_t i = 0; i < buffers.size(); ++i) {
+            MessageBufferPool::release(buffers[i]);
+        }
+        ASSERT_EQUALS(freed + 2, MessageBufferPool::getFreedCount());
+    }
+
+    TEST_F(MessageBufferPoolTest, MessageReleasesPooledData) {
+        const int len = sizeof(MsgData) + 10;
+        MsgData* md = static_cast<MsgData*>(MessageBufferPool::allocate(len));
+        md->len = len;
+        md->setOperation(mongo::opReply);
+
+        Message first;
+        first.setPooledData(md);
+        Message second(first);
+        ASSERT_TRUE(first.empty());
+        ASSERT_EQUALS(md, second.singleData());
+
+        second.reset();
+        void* reused = MessageBufferPool::allocate(len);
+        ASSERT_EQUALS(static_cast<void*>(md), reused);
+        MessageBufferPool::release(reused);
+    }
+
+}  // namespace
@@ -222,11 +222,8 @@ again:
             }
 
             psock->setHandshakeReceived();
-            int z = (len+1023)&0xfffffc00;
-            verify(z>=len);
-            MsgData *md = (MsgData *) malloc(z);
-            ScopeGuard guard = MakeGuard(free, md);
-            verify(md);
+            MsgData *md = static_cast<MsgData*>(MessageBufferPool::allocate(len));
+            ScopeGuard guard = MakeGuard(&MessageBufferPool::release, md);
 
             memcpy(md, &header, headerLen);
             int left = len - headerLen;
@@ -234,7 +231,7 @@ again:
             psock->recv( (char *)&md->_data, left );
 
             guard.Dismiss();
-            m.setData(md, true);
+            m.setPooledData(md);
             return true;
 
         }
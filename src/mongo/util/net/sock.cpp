@@ -40,6 +40,7 @@
 # include <arpa/inet.h>
 # include <errno.h>
 # include <netdb.h>
+# include <limits.h>
 # if defined(__openbsd__)
 #  include <sys/uio.h>
 # endif
@@ -56,6 +57,14 @@
 namespace mongo {
     MONGO_FP_DECLARE(throwSockExcep);
 
+#if !defined(_WIN32)
+# if defined(IOV_MAX)
+    static const size_t kMaxIovecsPerSend = IOV_MAX;
+# else
+    static const size_t kMaxIovecsPerSend = 16;
+# endif
+#endif
+
     static bool ipv6 = false;
     void enableIPv6(bool state) { ipv6 = state; }
     bool IPv6Enabled() { return ipv6; }
@@ -638,23 +647,26 @@ namespace mongo {
         _send( data , context );
 #else
         vector<struct iovec> d( data.size() );
-        int i = 0;
+        size_t remaining = 0;
         for (vector< pair<char *, int> >::const_iterator j = data.begin(); 
              j != data.end(); 
              ++j) {
             if ( j->second > 0 ) {
-                d[ i ].iov_base = j->first;
-                d[ i ].iov_len = j->second;
-                ++i;
+                d[ remaining ].iov_base = j->first;
+                d[ remaining ].iov_len = j->second;
+                ++remaining;
                 _bytesOut += j->second;
             }
         }
-        struct msghdr meta;
-        memset( &meta, 0, sizeof( meta ) );
-        meta.msg_iov = &d[ 0 ];
-        meta.msg_iovlen = d.size();
 
-        while( meta.msg_iovlen > 0 ) {
+        // sendmsg() rejects more than IOV_MAX buffers, so a long reply goes out in batches
+        struct iovec* next = remaining ? &d[ 0 ] : NULL;
+        while( remaining > 0 ) {
+            struct msghdr meta;
+            memset( &meta, 0, sizeof( meta ) );
+            meta.msg_iov = next;
+            meta.msg_iovlen = std::min( remaining, kMaxIovecsPerSend );
+
             int ret = -1;
             if (MONGO_FAIL_POINT(throwSockExcep)) {
 #if defined(_WIN32)
@@ -680,17 +692,16 @@ namespace mongo {
                 }
             }
             else {
-                struct iovec *& i = meta.msg_iov;
                 while( ret > 0 ) {
-                    if ( i->iov_len > unsigned( ret ) ) {
-                        i->iov_len -= ret;
-                        i->iov_base = (char*)(i->iov_base) + ret;
+                    if ( next->iov_len > unsigned( ret ) ) {
+                        next->iov_len -= ret;
+                        next->iov_base = (char*)(next->iov_base) + ret;
                         ret = 0;
                     }
                     else {
-                        ret -= i->iov_len;
-                        ++i;
-                        --(meta.msg_iovlen);
+                        ret -= next->iov_len;
+                        ++next;
+                        --remaining;
                     }
                 }
             }
@@ -30,6 +30,7 @@
 
 #include "mongo/pch.h" // for malloc/realloc/INFINITY pulled from bson
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/bsontypes.h"
 #include "mongo/util/safe_num.h"
 
@@ -76,6 +77,22 @@ namespace mongo {
         return os.str();
     }
 
+    void SafeNum::toBSON(const StringData& fieldName, BSONObjBuilder* bob) const {
+        switch (_type) {
+        case NumberInt:
+            bob->append(fieldName, _value.int32Val);
+            break;
+        case NumberLong:
+            bob->append(fieldName, _value.int64Val);
+            break;
+        case NumberDouble:
+            bob->append(fieldName, _value.doubleVal);
+            break;
+        default:
+            verify(false);
+        }
+    }
+
     std::ostream& operator<<(std::ostream& os, const SafeNum& snum) {
         return os << snum.debugString();
     }
@@ -35,6 +35,8 @@
 
 namespace mongo {
 
+    class BSONObjBuilder;
+
 namespace mutablebson {
     class Element;
     class Document;
@@ -152,7 +154,11 @@ namespace mutablebson {
         friend class mutablebson::Element;
         friend class mutablebson::Document;
 
-        // TODO: output to builder
+        /**
+         * Appends this number to 'bob' under 'fieldName', keeping its exact numeric type.
+         * It is illegal to call this on an invalid (EOO-typed) instance.
+         */
+        void toBSON(const StringData& fieldName, BSONObjBuilder* bob) const;
 
         //
         // accessors
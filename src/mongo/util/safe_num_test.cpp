@@ -29,6 +29,7 @@
 
 #include "mongo/pch.h" // for malloc/realloc pulled from bson
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/bsontypes.h"
 #include "mongo/util/safe_num.h"
 #include "mongo/unittest/unittest.h"
@@ -456,4 +457,18 @@ namespace {
         ASSERT_EQUALS(mongo::EOO, (minusOneInt64 * minInt64).type());
     }
 
+    TEST(Output, ToBSONKeepsType) {
+        mongo::BSONObjBuilder bob;
+        SafeNum(1).toBSON("i", &bob);
+        SafeNum(2LL).toBSON("l", &bob);
+        SafeNum(3.5).toBSON("d", &bob);
+        const mongo::BSONObj obj = bob.obj();
+        ASSERT_EQUALS(mongo::NumberInt, obj["i"].type());
+        ASSERT_EQUALS(1, obj["i"].numberInt());
+        ASSERT_EQUALS(mongo::NumberLong, obj["l"].type());
+        ASSERT_EQUALS(2LL, obj["l"].numberLong());
+        ASSERT_EQUALS(mongo::NumberDouble, obj["d"].type());
+        ASSERT_EQUALS(3.5, obj["d"].numberDouble());
+    }
+
 } // unnamed namespace
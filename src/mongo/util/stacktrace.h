@@ -46,6 +46,22 @@ namespace mongo {
     // Print stack trace information to "os", default to the log stream.
     void printStackTrace(std::ostream &os=log().stream());
 
+#if !defined(_WIN32)
+    /**
+     * Stores the return addresses of up to "maxFrames" frames of the calling thread's stack in
+     * "addresses", innermost first, and returns the number stored.
+     *
+     * Safe to call from a signal handler once it has been called outside of one.
+     */
+    int getStackAddresses(void** addresses, int maxFrames);
+
+    /**
+     * Prints a name for the code at "address" to "os": the demangled symbol containing it if
+     * there is one, otherwise the base name of the object file and the offset into it.
+     */
+    void printFrameName(void* address, std::ostream& os);
+#endif
+
 #if defined(_WIN32)
     // Print stack trace (using a specified stack context) to "os", default to the log stream.
     void printWindowsStackTrace(CONTEXT &context, std::ostream &os=log().stream());
@@ -30,6 +30,7 @@
 #include "mongo/util/stacktrace.h"
 
 #include <cstdlib>
+#include <cxxabi.h>
 #include <dlfcn.h>
 #include <iostream>
 #include <string>
@@ -172,6 +173,34 @@ namespace {
         os << "-----  END BACKTRACE  -----" << std::endl;
     }
 
+    int getStackAddresses(void** addresses, int maxFrames) {
+        return backtrace(addresses, maxFrames);
+    }
+
+    void printFrameName(void* address, std::ostream& os) {
+        Dl_info dlinfo;
+        if (!dladdr(address, &dlinfo) || !dlinfo.dli_fbase) {
+            os << "???";
+            return;
+        }
+
+        if (dlinfo.dli_sname) {
+            int status;
+            char* demangled = abi::__cxa_demangle(dlinfo.dli_sname, 0, 0, &status);
+            if (demangled) {
+                os << demangled;
+                free(demangled);
+            }
+            else {
+                os << dlinfo.dli_sname;
+            }
+            return;
+        }
+
+        const uintptr_t offset = uintptr_t(address) - uintptr_t(dlinfo.dli_fbase);
+        os << getBaseName(dlinfo.dli_fname) << "+0x" << std::hex << offset << std::dec;
+    }
+
 namespace {
 
     void addOSComponentsToSoMap(BSONObjBuilder* soMap);